@@ -51,6 +51,7 @@ struct Config {
   std::size_t batch_size{10'000'000};
   std::size_t iterations{1};
   std::uint64_t seed{123456789};
+  bool visit{false};
 };
 
 [[nodiscard]] static std::vector<std::uint64_t> init_bin_ids(const BinTable &bins,
@@ -66,10 +67,19 @@ struct Config {
 }
 
 [[nodiscard]] std::uint64_t run_benchmark(const BinTable &bins,
-                                          const std::vector<std::uint64_t> &queries) {
+                                          const std::vector<std::uint64_t> &queries, bool visit) {
   const auto t0 = std::chrono::system_clock::now();
-  for (const auto &q : queries) {
-    std::ignore = bins.at(q);
+  if (visit) {
+    // resolve the bin table type once and query the concrete bin table
+    bins.visit([&](const auto &bins_) {
+      for (const auto &q : queries) {
+        std::ignore = bins_.at(q);
+      }
+    });
+  } else {
+    for (const auto &q : queries) {
+      std::ignore = bins.at(q);
+    }
   }
   const auto t1 = std::chrono::system_clock::now();
 
@@ -87,6 +97,9 @@ int main(int argc, char **argv) noexcept {
   cli.add_option("--iterations", config.iterations, "Number of iterations to perform.")
       ->capture_default_str();
   cli.add_option("--seed", config.seed, "Seed")->capture_default_str();
+  cli.add_flag("--visit", config.visit,
+               "Query the underlying bin table through hictk::BinTable::visit().")
+      ->capture_default_str();
 
   try {
     cli.parse(argc, argv);
@@ -96,14 +109,15 @@ int main(int argc, char **argv) noexcept {
 
     std::uint64_t elapsed_time = 0;
     for (std::size_t i = 0; i < config.iterations; ++i) {
-      elapsed_time += run_benchmark(bin_table, bin_ids);
+      elapsed_time += run_benchmark(bin_table, bin_ids, config.visit);
     }
 
     const auto elapsed_seconds = static_cast<double>(elapsed_time) / 1.0e9;
     const auto throughput =
         static_cast<double>(config.batch_size * config.iterations) / elapsed_seconds;
 
-    fmt::print(FMT_STRING("hictk::BinTable::at(bin_id) throughput: {:.4} num/s\n"), throughput);
+    fmt::print(FMT_STRING("{}::at(bin_id) throughput: {:.4} num/s\n"),
+               config.visit ? "hictk::BinTableFixed" : "hictk::BinTable", throughput);
 
   } catch (const CLI::ParseError &e) {
     return cli.exit(e);
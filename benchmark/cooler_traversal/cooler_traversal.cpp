@@ -7,33 +7,65 @@
 #include <CLI/CLI.hpp>
 #include <chrono>
 #include <hictk/cooler/cooler.hpp>
+#include <hictk/file.hpp>
+#include <string>
 
 using namespace hictk;
 
 struct Config {
   std::filesystem::path uri{};
   std::size_t iterations{1};
+  std::string api{"cooler"};
 };
 
+// Traverse all pixels using one of the following APIs:
+// - cooler: hictk::cooler::File::iterator
+// - generic: hictk::PixelSelector::iterator (i.e. the std::variant-based iterator)
+// - visitor: hictk::PixelSelector::for_each_pixel()
+// - batches: hictk::PixelSelector::visit_batches()
+static std::ptrdiff_t traverse_pixels(const File &f, const Config &c) {
+  std::ptrdiff_t size = 0;
+  if (c.api == "cooler") {
+    const auto &clr = f.get<cooler::File>();
+    std::for_each(clr.begin<std::uint32_t>(), clr.end<std::uint32_t>(),
+                  [&]([[maybe_unused]] const auto n) { size++; });
+    return size;
+  }
+
+  const auto sel = f.fetch();
+  if (c.api == "generic") {
+    std::for_each(sel.begin<std::uint32_t>(), sel.end<std::uint32_t>(),
+                  [&]([[maybe_unused]] const auto n) { size++; });
+  } else if (c.api == "visitor") {
+    sel.for_each_pixel<std::uint32_t>([&]([[maybe_unused]] const auto &n) { size++; });
+  } else {
+    sel.visit_batches<std::uint32_t>(
+        64'000, [&](const auto &batch) { size += static_cast<std::ptrdiff_t>(batch.size()); });
+  }
+  return size;
+}
+
 // NOLINTNEXTLINE(bugprone-exception-escape)
 int main(int argc, char **argv) noexcept {
   CLI::App cli{};
   Config config{};
   cli.add_option("uri", config.uri, "URI to a cooler file.");
   cli.add_option("--iterations", config.iterations, "Number of iterations.")->capture_default_str();
+  cli.add_option("--api", config.api, "API used to traverse pixels.")
+      ->check(CLI::IsMember({"cooler", "generic", "visitor", "batches"}))
+      ->capture_default_str();
 
   try {
     cli.parse(argc, argv);
 
-    cooler::File f(config.uri.string());
+    const File f(config.uri.string());
 
     std::ptrdiff_t size = 0;
     std::uint64_t elapsed_time{};
 
     for (std::size_t i = 0; i < config.iterations; ++i) {
       const auto t0 = std::chrono::system_clock::now();
-      std::for_each(f.begin<std::uint32_t>(), f.end<std::uint32_t>(),
-                    [&]([[maybe_unused]] const auto n) { size++; });
+      size += traverse_pixels(f, config);
       const auto t1 = std::chrono::system_clock::now();
       const auto delta = static_cast<std ::uint64_t>(
           std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
@@ -43,8 +75,8 @@ int main(int argc, char **argv) noexcept {
     const auto elapsed_seconds = static_cast<double>(elapsed_time) / 1.0e9;
     const auto throughput = static_cast<double>(size) / elapsed_seconds;
 
-    fmt::print(FMT_STRING("hictk::cooler::File::iterator<std::uint32_t> throughput: {:.4} num/s\n"),
-               throughput);
+    fmt::print(FMT_STRING("hictk::{} pixel traversal (std::uint32_t) throughput: {:.4} num/s\n"),
+               config.api, throughput);
 
   } catch (const CLI::ParseError &e) {
     return cli.exit(e);
@@ -6,7 +6,9 @@
 
 #include <CLI/CLI.hpp>
 #include <chrono>
+#include <hictk/file.hpp>
 #include <hictk/hic.hpp>
+#include <string>
 
 using namespace hictk;
 
@@ -15,8 +17,37 @@ struct Config {
   std::uint32_t resolution{};
   bool sorted{true};
   std::size_t iterations{1};
+  std::string api{"hic"};
 };
 
+// Traverse all pixels using one of the following APIs:
+// - hic: hictk::hic::PixelSelector::iterator
+// - generic: hictk::PixelSelector::iterator (i.e. the std::variant-based iterator)
+// - visitor: hictk::PixelSelector::for_each_pixel()
+// - batches: hictk::PixelSelector::visit_batches()
+static std::ptrdiff_t traverse_pixels(const File &f, const Config &c) {
+  std::ptrdiff_t size = 0;
+  if (c.api == "hic") {
+    const auto sel = f.get<hic::File>().fetch();
+    std::for_each(sel.begin<std::uint32_t>(c.sorted), sel.end<std::uint32_t>(),
+                  [&]([[maybe_unused]] const auto n) { size++; });
+    return size;
+  }
+
+  const auto sel = f.fetch();
+  if (c.api == "generic") {
+    std::for_each(sel.begin<std::uint32_t>(c.sorted), sel.end<std::uint32_t>(),
+                  [&]([[maybe_unused]] const auto n) { size++; });
+  } else if (c.api == "visitor") {
+    sel.for_each_pixel<std::uint32_t>([&]([[maybe_unused]] const auto &n) { size++; }, c.sorted);
+  } else {
+    sel.visit_batches<std::uint32_t>(
+        64'000, [&](const auto &batch) { size += static_cast<std::ptrdiff_t>(batch.size()); },
+        c.sorted);
+  }
+  return size;
+}
+
 // NOLINTNEXTLINE(bugprone-exception-escape)
 int main(int argc, char **argv) noexcept {
   CLI::App cli{};
@@ -25,20 +56,21 @@ int main(int argc, char **argv) noexcept {
   cli.add_option("resolution", config.resolution, "Hi-C matrix resolution.");
   cli.add_option("--iterations", config.iterations, "Number of iterations.")->capture_default_str();
   cli.add_flag("--sorted,!--unsorted", config.sorted);
+  cli.add_option("--api", config.api, "API used to traverse pixels.")
+      ->check(CLI::IsMember({"hic", "generic", "visitor", "batches"}))
+      ->capture_default_str();
 
   try {
     cli.parse(argc, argv);
 
-    hic::File f(config.uri.string(), config.resolution);
+    const File f(config.uri.string(), config.resolution);
 
     std::ptrdiff_t size = 0;
     std::uint64_t elapsed_time{};
 
     for (std::size_t i = 0; i < config.iterations; ++i) {
       const auto t0 = std::chrono::system_clock::now();
-      const auto sel = f.fetch();
-      std::for_each(sel.begin<std::uint32_t>(config.sorted), sel.end<std::uint32_t>(),
-                    [&]([[maybe_unused]] const auto n) { size++; });
+      size += traverse_pixels(f, config);
       const auto t1 = std::chrono::system_clock::now();
       const auto delta = static_cast<std ::uint64_t>(
           std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
@@ -48,8 +80,8 @@ int main(int argc, char **argv) noexcept {
     const auto elapsed_seconds = static_cast<double>(elapsed_time) / 1.0e9;
     const auto throughput = static_cast<double>(size) / elapsed_seconds;
 
-    fmt::print(FMT_STRING("hictk::hic::File::iterator<std::uint32_t> throughput: {:.4} num/s\n"),
-               throughput);
+    fmt::print(FMT_STRING("hictk::{} pixel traversal (std::uint32_t) throughput: {:.4} num/s\n"),
+               config.api, throughput);
 
   } catch (const CLI::ParseError &e) {
     return cli.exit(e);
@@ -5,20 +5,38 @@
 #include <fmt/compile.h>
 #include <fmt/format.h>
 
+#include <BS_thread_pool.hpp>
 #include <CLI/CLI.hpp>
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <deque>
+#include <future>
 #include <hictk/cooler/cooler.hpp>
 #include <hictk/fmt/pixel.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
 
 using namespace hictk;
 
 struct Config {
   std::filesystem::path uri{};
   bool join{false};
+  std::string mode{"print"};
+  std::size_t threads{1};
+  std::size_t batch_size{64'000};
   std::size_t iterations{1};
 };
 
+template <typename PixelT>
+static void format_pixels(fmt::memory_buffer &buffer, const PixelT *first, const PixelT *last) {
+  std::for_each(first, last, [&](const auto &p) {
+    fmt::format_to(std::back_inserter(buffer), FMT_COMPILE("{}\n"), p);
+  });
+}
+
+// Print each pixel with a separate call to fmt::print
 template <typename PixelT>
 [[nodiscard]] static std::size_t print_pixels(const std::vector<PixelT> &pixels) {
   auto *dev_null = std::fopen("/dev/null", "w");
@@ -29,6 +47,72 @@ template <typename PixelT>
   return pixels.size();
 }
 
+// Format pixels into a memory buffer that is written to the output with large write calls
+template <typename PixelT>
+[[nodiscard]] static std::size_t print_pixels_buffered(const std::vector<PixelT> &pixels,
+                                                       std::size_t batch_size) {
+  auto *dev_null = std::fopen("/dev/null", "w");
+  fmt::memory_buffer buffer{};
+  for (std::size_t i = 0; i < pixels.size(); i += batch_size) {
+    const auto i1 = std::min(i + batch_size, pixels.size());
+    format_pixels(buffer, pixels.data() + i, pixels.data() + i1);
+    std::fwrite(buffer.data(), 1, buffer.size(), dev_null);
+    buffer.clear();
+  }
+  std::fclose(dev_null);
+
+  return pixels.size();
+}
+
+// Format batches of pixels in parallel and write the resulting buffers in order
+template <typename PixelT>
+[[nodiscard]] static std::size_t print_pixels_parallel(const std::vector<PixelT> &pixels,
+                                                       std::size_t batch_size,
+                                                       BS::thread_pool &tpool) {
+  auto *dev_null = std::fopen("/dev/null", "w");
+  const auto max_batches_in_flight = 2 * std::size_t{tpool.get_thread_count()};
+  std::deque<std::future<fmt::memory_buffer>> batches{};
+
+  auto write_next_batch = [&]() {
+    const auto buffer = batches.front().get();
+    batches.pop_front();
+    std::fwrite(buffer.data(), 1, buffer.size(), dev_null);
+  };
+
+  for (std::size_t i = 0; i < pixels.size(); i += batch_size) {
+    const auto i1 = std::min(i + batch_size, pixels.size());
+    const auto *first = pixels.data() + i;
+    const auto *last = pixels.data() + i1;
+    batches.emplace_back(tpool.submit_task([first, last]() {
+      fmt::memory_buffer buffer{};
+      format_pixels(buffer, first, last);
+      return buffer;
+    }));
+    while (batches.size() >= max_batches_in_flight) {
+      write_next_batch();
+    }
+  }
+  while (!batches.empty()) {
+    write_next_batch();
+  }
+  std::fclose(dev_null);
+
+  return pixels.size();
+}
+
+template <typename PixelT>
+[[nodiscard]] static std::size_t run_benchmark(const Config &c, const std::vector<PixelT> &pixels,
+                                               BS::thread_pool &tpool) {
+  if (c.mode == "buffered") {
+    return print_pixels_buffered(pixels, c.batch_size);
+  }
+  if (c.mode == "parallel") {
+    return print_pixels_parallel(pixels, c.batch_size, tpool);
+  }
+  assert(c.mode == "print");
+  return print_pixels(pixels);
+}
+
 
 // NOLINTNEXTLINE(bugprone-exception-escape)
 int main(int argc, char **argv) noexcept {
@@ -36,12 +120,22 @@ int main(int argc, char **argv) noexcept {
   Config config{};
   cli.add_option("uri", config.uri, "URI to a cooler file.");
   cli.add_flag("--bg2,!--coo", config.join, "Join genomic coordinates.")->capture_default_str();
+  cli.add_option("--mode", config.mode, "Formatting strategy.")
+      ->check(CLI::IsMember({"print", "buffered", "parallel"}))
+      ->capture_default_str();
+  cli.add_option("--threads", config.threads, "Number of formatting threads (--mode=parallel).")
+      ->check(CLI::PositiveNumber)
+      ->capture_default_str();
+  cli.add_option("--batch-size", config.batch_size, "Number of pixels formatted at once.")
+      ->check(CLI::PositiveNumber)
+      ->capture_default_str();
   cli.add_option("--iterations", config.iterations, "Number of iterations.")->capture_default_str();
 
   try {
     cli.parse(argc, argv);
 
     cooler::File f(config.uri.string());
+    BS::thread_pool tpool(static_cast<BS::concurrency_t>(config.threads));
 
     std::ptrdiff_t size = 0;
     std::uint64_t elapsed_time{};
@@ -60,8 +154,8 @@ int main(int argc, char **argv) noexcept {
 
     for (std::size_t i = 0; i < config.iterations; ++i) {
       const auto t0 = std::chrono::system_clock::now();
-      size += print_pixels(thin_pixel_buffer);
-      size += print_pixels(pixel_buffer);
+      size += run_benchmark(config, thin_pixel_buffer, tpool);
+      size += run_benchmark(config, pixel_buffer, tpool);
       const auto t1 = std::chrono::system_clock::now();
       const auto delta = static_cast<std ::uint64_t>(
           std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
@@ -71,8 +165,9 @@ int main(int argc, char **argv) noexcept {
     const auto elapsed_seconds = static_cast<double>(elapsed_time) / 1.0e9;
     const auto throughput = static_cast<double>(size) / elapsed_seconds;
 
-    fmt::print(FMT_STRING("fmt::print({}) throughput: {:.4} num/s\n"),
-               config.join ? "Pixel<std::uint32_t>" : "ThinPixel<std::uint32_t>", throughput);
+    fmt::print(FMT_STRING("{}({}; threads={}) throughput: {:.4} num/s\n"), config.mode,
+               config.join ? "Pixel<std::uint32_t>" : "ThinPixel<std::uint32_t>", config.threads,
+               throughput);
 
   } catch (const CLI::ParseError &e) {
     return cli.exit(e);
@@ -6,8 +6,10 @@
 
 #include <CLI/CLI.hpp>
 #include <chrono>
+#include <functional>
 #include <hictk/pixel.hpp>
 #include <hictk/transformers/pixel_merger.hpp>
+#include <queue>
 #include <random>
 #include <string_view>
 #include <vector>
@@ -16,8 +18,8 @@ using namespace hictk;
 
 struct Config {
   std::size_t genome_size{3'300'000};
-  std::size_t num_pixels_per_chunk{100'000'000};
-  std::size_t num_chunks{2};
+  std::size_t num_pixels{100'000'000};
+  std::vector<std::size_t> num_chunks{2, 10, 100, 1000};
   std::uint32_t resolution{1'000};
   std::size_t iterations{1};
   std::uint64_t seed{123456789};
@@ -41,6 +43,69 @@ using PixelBuffer = std::vector<ThinPixel<std::uint32_t>>;
   return buffer;
 }
 
+// Reference k-way merge based on std::priority_queue.
+// This is what hictk::transformers::PixelMerger used before switching to a loser tree.
+template <typename PixelIt, typename Fx>
+static void merge_pqueue(std::vector<PixelIt> heads, const std::vector<PixelIt> &tails, Fx fx) {
+  struct Node {
+    ThinPixel<std::uint32_t> pixel{};
+    std::size_t i{};
+
+    bool operator>(const Node &other) const noexcept {
+      if (pixel.bin1_id != other.pixel.bin1_id) {
+        return pixel.bin1_id > other.pixel.bin1_id;
+      }
+      return pixel.bin2_id > other.pixel.bin2_id;
+    }
+  };
+
+  std::priority_queue<Node, std::vector<Node>, std::greater<>> pqueue{};
+  for (std::size_t i = 0; i < heads.size(); ++i) {
+    if (heads[i] != tails[i]) {
+      pqueue.emplace(Node{*heads[i]++, i});
+    }
+  }
+
+  auto replace_top_node = [&]() {
+    const auto i = pqueue.top().i;
+    pqueue.pop();
+    if (auto &it = heads[i]; it != tails[i]) {
+      pqueue.emplace(Node{*it, i});
+      ++it;
+    }
+  };
+
+  while (!pqueue.empty()) {
+    auto pixel = pqueue.top().pixel;
+    replace_top_node();
+    while (!pqueue.empty() && pqueue.top().pixel.bin1_id == pixel.bin1_id &&
+           pqueue.top().pixel.bin2_id == pixel.bin2_id) {
+      pixel.count += pqueue.top().pixel.count;
+      replace_top_node();
+    }
+    fx(pixel);
+  }
+}
+
+template <typename Fx>
+[[nodiscard]] static double measure_throughput(std::size_t iterations, std::size_t num_pixels,
+                                               Fx fx) {
+  std::uint64_t elapsed_time = 0;
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto t0 = std::chrono::system_clock::now();
+    fx();
+    const auto t1 = std::chrono::system_clock::now();
+
+    const auto delta = static_cast<std ::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    elapsed_time += delta;
+  }
+
+  const auto avg_time =
+      (static_cast<double>(elapsed_time) / static_cast<double>(iterations)) / 1.0e9;
+  return static_cast<double>(num_pixels) / avg_time;
+}
+
 // NOLINTNEXTLINE(bugprone-exception-escape)
 int main(int argc, char **argv) noexcept {
   CLI::App cli{};
@@ -48,10 +113,13 @@ int main(int argc, char **argv) noexcept {
   cli.add_option("--genome-size", config.genome_size, "Genome size in bp.")->capture_default_str();
   cli.add_option("--resolution", config.resolution, "Resolution of the bin table.")
       ->capture_default_str();
-  cli.add_option("--pixels-per-chunk", config.num_pixels_per_chunk,
-                 "Number of pixels found in each chunk to be merged.")
+  cli.add_option("--num-pixels", config.num_pixels,
+                 "Total number of pixels to be merged.\n"
+                 "Pixels are evenly distributed across chunks.")
       ->capture_default_str();
-  cli.add_option("--num-chunks", config.num_chunks, "Number of chunks to be merged.")
+  cli.add_option("--num-chunks", config.num_chunks,
+                 "Number of chunks to be merged.\n"
+                 "When multiple values are provided, benchmarks are run once for each value.")
       ->capture_default_str();
   cli.add_option("--iterations", config.iterations, "Number of iterations to perform.")
       ->capture_default_str();
@@ -60,43 +128,44 @@ int main(int argc, char **argv) noexcept {
   try {
     cli.parse(argc, argv);
     std::mt19937_64 rand_eng(config.seed);
-    std::vector<PixelBuffer> pixel_chunks{};
-    using PixelIt = decltype(pixel_chunks.front().begin());
-
-    std::vector<PixelIt> heads{};
-    std::vector<PixelIt> tails{};
-
-    for (std::size_t i = 0; i < config.num_chunks; ++i) {
-      pixel_chunks.emplace_back(generate_pixels(config.genome_size / config.resolution,
-                                                config.num_pixels_per_chunk, rand_eng));
-      heads.emplace_back(pixel_chunks.back().begin());
-      tails.emplace_back(pixel_chunks.back().end());
+    for (const auto num_chunks : config.num_chunks) {
+      std::vector<PixelBuffer> pixel_chunks{};
+      using PixelIt = decltype(pixel_chunks.front().cbegin());
+
+      std::vector<PixelIt> heads{};
+      std::vector<PixelIt> tails{};
+
+      const auto num_pixels_per_chunk = config.num_pixels / num_chunks;
+      for (std::size_t i = 0; i < num_chunks; ++i) {
+        pixel_chunks.emplace_back(generate_pixels(config.genome_size / config.resolution,
+                                                  num_pixels_per_chunk, rand_eng));
+      }
+      for (const auto &chunk : pixel_chunks) {
+        heads.emplace_back(chunk.cbegin());
+        tails.emplace_back(chunk.cend());
+      }
+
+      const auto num_pixels = num_chunks * num_pixels_per_chunk;
+      std::uint64_t sum = 0;
+
+      const auto throughput_pqueue = measure_throughput(config.iterations, num_pixels, [&]() {
+        merge_pqueue(heads, tails, [&](const auto &p) { sum += p.count; });
+      });
+
+      const auto throughput_loser_tree = measure_throughput(config.iterations, num_pixels, [&]() {
+        const transformers::PixelMerger merger(heads, tails);
+        std::for_each(merger.begin(), merger.end(), [&](const auto &p) { sum += p.count; });
+      });
+
+      std::ignore = sum;
+
+      fmt::print(FMT_STRING("[{} chunks] std::priority_queue throughput: {:.4} pixels/s\n"),
+                 num_chunks, throughput_pqueue);
+      fmt::print(
+          FMT_STRING("[{} chunks] hictk::transformers::PixelMerger throughput: {:.4} pixels/s\n"),
+          num_chunks, throughput_loser_tree);
     }
 
-    std::uint64_t elapsed_time = 0;
-    std::uint64_t sum = 0;
-    for (std::size_t i = 0; i < config.iterations; ++i) {
-      const transformers::PixelMerger merger(heads, tails);
-
-      const auto t0 = std::chrono::system_clock::now();
-      std::for_each(merger.begin(), merger.end(), [&](const auto &p) { sum += p.count; });
-      const auto t1 = std::chrono::system_clock::now();
-
-      const auto delta = static_cast<std ::uint64_t>(
-          std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
-      elapsed_time += delta;
-    }
-
-    std::ignore = sum;
-
-    const auto avg_time =
-        (static_cast<double>(elapsed_time) / static_cast<double>(config.iterations)) / 1.0e9;
-    const auto throughput =
-        static_cast<double>(config.num_chunks * config.num_pixels_per_chunk) / avg_time;
-
-    fmt::print(FMT_STRING("hictk::transformers::PixelMerger throughput: {:.4} pixels/s\n"),
-               throughput);
-
   } catch (const CLI::ParseError &e) {
     return cli.exit(e);
   } catch (const std::exception &e) {
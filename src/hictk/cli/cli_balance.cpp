@@ -20,6 +20,7 @@
 #include "hictk/hic/validation.hpp"
 #include "hictk/tools/cli.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/memory_budget.hpp"
 
 namespace hictk::tools {
 
@@ -135,6 +136,12 @@ void Cli::make_ice_balance_subcommand(CLI::App& app) {
       "Number of interactions to process at once. Ignored when using --in-memory.")
       ->check(CLI::PositiveNumber)
       ->capture_default_str();
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
   sc.add_option(
       "-v,--verbosity",
       c.verbosity,
@@ -160,6 +167,8 @@ void Cli::make_ice_balance_subcommand(CLI::App& app) {
       ->capture_default_str();
   // clang-format on
 
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
+
   _config = std::monostate{};
 }
 
@@ -253,6 +262,12 @@ void Cli::make_scale_balance_subcommand(CLI::App& app) {
       "Number of interactions to process at once. Ignored when using --in-memory.")
       ->check(CLI::PositiveNumber)
       ->capture_default_str();
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
   sc.add_option(
       "-v,--verbosity",
       c.verbosity,
@@ -278,6 +293,8 @@ void Cli::make_scale_balance_subcommand(CLI::App& app) {
       ->capture_default_str();
   // clang-format on
 
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
+
   _config = std::monostate{};
 }
 
@@ -410,6 +427,12 @@ void Cli::transform_args_ice_balance_subcommand() {
     input_path = cooler::File(c.path_to_input.string()).path();
   }
 
+  if (c.max_memory != 0) {
+    // worker threads process their own chunk of interactions
+    MemoryBudget budget{c.max_memory};
+    c.chunk_size = budget.reserve_items(SPARSE_MATRIX_FOOTPRINT * (c.threads + 1));
+  }
+
   // in spdlog, high numbers correspond to low log levels
   assert(c.verbosity > 0 && c.verbosity < 5);
   c.verbosity = static_cast<std::uint8_t>(spdlog::level::critical) - c.verbosity;
@@ -435,6 +458,12 @@ void Cli::transform_args_scale_balance_subcommand() {
     input_path = cooler::File(c.path_to_input.string()).path();
   }
 
+  if (c.max_memory != 0) {
+    // worker threads process their own chunk of interactions
+    MemoryBudget budget{c.max_memory};
+    c.chunk_size = budget.reserve_items(SPARSE_MATRIX_FOOTPRINT * (c.threads + 1));
+  }
+
   // in spdlog, high numbers correspond to low log levels
   assert(c.verbosity > 0 && c.verbosity < 5);
   c.verbosity = static_cast<std::uint8_t>(spdlog::level::critical) - c.verbosity;
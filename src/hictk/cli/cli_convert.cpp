@@ -27,6 +27,7 @@
 #include "hictk/hic/validation.hpp"
 #include "hictk/tools/cli.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/memory_budget.hpp"
 
 namespace hictk::tools {
 
@@ -96,6 +97,12 @@ void Cli::make_convert_subcommand() {
       "Batch size to use when converting .[m]cool to .hic.")
       ->check(CLI::PositiveNumber)
       ->capture_default_str();
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
   sc.add_option(
       "-v,--verbosity",
       c.verbosity,
@@ -106,7 +113,8 @@ void Cli::make_convert_subcommand() {
       "-t,--threads",
       c.threads,
       "Maximum number of parallel threads to spawn.\n"
-      "When converting from hic to cool, only two threads will be used.")
+      "When converting from hic to cool, one thread is used to write interactions, while\n"
+      "the remaining threads are used to read and decode interactions from the .hic file.")
       ->check(CLI::Range(std::uint32_t(2), std::thread::hardware_concurrency()))
       ->capture_default_str();
   sc.add_option(
@@ -129,6 +137,8 @@ void Cli::make_convert_subcommand() {
       ->capture_default_str();
   // clang-format on
 
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
+
   _config = std::monostate{};
 }
 
@@ -244,6 +254,15 @@ void Cli::transform_args_convert_subcommand() {
     }
   }
 
+  if (c.max_memory != 0 && c.output_format == "hic") {
+    MemoryBudget budget{c.max_memory};
+    // pixels are added with HiCFileWriter::add_sorted_pixels(), which hands the blocks that do not
+    // fit in memory over to the block mapper of the resolution being processed
+    budget.reserve(hic_file_writer_fixed_footprint(c.threads));
+    c.chunk_size = budget.reserve_items(hic_file_writer_pixel_footprint(c.resolutions.size()) +
+                                        HIC_SORTED_PIXELS_FOOTPRINT);
+  }
+
   // in spdlog, high numbers correspond to low log levels
   assert(c.verbosity > 0 && c.verbosity < 5);
   c.verbosity = static_cast<std::uint8_t>(spdlog::level::critical) - c.verbosity;
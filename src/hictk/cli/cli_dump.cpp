@@ -4,14 +4,17 @@
 
 #include <fmt/format.h>
 #include <fmt/ranges.h>
+#include <fmt/std.h>
 #include <spdlog/spdlog.h>
 
 #include <CLI/CLI.hpp>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <variant>
 #include <vector>
 
@@ -23,12 +26,14 @@
 namespace hictk::tools {
 
 void Cli::make_dump_subcommand() {
-  auto& sc = *_cli.add_subcommand("dump", "Dump data from .hic and Cooler files to stdout.")
-                  ->fallthrough()
-                  ->preparse_callback([this]([[maybe_unused]] std::size_t i) {
-                    assert(_config.index() == 0);
-                    _config = DumpConfig{};
-                  });
+  auto& sc =
+      *_cli.add_subcommand("dump",
+                           "Dump data from .hic and Cooler files to stdout or to a file.")
+           ->fallthrough()
+           ->preparse_callback([this]([[maybe_unused]] std::size_t i) {
+             assert(_config.index() == 0);
+             _config = DumpConfig{};
+           });
 
   _config = DumpConfig{};
   auto& c = std::get<DumpConfig>(_config);
@@ -118,6 +123,38 @@ void Cli::make_dump_subcommand() {
       c.join,
       "Output pixels in BG2 format.")
       ->capture_default_str();
+
+  sc.add_option(
+      "-o,--output",
+      c.output_path,
+      "Path where to write the output. When not provided, output is written to stdout.");
+
+  sc.add_option(
+      "--output-format",
+      c.output_format,
+      "Format used to write pixels.\n"
+      "- tsv: tab-separated text.\n"
+      "- binary: sequence of records with layout bin1_id (uint64), bin2_id (uint64),\n"
+      "  count (float64).\n"
+      "- npy: same as binary, stored as a NumPy structured array (requires --output).")
+      ->check(CLI::IsMember({"tsv", "binary", "npy"}))
+      ->capture_default_str();
+
+  sc.add_flag(
+      "-f,--force",
+      c.force,
+      "Overwrite existing files (if any).")
+      ->capture_default_str();
+
+  sc.add_option(
+      "--threads",
+      c.threads,
+      "Maximum number of parallel threads to spawn.\n"
+      "Threads are used to format pixels in parallel when --output-format=tsv and to read\n"
+      "genome-wide interactions from .hic files.\n"
+      "When both apply, threads are split evenly between the two tasks.")
+      ->check(CLI::Range(std::uint32_t(1), std::thread::hardware_concurrency()))
+      ->capture_default_str();
   // clang-format on
 
   sc.get_option("--range2")->needs(sc.get_option("--range"));
@@ -204,6 +241,27 @@ void Cli::validate_dump_subcommand() const {
     errors.emplace_back("--balance requires --table=pixels.");
   }
 
+  if (c.output_format != "tsv") {
+    if (c.table != "pixels") {
+      errors.emplace_back(
+          fmt::format(FMT_STRING("--output-format={} requires --table=pixels."), c.output_format));
+    }
+    if (c.join) {
+      errors.emplace_back(
+          fmt::format(FMT_STRING("--output-format={} is not compatible with --join."),
+                      c.output_format));
+    }
+  }
+
+  if (c.output_format == "npy" && c.output_path.empty()) {
+    errors.emplace_back("--output-format=npy requires --output.");
+  }
+
+  if (!c.output_path.empty() && !c.force && std::filesystem::exists(c.output_path)) {
+    errors.emplace_back(fmt::format(
+        FMT_STRING("Refusing to overwrite file {}. Pass --force to overwrite."), c.output_path));
+  }
+
   for (const auto& w : warnings) {
     SPDLOG_WARN(FMT_STRING("{}"), w);
   }
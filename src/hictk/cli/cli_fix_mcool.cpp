@@ -19,6 +19,7 @@
 
 #include "hictk/tools/cli.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/memory_budget.hpp"
 
 namespace hictk::tools {
 
@@ -71,6 +72,12 @@ void Cli::make_fix_mcool_subcommand() {
       "Ignored when using --in-memory.")
       ->check(CLI::PositiveNumber)
       ->capture_default_str();
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
   sc.add_option(
       "-v,--verbosity",
       c.verbosity,
@@ -96,6 +103,8 @@ void Cli::make_fix_mcool_subcommand() {
       ->capture_default_str();
   // clang-format on
 
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
+
   _config = std::monostate{};
 }
 
@@ -124,6 +133,9 @@ void Cli::validate_fix_mcool_subcommand() const {
     if (!sc->get_option("--chunk-size")->empty()) {
       warnings.emplace_back("option --chunk-size is ignored when --skip-balancing is provided.");
     }
+    if (!sc->get_option("--max-memory")->empty()) {
+      warnings.emplace_back("option --max-memory is ignored when --skip-balancing is provided.");
+    }
     if (!sc->get_option("--threads")->empty()) {
       warnings.emplace_back("option --threads is ignored when --skip-balancing is provided.");
     }
@@ -144,6 +156,12 @@ void Cli::validate_fix_mcool_subcommand() const {
 void Cli::transform_args_fix_mcool_subcommand() {
   auto& c = std::get<FixMcoolConfig>(_config);
 
+  if (c.max_memory != 0) {
+    // worker threads process their own chunk of interactions
+    MemoryBudget budget{c.max_memory};
+    c.chunk_size = budget.reserve_items(SPARSE_MATRIX_FOOTPRINT * (c.threads + 1));
+  }
+
   // in spdlog, high numbers correspond to low log levels
   assert(c.verbosity > 0 && c.verbosity < 5);
   c.verbosity = static_cast<std::uint8_t>(spdlog::level::critical) - c.verbosity;
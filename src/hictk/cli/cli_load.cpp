@@ -18,6 +18,7 @@
 
 #include "hictk/tools/cli.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/memory_budget.hpp"
 
 namespace hictk::tools {
 
@@ -112,6 +113,13 @@ void Cli::make_load_subcommand() {
       "Number of pixels to buffer in memory.")
       ->capture_default_str();
 
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
+
   sc.add_option(
       "-l,--compression-lvl",
       c.compression_lvl,
@@ -144,6 +152,7 @@ void Cli::make_load_subcommand() {
   // clang-format on
 
   sc.get_option("--bin-size")->excludes(sc.get_option("--bin-table"));
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
   _config = std::monostate{};
 }
 
@@ -211,6 +220,18 @@ void Cli::transform_args_load_subcommand() {
     c.compression_lvl = c.output_format == "hic" ? 10 : 6;
   }
 
+  if (c.max_memory != 0) {
+    MemoryBudget budget{c.max_memory};
+    if (c.output_format == "hic") {
+      // pixels are buffered before being handed over to the HiCFileWriter
+      budget.reserve(hic_file_writer_fixed_footprint(c.threads));
+      c.batch_size =
+          budget.reserve_items(PIXEL_BUFFER_FOOTPRINT + hic_file_writer_pixel_footprint(1));
+    } else {
+      c.batch_size = budget.reserve_items(PIXEL_BUFFER_FOOTPRINT);
+    }
+  }
+
   // in spdlog, high numbers correspond to low log levels
   assert(c.verbosity > 0 && c.verbosity < 5);
   c.verbosity = static_cast<std::uint8_t>(spdlog::level::critical) - c.verbosity;
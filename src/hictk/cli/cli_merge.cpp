@@ -19,6 +19,7 @@
 
 #include "hictk/tools/cli.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/memory_budget.hpp"
 
 namespace hictk::tools {
 
@@ -67,6 +68,13 @@ void Cli::make_merge_subcommand() {
       "Number of pixels to store in memory before writing to disk.")
       ->capture_default_str();
 
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
+
   sc.add_option(
       "-l,--compression-lvl",
       c.compression_lvl,
@@ -78,7 +86,7 @@ void Cli::make_merge_subcommand() {
       "-t,--threads",
       c.threads,
       "Maximum number of parallel threads to spawn.\n"
-      "When merging interactions in Cooler format, only a single thread will be used.")
+      "Interactions are merged in parallel by splitting the matrix into ranges of rows.")
       ->check(CLI::Range(std::uint32_t(1), std::thread::hardware_concurrency()))
       ->capture_default_str();
 
@@ -105,6 +113,8 @@ void Cli::make_merge_subcommand() {
 
   // clang-format on
 
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
+
   _config = std::monostate{};
 }
 
@@ -192,6 +202,16 @@ void Cli::transform_args_merge_subcommand() {
     c.compression_lvl = c.output_format == "hic" ? 10 : 6;
   }
 
+  if (c.max_memory != 0) {
+    MemoryBudget budget{c.max_memory};
+    if (c.output_format == "hic") {
+      budget.reserve(hic_file_writer_fixed_footprint(c.threads));
+      c.chunk_size = budget.reserve_items(hic_file_writer_pixel_footprint(1));
+    } else {
+      c.chunk_size = budget.reserve_items(PIXEL_BUFFER_FOOTPRINT);
+    }
+  }
+
   // in spdlog, high numbers correspond to low log levels
   assert(c.verbosity > 0 && c.verbosity < 5);
   c.verbosity = static_cast<std::uint8_t>(spdlog::level::critical) - c.verbosity;
@@ -19,6 +19,7 @@
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/tools/cli.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/memory_budget.hpp"
 
 namespace hictk::tools {
 
@@ -96,9 +97,16 @@ void Cli::make_zoomify_subcommand() {
       "--chunk-size",
       c.batch_size,
       "Number of pixels to buffer in memory.\n"
-      "Only used when zoomifying .hic files.")
+      "When zoomifying .cool files, the buffer is shared by all resolutions.")
       ->capture_default_str();
 
+  sc.add_option(
+      "--max-memory",
+      c.max_memory,
+      "Approximate amount of memory used to buffer interactions (e.g. 512MiB or 4GB).\n"
+      "When provided, the chunk size is computed based on the given budget.")
+      ->transform(CLI::AsSizeValue(false));
+
   sc.add_flag(
       "--skip-all-vs-all,!--no-skip-all-vs-all",
       c.skip_all_vs_all_matrix,
@@ -122,6 +130,8 @@ void Cli::make_zoomify_subcommand() {
 
   // clang-format on
 
+  sc.get_option("--max-memory")->excludes(sc.get_option("--chunk-size"));
+
   _config = std::monostate{};
 }
 
@@ -297,6 +307,16 @@ void Cli::transform_args_zoomify_subcommand() {
   if (sc.get_option("--compression-lvl")->empty()) {
     c.compression_lvl = c.output_format == "hic" ? 10 : 6;
   }
+
+  if (c.max_memory != 0) {
+    MemoryBudget budget{c.max_memory};
+    if (c.output_format == "hic") {
+      budget.reserve(hic_file_writer_fixed_footprint(c.threads));
+      c.batch_size = budget.reserve_items(hic_file_writer_pixel_footprint(c.resolutions.size()));
+    } else {
+      c.batch_size = budget.reserve_items(PIXEL_BUFFER_FOOTPRINT);
+    }
+  }
 }
 
 }  // namespace hictk::tools
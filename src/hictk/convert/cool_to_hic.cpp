@@ -20,10 +20,12 @@
 
 namespace hictk::tools {
 
+// Pixels in Cooler files are always sorted by (bin1_id, bin2_id), so interaction blocks can be
+// written as soon as they are complete
 static void copy_pixels(hic::internal::HiCFileWriter& w, const cooler::File& base_clr,
                         const ConvertConfig& c) {
   if (c.input_format == "cool") {
-    w.add_pixels(base_clr.resolution(), base_clr.begin<float>(), base_clr.end<float>());
+    w.add_sorted_pixels(base_clr.resolution(), base_clr.begin<float>(), base_clr.end<float>());
     return;
   }
 
@@ -33,7 +35,7 @@ static void copy_pixels(hic::internal::HiCFileWriter& w, const cooler::File& bas
   for (const auto& res : c.resolutions) {
     try {
       const auto clr = mclr.open(res);
-      w.add_pixels(res, clr.begin<float>(), clr.end<float>());
+      w.add_sorted_pixels(res, clr.begin<float>(), clr.end<float>());
     } catch (const std::exception& e) {
       const std::string_view msg{e.what()};
       const auto pos = msg.find("does not have interactions for resolution");
@@ -81,7 +83,6 @@ static void copy_normalization_vectors(hic::internal::HiCFileWriter& w,
     for (const auto& norm : c.normalization_methods) {
       copy_normalization_vector(w, base_clr, norm, c.fail_if_normalization_method_is_not_avaliable);
     }
-    w.write_norm_vectors_and_norm_expected_values();
     return;
   }
 
@@ -94,7 +95,6 @@ static void copy_normalization_vectors(hic::internal::HiCFileWriter& w,
       copy_normalization_vector(w, clr, norm, c.fail_if_normalization_method_is_not_avaliable);
     }
   }
-  w.write_norm_vectors_and_norm_expected_values();
 }
 
 void cool_to_hic(const ConvertConfig& c) {
@@ -120,9 +120,10 @@ void cool_to_hic(const ConvertConfig& c) {
   hictk::hic::internal::HiCFileWriter w(c.path_to_output.string(), chromosomes, resolutions,
                                         c.genome, c.threads, c.chunk_size, c.tmp_dir,
                                         c.compression_lvl, c.skip_all_vs_all_matrix);
+  // Normalization vectors are added before interactions, so that normalized expected values can
+  // be computed while interaction blocks are being written
+  copy_normalization_vectors(w, base_clr, c);
   copy_pixels(w, base_clr, c);
   w.serialize();
-
-  copy_normalization_vectors(w, base_clr, c);
 }
 }  // namespace hictk::tools
@@ -139,9 +139,8 @@ static Reference generate_reference(const std::filesystem::path& p, std::uint32_
   return {names.begin(), names.end(), sizes.begin()};
 }
 
-[[nodiscard]] static hic::PixelSelectorAll fetch_interactions_for_chromosome(
-    hic::File& hf, const Chromosome& chrom1) {
-  std::vector<hic::PixelSelector> selectors{};
+static void fetch_interactions_for_chromosome(hic::File& hf, const Chromosome& chrom1,
+                                              std::vector<hic::PixelSelector>& selectors) {
   for (std::uint32_t chrom2_id = chrom1.id(); chrom2_id < hf.chromosomes().size(); ++chrom2_id) {
     const auto& chrom2 = hf.chromosomes().at(chrom2_id);
     if (chrom2.is_all()) {
@@ -161,18 +160,68 @@ static Reference generate_reference(const std::filesystem::path& p, std::uint32_
       }
     }
   }
+}
 
-  return hic::PixelSelectorAll{std::move(selectors)};
+template <typename N, typename PixelIt>
+[[nodiscard]] static bool enqueue_pixels(const hic::File& hf, PixelIt first, PixelIt last,
+                                         moodycamel::BlockingReaderWriterQueue<ThinPixel<N>>& queue,
+                                         std::atomic<bool>& early_return, std::size_t& i,
+                                         std::chrono::steady_clock::time_point& t0,
+                                         std::size_t update_frequency) {
+  for (; first != last && !early_return; ++i) {
+    while (!queue.try_enqueue(*first)) {
+      if (early_return) {
+        return false;
+      }
+    }
+    ++first;
+
+    if (i == update_frequency) {
+      const auto t1 = std::chrono::steady_clock::now();
+      const auto delta =
+          static_cast<double>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()) /
+          1000.0;
+      const auto bin1 = hf.bins().at(first->bin1_id);
+      SPDLOG_INFO(
+          FMT_STRING("[{}] processing {:ucsc} at {:.0f} pixels/s (cache hit rate {:.2f}%)..."),
+          hf.resolution(), bin1, double(update_frequency) / delta,
+          hf.block_cache_hit_rate() * 100);
+      hf.reset_cache_stats();
+      t0 = t1;
+      i = 0;
+    }
+  }
+  return !early_return;
 }
 
 template <typename N>
 static void enqueue_pixels(hic::File& hf,
                            moodycamel::BlockingReaderWriterQueue<ThinPixel<N>>& queue,
-                           std::atomic<bool>& early_return,
+                           std::atomic<bool>& early_return, std::size_t num_threads,
                            std::size_t update_frequency = 10'000'000) {
   try {
     std::size_t i = 0;
     auto t0 = std::chrono::steady_clock::now();
+    std::vector<hic::PixelSelector> selectors{};
+
+    if (num_threads > 1) {
+      // Fetch all chromosome pairs up front, so that the worker threads and their file handles
+      // and block caches are set up once instead of once per chromosome
+      for (const auto& chrom1 : hf.chromosomes()) {
+        if (!chrom1.is_all()) {
+          fetch_interactions_for_chromosome(hf, chrom1, selectors);
+        }
+      }
+      const hic::PixelSelectorAll sel{std::move(selectors), num_threads};
+      if (!enqueue_pixels<N>(hf, sel.begin<N>(), sel.end<N>(), queue, early_return, i, t0,
+                             update_frequency)) {
+        return;
+      }
+      queue.enqueue(ThinPixel<N>{});
+      return;
+    }
+
     for (std::uint32_t chrom1_id = 0; chrom1_id < hf.chromosomes().size(); ++chrom1_id) {
       hf.purge_footer_cache();
       hf.clear_cache();
@@ -182,33 +231,12 @@ static void enqueue_pixels(hic::File& hf,
         continue;
       }
 
-      const auto sel = fetch_interactions_for_chromosome(hf, chrom1);
-      auto first = sel.begin<N>();
-      auto last = sel.end<N>();
-
-      for (; first != last && !early_return; ++i) {
-        while (!queue.try_enqueue(*first)) {
-          if (early_return) {
-            return;
-          }
-        }
-        ++first;
-
-        if (i == update_frequency) {
-          const auto t1 = std::chrono::steady_clock::now();
-          const auto delta =
-              static_cast<double>(
-                  std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()) /
-              1000.0;
-          const auto bin1 = hf.bins().at(first->bin1_id);
-          SPDLOG_INFO(
-              FMT_STRING("[{}] processing {:ucsc} at {:.0f} pixels/s (cache hit rate {:.2f}%)..."),
-              hf.resolution(), bin1, double(update_frequency) / delta,
-              hf.block_cache_hit_rate() * 100);
-          hf.reset_cache_stats();
-          t0 = t1;
-          i = 0;
-        }
+      selectors.clear();
+      fetch_interactions_for_chromosome(hf, chrom1, selectors);
+      const hic::PixelSelectorAll sel{std::move(selectors), num_threads};
+      if (!enqueue_pixels<N>(hf, sel.begin<N>(), sel.end<N>(), queue, early_return, i, t0,
+                             update_frequency)) {
+        return;
       }
     }
     queue.enqueue(ThinPixel<N>{});
@@ -263,7 +291,7 @@ static std::size_t append_pixels(cooler::File& clr,
 template <typename N>  // NOLINTNEXTLINE(*-rvalue-reference-param-not-moved)
 static void convert_resolution_multi_threaded(hic::File& hf, cooler::File&& clr,
                                               std::vector<balancing::Method> normalization_methods,
-                                              bool fail_if_norm_not_found) {
+                                              bool fail_if_norm_not_found, std::size_t threads) {
   const auto t0 = std::chrono::steady_clock::now();
 
   if (normalization_methods.empty()) {
@@ -275,7 +303,11 @@ static void convert_resolution_multi_threaded(hic::File& hf, cooler::File&& clr,
   std::atomic<bool> early_return = false;
   moodycamel::BlockingReaderWriterQueue<ThinPixel<N>> queue{1'000'000};
 
-  auto producer_fx = [&]() { return enqueue_pixels<N>(hf, queue, early_return); };
+  // One thread is reserved to the consumer, the remaining threads are used to read and decode
+  // interactions
+  assert(threads >= 2);
+  const auto reader_threads = threads - 1;
+  auto producer_fx = [&]() { return enqueue_pixels<N>(hf, queue, early_return, reader_threads); };
   auto producer = std::async(std::launch::async, producer_fx);
 
   auto consumer_fx = [&]() { return append_pixels<N>(clr, queue, early_return); };
@@ -324,7 +356,7 @@ void hic_to_cool(const ConvertConfig& c) {
         hf,
         init_cooler(c.path_to_output.string(), c.resolutions.front(), c.genome, chroms,
                     c.compression_lvl),
-        c.normalization_methods, c.fail_if_normalization_method_is_not_avaliable);
+        c.normalization_methods, c.fail_if_normalization_method_is_not_avaliable, c.threads);
     return;
   }
 
@@ -336,7 +368,7 @@ void hic_to_cool(const ConvertConfig& c) {
     attrs.assembly = c.genome.empty() ? "unknown" : std::string{c.genome};
     convert_resolution_multi_threaded<std::int32_t>(
         hf, init_cooler(mclr.init_resolution(res), res, c.genome, chroms, c.compression_lvl),
-        c.normalization_methods, c.fail_if_normalization_method_is_not_avaliable);
+        c.normalization_methods, c.fail_if_normalization_method_is_not_avaliable, c.threads);
     hf.clear_cache();
   });
 }
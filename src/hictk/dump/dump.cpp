@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
@@ -34,73 +35,86 @@
 #include "hictk/pixel.hpp"
 #include "hictk/reference.hpp"
 #include "hictk/tools/config.hpp"
+#include "hictk/tools/thread_budget.hpp"
 #include "hictk/transformers/join_genomic_coords.hpp"
 
 namespace hictk::tools {
 
 template <typename PixelIt>
-static void dump_pixels(PixelIt first_pixel, PixelIt last_pixel,
-                        const std::shared_ptr<const BinTable>& bins, bool join) {
+static void dump_pixels(DumpWriter& writer, PixelIt first_pixel, PixelIt last_pixel,
+                        const std::shared_ptr<const BinTable>& bins, bool join,
+                        std::size_t threads) {
+  if (threads > 1 && !writer.is_binary()) {
+    print_pixels_parallel(writer, first_pixel, last_pixel, join ? bins : nullptr, threads);
+    return;
+  }
+
   if (!join) {
-    print_pixels(first_pixel, last_pixel);
+    print_pixels(writer, first_pixel, last_pixel);
     return;
   }
   auto jsel = transformers::JoinGenomicCoords(first_pixel, last_pixel, bins);
-  print_pixels(jsel.begin(), jsel.end());
+  print_pixels(writer, jsel.begin(), jsel.end());
 }
 
-static void dump_pixels_gw(File& f, std::string_view normalization, bool join, bool sorted) {
+static void dump_pixels_gw(DumpWriter& writer, File& f, std::string_view normalization, bool join,
+                           bool sorted, std::size_t threads) {
   if (f.is_hic()) {
     f.get<hic::File>().optimize_cache_size_for_iteration();
   }
 
   if (f.is_hic()) {
+    // decoding and formatting run concurrently: split threads between the two stages
+    const auto stage_threads = split_dump_threads(threads, !writer.is_binary());
     const auto& ff = f.get<hic::File>();
-    const auto sel = ff.fetch(balancing::Method{normalization});
-    dump_pixels(sel.template begin<double>(sorted), sel.template end<double>(), ff.bins_ptr(),
-                join);
+    const auto sel = ff.fetch(balancing::Method{normalization}, stage_threads.fetch);
+    dump_pixels(writer, sel.template begin<double>(sorted), sel.template end<double>(),
+                ff.bins_ptr(), join, stage_threads.format);
     return;
   }
 
   const auto& ff = f.get<cooler::File>();
   const auto sel = ff.fetch(balancing::Method{normalization});
-  dump_pixels(sel.template begin<double>(), sel.template end<double>(), ff.bins_ptr(), join);
+  dump_pixels(writer, sel.template begin<double>(), sel.template end<double>(), ff.bins_ptr(),
+              join, threads);
 }
 
-static void dump_pixels_chrom_chrom(File& f, std::string_view range1, std::string_view range2,
-                                    std::string_view normalization, bool join, bool sorted) {
+static void dump_pixels_chrom_chrom(DumpWriter& writer, File& f, std::string_view range1,
+                                    std::string_view range2, std::string_view normalization,
+                                    bool join, bool sorted, std::size_t threads) {
   if (f.is_hic()) {
     const auto& ff = f.get<hic::File>();
     const auto sel = ff.fetch(range1, range2, balancing::Method{normalization});
-    dump_pixels(sel.template begin<double>(sorted), sel.template end<double>(), ff.bins_ptr(),
-                join);
+    dump_pixels(writer, sel.template begin<double>(sorted), sel.template end<double>(),
+                ff.bins_ptr(), join, threads);
     return;
   }
 
   const auto& ff = f.get<cooler::File>();
   const auto sel = ff.fetch(range1, range2, balancing::Method{normalization});
-  dump_pixels(sel.template begin<double>(), sel.template end<double>(), ff.bins_ptr(), join);
+  dump_pixels(writer, sel.template begin<double>(), sel.template end<double>(), ff.bins_ptr(),
+              join, threads);
 }
 
-static void dump_pixels(File& f, std::string_view range1, std::string_view range2,
-                        std::string_view normalization, bool join, bool sorted) {
-  auto norm = balancing::Method{std::string{normalization}};
+static void dump_pixels(DumpWriter& writer, File& f, std::string_view range1,
+                        std::string_view range2, std::string_view normalization, bool join,
+                        bool sorted, std::size_t threads) {
   if (range1 == "all") {
     assert(range2 == "all");
-    dump_pixels_gw(f, normalization, join, sorted);
+    dump_pixels_gw(writer, f, normalization, join, sorted, threads);
     return;
   }
 
-  dump_pixels_chrom_chrom(f, range1, range2, normalization, join, sorted);
+  dump_pixels_chrom_chrom(writer, f, range1, range2, normalization, join, sorted, threads);
 }
 
-static void process_query_cis_only(File& f, std::string_view normalization, bool join,
-                                   bool sorted) {
+static void process_query_cis_only(DumpWriter& writer, File& f, std::string_view normalization,
+                                   bool join, bool sorted, std::size_t threads) {
   for (const auto& chrom : f.chromosomes()) {
     if (chrom.is_all()) {
       continue;
     }
-    dump_pixels(f, chrom.name(), chrom.name(), normalization, join, sorted);
+    dump_pixels(writer, f, chrom.name(), chrom.name(), normalization, join, sorted, threads);
   }
 }
 
@@ -145,24 +159,20 @@ static transformers::PixelMerger<PixelIt> init_pixel_merger(const File& f,
   return {std::move(heads), std::move(tails)};
 }
 
-static void dump_pixels_trans_only_sorted(File& f, std::string_view normalization, bool join) {
-  auto norm = balancing::Method{std::string{normalization}};
-
+static void dump_pixels_trans_only_sorted(DumpWriter& writer, File& f,
+                                          std::string_view normalization, bool join,
+                                          std::size_t threads) {
   std::visit(
       [&](const auto& ff) {
         const auto merger = init_pixel_merger(ff, normalization);
-
-        if (!join) {
-          print_pixels(merger.begin(), merger.end());
-        }
-
-        auto jsel = transformers::JoinGenomicCoords(merger.begin(), merger.end(), f.bins_ptr());
-        print_pixels(jsel.begin(), jsel.end());
+        dump_pixels(writer, merger.begin(), merger.end(), f.bins_ptr(), join, threads);
       },
       f.get());
 }
 
-static void dump_pixels_trans_only_unsorted(File& f, std::string_view normalization, bool join) {
+static void dump_pixels_trans_only_unsorted(DumpWriter& writer, File& f,
+                                            std::string_view normalization, bool join,
+                                            std::size_t threads) {
   const auto& chromosomes = f.chromosomes();
   for (std::uint32_t chrom1_id = 0; chrom1_id < chromosomes.size(); ++chrom1_id) {
     const auto& chrom1 = chromosomes[chrom1_id];
@@ -175,54 +185,56 @@ static void dump_pixels_trans_only_unsorted(File& f, std::string_view normalizat
         continue;
       }
 
-      dump_pixels(f, chrom1.name(), chrom2.name(), normalization, join, false);
+      dump_pixels(writer, f, chrom1.name(), chrom2.name(), normalization, join, false, threads);
     }
   }
 }
 
-static void process_query(File& f, std::string_view table, std::string_view range1,
-                          std::string_view range2, std::string_view normalization, bool join,
-                          bool sorted) {
+static void process_query(DumpWriter& writer, File& f, std::string_view table,
+                          std::string_view range1, std::string_view range2,
+                          std::string_view normalization, bool join, bool sorted,
+                          std::size_t threads) {
   if (table == "bins") {
-    dump_bins(f, range1);
+    dump_bins(writer, f, range1);
     return;
   }
 
   if (table == "weights") {
-    dump_weights(f, range1);
+    dump_weights(writer, f, range1);
     return;
   }
 
   assert(table == "pixels");
-  dump_pixels(f, range1, range2, normalization, join, sorted);
+  dump_pixels(writer, f, range1, range2, normalization, join, sorted, threads);
 }
 
-static void process_query_trans_only(File& f, std::string_view normalization, bool join,
-                                     bool sorted) {
+static void process_query_trans_only(DumpWriter& writer, File& f, std::string_view normalization,
+                                     bool join, bool sorted, std::size_t threads) {
   if (sorted) {
-    dump_pixels_trans_only_sorted(f, normalization, join);
+    dump_pixels_trans_only_sorted(writer, f, normalization, join, threads);
     return;
   }
-  dump_pixels_trans_only_unsorted(f, normalization, join);
+  dump_pixels_trans_only_unsorted(writer, f, normalization, join, threads);
 }
 
-static void dump_tables(const DumpConfig& c) {
+static void dump_tables(DumpWriter& writer, const DumpConfig& c) {
   hictk::File f{c.uri, c.resolution, c.matrix_type, c.matrix_unit};
 
   if (c.query_file.empty() && !c.cis_only && !c.trans_only) {
-    process_query(f, c.table, c.range1, c.range2, c.normalization, c.join, c.sorted);
+    process_query(writer, f, c.table, c.range1, c.range2, c.normalization, c.join, c.sorted,
+                  c.threads);
     return;
   }
 
   if (c.cis_only) {
     assert(c.table == "pixels");
-    process_query_cis_only(f, c.normalization, c.join, c.sorted);
+    process_query_cis_only(writer, f, c.normalization, c.join, c.sorted, c.threads);
     return;
   }
 
   if (c.trans_only) {
     assert(c.table == "pixels");
-    process_query_trans_only(f, c.normalization, c.join, c.sorted);
+    process_query_trans_only(writer, f, c.normalization, c.join, c.sorted, c.threads);
     return;
   }
 
@@ -238,34 +250,40 @@ static void dump_tables(const DumpConfig& c) {
   std::string line;
   while (std::getline(read_from_stdin ? std::cin : ifs, line)) {
     const auto [range1, range2] = parse_bedpe(line);
-    process_query(f, c.table, range1, range2, c.normalization, c.join, c.sorted);
+    process_query(writer, f, c.table, range1, range2, c.normalization, c.join, c.sorted,
+                  c.threads);
   }
 }
 
-int dump_subcmd(const DumpConfig& c) {
+static void dump(DumpWriter& writer, const DumpConfig& c) {
   if (c.table == "bins" || c.table == "pixels" || c.table == "weights") {
-    dump_tables(c);
-    return 0;
+    dump_tables(writer, c);
+    return;
   }
 
   if (c.table == "chroms") {
-    dump_chroms(c.uri, c.format, c.resolution);
-    return 0;
+    dump_chroms(writer, c.uri, c.format, c.resolution);
+    return;
   }
 
   if (c.table == "resolutions") {
-    dump_resolutions(c.uri, c.format, c.resolution);
-    return 0;
+    dump_resolutions(writer, c.uri, c.format, c.resolution);
+    return;
   }
 
   if (c.table == "normalizations") {
-    dump_normalizations(c.uri, c.format, c.resolution);
-    return 0;
+    dump_normalizations(writer, c.uri, c.format, c.resolution);
+    return;
   }
 
   assert(c.table == "cells");
+  dump_cells(writer, c.uri, c.format);
+}
 
-  dump_cells(c.uri, c.format);
+int dump_subcmd(const DumpConfig& c) {
+  DumpWriter writer(c.output_path, DumpWriter::parse_format(c.output_format));
+  dump(writer, c);
+  writer.finalize();
   return 0;
 }
 }  // namespace hictk::tools
@@ -4,32 +4,206 @@
 
 #pragma once
 
+#include <fmt/format.h>
+
+#include <BS_thread_pool.hpp>
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
+#include "hictk/bin_table.hpp"
+#include "hictk/common.hpp"
 #include "hictk/file.hpp"
 #include "hictk/pixel.hpp"
 
 namespace hictk::tools {
 
-void print(const Pixel<double>& pixel);
-void print(const ThinPixel<double>& pixel);
+// Class used to write the output of hictk dump to stdout or to a file.
+// Records are formatted (or copied, in case of binary formats) into a large memory buffer that is
+// flushed in chunks, so that the output is written using few, large write calls.
+//
+// Supported formats:
+// - tsv: plain text
+// - binary: sequence of 24 bytes records with the following layout:
+//     bin1_id (uint64) | bin2_id (uint64) | count (float64)
+//   Values are encoded in the native byte order (i.e. little-endian on all supported platforms)
+// - npy: same as binary, with a header describing the records as a NumPy structured array.
+//   The header is updated with the final number of records when the writer is finalized, so this
+//   format requires the output to be a regular file.
+//   Output can be read with np.load("pixels.npy")
+class DumpWriter {
+ public:
+  enum class Format : std::uint_fast8_t { tsv, binary, npy };
+
+ private:
+  std::FILE* _fp{};
+  std::filesystem::path _path{};
+  Format _format{Format::tsv};
+  fmt::memory_buffer _buffer{};
+  std::size_t _buffer_capacity{};
+  std::uint64_t _num_records{};
+  bool _finalized{false};
+
+ public:
+  static constexpr std::size_t DEFAULT_BUFFER_CAPACITY{4ULL << 20U};  // 4 MiB
+
+  // Write to stdout when path is empty. Existing files are overwritten
+  explicit DumpWriter(const std::filesystem::path& path = {}, Format format = Format::tsv,
+                      std::size_t buffer_capacity = DEFAULT_BUFFER_CAPACITY);
+  DumpWriter(const DumpWriter& other) = delete;
+  DumpWriter(DumpWriter&& other) noexcept = delete;
+  ~DumpWriter() noexcept;
+
+  DumpWriter& operator=(const DumpWriter& other) = delete;
+  DumpWriter& operator=(DumpWriter&& other) noexcept = delete;
+
+  [[nodiscard]] static Format parse_format(std::string_view format);
+  [[nodiscard]] constexpr Format format() const noexcept { return _format; }
+  [[nodiscard]] constexpr bool is_binary() const noexcept { return _format != Format::tsv; }
+
+  // Format a record using fmt and append it to the output. Only supported by text formats
+  template <typename S, typename... Args>
+  void print(const S& format_str, Args&&... args);
+
+  void write(const ThinPixel<double>& pixel);
+  // Pixels with genomic coordinates can only be written using text formats
+  void write(const Pixel<double>& pixel);
+  // Append a chunk of pre-formatted text (see format_pixel()). Only supported by text formats
+  void write(const fmt::memory_buffer& buffer);
+
+  // Append the text representation of the given pixel to buffer, using the same formatting as
+  // write(). Useful to format pixels from multiple threads
+  static void format_pixel(fmt::memory_buffer& buffer, const ThinPixel<double>& pixel);
+  static void format_pixel(fmt::memory_buffer& buffer, const Pixel<double>& pixel);
+
+  void flush();
+  // Flush buffered data and update the file header (when applicable).
+  // Must be called once all records have been written
+  void finalize();
+
+ private:
+  void flush_if_full();
+  void write_to_file(const char* data, std::size_t size);
+  void write_npy_header();
+  [[nodiscard]] static std::string generate_npy_header(std::uint64_t num_records);
+};
 
-void dump_bins(const File& f, std::string_view range);
-void dump_cells(std::string_view uri, std::string_view format);
-void dump_chroms(std::string_view uri, std::string_view format, std::uint32_t resolution);
-void dump_normalizations(std::string_view uri, std::string_view format, std::uint32_t resolution);
-void dump_resolutions(std::string_view uri, std::string_view format, std::uint32_t resolution);
-void dump_weights(const File& f, std::string_view range);
+void dump_bins(DumpWriter& writer, const File& f, std::string_view range);
+void dump_cells(DumpWriter& writer, std::string_view uri, std::string_view format);
+void dump_chroms(DumpWriter& writer, std::string_view uri, std::string_view format,
+                 std::uint32_t resolution);
+void dump_normalizations(DumpWriter& writer, std::string_view uri, std::string_view format,
+                         std::uint32_t resolution);
+void dump_resolutions(DumpWriter& writer, std::string_view uri, std::string_view format,
+                      std::uint32_t resolution);
+void dump_weights(DumpWriter& writer, const File& f, std::string_view range);
 
 [[nodiscard]] std::pair<std::string, std::string> parse_bedpe(std::string_view line);
 
 template <typename PixelIt>
-inline void print_pixels(PixelIt first, PixelIt last) {
-  std::for_each(first, last, [&](const auto& pixel) { print(pixel); });
+inline void print_pixels(DumpWriter& writer, PixelIt first, PixelIt last) {
+  std::for_each(first, last, [&](const auto& pixel) { writer.write(pixel); });
+}
+
+// Print pixels using a pipeline where:
+// - the calling thread decodes pixels and groups them in batches of batch_size pixels
+// - threads - 1 worker threads format batches into text buffers in parallel (joining genomic
+//   coordinates when bins is not null), so that at most threads threads run at the same time
+// - buffers are handed back to the calling thread, which writes them in the same order as they
+//   were submitted
+// The number of batches being processed at any given time is bounded, so memory usage does not
+// depend on the number of pixels being printed.
+// Decoding is kept on the calling thread as reading from Cooler files is not thread-safe.
+template <typename PixelIt>
+inline void print_pixels_parallel(DumpWriter& writer, PixelIt first, PixelIt last,
+                                  std::shared_ptr<const BinTable> bins, std::size_t threads,
+                                  std::size_t batch_size = 64'000) {
+  assert(!writer.is_binary());
+  assert(threads > 1);
+  assert(batch_size != 0);
+
+  using PixelBuffer = std::vector<ThinPixel<double>>;
+  struct Batch {
+    PixelBuffer pixels{};
+    fmt::memory_buffer text{};
+  };
+
+  BS::thread_pool tpool(conditional_static_cast<BS::concurrency_t>(threads - 1));
+  const auto max_batches_in_flight = 2 * threads;
+
+  std::deque<std::future<Batch>> batches_in_flight{};
+  // pixel buffers are recycled to avoid allocating a new buffer for every batch
+  std::vector<PixelBuffer> buffer_pool{};
+
+  auto write_next_batch = [&]() {
+    assert(!batches_in_flight.empty());
+    auto batch = batches_in_flight.front().get();
+    batches_in_flight.pop_front();
+    writer.write(batch.text);
+    batch.pixels.clear();
+    buffer_pool.emplace_back(std::move(batch.pixels));
+  };
+
+  auto submit_batch = [&](PixelBuffer pixels) {
+    batches_in_flight.emplace_back(tpool.submit_task([pixels = std::move(pixels), bins]() mutable {
+      Batch batch{};
+      batch.pixels = std::move(pixels);
+      for (const auto& p : batch.pixels) {
+        if (bins) {
+          DumpWriter::format_pixel(batch.text, Pixel<double>{*bins, p});
+        } else {
+          DumpWriter::format_pixel(batch.text, p);
+        }
+      }
+      return batch;
+    }));
+  };
+
+  PixelBuffer pixels{};
+  pixels.reserve(batch_size);
+  for (; first != last; ++first) {
+    const auto& p = *first;
+    pixels.emplace_back(
+        ThinPixel<double>{p.bin1_id, p.bin2_id, conditional_static_cast<double>(p.count)});
+    if (pixels.size() == batch_size) {
+      submit_batch(std::move(pixels));
+      while (batches_in_flight.size() >= max_batches_in_flight) {
+        write_next_batch();
+      }
+      if (buffer_pool.empty()) {
+        pixels = PixelBuffer{};
+        pixels.reserve(batch_size);
+      } else {
+        pixels = std::move(buffer_pool.back());
+        buffer_pool.pop_back();
+      }
+    }
+  }
+
+  if (!pixels.empty()) {
+    submit_batch(std::move(pixels));
+  }
+  while (!batches_in_flight.empty()) {
+    write_next_batch();
+  }
+}
+
+template <typename S, typename... Args>
+inline void DumpWriter::print(const S& format_str, Args&&... args) {
+  assert(!is_binary());
+  fmt::format_to(std::back_inserter(_buffer), format_str, std::forward<Args>(args)...);
+  flush_if_full();
 }
 
 }  // namespace hictk::tools
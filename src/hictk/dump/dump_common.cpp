@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: MIT
 
+#include <fmt/compile.h>
 #include <fmt/format.h>
 #include <parallel_hashmap/btree.h>
 
@@ -20,25 +21,18 @@
 #include "hictk/pixel.hpp"
 
 namespace hictk::tools {
-void print(const Pixel<double>& pixel) {
-  fmt::print(FMT_COMPILE("{:bg2}\t{:.16g}\n"), pixel.coords, pixel.count);
-}
-void print(const ThinPixel<double>& pixel) {
-  fmt::print(FMT_COMPILE("{:d}\t{:d}\t{:.16g}\n"), pixel.bin1_id, pixel.bin2_id, pixel.count);
-}
-
-void dump_bins(const File& f, std::string_view range) {
+void dump_bins(DumpWriter& writer, const File& f, std::string_view range) {
   if (range == "all") {
     for (const auto& bin : f.bins()) {
-      fmt::print(FMT_COMPILE("{:s}\t{:d}\t{:d}\n"), bin.chrom().name(), bin.start(), bin.end());
+      writer.print(FMT_COMPILE("{:s}\t{:d}\t{:d}\n"), bin.chrom().name(), bin.start(), bin.end());
     }
     return;
   }
 
   const auto coords = GenomicInterval::parse_ucsc(f.chromosomes(), std::string{range});
   auto [first_bin, last_bin] = f.bins().find_overlap(coords);
-  std::for_each(first_bin, last_bin, [](const Bin& bin) {
-    fmt::print(FMT_COMPILE("{:s}\t{:d}\t{:d}\n"), bin.chrom().name(), bin.start(), bin.end());
+  std::for_each(first_bin, last_bin, [&](const Bin& bin) {
+    writer.print(FMT_COMPILE("{:s}\t{:d}\t{:d}\n"), bin.chrom().name(), bin.start(), bin.end());
   });
 }
 
@@ -56,7 +50,7 @@ void dump_bins(const File& f, std::string_view range) {
   return {i0, i1};
 }
 
-void dump_weights(const File& f, std::string_view range) {
+void dump_weights(DumpWriter& writer, const File& f, std::string_view range) {
   const auto norms = f.avail_normalizations();
   std::vector<balancing::Weights> weights{};
   for (const auto& norm : norms) {
@@ -65,7 +59,7 @@ void dump_weights(const File& f, std::string_view range) {
 
   const auto [i0, i1] = compute_bin_ids(f.bins(), range);
 
-  fmt::print(FMT_STRING("{}\n"), fmt::join(norms, "\t"));
+  writer.print(FMT_STRING("{}\n"), fmt::join(norms, "\t"));
   std::vector<double> record(norms.size());
   for (std::size_t i = i0; i < i1; ++i) {
     for (std::size_t j = 0; j < norms.size(); ++j) {
@@ -76,20 +70,21 @@ void dump_weights(const File& f, std::string_view range) {
         record[j] = 1.0 / w[i];
       }
     }
-    fmt::print(FMT_COMPILE("{}\n"), fmt::join(record, "\t"));
+    writer.print(FMT_COMPILE("{}\n"), fmt::join(record, "\t"));
   }
 }
 
-void dump_cells(std::string_view uri, std::string_view format) {
+void dump_cells(DumpWriter& writer, std::string_view uri, std::string_view format) {
   if (format != "scool") {
     throw std::runtime_error(fmt::format(FMT_STRING("\"{}\" is not a .scool file"), uri));
   }
   const auto cells = cooler::SingleCellFile{uri}.cells();
   std::for_each(cells.begin(), cells.end(),
-                [&](const auto& cell) { fmt::print(FMT_COMPILE("{}\n"), cell); });
+                [&](const auto& cell) { writer.print(FMT_COMPILE("{}\n"), cell); });
 }
 
-void dump_chroms(std::string_view uri, std::string_view format, std::uint32_t resolution) {
+void dump_chroms(DumpWriter& writer, std::string_view uri, std::string_view format,
+                 std::uint32_t resolution) {
   Reference ref{};
 
   if (format == "mcool") {
@@ -102,7 +97,7 @@ void dump_chroms(std::string_view uri, std::string_view format, std::uint32_t re
 
   for (const Chromosome& chrom : ref) {
     if (!chrom.is_all()) {
-      fmt::print(FMT_COMPILE("{:s}\t{:d}\n"), chrom.name(), chrom.size());
+      writer.print(FMT_COMPILE("{:s}\t{:d}\n"), chrom.name(), chrom.size());
     }
   }
 }
@@ -139,7 +134,8 @@ static phmap::btree_set<std::string> get_normalizations(std::string_view uri,
   return norms;
 }
 
-void dump_normalizations(std::string_view uri, std::string_view format, std::uint32_t resolution) {
+void dump_normalizations(DumpWriter& writer, std::string_view uri, std::string_view format,
+                         std::uint32_t resolution) {
   phmap::btree_set<std::string> norms{};
   std::vector<std::uint32_t> resolutions{};
   if (format == "mcool") {
@@ -163,11 +159,12 @@ void dump_normalizations(std::string_view uri, std::string_view format, std::uin
   }
 
   if (!norms.empty()) {
-    fmt::print(FMT_STRING("{}\n"), fmt::join(norms, "\n"));
+    writer.print(FMT_STRING("{}\n"), fmt::join(norms, "\n"));
   }
 }
 
-void dump_resolutions(std::string_view uri, std::string_view format, std::uint32_t resolution) {
+void dump_resolutions(DumpWriter& writer, std::string_view uri, std::string_view format,
+                      std::uint32_t resolution) {
   std::vector<std::uint32_t> resolutions{};
 
   if (format == "hic") {
@@ -190,7 +187,7 @@ void dump_resolutions(std::string_view uri, std::string_view format, std::uint32
   }
 
   if (!resolutions.empty()) {
-    fmt::print(FMT_STRING("{}\n"), fmt::join(resolutions, "\n"));
+    writer.print(FMT_STRING("{}\n"), fmt::join(resolutions, "\n"));
   }
 }
 
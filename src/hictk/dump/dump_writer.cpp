@@ -0,0 +1,239 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+#include <fmt/std.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "./dump.hpp"
+#include "hictk/fmt/pixel.hpp"
+#include "hictk/pixel.hpp"
+
+namespace hictk::tools {
+
+DumpWriter::DumpWriter(const std::filesystem::path& path, Format format,
+                       std::size_t buffer_capacity)
+    : _path(path),
+      _format(format),
+      _buffer_capacity(std::max(buffer_capacity, std::size_t{1})) {
+  if (_format == Format::npy && _path.empty()) {
+    throw std::runtime_error("writing pixels in .npy format requires an output file");
+  }
+
+  if (_path.empty()) {
+    _fp = stdout;
+#ifdef _WIN32
+    if (is_binary()) {
+      // prevent Windows from translating \n to \r\n
+      _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+  } else {
+    _fp = std::fopen(_path.string().c_str(), "wb");
+    if (!_fp) {
+      throw std::runtime_error(fmt::format(FMT_STRING("failed to open file {} for writing: {}"),
+                                           _path, std::strerror(errno)));
+    }
+  }
+
+  _buffer.reserve(_buffer_capacity);
+  if (_format == Format::npy) {
+    // write a placeholder header: the actual header is written by finalize()
+    write_npy_header();
+  }
+}
+
+DumpWriter::~DumpWriter() noexcept {
+  try {
+    if (!_finalized) {
+      flush();
+    }
+  } catch (...) {  // NOLINT
+  }
+  if (_fp && _fp != stdout) {
+    std::fclose(_fp);  // NOLINT(cert-err33-c)
+  }
+}
+
+auto DumpWriter::parse_format(std::string_view format) -> Format {
+  if (format == "tsv") {
+    return Format::tsv;
+  }
+  if (format == "binary") {
+    return Format::binary;
+  }
+  if (format == "npy") {
+    return Format::npy;
+  }
+  throw std::runtime_error(fmt::format(FMT_STRING("unknown output format \"{}\""), format));
+}
+
+void DumpWriter::write(const ThinPixel<double>& pixel) {
+  if (!is_binary()) {
+    format_pixel(_buffer, pixel);
+    flush_if_full();
+    return;
+  }
+
+  static_assert(sizeof(pixel.bin1_id) == 8);
+  static_assert(sizeof(pixel.bin2_id) == 8);
+  static_assert(sizeof(pixel.count) == 8);
+  std::array<char, 24> record{};
+  std::memcpy(record.data(), &pixel.bin1_id, 8);
+  std::memcpy(record.data() + 8, &pixel.bin2_id, 8);
+  std::memcpy(record.data() + 16, &pixel.count, 8);
+
+  _buffer.append(record.data(), record.data() + record.size());
+  ++_num_records;
+  flush_if_full();
+}
+
+void DumpWriter::write(const Pixel<double>& pixel) {
+  if (is_binary()) {
+    throw std::runtime_error(
+        "pixels with genomic coordinates can only be written using text formats");
+  }
+  format_pixel(_buffer, pixel);
+  flush_if_full();
+}
+
+void DumpWriter::write(const fmt::memory_buffer& buffer) {
+  if (is_binary()) {
+    throw std::runtime_error("pre-formatted text can only be written using text formats");
+  }
+  if (_buffer.size() + buffer.size() > _buffer_capacity) {
+    // write the buffered data first to preserve the order of records
+    write_to_file(_buffer.data(), _buffer.size());
+    _buffer.clear();
+  }
+  if (buffer.size() >= _buffer_capacity) {
+    // large chunks are written directly to avoid a redundant copy
+    write_to_file(buffer.data(), buffer.size());
+    return;
+  }
+  _buffer.append(buffer.data(), buffer.data() + buffer.size());
+}
+
+void DumpWriter::format_pixel(fmt::memory_buffer& buffer, const ThinPixel<double>& pixel) {
+  fmt::format_to(std::back_inserter(buffer), FMT_COMPILE("{:d}\t{:d}\t{:.16g}\n"), pixel.bin1_id,
+                 pixel.bin2_id, pixel.count);
+}
+
+void DumpWriter::format_pixel(fmt::memory_buffer& buffer, const Pixel<double>& pixel) {
+  fmt::format_to(std::back_inserter(buffer), FMT_COMPILE("{:bg2}\t{:.16g}\n"), pixel.coords,
+                 pixel.count);
+}
+
+void DumpWriter::flush() {
+  assert(_fp);
+  write_to_file(_buffer.data(), _buffer.size());
+  _buffer.clear();
+  if (std::fflush(_fp) != 0) {
+    throw std::runtime_error(fmt::format(FMT_STRING("failed to flush data to {}: {}"),
+                                         _path.empty() ? "stdout" : _path.string(),
+                                         std::strerror(errno)));
+  }
+}
+
+void DumpWriter::finalize() {
+  if (_finalized) {
+    return;
+  }
+
+  flush();
+  if (_format == Format::npy) {
+    write_npy_header();
+    flush();
+  }
+
+  if (_fp != stdout) {
+    const auto status = std::fclose(_fp);
+    _fp = nullptr;
+    if (status != 0) {
+      throw std::runtime_error(fmt::format(FMT_STRING("failed to close file {}"), _path));
+    }
+  }
+  _finalized = true;
+}
+
+void DumpWriter::flush_if_full() {
+  if (_buffer.size() >= _buffer_capacity) {
+    write_to_file(_buffer.data(), _buffer.size());
+    _buffer.clear();
+  }
+}
+
+void DumpWriter::write_to_file(const char* data, std::size_t size) {
+  assert(_fp);
+  if (size != 0 && std::fwrite(data, 1, size, _fp) != size) {
+    throw std::runtime_error(fmt::format(FMT_STRING("failed to write data to {}: {}"),
+                                         _path.empty() ? "stdout" : _path.string(),
+                                         std::strerror(errno)));
+  }
+}
+
+void DumpWriter::write_npy_header() {
+  assert(_format == Format::npy);
+  const auto header = generate_npy_header(_num_records);
+  // the header has the same size regardless of the number of records, so it can be safely
+  // overwritten once all records have been written
+  if (std::fseek(_fp, 0, SEEK_SET) != 0) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("failed to write .npy header to {}: file is not seekable"), _path));
+  }
+  write_to_file(header.data(), header.size());
+  if (std::fseek(_fp, 0, SEEK_END) != 0) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("failed to write .npy header to {}: file is not seekable"), _path));
+  }
+}
+
+std::string DumpWriter::generate_npy_header(std::uint64_t num_records) {
+  // See https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html
+  constexpr std::string_view magic_string{"\x93NUMPY\x01\x00", 8};
+  constexpr std::size_t max_shape_digits = std::numeric_limits<std::uint64_t>::digits10 + 1;
+
+  auto dict = fmt::format(FMT_STRING("{{'descr': [('bin1_id', '<u8'), ('bin2_id', '<u8'), "
+                                     "('count', '<f8')], 'fortran_order': False, "
+                                     "'shape': ({},), }}"),
+                          num_records);
+  // pad the dictionary so that the size of the header does not depend on num_records
+  dict.append(max_shape_digits - fmt::formatted_size(FMT_COMPILE("{}"), num_records), ' ');
+
+  // the total size of the header (including the terminating newline) must be a multiple of 64
+  const auto unpadded_size = magic_string.size() + sizeof(std::uint16_t) + dict.size() + 1;
+  dict.append((64 - (unpadded_size % 64)) % 64, ' ');
+  dict.push_back('\n');
+
+  assert(dict.size() <= std::numeric_limits<std::uint16_t>::max());
+  const auto header_len = static_cast<std::uint16_t>(dict.size());
+
+  std::string header{magic_string};
+  header.push_back(static_cast<char>(header_len & 0xFFU));
+  header.push_back(static_cast<char>(header_len >> 8U));
+  header.append(dict);
+  return header;
+}
+
+}  // namespace hictk::tools
@@ -35,6 +35,7 @@ struct BalanceICEConfig {
   std::uint8_t zstd_compression_lvl{3};
   std::size_t threads{1};
   std::size_t chunk_size{10'000'000};
+  std::size_t max_memory{};
 
   std::uint8_t verbosity{4};
   bool force{false};
@@ -57,6 +58,7 @@ struct BalanceSCALEConfig {
   std::uint8_t zstd_compression_lvl{3};
   std::size_t threads{1};
   std::size_t chunk_size{10'000'000};
+  std::size_t max_memory{};
 
   std::uint8_t verbosity{4};
   bool force{false};
@@ -93,6 +95,7 @@ struct ConvertConfig {
   std::uint32_t compression_lvl{6};
   std::size_t threads{2};
   std::size_t chunk_size{10'000'000};
+  std::size_t max_memory{};
 
   std::uint8_t verbosity{4};
   bool force{false};
@@ -117,6 +120,11 @@ struct DumpConfig {
   hic::MatrixType matrix_type{hic::MatrixType::observed};
   hic::MatrixUnit matrix_unit{hic::MatrixUnit::BP};
   std::uint32_t resolution{};
+
+  std::filesystem::path output_path{};
+  std::string output_format{"tsv"};
+
+  std::size_t threads{1};
   std::uint8_t verbosity{2};
   bool force{false};
 };
@@ -132,6 +140,7 @@ struct FixMcoolConfig {
   bool in_memory{false};
   std::uint8_t zstd_compression_lvl{3};
   std::size_t chunk_size{10'000'000};
+  std::size_t max_memory{};
 
   std::size_t threads{1};
   std::uint8_t verbosity{4};
@@ -163,6 +172,7 @@ struct LoadConfig {
 
   std::uint8_t verbosity{4};
   std::size_t batch_size{10'000'000};
+  std::size_t max_memory{};
 };
 
 struct MergeConfig {
@@ -174,6 +184,7 @@ struct MergeConfig {
   std::filesystem::path tmp_dir{std::filesystem::temp_directory_path()};
 
   std::size_t chunk_size{10'000'000};
+  std::size_t max_memory{};
   std::uint32_t compression_lvl{9};
   std::size_t threads{1};
   bool skip_all_vs_all_matrix{true};
@@ -211,6 +222,7 @@ struct ZoomifyConfig {
   std::uint32_t compression_lvl{6};
   std::uint32_t threads{1};
   std::size_t batch_size{10'000'000};
+  std::size_t max_memory{};
   bool skip_all_vs_all_matrix{false};
 
   bool force{false};
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "hictk/hic/file_writer.hpp"
+#include "hictk/hic/interaction_to_block_mapper.hpp"
+#include "hictk/pixel.hpp"
+
+namespace hictk::tools {
+
+// Class used to split the memory budget specified through --max-memory across the components of a
+// subcommand.
+// Components are handed out quotas (in bytes), which are then converted to the number of pixels
+// that can be buffered before spilling them to disk (or flushing them to the output file).
+// Budgets are approximate: quotas only account for the memory used to buffer pixels and for the
+// largest fixed-size buffers, and the footprint of a pixel is estimated based on the containers
+// used to store it.
+// An exception is thrown when the budget is too small to accommodate the fixed-size buffers and at
+// least MIN_CHUNK_SIZE pixels, as the subcommands cannot run with less than that.
+class MemoryBudget {
+  std::size_t _capacity{};
+  std::size_t _available{};
+
+ public:
+  // Pixel counts computed from a budget are never smaller than this
+  static constexpr std::size_t MIN_CHUNK_SIZE{100'000};
+
+  MemoryBudget() = default;
+  explicit constexpr MemoryBudget(std::size_t capacity) noexcept
+      : _capacity(capacity), _available(capacity) {}
+
+  [[nodiscard]] constexpr std::size_t capacity() const noexcept { return _capacity; }
+  [[nodiscard]] constexpr std::size_t available() const noexcept { return _available; }
+  [[nodiscard]] constexpr std::size_t reserved() const noexcept { return _capacity - _available; }
+
+  // Reserve the given number of bytes from the remaining budget
+  void reserve(std::size_t bytes) {
+    if (bytes > _available) {
+      throw std::runtime_error(fmt::format(
+          FMT_STRING("--max-memory is too small: at least {} bytes are required, but only {} "
+                     "bytes were provided"),
+          min_capacity(bytes, 0), _capacity));
+    }
+    _available -= bytes;
+  }
+
+  // Reserve all the remaining budget and return the number of items with the given footprint
+  // fitting in it
+  [[nodiscard]] std::size_t reserve_items(std::size_t item_footprint) {
+    item_footprint = std::max(item_footprint, std::size_t{1});
+    const auto num_items = _available / item_footprint;
+    if (num_items < MIN_CHUNK_SIZE) {
+      throw std::runtime_error(fmt::format(
+          FMT_STRING("--max-memory is too small: at least {} bytes are required to buffer {} "
+                     "interactions, but only {} bytes were provided"),
+          min_capacity(0, item_footprint), MIN_CHUNK_SIZE, _capacity));
+    }
+    _available = 0;
+    return num_items;
+  }
+
+ private:
+  // Smallest budget that can accommodate what has been reserved so far, the given number of bytes
+  // and MIN_CHUNK_SIZE items with the given footprint
+  [[nodiscard]] constexpr std::size_t min_capacity(std::size_t bytes,
+                                                   std::size_t item_footprint) const noexcept {
+    return reserved() + bytes + (MIN_CHUNK_SIZE * item_footprint);
+  }
+};
+
+// Approximate number of bytes required to buffer one pixel in the containers used by the different
+// subcommands
+
+// Plain vectors of pixels (e.g. the buffers used to read pixels from text files)
+inline constexpr std::size_t PIXEL_BUFFER_FOOTPRINT{sizeof(ThinPixel<double>)};
+// Partial interaction blocks buffered by HiCInteractionToBlockMapper: pixels are stored in columnar
+// format, and the btree used to index blocks roughly doubles their size
+inline constexpr std::size_t HIC_BLOCK_MAPPER_FOOTPRINT{
+    2 * (sizeof(std::uint64_t) + sizeof(std::uint64_t) + sizeof(float))};
+// Chunks of interactions buffered by balancing::SparseMatrixChunked
+inline constexpr std::size_t SPARSE_MATRIX_FOOTPRINT{sizeof(std::uint64_t) + sizeof(std::uint64_t) +
+                                                     sizeof(double)};
+// Pending interaction blocks buffered by HiCFileWriter::add_sorted_pixels(), which are capped to
+// the equivalent of chunk_size thin pixels
+inline constexpr std::size_t HIC_SORTED_PIXELS_FOOTPRINT{sizeof(ThinPixel<float>)};
+
+// Fixed-size buffers allocated by HiCFileWriter: the buffers used to compress interaction blocks,
+// the pixel batches used to map pixels to interaction blocks in parallel, and the readahead
+// buffers used to read spilled blocks back (the writer and each worker thread use their own
+// reader).
+// HiCInteractionToBlockMapper::append_pixels() keeps two batches of pixels in memory, one of
+// which is being mapped by the worker threads into thread-local interaction blocks. Batches store
+// the pixels as they are passed to the writer, which can be full Pixel<float> objects.
+[[nodiscard]] constexpr std::size_t hic_file_writer_fixed_footprint(std::size_t threads) noexcept {
+  using HiCFileWriter = hic::internal::HiCFileWriter;
+  using HiCInteractionToBlockMapper = hic::internal::HiCInteractionToBlockMapper;
+  constexpr auto batch_size = HiCInteractionToBlockMapper::DEFAULT_BATCH_SIZE;
+  return HiCFileWriter::DEFAULT_BUFFER_SIZE + (threads * HiCFileWriter::WORKER_BUFFER_SIZE) +
+         (2 * batch_size * sizeof(Pixel<float>)) + (batch_size * HIC_BLOCK_MAPPER_FOOTPRINT) +
+         ((threads + 1) * HiCInteractionToBlockMapper::SpillReader::DEFAULT_READAHEAD_BUDGET);
+}
+
+// Memory used by HiCFileWriter to buffer one pixel per chunk: each resolution has its own
+// HiCInteractionToBlockMapper, which keeps up to chunk_size pixels in memory until serialize() is
+// called
+[[nodiscard]] constexpr std::size_t hic_file_writer_pixel_footprint(
+    std::size_t num_resolutions) noexcept {
+  return std::max(num_resolutions, std::size_t{1}) * HIC_BLOCK_MAPPER_FOOTPRINT;
+}
+
+}  // namespace hictk::tools
@@ -0,0 +1,38 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace hictk::tools {
+
+// Number of threads assigned to the stages of hictk dump.
+// Both stages count the calling thread, which reads pixels and writes the formatted output:
+// - reading interactions with fetch threads spawns fetch - 1 decoding workers (.hic files only)
+// - formatting pixels with format threads spawns format - 1 formatting workers
+struct DumpThreads {
+  std::size_t fetch{1};   // NOLINT
+  std::size_t format{1};  // NOLINT
+
+  // Maximum number of threads running at the same time
+  [[nodiscard]] constexpr std::size_t total() const noexcept { return fetch + format - 1; }
+};
+
+// Split the number of threads specified through --threads between the stages of hictk dump, so
+// that the total number of threads never exceeds threads.
+// When pixels are not formatted in parallel (e.g. when writing binary output), all threads are
+// assigned to decoding. Otherwise decoding gets half of the threads and formatting the rest.
+[[nodiscard]] constexpr DumpThreads split_dump_threads(std::size_t threads,
+                                                       bool format_in_parallel) noexcept {
+  threads = std::max(std::size_t{1}, threads);
+  if (!format_in_parallel) {
+    return {threads, 1};
+  }
+  const auto fetch = std::max(std::size_t{1}, threads / 2);
+  return {fetch, threads - fetch + 1};
+}
+
+}  // namespace hictk::tools
@@ -4,13 +4,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <istream>
+#include <string>
 #include <string_view>
+#include <system_error>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "hictk/bin_table.hpp"
+#include "hictk/chromosome.hpp"
+#include "hictk/numeric_utils.hpp"
 #include "hictk/pixel.hpp"
 #include "hictk/type_traits.hpp"
 
@@ -35,8 +45,11 @@ enum class Format { COO, BG2, VP, _4DN };
   return Format::_4DN;
 }
 
-template <typename N>
-[[nodiscard]] inline ThinPixel<N> parse_pixel(const BinTable& bins, std::string_view line,
+// Parse a pixel in the given format.
+// bins can be a BinTable or one of the concrete bin table types (see BinTable::visit()): passing
+// the concrete type avoids dispatching bin lookups through std::variant for every pixel
+template <typename N, typename BinTableT>
+[[nodiscard]] inline ThinPixel<N> parse_pixel(const BinTableT& bins, std::string_view line,
                                               Format format, std::int64_t offset) {
   ThinPixel<N> pixel{};
   switch (format) {
@@ -59,10 +72,317 @@ template <typename N>
   return pixel;
 }
 
+// Class used to parse pixels from text with as little overhead as possible.
+// Lines are split with memchr (which libc implementations vectorize), numbers are parsed with
+// from_chars without going through the error handling code, and the chromosome found in each
+// column is memoized, as interactions are usually grouped by chromosome.
+// Lines that cannot be parsed by the fast path are handed over to parse_pixel(), which takes care
+// of throwing exceptions with detailed error messages.
+template <typename N, typename BinTableT>
+class PixelParser {
+  struct ChromCache {
+    std::string name{};
+    const Chromosome* chrom{};
+  };
+
+  // Genomic coordinates of one of the bins of a pixel
+  struct Coords {
+    const Chromosome* chrom{};
+    std::uint32_t pos{};
+  };
+
+  // Coordinates of the pixels appended by push_back() whose bin ids have not yet been mapped
+  struct PendingPixels {
+    std::vector<std::size_t> idx{};
+    std::array<std::vector<const Chromosome*>, 2> chroms{};
+    std::array<std::vector<std::uint32_t>, 2> positions{};
+  };
+
+  const BinTableT* _bins{};
+  Format _format{};
+  std::int64_t _offset{};
+  std::array<ChromCache, 2> _chroms{};
+  PendingPixels _pending{};
+  std::vector<std::uint64_t> _bin_ids{};
+
+ public:
+  static constexpr std::size_t MAX_PENDING_PIXELS{64ULL << 10U};
+
+  PixelParser(const BinTableT& bins, Format format, std::int64_t offset)
+      : _bins(&bins), _format(format), _offset(offset) {}
+
+  [[nodiscard]] ThinPixel<N> operator()(std::string_view line) {
+    ThinPixel<N> pixel{};
+    std::array<Coords, 2> coords{};
+    if (!try_parse(line, pixel, coords)) {
+      return parse_pixel<N>(*_bins, line, _format, _offset);
+    }
+    if (coords[0].chrom) {
+      pixel.bin1_id = _bins->map_to_bin_id(*coords[0].chrom, coords[0].pos);
+      pixel.bin2_id = _bins->map_to_bin_id(*coords[1].chrom, coords[1].pos);
+    }
+    if (pixel.bin1_id > pixel.bin2_id) {
+      std::swap(pixel.bin1_id, pixel.bin2_id);
+    }
+    return pixel;
+  }
+
+  // Parse line and append the resulting pixel to pixels.
+  // Genomic coordinates are mapped to bin ids lazily: flush() must be called before reading the
+  // pixels appended by push_back(). Coordinates are mapped in batches (one per run of
+  // consecutive pixels whose bins are located on the same chromosome), so that, when
+  // interactions are sorted by genomic coordinates, BinTableVariable::map_to_bin_ids() can find
+  // most bins by walking forward from the previous bin.
+  // Coordinates are flushed every MAX_PENDING_PIXELS pixels to bound memory usage.
+  void push_back(std::string_view line, std::vector<ThinPixel<N>>& pixels) {
+    ThinPixel<N> pixel{};
+    std::array<Coords, 2> coords{};
+    if (!try_parse(line, pixel, coords)) {
+      pixels.push_back(parse_pixel<N>(*_bins, line, _format, _offset));
+      return;
+    }
+    if (!coords[0].chrom) {
+      if (pixel.bin1_id > pixel.bin2_id) {
+        std::swap(pixel.bin1_id, pixel.bin2_id);
+      }
+      pixels.push_back(pixel);
+      return;
+    }
+
+    _pending.idx.push_back(pixels.size());
+    for (std::size_t col = 0; col < coords.size(); ++col) {
+      _pending.chroms[col].push_back(coords[col].chrom);
+      _pending.positions[col].push_back(coords[col].pos);
+    }
+    pixels.push_back(pixel);
+    if (_pending.idx.size() == MAX_PENDING_PIXELS) {
+      flush(pixels);
+    }
+  }
+
+  // Map the coordinates of the pixels appended by push_back() to bin ids
+  void flush(std::vector<ThinPixel<N>>& pixels) {
+    const auto num_pixels = _pending.idx.size();
+    _bin_ids.resize(num_pixels);
+    for (std::size_t col = 0; col < _pending.chroms.size(); ++col) {
+      const auto& chroms = _pending.chroms[col];
+      const auto& positions = _pending.positions[col];
+      for (std::size_t i = 0; i < num_pixels;) {
+        auto j = i + 1;
+        while (j < num_pixels && chroms[j] == chroms[i]) {
+          ++j;
+        }
+        _bins->map_to_bin_ids(*chroms[i], positions.begin() + static_cast<std::ptrdiff_t>(i),
+                              positions.begin() + static_cast<std::ptrdiff_t>(j),
+                              _bin_ids.begin() + static_cast<std::ptrdiff_t>(i));
+        i = j;
+      }
+
+      for (std::size_t i = 0; i < num_pixels; ++i) {
+        auto& pixel = pixels[_pending.idx[i]];
+        (col == 0 ? pixel.bin1_id : pixel.bin2_id) = _bin_ids[i];
+      }
+    }
+
+    for (const auto i : _pending.idx) {
+      auto& pixel = pixels[i];
+      if (pixel.bin1_id > pixel.bin2_id) {
+        std::swap(pixel.bin1_id, pixel.bin2_id);
+      }
+    }
+
+    _pending.idx.clear();
+    for (std::size_t col = 0; col < _pending.chroms.size(); ++col) {
+      _pending.chroms[col].clear();
+      _pending.positions[col].clear();
+    }
+  }
+
+ private:
+  // Parse line into pixel.
+  // For formats storing genomic coordinates, the coordinates of the two bins are stored in coords
+  // instead of being mapped to bin ids
+  [[nodiscard]] bool try_parse(std::string_view line, ThinPixel<N>& pixel,
+                               std::array<Coords, 2>& coords) {
+    if (line.empty()) {
+      return false;
+    }
+    if (_format != Format::COO && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+
+    switch (_format) {
+      case Format::COO: {
+        std::array<std::string_view, 3> toks{};
+        return split_fields(line, toks, true) && parse_bin_id(toks[0], pixel.bin1_id) &&
+               parse_bin_id(toks[1], pixel.bin2_id) && parse_number(toks[2], pixel.count);
+      }
+      case Format::BG2: {
+        std::array<std::string_view, 7> toks{};
+        return split_fields(line, toks, false) && parse_coords(0, toks[0], toks[1], coords[0]) &&
+               parse_coords(1, toks[3], toks[4], coords[1]) && parse_number(toks[6], pixel.count);
+      }
+      case Format::VP: {
+        std::array<std::string_view, 6> toks{};
+        pixel.count = 1;
+        return split_fields(line, toks, false) && parse_coords(0, toks[1], toks[2], coords[0]) &&
+               parse_coords(1, toks[4], toks[5], coords[1]);
+      }
+      case Format::_4DN: {
+        std::array<std::string_view, 6> toks{};
+        pixel.count = 1;
+        return split_fields(line, toks, false) && parse_coords(0, toks[1], toks[2], coords[0]) &&
+               parse_coords(1, toks[3], toks[4], coords[1]);
+      }
+    }
+    return false;
+  }
+
+  // Split line into toks.size() tab-separated fields.
+  // Return false when any of the fields is empty, when line has fewer fields than toks.size(), or
+  // when line has more fields than toks.size() and exact_match is true
+  template <std::size_t NFields>
+  [[nodiscard]] static bool split_fields(std::string_view line,
+                                         std::array<std::string_view, NFields>& toks,
+                                         bool exact_match) noexcept {
+    const auto* first = line.data();
+    const auto* last = first + line.size();  // NOLINT(*-pointer-arithmetic)
+    for (std::size_t i = 0; i < toks.size(); ++i) {
+      const auto* sep = static_cast<const char*>(
+          std::memchr(first, '\t', static_cast<std::size_t>(last - first)));
+      const auto* tok_last = sep ? sep : last;
+      toks[i] = std::string_view{first, static_cast<std::size_t>(tok_last - first)};
+      if (toks[i].empty()) {
+        return false;
+      }
+      if (!sep) {
+        return i + 1 == toks.size();
+      }
+      first = sep + 1;  // NOLINT(*-pointer-arithmetic)
+    }
+    return !exact_match;
+  }
+
+  template <typename T>
+  [[nodiscard]] static bool parse_number(std::string_view tok, T& value) noexcept {
+    const auto* last = tok.data() + tok.size();  // NOLINT(*-pointer-arithmetic)
+    const auto [ptr, err] = internal::from_chars(tok.data(), last, value);
+    return ptr == last && err == std::errc{};
+  }
+
+  [[nodiscard]] bool parse_bin_id(std::string_view tok, std::uint64_t& bin_id) const noexcept {
+    std::int64_t value{};
+    if (!parse_number(tok, value)) {
+      return false;
+    }
+    value += _offset;
+    if (value < 0 || static_cast<std::uint64_t>(value) >= _bins->size()) {
+      return false;
+    }
+    bin_id = static_cast<std::uint64_t>(value);
+    return true;
+  }
+
+  [[nodiscard]] bool parse_coords(std::size_t col, std::string_view chrom_name,
+                                  std::string_view pos_tok, Coords& coords) {
+    std::int64_t pos{};
+    if (!parse_number(pos_tok, pos)) {
+      return false;
+    }
+    pos += _offset;
+
+    const auto* chrom = find_chromosome(col, chrom_name);
+    if (!chrom || pos < 0 || pos >= static_cast<std::int64_t>(chrom->size())) {
+      return false;
+    }
+    coords = {chrom, static_cast<std::uint32_t>(pos)};
+    return true;
+  }
+
+  [[nodiscard]] const Chromosome* find_chromosome(std::size_t col, std::string_view chrom_name) {
+    auto& cache = _chroms[col];
+    if (cache.chrom && cache.name == chrom_name) {
+      return cache.chrom;
+    }
+
+    const auto& chroms = _bins->chromosomes();
+    const auto match = chroms.find(chrom_name);
+    if (match == chroms.end()) {
+      return nullptr;
+    }
+    cache.name = chrom_name;
+    cache.chrom = &(*match);
+    return cache.chrom;
+  }
+};
+
 [[nodiscard]] inline bool line_is_header(std::string_view line) {
   return !line.empty() && line.front() == '#';
 }
 
+// Class used to read lines of text from a stream (usually std::cin).
+// Text is read in large blocks and lines are returned as views into the read buffer, so that
+// reading a line does not copy it nor go through the per-character machinery of std::getline.
+// The buffer grows as needed to fit lines longer than the current buffer size.
+class LineReader {
+  std::istream* _is{};
+  std::string _buffer{};
+  std::size_t _first{};
+  std::size_t _last{};
+
+ public:
+  static constexpr std::size_t DEFAULT_BUFFER_SIZE{1ULL << 20U};  // 1 MiB
+
+  explicit LineReader(std::istream& is, std::size_t buffer_size = DEFAULT_BUFFER_SIZE)
+      : _is(&is), _buffer(std::max(buffer_size, std::size_t{1}), '\0') {}
+
+  // Read the next line, excluding the newline character.
+  // The view is invalidated by the next call to getline().
+  // Return false once all lines have been read, in which case line is set to an empty view
+  [[nodiscard]] bool getline(std::string_view& line) {
+    while (true) {
+      const auto* first = _buffer.data() + _first;  // NOLINT(*-pointer-arithmetic)
+      const auto* sep = static_cast<const char*>(std::memchr(first, '\n', _last - _first));
+      if (sep) {
+        const auto size = static_cast<std::size_t>(sep - first);
+        line = std::string_view{first, size};
+        _first += size + 1;
+        return true;
+      }
+
+      if (!_is->good()) {
+        // last line is not terminated by a newline
+        line = std::string_view{first, _last - _first};
+        _first = _last;
+        return !line.empty();
+      }
+      read_next_block();
+    }
+  }
+
+  // Return true when all lines have been read, mimicking std::istream::eof()
+  [[nodiscard]] bool eof() const noexcept { return _first == _last && !_is->good(); }
+
+ private:
+  void read_next_block() {
+    // move the partial line at the end of the buffer to its beginning
+    const auto partial_line_size = _last - _first;
+    if (_first != 0) {
+      std::memmove(_buffer.data(), _buffer.data() + _first,  // NOLINT(*-pointer-arithmetic)
+                   partial_line_size);
+      _first = 0;
+      _last = partial_line_size;
+    }
+    if (_last == _buffer.size()) {
+      _buffer.resize(2 * _buffer.size());
+    }
+
+    _is->read(_buffer.data() + _last,  // NOLINT(*-pointer-arithmetic)
+              static_cast<std::streamsize>(_buffer.size() - _last));
+    _last += static_cast<std::size_t>(_is->gcount());
+  }
+};
+
 struct Stats {
   std::variant<std::uint64_t, double> sum{0.0};
   std::uint64_t nnz{};
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <iostream>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -50,13 +51,14 @@ inline Stats ingest_pixels_unsorted_cooler(std::string_view uri, std::string_vie
           auto attrs = cooler::Attributes::init(bins.resolution());
           attrs.assembly = assembly;
 
+          LineReader reader{std::cin};
           for (std::size_t i = 0; true; ++i) {
             SPDLOG_INFO(FMT_STRING("writing chunk #{} to intermediate file \"{}\"..."), i + 1,
                         tmp_cooler_path);
             const auto partial_stats = ingest_pixels_unsorted(
                 tmp_clr.create_cell<N>(fmt::to_string(i), attrs,
                                        cooler::DEFAULT_HDF5_CACHE_SIZE * 4, compression_lvl),
-                buffer, format, offset, validate_pixels);
+                reader, buffer, format, offset, validate_pixels);
             local_stats += partial_stats;
             SPDLOG_INFO(FMT_STRING("done writing chunk #{} to tmp file \"{}\"."), i + 1,
                         tmp_cooler_path);
@@ -120,13 +122,14 @@ inline Stats ingest_pairs_cooler(std::string_view uri, std::string_view tmp_cool
           auto attrs = cooler::Attributes::init(bins.resolution());
           attrs.assembly = assembly;
 
+          LineReader reader{std::cin};
           for (std::size_t i = 0; true; ++i) {
             SPDLOG_INFO(FMT_STRING("writing chunk #{} to intermediate file \"{}\"..."), i + 1,
                         tmp_cooler_path);
             const auto partial_stats = ingest_pairs(
                 tmp_clr.create_cell<N>(fmt::to_string(i), attrs,
                                        cooler::DEFAULT_HDF5_CACHE_SIZE * 4, compression_lvl),
-                buffer, batch_size, format, offset, validate_pixels);
+                reader, buffer, batch_size, format, offset, validate_pixels);
 
             SPDLOG_INFO(FMT_STRING("done writing chunk #{} to tmp file \"{}\"."), i + 1,
                         tmp_cooler_path);
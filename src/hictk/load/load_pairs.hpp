@@ -15,7 +15,7 @@
 #include <exception>
 #include <iostream>
 #include <stdexcept>
-#include <string>
+#include <string_view>
 #include <vector>
 
 #include "./common.hpp"
@@ -23,6 +23,7 @@
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/hic/file_writer.hpp"
 #include "hictk/pixel.hpp"
+#include "hictk/type_traits.hpp"
 
 namespace hictk::tools {
 
@@ -37,27 +38,28 @@ struct PixelCmp {
   }
 };
 
-template <typename N>
+// BinTableT should be one of the concrete bin table types (see BinTable::visit())
+template <typename N, typename BinTableT>
 class PairsAggregator {
   phmap::btree_set<ThinPixel<N>, PixelCmp<N>> _buffer{};
 
-  const BinTable& _bins{};  // NOLINT
-  Format _format{};
+  LineReader* _reader{};
+  PixelParser<N, BinTableT> _parse;
   ThinPixel<N> _last_pixel{};
-  std::string _line_buffer{};
-  std::int64_t _offset{};
+  std::string_view _line_buffer{};
 
  public:
   PairsAggregator() = delete;
-  inline PairsAggregator(const BinTable& bins, Format format, std::int64_t offset)
-      : _bins(bins), _format(format), _offset(offset) {
-    while (std::getline(std::cin, _line_buffer)) {
+  inline PairsAggregator(LineReader& reader, const BinTableT& bins, Format format,
+                         std::int64_t offset)
+      : _reader(&reader), _parse(bins, format, offset) {
+    while (_reader->getline(_line_buffer)) {
       if (!line_is_header(_line_buffer)) {
         break;
       }
     }
     if (!_line_buffer.empty()) {
-      _last_pixel = parse_pixel<N>(_bins, _line_buffer, _format, _offset);
+      _last_pixel = _parse(_line_buffer);
     }
   }
 
@@ -74,12 +76,12 @@ class PairsAggregator {
   inline ThinPixel<N> aggregate_pixel() {
     assert(!!_last_pixel);
 
-    while (std::getline(std::cin, _line_buffer)) {
+    while (_reader->getline(_line_buffer)) {
       if (_line_buffer.empty()) {
         continue;
       }
 
-      auto p = parse_pixel<N>(_bins, _line_buffer, _format, _offset);
+      auto p = _parse(_line_buffer);
       if (p.bin1_id != _last_pixel.bin1_id || p.bin2_id != _last_pixel.bin2_id) {
         std::swap(p, _last_pixel);
         return p;
@@ -123,13 +125,16 @@ class PairsAggregator {
 template <typename N>
 [[nodiscard]] inline Stats ingest_pairs(
     cooler::File&& clr,  // NOLINT(*-rvalue-reference-param-not-moved)
-    std::vector<ThinPixel<N>>& buffer, std::size_t batch_size, Format format, std::int64_t offset,
-    bool validate_pixels) {
+    LineReader& reader, std::vector<ThinPixel<N>>& buffer, std::size_t batch_size, Format format,
+    std::int64_t offset, bool validate_pixels) {
   buffer.reserve(batch_size);
-  PairsAggregator<N>{clr.bins(), format, offset}.read_next_chunk(buffer);
+  clr.bins().visit([&](const auto& bins) {
+    PairsAggregator<N, remove_cvref_t<decltype(bins)>>{reader, bins, format, offset}
+        .read_next_chunk(buffer);
+  });
 
   if (buffer.empty()) {
-    assert(std::cin.eof());
+    assert(reader.eof());
     return {N{}, 0};
   }
 
@@ -152,15 +157,19 @@ template <typename N>
   const auto resolution = hf.resolutions().front();
   assert(buffer.capacity() != 0);
   buffer.reserve(buffer.capacity());
+  LineReader reader{std::cin};
   std::size_t i = 0;
 
   try {
     auto t0 = std::chrono::steady_clock::now();
-    for (; !std::cin.eof(); ++i) {
-      PairsAggregator<float>{hf.bins(resolution), format, offset}.read_next_chunk(buffer);
+    for (; !reader.eof(); ++i) {
+      hf.bins(resolution).visit([&](const auto& bins) {
+        PairsAggregator<float, remove_cvref_t<decltype(bins)>>{reader, bins, format, offset}
+            .read_next_chunk(buffer);
+      });
 
       if (buffer.empty()) {
-        assert(std::cin.eof());
+        assert(reader.eof());
         break;
       }
       const auto t1 = std::chrono::steady_clock::now();
@@ -13,7 +13,7 @@
 #include <exception>
 #include <iostream>
 #include <stdexcept>
-#include <string>
+#include <string_view>
 #include <vector>
 
 #include "./common.hpp"
@@ -21,31 +21,29 @@
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/hic/file_writer.hpp"
 #include "hictk/pixel.hpp"
+#include "hictk/type_traits.hpp"
 
 namespace hictk::tools {
 
 template <typename N>
-inline Stats read_batch(const BinTable& bins, std::vector<ThinPixel<N>>& buffer, Format format,
-                        std::int64_t offset) {
+inline Stats read_batch(LineReader& reader, const BinTable& bins, std::vector<ThinPixel<N>>& buffer,
+                        Format format, std::int64_t offset) {
   buffer.clear();
   Stats stats{N{}, 0};
-  std::string line{};
+  std::string_view line{};
   try {
-    while (std::getline(std::cin, line)) {
-      if (line_is_header(line)) {
-        continue;
+    // resolve the bin table type once per batch, and map the genomic coordinates of the whole
+    // batch to bin ids at once (see PixelParser::push_back())
+    bins.visit([&](const auto& bins_) {
+      PixelParser<N, remove_cvref_t<decltype(bins_)>> parse(bins_, format, offset);
+      while (buffer.size() != buffer.capacity() && reader.getline(line)) {
+        if (line_is_header(line)) {
+          continue;
+        }
+        parse.push_back(line, buffer);
       }
-      const auto& p = buffer.emplace_back(parse_pixel<N>(bins, line, format, offset));
-      stats.nnz++;
-      if constexpr (std::is_floating_point_v<N>) {
-        std::get<double>(stats.sum) += conditional_static_cast<double>(p.count);
-      } else {
-        std::get<std::uint64_t>(stats.sum) += conditional_static_cast<std::uint64_t>(p.count);
-      }
-      if (buffer.size() == buffer.capacity()) {
-        return stats;
-      }
-    }
+      parse.flush(buffer);
+    });
   } catch (const std::exception& e) {
     throw std::runtime_error(
         fmt::format(FMT_STRING("encountered error while processing the following line:\n"
@@ -54,6 +52,15 @@ inline Stats read_batch(const BinTable& bins, std::vector<ThinPixel<N>>& buffer,
                     line, e.what()));
   }
 
+  for (const auto& p : buffer) {
+    if constexpr (std::is_floating_point_v<N>) {
+      std::get<double>(stats.sum) += conditional_static_cast<double>(p.count);
+    } else {
+      std::get<std::uint64_t>(stats.sum) += conditional_static_cast<std::uint64_t>(p.count);
+    }
+  }
+  stats.nnz = buffer.size();
+
   return stats;
 }
 
@@ -62,13 +69,14 @@ template <typename N>
     cooler::File&& clr,  // NOLINT(*-rvalue-reference-param-not-moved)
     Format format, std::int64_t offset, std::size_t batch_size, bool validate_pixels) {
   std::vector<ThinPixel<N>> buffer(batch_size);
+  LineReader reader{std::cin};
 
   std::size_t i = 0;
   Stats stats{N{}, 0};
   try {
-    for (; !std::cin.eof(); ++i) {
+    for (; !reader.eof(); ++i) {
       SPDLOG_INFO(FMT_STRING("processing chunk #{}..."), i + 1);
-      stats += read_batch(clr.bins(), buffer, format, offset);
+      stats += read_batch(reader, clr.bins(), buffer, format, offset);
       clr.append_pixels(buffer.begin(), buffer.end(), validate_pixels);
       buffer.clear();
     }
@@ -86,13 +94,14 @@ template <typename N>
 template <typename N>
 [[nodiscard]] inline Stats ingest_pixels_unsorted(
     cooler::File&& clr,  // NOLINT(*-rvalue-reference-param-not-moved)
-    std::vector<ThinPixel<N>>& buffer, Format format, std::int64_t offset, bool validate_pixels) {
+    LineReader& reader, std::vector<ThinPixel<N>>& buffer, Format format, std::int64_t offset,
+    bool validate_pixels) {
   assert(buffer.capacity() != 0);
 
-  auto stats = read_batch(clr.bins(), buffer, format, offset);
+  auto stats = read_batch(reader, clr.bins(), buffer, format, offset);
 
   if (buffer.empty()) {
-    assert(std::cin.eof());
+    assert(reader.eof());
     return {N{}, 0};
   }
 
@@ -108,17 +117,18 @@ template <typename N>
     hic::internal::HiCFileWriter&& hf,  // NOLINT(*-rvalue-reference-param-not-moved)
     std::vector<ThinPixel<float>>& buffer, Format format, std::int64_t offset) {
   assert(buffer.capacity() != 0);
+  LineReader reader{std::cin};
 
   std::size_t i = 0;
   Stats stats{0.0, 0};
   try {
     auto t0 = std::chrono::steady_clock::now();
     const auto& bins = hf.bins(hf.resolutions().front());
-    for (; !std::cin.eof(); ++i) {
-      stats += read_batch(bins, buffer, format, offset);
+    for (; !reader.eof(); ++i) {
+      stats += read_batch(reader, bins, buffer, format, offset);
 
       if (buffer.empty()) {
-        assert(std::cin.eof());
+        assert(reader.eof());
         break;
       }
 
@@ -20,7 +20,7 @@ static void merge_coolers(const MergeConfig& c) {
   SPDLOG_INFO(FMT_STRING("begin merging {} coolers..."), c.input_files.size());
   cooler::utils::merge<std::int32_t>(c.input_files.begin(), c.input_files.end(),
                                      c.output_file.string(), c.force, c.chunk_size, 10'000'000,
-                                     c.compression_lvl);
+                                     c.compression_lvl, c.threads);
 }
 
 static void merge_hics(const MergeConfig& c) {
@@ -51,24 +51,28 @@ void zoomify_once_cooler(std::string_view uri1, std::string_view uri2, std::uint
 
 void zoomify_many_cooler(std::string_view in_uri, std::string_view out_path,
                          const std::vector<std::uint32_t>& resolutions, bool copy_base_resolution,
-                         bool force, std::uint32_t compression_lvl) {
+                         bool force, std::uint32_t compression_lvl,
+                         std::size_t max_buffered_pixels) {
   const cooler::File clr(in_uri);
-  auto mclr = cooler::MultiResFile::create(out_path, cooler::File(in_uri).chromosomes(), force);
+  auto mclr = cooler::MultiResFile::create(out_path, clr.chromosomes(), force);
 
   SPDLOG_INFO(FMT_STRING("coarsening cooler at {} {} times ({} -> {})"), clr.uri(),
               resolutions.size(), clr.resolution(), fmt::join(resolutions, " -> "));
 
+  assert(resolutions.front() == clr.resolution());
   if (copy_base_resolution) {
-    assert(resolutions.front() == clr.resolution());
     mclr.copy_resolution(clr);
   } else {
     assert(resolutions.size() > 1);
-    zoomify_once_cooler(cooler::File(in_uri), mclr.init_resolution(resolutions[1]), resolutions[1],
-                        compression_lvl);
   }
 
-  for (std::size_t i = 1; i < resolutions.size(); ++i) {
-    mclr.create_resolution(resolutions[i]);
+  // All resolutions are generated with a single pass over the interactions from the input cooler
+  if (clr.has_float_pixels()) {
+    mclr.create_resolutions<double>(clr, resolutions.begin() + 1, resolutions.end(),
+                                    max_buffered_pixels, compression_lvl);
+  } else {
+    mclr.create_resolutions<std::int32_t>(clr, resolutions.begin() + 1, resolutions.end(),
+                                          max_buffered_pixels, compression_lvl);
   }
 }
 
@@ -117,7 +121,7 @@ void zoomify_hic(const ZoomifyConfig& c) {
 void zoomify_cooler(const ZoomifyConfig& c, bool output_is_multires) {
   if (output_is_multires) {
     zoomify_many_cooler(c.path_to_input.string(), c.path_to_output.string(), c.resolutions,
-                        c.copy_base_resolution, c.force, c.compression_lvl);
+                        c.copy_base_resolution, c.force, c.compression_lvl, c.batch_size);
     return;
   }
   zoomify_once_cooler(c.path_to_input.string(), c.path_to_output.string(), c.resolutions.back(),
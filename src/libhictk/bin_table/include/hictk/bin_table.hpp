@@ -9,6 +9,8 @@
 #include <functional>
 #include <iterator>
 #include <limits>
+#include <variant>
+#include <vector>
 
 #include "hictk/bin_table_fixed.hpp"
 #include "hictk/bin_table_variable.hpp"
@@ -84,6 +86,11 @@ class BinTable {
   [[nodiscard]] std::uint64_t map_to_bin_id(const Chromosome &chrom, std::uint32_t pos) const;
   [[nodiscard]] std::uint64_t map_to_bin_id(std::string_view chrom_name, std::uint32_t pos) const;
   [[nodiscard]] std::uint64_t map_to_bin_id(std::uint32_t chrom_id, std::uint32_t pos) const;
+  // Map a range of positions on the given chromosome to bin ids, writing bin ids to out
+  // (see BinTableVariable::map_to_bin_ids())
+  template <typename PosIt, typename OutputIt>
+  OutputIt map_to_bin_ids(const Chromosome &chrom, PosIt first_pos, PosIt last_pos,
+                          OutputIt out) const;
 
   [[nodiscard]] bool operator==(const BinTable &other) const;
   [[nodiscard]] bool operator!=(const BinTable &other) const;
@@ -95,6 +102,16 @@ class BinTable {
   [[nodiscard]] constexpr auto get() const noexcept -> const BinTableVar &;
   [[nodiscard]] constexpr auto get() noexcept -> BinTableVar &;
 
+  // Call visitor with the underlying bin table (i.e. BinTableFixed or BinTableVariable<>) and
+  // return its result.
+  // This can be used to instantiate hot loops once per bin table type, so that e.g. mapping bin
+  // ids to bins does not go through std::visit for every query. When using BinTableFixed, bin
+  // lookups then boil down to integer arithmetic on the chromosome offsets.
+  template <typename Visitor>
+  decltype(auto) visit(Visitor &&visitor) const;
+  template <typename Visitor>
+  decltype(auto) visit(Visitor &&visitor);
+
   class iterator {
     friend BinTable;
     std::variant<BinTableFixed::iterator, BinTableVariable<>::iterator> _it{
@@ -143,6 +160,15 @@ class BinTable {
   };
 };
 
+namespace internal {
+// Find the id of the chromosome overlapping bin_id given the bin offsets of a bin table
+// (i.e. BinTable::num_bin_prefix_sum()).
+// hint is returned without performing a binary search when it overlaps bin_id.
+// Throws std::out_of_range when bin_id is not covered by the bin table.
+[[nodiscard]] std::uint32_t find_chrom_id(const std::vector<std::uint64_t> &offsets,
+                                          std::uint64_t bin_id, std::uint32_t hint);
+}  // namespace internal
+
 }  // namespace hictk
 
 #include "./impl/bin_table_impl.hpp"  // NOLINT
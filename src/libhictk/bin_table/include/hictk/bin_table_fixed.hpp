@@ -78,6 +78,11 @@ class BinTableFixed {
   [[nodiscard]] std::uint64_t map_to_bin_id(const Chromosome &chrom, std::uint32_t pos) const;
   [[nodiscard]] std::uint64_t map_to_bin_id(std::string_view chrom_name, std::uint32_t pos) const;
   [[nodiscard]] std::uint64_t map_to_bin_id(std::uint32_t chrom_id, std::uint32_t pos) const;
+  // Map a range of positions on the given chromosome to bin ids, writing bin ids to out
+  // (see BinTableVariable::map_to_bin_ids())
+  template <typename PosIt, typename OutputIt>
+  OutputIt map_to_bin_ids(const Chromosome &chrom, PosIt first_pos, PosIt last_pos,
+                          OutputIt out) const;
 
   [[nodiscard]] bool operator==(const BinTableFixed &other) const;
   [[nodiscard]] bool operator!=(const BinTableFixed &other) const;
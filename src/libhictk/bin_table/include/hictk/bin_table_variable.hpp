@@ -22,6 +22,13 @@ class BinTableVariable {
   Reference _chroms{};
   std::vector<I> _bin_end_prefix_sum{0};
   std::vector<std::uint64_t> _num_bins_prefix_sum{0};
+  // Coarse index used to speed up mapping genomic coordinates to bin ids.
+  // Genome-wide positions are grouped in buckets of 2^_bin_index_shift bp, and _bin_index[i]
+  // stores the id of the bin overlapping the first position of the i-th bucket.
+  // Buckets are about as large as the average bin, so that lookups only need to search the
+  // handful of bins overlapping a bucket instead of the whole table.
+  std::vector<std::uint64_t> _bin_index{};
+  std::uint32_t _bin_index_shift{};
 
  public:
   class iterator;
@@ -73,12 +80,23 @@ class BinTableVariable {
   [[nodiscard]] std::uint64_t map_to_bin_id(const Chromosome &chrom, std::uint32_t pos) const;
   [[nodiscard]] std::uint64_t map_to_bin_id(std::string_view chrom_name, std::uint32_t pos) const;
   [[nodiscard]] std::uint64_t map_to_bin_id(std::uint32_t chrom_id, std::uint32_t pos) const;
+  // Map a range of positions on the given chromosome to bin ids, writing bin ids to out.
+  // Positions are expected to be sorted in ascending order: bin ids are found by walking forward
+  // from the bin overlapping the previous position instead of searching the whole bin table.
+  // Unsorted positions are still mapped correctly, but less efficiently
+  template <typename PosIt, typename OutputIt>
+  OutputIt map_to_bin_ids(const Chromosome &chrom, PosIt first_pos, PosIt last_pos,
+                          OutputIt out) const;
 
   [[nodiscard]] bool operator==(const BinTableVariable &other) const;
   [[nodiscard]] bool operator!=(const BinTableVariable &other) const;
 
  private:
   static void validate_bin_coords(const std::vector<I> &start_pos, const std::vector<I> &end_pos);
+  void build_bin_index();
+  // Map a genome-wide position to the id of the overlapping bin
+  [[nodiscard]] std::uint64_t find_bin_id(std::uint64_t pos) const noexcept;
+  [[nodiscard]] std::uint64_t genome_wide_pos(const Chromosome &chrom, std::uint32_t pos) const;
 
  public:
   class iterator {
@@ -200,6 +200,14 @@ inline std::uint64_t BinTableFixed::map_to_bin_id(std::uint32_t chrom_id, std::u
   return map_to_bin_id(_chroms.at(chrom_id), pos);
 }
 
+template <typename PosIt, typename OutputIt>
+inline OutputIt BinTableFixed::map_to_bin_ids(const Chromosome &chrom, PosIt first_pos,
+                                              PosIt last_pos, OutputIt out) const {
+  return std::transform(first_pos, last_pos, out, [&](const auto pos) {
+    return map_to_bin_id(chrom, conditional_static_cast<std::uint32_t>(pos));
+  });
+}
+
 inline std::vector<std::uint64_t> BinTableFixed::compute_num_bins_prefix_sum(
     const Reference &chroms, std::uint32_t bin_size, std::size_t bin_offset) {
   assert(bin_size != 0);
@@ -4,10 +4,17 @@
 
 #pragma once
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <map>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -170,6 +177,14 @@ inline std::uint64_t BinTable::map_to_bin_id(std::uint32_t chrom_id, std::uint32
   return std::visit([&](const auto &t) { return t.map_to_bin_id(chrom_id, pos); }, _table);
 }
 
+template <typename PosIt, typename OutputIt>
+inline OutputIt BinTable::map_to_bin_ids(const Chromosome &chrom, PosIt first_pos, PosIt last_pos,
+                                         OutputIt out) const {
+  return visit([&](const auto &t) {
+    return t.map_to_bin_ids(chrom, std::move(first_pos), std::move(last_pos), std::move(out));
+  });
+}
+
 inline bool BinTable::operator==(const BinTable &other) const {
   return std::visit(
       [&](const auto &t1) {
@@ -200,6 +215,16 @@ constexpr auto BinTable::get() const noexcept -> const BinTableVar & { return _t
 
 constexpr auto BinTable::get() noexcept -> BinTableVar & { return _table; }
 
+template <typename Visitor>
+inline decltype(auto) BinTable::visit(Visitor &&visitor) const {
+  return std::visit(std::forward<Visitor>(visitor), _table);
+}
+
+template <typename Visitor>
+inline decltype(auto) BinTable::visit(Visitor &&visitor) {
+  return std::visit(std::forward<Visitor>(visitor), _table);
+}
+
 template <typename It>
 inline BinTable::iterator::iterator(It it) noexcept : _it(it) {}
 
@@ -326,4 +351,26 @@ constexpr IteratorT &BinTable::iterator::get() {
 constexpr auto BinTable::iterator::get() const noexcept -> const IteratorVar & { return _it; }
 
 constexpr auto BinTable::iterator::get() noexcept -> IteratorVar & { return _it; }
+namespace internal {
+inline std::uint32_t find_chrom_id(const std::vector<std::uint64_t> &offsets, std::uint64_t bin_id,
+                                   std::uint32_t hint) {
+  assert(!offsets.empty());
+  if (hint + 1 < offsets.size() && offsets[hint] <= bin_id && bin_id < offsets[hint + 1]) {
+    return hint;
+  }
+
+  if (bin_id < offsets.front() || bin_id >= offsets.back()) {
+    throw std::out_of_range(
+        fmt::format(FMT_STRING("bin id {} is out of range: bin table has {} bins"), bin_id,
+                    offsets.back()));
+  }
+
+  // Offsets of chromosomes without bins (e.g. chromosome "All") are identical to the offset of the
+  // next chromosome: upper_bound makes sure we always pick the chromosome with at least one bin
+  const auto it = std::upper_bound(offsets.begin(), offsets.end(), bin_id);
+  assert(it != offsets.begin());
+  return static_cast<std::uint32_t>(std::distance(offsets.begin(), it) - 1);
+}
+}  // namespace internal
+
 }  // namespace hictk
@@ -50,6 +50,8 @@ inline BinTableVariable<I>::BinTableVariable(Reference chroms, const std::vector
                                "{} chromosomes, found {}."),
                     _chroms.size(), _num_bins_prefix_sum.size() - 1));
   }
+
+  build_bin_index();
 }
 
 template <typename I>
@@ -233,12 +235,12 @@ inline Bin BinTableVariable<I>::at(const Chromosome &chrom, std::uint32_t pos) c
 
 template <typename I>
 inline Bin BinTableVariable<I>::at(std::string_view chrom_name, std::uint32_t pos) const {
-  return at(map_to_bin_id(chrom_name, pos));
+  return at(_chroms.at(chrom_name), pos);
 }
 
 template <typename I>
 inline Bin BinTableVariable<I>::at(std::uint32_t chrom_id, std::uint32_t pos) const {
-  return at(map_to_bin_id(chrom_id, pos));
+  return at(_chroms.at(chrom_id), pos);
 }
 
 template <typename I>
@@ -251,6 +253,55 @@ inline std::pair<std::uint64_t, std::uint64_t> BinTableVariable<I>::map_to_bin_i
 template <typename I>
 inline std::uint64_t BinTableVariable<I>::map_to_bin_id(const Chromosome &chrom,
                                                         std::uint32_t pos) const {
+  return find_bin_id(genome_wide_pos(chrom, pos));
+}
+
+template <typename I>
+inline std::uint64_t BinTableVariable<I>::map_to_bin_id(std::string_view chrom_name,
+                                                        std::uint32_t pos) const {
+  return map_to_bin_id(_chroms.at(chrom_name), pos);
+}
+
+template <typename I>
+inline std::uint64_t BinTableVariable<I>::map_to_bin_id(std::uint32_t chrom_id,
+                                                        std::uint32_t pos) const {
+  return map_to_bin_id(_chroms.at(chrom_id), pos);
+}
+
+template <typename I>
+template <typename PosIt, typename OutputIt>
+inline OutputIt BinTableVariable<I>::map_to_bin_ids(const Chromosome &chrom, PosIt first_pos,
+                                                    PosIt last_pos, OutputIt out) const {
+  if (first_pos == last_pos) {
+    return out;
+  }
+
+  auto bin_end = [&](std::size_t i) {
+    return conditional_static_cast<std::uint64_t>(_bin_end_prefix_sum[i]);
+  };
+
+  auto bin_id = map_to_bin_id(chrom, conditional_static_cast<std::uint32_t>(*first_pos));
+  *out = bin_id;
+  for (++first_pos, ++out; first_pos != last_pos; ++first_pos, ++out) {
+    const auto pos = genome_wide_pos(chrom, conditional_static_cast<std::uint32_t>(*first_pos));
+    // Try the current and next bins before falling back to a regular lookup
+    if (bin_id + 1 < _bin_end_prefix_sum.size() && bin_end(bin_id) <= pos &&
+        pos < bin_end(bin_id + 1)) {
+      // pos overlaps the current bin
+    } else if (bin_id + 2 < _bin_end_prefix_sum.size() && bin_end(bin_id + 1) <= pos &&
+               pos < bin_end(bin_id + 2)) {
+      ++bin_id;
+    } else {
+      bin_id = find_bin_id(pos);
+    }
+    *out = bin_id;
+  }
+  return out;
+}
+
+template <typename I>
+inline std::uint64_t BinTableVariable<I>::genome_wide_pos(const Chromosome &chrom,
+                                                          std::uint32_t pos) const {
   // GCC8 fails to compile when using if constexpr instead #ifndef
   // See: https://github.com/fmtlib/fmt/issues/1455
 #ifndef NDEBUG
@@ -264,23 +315,59 @@ inline std::uint64_t BinTableVariable<I>::map_to_bin_id(const Chromosome &chrom,
         FMT_STRING("position is greater than chromosome size: {} >= {}"), pos, chrom.size()));
   }
 
-  const auto pos_offset = _chroms.chrom_size_prefix_sum()[chrom.id()];
-  auto match =
-      std::upper_bound(_bin_end_prefix_sum.begin(), _bin_end_prefix_sum.end(), pos + pos_offset);
-
-  return static_cast<std::uint64_t>(std::distance(_bin_end_prefix_sum.begin(), --match));
+  return pos + _chroms.chrom_size_prefix_sum()[chrom.id()];
 }
 
 template <typename I>
-inline std::uint64_t BinTableVariable<I>::map_to_bin_id(std::string_view chrom_name,
-                                                        std::uint32_t pos) const {
-  return map_to_bin_id(_chroms.at(chrom_name), pos);
+inline std::uint64_t BinTableVariable<I>::find_bin_id(std::uint64_t pos) const noexcept {
+  const auto bucket = pos >> _bin_index_shift;
+  if (pos < conditional_static_cast<std::uint64_t>(_bin_end_prefix_sum.front()) ||
+      bucket + 1 >= _bin_index.size()) {
+    auto match = std::upper_bound(_bin_end_prefix_sum.begin(), _bin_end_prefix_sum.end(), pos);
+    return static_cast<std::uint64_t>(std::distance(_bin_end_prefix_sum.begin(), --match));
+  }
+
+  // The bin overlapping pos lies between the bins overlapping the first position of the current
+  // and next buckets
+  const auto first_bin = _bin_index[bucket];
+  const auto last_bin =
+      std::min(_bin_index[bucket + 1] + 2, static_cast<std::uint64_t>(_bin_end_prefix_sum.size()));
+  const auto first = _bin_end_prefix_sum.begin() + static_cast<std::ptrdiff_t>(first_bin);
+  const auto last = _bin_end_prefix_sum.begin() + static_cast<std::ptrdiff_t>(last_bin);
+
+  auto match = std::upper_bound(first, last, pos);
+  assert(match != first);
+  return static_cast<std::uint64_t>(std::distance(_bin_end_prefix_sum.begin(), --match));
 }
 
 template <typename I>
-inline std::uint64_t BinTableVariable<I>::map_to_bin_id(std::uint32_t chrom_id,
-                                                        std::uint32_t pos) const {
-  return map_to_bin_id(_chroms.at(chrom_id), pos);
+inline void BinTableVariable<I>::build_bin_index() {
+  _bin_index.clear();
+  _bin_index_shift = 0;
+
+  const auto last_pos = conditional_static_cast<std::uint64_t>(_bin_end_prefix_sum.back());
+  if (empty() || last_pos == 0) {
+    return;
+  }
+
+  // Use buckets of 2^n bp, where 2^n is the largest power of two not exceeding the average bin
+  // size. This results in an index with at most ~2x as many buckets as bins
+  const auto avg_bin_size = std::max(last_pos / size(), std::uint64_t{1});
+  while ((std::uint64_t{2} << _bin_index_shift) <= avg_bin_size) {
+    ++_bin_index_shift;
+  }
+
+  const auto num_buckets = (last_pos >> _bin_index_shift) + 1;
+  _bin_index.resize(num_buckets);
+  std::uint64_t bin_id = 0;
+  for (std::uint64_t i = 0; i < num_buckets; ++i) {
+    const auto pos = i << _bin_index_shift;
+    while (bin_id + 1 < _bin_end_prefix_sum.size() &&
+           conditional_static_cast<std::uint64_t>(_bin_end_prefix_sum[bin_id + 1]) <= pos) {
+      ++bin_id;
+    }
+    _bin_index[i] = bin_id;
+  }
 }
 
 template <typename I>
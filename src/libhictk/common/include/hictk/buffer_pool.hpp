@@ -0,0 +1,80 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace hictk::internal {
+
+// Thread-safe pool of reusable buffers (e.g. vectors of pixels).
+// Buffers are handed out as std::shared_ptr: when the last reference to a buffer goes out of
+// scope, the buffer is cleared and returned to the pool instead of being deallocated, so that the
+// memory it owns can be recycled by the next call to acquire().
+// Buffers outliving their pool are simply deallocated.
+template <typename T>
+class BufferPool : public std::enable_shared_from_this<BufferPool<T>> {
+  mutable std::mutex _mtx{};
+  std::vector<std::unique_ptr<T>> _buffers{};
+  std::size_t _capacity{};
+
+  struct Token {};
+
+ public:
+  static constexpr std::size_t DEFAULT_CAPACITY{8};
+
+  // Use create() to construct new pools
+  BufferPool(Token, std::size_t capacity) : _capacity(capacity) {}
+
+  [[nodiscard]] static std::shared_ptr<BufferPool> create(
+      std::size_t capacity = DEFAULT_CAPACITY) {
+    return std::make_shared<BufferPool>(Token{}, capacity);
+  }
+
+  // Return the number of idle buffers
+  [[nodiscard]] std::size_t size() const {
+    const std::scoped_lock lck(_mtx);
+    return _buffers.size();
+  }
+
+  [[nodiscard]] std::shared_ptr<T> acquire() {
+    std::unique_ptr<T> buff{};
+    {
+      const std::scoped_lock lck(_mtx);
+      if (!_buffers.empty()) {
+        buff = std::move(_buffers.back());
+        _buffers.pop_back();
+      }
+    }
+    if (!buff) {
+      buff = std::make_unique<T>();
+    }
+
+    std::weak_ptr<BufferPool> pool = this->shared_from_this();
+    return {buff.release(), [pool = std::move(pool)](T* ptr) {
+              std::unique_ptr<T> buff_{ptr};
+              if (auto pool_ = pool.lock(); pool_) {
+                pool_->release(std::move(buff_));
+              }
+            }};
+  }
+
+ private:
+  void release(std::unique_ptr<T> buff) noexcept {
+    buff->clear();
+    const std::scoped_lock lck(_mtx);
+    if (_buffers.size() < _capacity) {
+      try {
+        _buffers.emplace_back(std::move(buff));
+      } catch (...) {  // NOLINT
+      }
+    }
+  }
+};
+
+}  // namespace hictk::internal
@@ -17,7 +17,9 @@ DISABLE_WARNING_POP
 
 #include <initializer_list>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <parallel_hashmap/phmap.h>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -32,7 +34,9 @@ DISABLE_WARNING_POP
 #include "hictk/cooler/dataset.hpp"
 #include "hictk/cooler/group.hpp"
 #include "hictk/cooler/index.hpp"
+#include "hictk/cooler/index_cache.hpp"
 #include "hictk/cooler/pixel_selector.hpp"
+#include "hictk/expected_values_table.hpp"
 #include "hictk/genomic_interval.hpp"
 #include "hictk/numeric_variant.hpp"
 #include "hictk/pixel.hpp"
@@ -94,10 +98,16 @@ class File {
   DatasetMap _datasets{};
   mutable balancing::WeightMap _weights{};
   mutable balancing::WeightMap _weights_scaled{};
+  using ExpectedValuesMap =
+      phmap::flat_hash_map<std::string, std::shared_ptr<const ExpectedValuesTable>>;
+  mutable ExpectedValuesMap _expected_values{};
   Attributes _attrs{Attributes::init(0)};
   NumericVariant _pixel_variant{};
   std::shared_ptr<const BinTable> _bins{};
+  // Files opened in read-only mode share their index with all other Files referring to the same
+  // Cooler (see internal::IndexCache). _index_mtx is used to synchronize updates to shared indexes
   mutable std::shared_ptr<Index> _index{};
+  std::shared_ptr<std::mutex> _index_mtx{};
   bool _finalize{false};
 
   // Private ctors
@@ -301,6 +311,18 @@ class File {
   void write_weights(std::string_view name, It first_weight, It last_weight,
                      bool overwrite_if_exists = false, bool divisive = false);
 
+  // Expected values are read from the expected/ group when available. Otherwise, they are
+  // computed with a single pass over the pixels (see ExpectedValuesTable::compute())
+  [[nodiscard]] std::shared_ptr<const ExpectedValuesTable> expected_values(
+      const balancing::Method &normalization_ = balancing::Method::NONE(),
+      std::size_t threads = 1) const;
+  [[nodiscard]] bool has_expected_values(const balancing::Method &normalization_) const;
+
+  static void write_expected_values(std::string_view uri, const balancing::Method &normalization_,
+                                    std::size_t threads = 1, bool overwrite_if_exists = false);
+  void write_expected_values(const balancing::Method &normalization_,
+                             const ExpectedValuesTable &expected, bool overwrite_if_exists = false);
+
   void validate_bins(bool full = false) const;
 
  private:
@@ -310,6 +332,12 @@ class File {
   [[nodiscard]] static HighFive::File open_file(std::string_view uri, unsigned int mode,
                                                 bool validate);
 
+  [[nodiscard]] auto read_expected_values(const balancing::Method &normalization_) const
+      -> std::shared_ptr<const ExpectedValuesTable>;
+  [[nodiscard]] auto compute_expected_values(const balancing::Method &normalization_,
+                                             std::size_t threads) const
+      -> std::shared_ptr<const ExpectedValuesTable>;
+
   [[nodiscard]] static auto open_or_create_root_group(HighFive::File f, std::string_view uri)
       -> RootGroup;
 
@@ -345,6 +373,11 @@ class File {
                                         const Dataset &bin_offset_dset,
                                         std::shared_ptr<const BinTable> bin_table,
                                         std::uint64_t expected_nnz, bool missing_ok);
+  // The bin table is only read when the index is not found in internal::IndexCache: the bin table
+  // of a shared index is in turn shared by all Files using the index
+  [[nodiscard]] static auto init_shared_index(const RootGroup &root_group,
+                                              const DatasetMap &dsets, const Attributes &attrs)
+      -> std::shared_ptr<internal::SharedIndex>;
   void read_index_chunk(std::initializer_list<Chromosome> chroms) const;
 
   template <typename PixelIt>
@@ -43,13 +43,23 @@ inline File::File(RootGroup entrypoint, unsigned int mode, std::size_t cache_siz
       _groups(open_groups(_root_group)),
       _datasets(open_datasets(_root_group, cache_size_bytes, w0)),
       _attrs(read_standard_attributes(_root_group)),
-      _pixel_variant(detect_pixel_type(_root_group)),
-      _bins(std::make_shared<BinTable>(
-          init_bin_table(_datasets, _attrs.bin_type.value(), _attrs.bin_size))),
-      _index(std::make_shared<Index>(init_index(_datasets.at("indexes/chrom_offset"),
-                                                _datasets.at("indexes/bin1_offset"), _bins,
-                                                _datasets.at("pixels/count").size(), false))) {
+      _pixel_variant(detect_pixel_type(_root_group)) {
   assert(mode == HighFive::File::ReadOnly || mode == HighFive::File::ReadWrite);
+  if (mode == HighFive::File::ReadOnly) {
+    // the bin table is only read when the index is not already cached
+    auto idx = init_shared_index(_root_group, _datasets, _attrs);
+    // aliasing ctors: both pointers keep the SharedIndex alive
+    _index = std::shared_ptr<Index>(idx, &idx->index);
+    _index_mtx = std::shared_ptr<std::mutex>(idx, &idx->mtx);
+    // the bin table is shared as well
+    _bins = _index->bins_ptr();
+  } else {
+    _bins = std::make_shared<const BinTable>(
+        init_bin_table(_datasets, _attrs.bin_type.value(), _attrs.bin_size));
+    _index = std::make_shared<Index>(init_index(_datasets.at("indexes/chrom_offset"),
+                                                _datasets.at("indexes/bin1_offset"), _bins,
+                                                _datasets.at("pixels/count").size(), false));
+  }
   if (validate) {
     validate_bins();
   }
@@ -17,6 +17,7 @@
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -34,8 +35,10 @@
 #include "hictk/cooler/dataset.hpp"
 #include "hictk/cooler/group.hpp"
 #include "hictk/cooler/index.hpp"
+#include "hictk/cooler/index_cache.hpp"
 #include "hictk/cooler/pixel_selector.hpp"
 #include "hictk/cooler/uri.hpp"
+#include "hictk/expected_values_table.hpp"
 #include "hictk/genomic_interval.hpp"
 #include "hictk/pixel.hpp"
 #include "hictk/reference.hpp"
@@ -327,6 +330,82 @@ inline bool File::purge_weights(std::string_view name) {
   return _weights.erase(std::string{name});
 }
 
+inline std::shared_ptr<const ExpectedValuesTable> File::expected_values(
+    const balancing::Method &normalization_, std::size_t threads) const {
+  const auto key = normalization_.to_string();
+  if (const auto it = _expected_values.find(key); it != _expected_values.end()) {
+    return it->second;
+  }
+
+  auto expected = has_expected_values(normalization_)
+                      ? read_expected_values(normalization_)
+                      : compute_expected_values(normalization_, threads);
+  return _expected_values.emplace(key, std::move(expected)).first->second;
+}
+
+inline bool File::has_expected_values(const balancing::Method &normalization_) const {
+  return _root_group().exist(fmt::format(FMT_STRING("expected/{}"), normalization_.to_string()));
+}
+
+inline auto File::read_expected_values(const balancing::Method &normalization_) const
+    -> std::shared_ptr<const ExpectedValuesTable> {
+  const auto path = fmt::format(FMT_STRING("expected/{}"), normalization_.to_string());
+
+  const auto cis_offsets = Dataset{_root_group, fmt::format(FMT_STRING("{}/cis/offsets"), path)}
+                               .read_all<std::vector<std::uint64_t>>();
+  const auto cis_values = Dataset{_root_group, fmt::format(FMT_STRING("{}/cis/values"), path)}
+                              .read_all<std::vector<double>>();
+
+  if (cis_offsets.size() != chromosomes().size() + 1 || cis_offsets.back() != cis_values.size()) {
+    throw std::runtime_error(fmt::format(
+        FMT_STRING("unable to read \"{}\" expected values: \"{}/cis\" is corrupted"),
+        normalization_.to_string(), path));
+  }
+
+  std::vector<std::vector<double>> cis(chromosomes().size());
+  for (std::size_t i = 0; i < cis.size(); ++i) {
+    const auto first = cis_values.begin() + static_cast<std::ptrdiff_t>(cis_offsets[i]);
+    const auto last = cis_values.begin() + static_cast<std::ptrdiff_t>(cis_offsets[i + 1]);
+    cis[i].assign(first, last);
+  }
+
+  const auto chrom1_ids = Dataset{_root_group, fmt::format(FMT_STRING("{}/trans/chrom1_id"), path)}
+                              .read_all<std::vector<std::uint32_t>>();
+  const auto chrom2_ids = Dataset{_root_group, fmt::format(FMT_STRING("{}/trans/chrom2_id"), path)}
+                              .read_all<std::vector<std::uint32_t>>();
+  const auto trans_values = Dataset{_root_group, fmt::format(FMT_STRING("{}/trans/values"), path)}
+                                .read_all<std::vector<double>>();
+
+  if (chrom1_ids.size() != trans_values.size() || chrom2_ids.size() != trans_values.size()) {
+    throw std::runtime_error(fmt::format(
+        FMT_STRING("unable to read \"{}\" expected values: \"{}/trans\" is corrupted"),
+        normalization_.to_string(), path));
+  }
+
+  ExpectedValuesTable::TransMap trans(trans_values.size());
+  for (std::size_t i = 0; i < trans_values.size(); ++i) {
+    trans.emplace(std::make_pair(chrom1_ids[i], chrom2_ids[i]), trans_values[i]);
+  }
+
+  return std::make_shared<const ExpectedValuesTable>(_bins, std::move(cis), std::move(trans));
+}
+
+inline auto File::compute_expected_values(const balancing::Method &normalization_,
+                                          std::size_t threads) const
+    -> std::shared_ptr<const ExpectedValuesTable> {
+  // HDF5 is not thread-safe: pixels are always read by the calling thread
+  auto weights = normalization(normalization_);
+  const auto sel = fetch();
+  if (!weights) {
+    return std::make_shared<const ExpectedValuesTable>(
+        ExpectedValuesTable::compute(_bins, sel.begin<double>(), sel.end<double>(), threads));
+  }
+
+  return std::make_shared<const ExpectedValuesTable>(ExpectedValuesTable::compute(
+      _bins, sel.begin<double>(), sel.end<double>(), threads,
+      [w = std::move(weights)](const ThinPixel<double> &p) { return w->balance(p); }));
+}
+
 inline auto File::open_root_group(const HighFive::File &f, std::string_view uri) -> RootGroup {
   [[maybe_unused]] HighFive::SilenceHDF5 silencer{};  // NOLINT
   RootGroup grp{f.getGroup(parse_cooler_uri(uri).group_path)};
@@ -582,11 +661,35 @@ inline Index File::init_index(const Dataset &chrom_offset_dset, const Dataset &b
   }
 }
 
+inline auto File::init_shared_index(const RootGroup &root_group, const DatasetMap &dsets,
+                                    const Attributes &attrs)
+    -> std::shared_ptr<internal::SharedIndex> {
+  auto init = [&]() {
+    auto bin_table = std::make_shared<const BinTable>(
+        init_bin_table(dsets, attrs.bin_type.value(), attrs.bin_size));
+    return init_index(dsets.at("indexes/chrom_offset"), dsets.at("indexes/bin1_offset"),
+                      std::move(bin_table), dsets.at("pixels/count").size(), false);
+  };
+
+  const auto key = internal::IndexCache::make_key(root_group.file_name(), root_group.hdf5_path());
+  if (key.empty()) {
+    return std::make_shared<internal::SharedIndex>(init());
+  }
+  return internal::IndexCache::instance().get_or_emplace(key, init);
+}
+
 inline void File::read_index_chunk(std::initializer_list<Chromosome> chroms) const {
   assert(_index);
+  std::unique_lock<std::mutex> lck{};
+  if (_index_mtx) {
+    lck = std::unique_lock(*_index_mtx);
+  }
+  const auto &bin_offsets = bins().num_bin_prefix_sum();
   try {
     for (const auto &chrom : chroms) {
-      if (_index->size(chrom.id()) != 1) {
+      // offsets for chromosomes with a single bin are already known
+      const auto num_bins = bin_offsets[chrom.id() + 1] - bin_offsets[chrom.id()];
+      if (_index->size(chrom.id()) != 1 || num_bins == 1) {
         continue;
       }
 
@@ -22,7 +22,9 @@
 #include <type_traits>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include "hictk/balancing/methods.hpp"
 #include "hictk/bin_table.hpp"
 #include "hictk/chromosome.hpp"
 #include "hictk/common.hpp"
@@ -31,6 +33,7 @@
 #include "hictk/cooler/group.hpp"
 #include "hictk/cooler/index.hpp"
 #include "hictk/cooler/uri.hpp"
+#include "hictk/expected_values_table.hpp"
 #include "hictk/pixel.hpp"
 #include "hictk/type_traits.hpp"
 
@@ -192,6 +195,85 @@ inline void File::write_weights(std::string_view name, It first_weight, It last_
   dset.write_attribute("divisive_weights", std::uint8_t(divisive), overwrite_if_exists);
 }
 
+inline void File::write_expected_values(std::string_view uri,
+                                        const balancing::Method &normalization_,
+                                        std::size_t threads, bool overwrite_if_exists) {
+  File f(open_or_create_root_group(open_file(uri, HighFive::File::ReadWrite, true), uri),
+         HighFive::File::ReadWrite, DEFAULT_HDF5_CACHE_SIZE * 4, DEFAULT_HDF5_CACHE_W0, true);
+  if (!overwrite_if_exists && f.has_expected_values(normalization_)) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("group \"expected/{}\" already exists"), normalization_));
+  }
+
+  const auto expected = f.compute_expected_values(normalization_, threads);
+  f.write_expected_values(normalization_, *expected, overwrite_if_exists);
+}
+
+inline void File::write_expected_values(const balancing::Method &normalization_,
+                                        const ExpectedValuesTable &expected,
+                                        bool overwrite_if_exists) {
+  if (_mode == HighFive::File::ReadOnly) {
+    throw std::runtime_error(
+        "File::write_expected_values() was called on a file open in read-only mode");
+  }
+
+  if (expected.bins() != bins()) {
+    throw std::runtime_error(
+        "unable to write expected values: expected values were computed on a different bin table");
+  }
+
+  const auto path = fmt::format(FMT_STRING("expected/{}"), normalization_.to_string());
+  if (has_expected_values(normalization_)) {
+    if (!overwrite_if_exists) {
+      throw std::runtime_error(fmt::format(FMT_STRING("group \"{}\" already exists"), path));
+    }
+    _root_group().unlink(path);
+  }
+  _expected_values.erase(normalization_.to_string());
+
+  // Cis expected values are stored as a single vector of values together with a vector of
+  // offsets, where the values for the i-th chromosome are found in [offsets[i], offsets[i + 1])
+  std::vector<std::uint64_t> cis_offsets{0};
+  std::vector<double> cis_values{};
+  for (const auto &chrom : chromosomes()) {
+    const auto &values = expected.cis(chrom);
+    cis_values.insert(cis_values.end(), values.begin(), values.end());
+    cis_offsets.push_back(cis_values.size());
+  }
+
+  // Trans expected values are stored in COO format, sorted by chromosome IDs
+  std::vector<std::pair<ExpectedValuesTable::TransMap::key_type, double>> trans(
+      expected.trans().begin(), expected.trans().end());
+  std::sort(trans.begin(), trans.end());
+
+  std::vector<std::uint32_t> chrom1_ids(trans.size());
+  std::vector<std::uint32_t> chrom2_ids(trans.size());
+  std::vector<double> trans_values(trans.size());
+  for (std::size_t i = 0; i < trans.size(); ++i) {
+    chrom1_ids[i] = trans[i].first.first;
+    chrom2_ids[i] = trans[i].first.second;
+    trans_values[i] = trans[i].second;
+  }
+
+  auto write_dataset = [&](std::string_view name, const auto &buff) {
+    using T = typename remove_cvref_t<decltype(buff)>::value_type;
+    Dataset dset(_root_group, fmt::format(FMT_STRING("{}/{}"), path, name), T{},
+                 HighFive::DataSpace::UNLIMITED);
+    dset.resize(buff.size());
+    if (!buff.empty()) {
+      dset.write(buff.begin(), buff.end());
+    }
+  };
+
+  _root_group().createGroup(fmt::format(FMT_STRING("{}/cis"), path));
+  _root_group().createGroup(fmt::format(FMT_STRING("{}/trans"), path));
+  write_dataset("cis/offsets", cis_offsets);
+  write_dataset("cis/values", cis_values);
+  write_dataset("trans/chrom1_id", chrom1_ids);
+  write_dataset("trans/chrom2_id", chrom2_ids);
+  write_dataset("trans/values", trans_values);
+}
+
 inline auto File::create_root_group(HighFive::File &f, std::string_view uri,
                                     bool write_sentinel_attr) -> RootGroup {
   [[maybe_unused]] HighFive::SilenceHDF5 silencer{};  // NOLINT
@@ -0,0 +1,86 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace hictk::cooler::internal {
+
+inline IndexCache &IndexCache::instance() {
+  static IndexCache cache{};
+  return cache;
+}
+
+template <typename IndexFactory>
+inline std::shared_ptr<SharedIndex> IndexCache::get_or_emplace(const std::string &key,
+                                                               IndexFactory &&init_index) {
+  const std::scoped_lock lck(_mtx);
+  if (auto match = _indexes.find(key); match != _indexes.end()) {
+    if (auto idx = match->second.lock(); idx) {
+      return idx;
+    }
+  }
+
+  // this is a good time to get rid of indexes that are no longer in use
+  purge_expired_entries();
+
+  auto idx = std::make_shared<SharedIndex>(init_index());
+  _indexes.insert_or_assign(key, idx);
+  return idx;
+}
+
+inline std::size_t IndexCache::size() {
+  const std::scoped_lock lck(_mtx);
+  purge_expired_entries();
+  return _indexes.size();
+}
+
+inline void IndexCache::clear() {
+  const std::scoped_lock lck(_mtx);
+  _indexes.clear();
+}
+
+inline std::string IndexCache::make_key(const std::string &file_name,
+                                        const std::string &hdf5_path) noexcept {
+  try {
+    std::error_code ec{};
+    const auto path = std::filesystem::weakly_canonical(file_name, ec);
+    if (ec) {
+      return "";
+    }
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+      return "";
+    }
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+      return "";
+    }
+    return fmt::format(FMT_STRING("{}::{}:{}:{}"), path.string(), hdf5_path, size,
+                       mtime.time_since_epoch().count());
+  } catch (...) {  // NOLINT
+    return "";
+  }
+}
+
+inline void IndexCache::purge_expired_entries() {
+  for (auto it = _indexes.begin(); it != _indexes.end();) {
+    if (it->second.expired()) {
+      _indexes.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace hictk::cooler::internal
@@ -4,6 +4,10 @@
 
 #pragma once
 
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include <spdlog/spdlog.h>
+
 #include <algorithm>
 #include <cassert>
 #include <chrono>
@@ -15,9 +19,11 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "hictk/bin_table.hpp"
 #include "hictk/common.hpp"
 #include "hictk/cooler/attribute.hpp"
 #include "hictk/cooler/cooler.hpp"
@@ -30,6 +36,189 @@
 
 namespace hictk::cooler {
 
+namespace internal {
+
+template <typename N>
+inline CoarsenCascade<N>::CoarsenCascade(const BinTable& base_bins, std::vector<File> levels,
+                                         std::size_t max_buffered_pixels)
+    : _base_offsets(base_bins.num_bin_prefix_sum()),
+      // each level owns a row buffer and a write buffer
+      _buffer_capacity(std::max(
+          std::size_t(1), max_buffered_pixels / (2 * std::max(std::size_t(1), levels.size())))) {
+  if (!base_bins.has_fixed_resolution()) {
+    throw std::runtime_error("coarsening bin tables with variable bin size is not supported");
+  }
+
+  const auto base_resolution = base_bins.resolution();
+  _levels.reserve(levels.size());
+  for (auto& clr : levels) {
+    const auto resolution = clr.resolution();
+    if (resolution <= base_resolution || resolution % base_resolution != 0) {
+      throw std::runtime_error(
+          fmt::format(FMT_STRING("resolution {} is not a multiple of base resolution {}"),
+                      resolution, base_resolution));
+    }
+
+    if (!_levels.empty() && _levels.back().clr.resolution() >= resolution) {
+      throw std::runtime_error("resolutions should be unique and sorted in ascending order");
+    }
+
+    Level level{};
+    // Coarsen pixels from the coarsest level that is a divisor of the current resolution
+    auto src_resolution = base_resolution;
+    for (std::size_t i = _levels.size(); i > 0; --i) {
+      const auto res = _levels[i - 1].clr.resolution();
+      if (res < resolution && resolution % res == 0) {
+        level.parent = i - 1;
+        src_resolution = res;
+        break;
+      }
+    }
+
+    level.factor = resolution / src_resolution;
+    level.offsets = clr.bins().num_bin_prefix_sum();
+    level.clr = std::move(clr);
+    level.row_buffer_capacity = _buffer_capacity;
+    level.write_buffer.reserve(std::min(_buffer_capacity, std::size_t(1'000'000)));
+
+    SPDLOG_INFO(FMT_STRING("generating {} resolution from {} ({}x)"), resolution, src_resolution,
+                level.factor);
+
+    if (level.parent == NO_PARENT) {
+      _roots.push_back(_levels.size());
+    } else {
+      _levels[level.parent].children.push_back(_levels.size());
+    }
+    _levels.emplace_back(std::move(level));
+  }
+}
+
+template <typename N>
+inline void CoarsenCascade<N>::add(const ThinPixel<N>& pixel) {
+  for (const auto& i : _roots) {
+    push(i, pixel);
+  }
+}
+
+template <typename N>
+inline std::vector<File> CoarsenCascade<N>::finalize() {
+  // Levels are sorted by resolution, so parents are always flushed before their children
+  for (std::size_t i = 0; i < _levels.size(); ++i) {
+    flush_row(i);
+  }
+
+  std::vector<File> files{};
+  for (auto& level : _levels) {
+    flush_write_buffer(level);
+    files.emplace_back(std::move(level.clr));
+  }
+  _levels.clear();
+  _roots.clear();
+
+  return files;
+}
+
+template <typename N>
+inline void CoarsenCascade<N>::push(std::size_t level_idx, const ThinPixel<N>& pixel) {
+  auto& level = _levels[level_idx];
+  const auto& offsets = src_offsets(level);
+
+  // We need to map bin ids to the corresponding chromosome instead of just dividing bin ids by the
+  // coarsening factor to avoid mapping the last bin in chromosome i and the first bin in chromosome
+  // i+1 to the same coarse bin
+  level.chrom1_id = hictk::internal::find_chrom_id(offsets, pixel.bin1_id, level.chrom1_id);
+  level.chrom2_id = hictk::internal::find_chrom_id(offsets, pixel.bin2_id, level.chrom2_id);
+
+  const auto bin1_id =
+      level.offsets[level.chrom1_id] + (pixel.bin1_id - offsets[level.chrom1_id]) / level.factor;
+  const auto bin2_id =
+      level.offsets[level.chrom2_id] + (pixel.bin2_id - offsets[level.chrom2_id]) / level.factor;
+
+  if (bin1_id != level.row) {
+    flush_row(level_idx);
+    level.row = bin1_id;
+  }
+
+  auto& row = level.row_buffer;
+  if (!row.empty() && row.back().bin2_id == bin2_id) {
+    row.back().count += pixel.count;
+  } else {
+    row.push_back(ThinPixel<N>{bin1_id, bin2_id, pixel.count});
+  }
+
+  if (row.size() >= level.row_buffer_capacity) {
+    compact_row(row);
+    // Make sure compacting rows with many non-zero pixels does not become quadratic
+    level.row_buffer_capacity = std::max(_buffer_capacity, 2 * row.size());
+  }
+}
+
+template <typename N>
+inline void CoarsenCascade<N>::flush_row(std::size_t level_idx) {
+  auto& level = _levels[level_idx];
+  auto& row = level.row_buffer;
+  if (row.empty()) {
+    return;
+  }
+
+  compact_row(row);
+  for (const auto& pixel : row) {
+    level.write_buffer.push_back(pixel);
+    if (level.write_buffer.size() >= _buffer_capacity) {
+      flush_write_buffer(level);
+    }
+    for (const auto& child : level.children) {
+      push(child, pixel);
+    }
+  }
+
+  row.clear();
+  if (level.row_buffer_capacity > _buffer_capacity) {
+    // release the memory used by rows with an unusually large number of non-zero pixels
+    row.shrink_to_fit();
+    level.row_buffer_capacity = _buffer_capacity;
+  }
+}
+
+template <typename N>
+inline void CoarsenCascade<N>::compact_row(std::vector<ThinPixel<N>>& row) {
+  assert(!row.empty());
+  // Pixels in the row buffer are sorted by bin2_id only within each row of the source matrix
+  std::sort(row.begin(), row.end(), [](const ThinPixel<N>& p1, const ThinPixel<N>& p2) {
+    return p1.bin2_id < p2.bin2_id;
+  });
+
+  // aggregate pixels with the same coordinates in place
+  auto dest = row.begin();
+  for (auto it = row.begin() + 1; it != row.end(); ++it) {
+    if (it->bin2_id == dest->bin2_id) {
+      dest->count += it->count;
+    } else {
+      *++dest = *it;
+    }
+  }
+  row.erase(dest + 1, row.end());
+}
+
+template <typename N>
+inline void CoarsenCascade<N>::flush_write_buffer(Level& level) {
+  if (!level.write_buffer.empty()) {
+    level.clr.append_pixels(level.write_buffer.begin(), level.write_buffer.end());
+    level.write_buffer.clear();
+  }
+}
+
+template <typename N>
+inline const std::vector<std::uint64_t>& CoarsenCascade<N>::src_offsets(
+    const Level& level) const noexcept {
+  if (level.parent == NO_PARENT) {
+    return _base_offsets;
+  }
+  return _levels[level.parent].offsets;
+}
+
+}  // namespace internal
+
 inline bool MultiResAttributes::operator==(const MultiResAttributes& other) const noexcept {
   return format == other.format && format_version == other.format_version &&
          bin_type == other.bin_type;
@@ -99,25 +288,13 @@ inline MultiResFile MultiResFile::create(const std::filesystem::path& path, cons
   SPDLOG_INFO(FMT_STRING("Copying {} resolution from \"{}\""), base_res, base.path());
   mclr.copy_resolution(base);
 
-  std::vector<ThinPixel<std::int32_t>> buffer{500'000};
-  for (std::size_t i = 1; i < resolutions_.size(); ++i) {
-    const auto tgt_resolution = resolutions_[i];
-    const auto base_resolution = compute_base_resolution(mclr._resolutions, tgt_resolution);
-
-    auto attributes = base.has_float_pixels() ? Attributes::init<double>(tgt_resolution)
-                                              : Attributes::init<std::int32_t>(tgt_resolution);
-    attributes.assembly = base.attributes().assembly;
-    auto clr =
-        base.has_float_pixels()
-            ? File::create<double>(mclr.init_resolution(tgt_resolution), base.chromosomes(),
-                                   tgt_resolution, attributes, DEFAULT_HDF5_CACHE_SIZE)
-            : File::create<std::int32_t>(mclr.init_resolution(tgt_resolution), base.chromosomes(),
-                                         tgt_resolution, attributes, DEFAULT_HDF5_CACHE_SIZE);
-    SPDLOG_INFO(FMT_STRING("Generating {} resolution from {} ({}x)"), tgt_resolution,
-                base_resolution, tgt_resolution / base_resolution);
-
-    MultiResFile::coarsen(mclr.open(base_res), clr, buffer);
-    mclr._resolutions.push_back(tgt_resolution);
+  resolutions_.erase(std::remove(resolutions_.begin(), resolutions_.end(), base_res),
+                     resolutions_.end());
+  if (base.has_float_pixels()) {
+    mclr.create_resolutions<double>(mclr.open(base_res), resolutions_.begin(), resolutions_.end());
+  } else {
+    mclr.create_resolutions<std::int32_t>(mclr.open(base_res), resolutions_.begin(),
+                                          resolutions_.end());
   }
 
   return mclr;
@@ -171,6 +348,72 @@ inline File MultiResFile::create_resolution(std::uint32_t resolution, Attributes
   return open(resolution);
 }
 
+template <typename N, typename ResolutionIt>
+inline void MultiResFile::create_resolutions(const File& base, ResolutionIt first_res,
+                                             ResolutionIt last_res,
+                                             std::size_t max_buffered_pixels,
+                                             std::uint32_t compression_lvl) {
+  std::vector<std::uint32_t> resolutions_{first_res, last_res};
+  std::sort(resolutions_.begin(), resolutions_.end());
+  resolutions_.erase(std::unique(resolutions_.begin(), resolutions_.end()), resolutions_.end());
+  if (resolutions_.empty()) {
+    return;
+  }
+
+  const auto base_resolution = base.resolution();
+  for (const auto& res : resolutions_) {
+    if (res <= base_resolution || res % base_resolution != 0) {
+      throw std::runtime_error(
+          fmt::format(FMT_STRING("resolution {} is not a multiple of base resolution {}"), res,
+                      base_resolution));
+    }
+  }
+
+  SPDLOG_INFO(FMT_STRING("generating {} resolutions from {} with a single pass"),
+              resolutions_.size(), base.uri());
+
+  std::vector<File> levels{};
+  for (const auto& res : resolutions_) {
+    auto attributes = Attributes::init<N>(res);
+    attributes.assembly = base.attributes().assembly;
+    levels.emplace_back(File::create<N>(init_resolution(res), base.chromosomes(), res, attributes,
+                                        DEFAULT_HDF5_CACHE_SIZE, compression_lvl));
+  }
+
+  internal::CoarsenCascade<N> cascade(base.bins(), std::move(levels), max_buffered_pixels);
+
+  const auto update_frequency =
+      std::max(std::size_t(1'000'000), (base.dataset("pixels/bin1_id").size() / 100));
+
+  const auto sel = base.fetch();
+  auto first = sel.begin<N>();
+  const auto last = sel.end<N>();
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t j = 0; first != last; ++j, ++first) {
+    cascade.add(*first);
+    if (j == update_frequency) {
+      const auto t1 = std::chrono::steady_clock::now();
+      const auto delta =
+          static_cast<double>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()) /
+          1000.0;
+      const auto bin1 = base.bins().at(first->bin1_id);
+      SPDLOG_INFO(FMT_STRING("[{} -> {}] processing {:ucsc} at {:.0f} pixels/s..."),
+                  base.resolution(), fmt::join(resolutions_, ", "), bin1,
+                  double(update_frequency) / delta);
+      t0 = t1;
+      j = 0;
+    }
+  }
+
+  // Close all Files before registering the new resolutions
+  std::ignore = cascade.finalize();
+
+  _resolutions.insert(_resolutions.end(), resolutions_.begin(), resolutions_.end());
+  std::sort(_resolutions.begin(), _resolutions.end());
+}
+
 inline RootGroup MultiResFile::init_resolution(std::uint32_t resolution) {
   const auto grp = fmt::format(FMT_STRING("/resolutions/{}"), resolution);
   return RootGroup{(*_root_grp)().createGroup(grp, false)};
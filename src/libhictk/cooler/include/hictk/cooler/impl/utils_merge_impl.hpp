@@ -6,12 +6,15 @@
 
 #include <spdlog/spdlog.h>
 
+#include <BS_thread_pool.hpp>
 #include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <exception>
+#include <future>
 #include <iterator>
 #include <stdexcept>
 #include <string>
@@ -20,8 +23,11 @@
 #include <utility>
 #include <vector>
 
+#include "hictk/bin_table.hpp"
+#include "hictk/common.hpp"
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/cooler/pixel_selector.hpp"
+#include "hictk/pixel.hpp"
 #include "hictk/reference.hpp"
 #include "hictk/transformers/pixel_merger.hpp"
 
@@ -85,12 +91,146 @@ inline void validate_chromosomes(const std::vector<LightCooler<N>>& coolers) {
   }
 }
 
+// Split the bin table into ranges of rows (i.e. bin1_ids) such that each range overlaps roughly
+// target_num_pixels pixels across all coolers.
+// The number of pixels overlapping each row is computed using the bin1_offset index of each cooler.
+// Returns the bin1_id boundaries of each range (i.e. [0, bin1_id_1, ..., num_bins]).
+template <typename N>
+[[nodiscard]] inline std::vector<std::uint64_t> partition_bin_table(
+    const std::vector<LightCooler<N>>& coolers, std::size_t num_bins,
+    std::size_t target_num_pixels) {
+  std::vector<std::uint64_t> row_nnz(num_bins, 0);
+  std::vector<std::uint64_t> bin1_offsets{};
+  for (const auto& clr : coolers) {
+    File::open_read_once(clr.uri).dataset("indexes/bin1_offset").read_all(bin1_offsets);
+    if (bin1_offsets.size() != num_bins + 1) {
+      throw std::runtime_error(
+          fmt::format(FMT_STRING("cooler \"{}\" has a corrupted or incomplete bin1_offset index"),
+                      clr.uri));
+    }
+    for (std::size_t i = 0; i < num_bins; ++i) {
+      row_nnz[i] += bin1_offsets[i + 1] - bin1_offsets[i];
+    }
+  }
+
+  std::vector<std::uint64_t> boundaries{0};
+  std::uint64_t nnz = 0;
+  for (std::size_t i = 0; i < num_bins; ++i) {
+    nnz += row_nnz[i];
+    if (nnz >= target_num_pixels) {
+      boundaries.push_back(i + 1);
+      nnz = 0;
+    }
+  }
+  if (boundaries.back() != num_bins) {
+    boundaries.push_back(num_bins);
+  }
+  return boundaries;
+}
+
+template <typename N>
+[[nodiscard]] inline std::vector<ThinPixel<N>> merge_partition(
+    const std::vector<std::vector<ThinPixel<N>>>& chunks) {
+  using PixelIt = typename std::vector<ThinPixel<N>>::const_iterator;
+  std::vector<PixelIt> heads{};
+  std::vector<PixelIt> tails{};
+  for (const auto& chunk : chunks) {
+    heads.emplace_back(chunk.begin());
+    tails.emplace_back(chunk.end());
+  }
+  return hictk::transformers::PixelMerger<PixelIt>{heads, tails}.read_all();
+}
+
+// Merge coolers by splitting the bin table into ranges of rows that are merged in parallel.
+// HDF5 is not thread-safe: pixels are thus read from the input coolers and written to the output
+// cooler by the calling thread, while worker threads take care of merging interactions
+// overlapping each range of rows into sorted runs of pixels.
+// Runs are appended to the output cooler in order.
+template <typename N>
+inline void merge_parallel(std::vector<LightCooler<N>>& coolers, const BinTable& bins,
+                           std::string_view dest_uri, std::string_view assembly,
+                           bool overwrite_if_exists, std::size_t chunk_size,
+                           std::size_t update_frequency, std::uint32_t compression_lvl,
+                           std::size_t threads) {
+  assert(threads > 1);
+  using PixelBuffer = std::vector<ThinPixel<N>>;
+
+  // the total number of pixels held in memory is roughly 2 * chunk_size
+  const auto num_workers = threads - 1;
+  const auto boundaries =
+      partition_bin_table(coolers, bins.size(), std::max(std::size_t(1), chunk_size / threads));
+  const auto max_pending_runs = num_workers + 1;
+
+  auto attrs = Attributes::init(bins.resolution());
+  attrs.assembly = assembly;
+
+  auto dest = File::create<N>(dest_uri, bins, overwrite_if_exists, attrs,
+                              DEFAULT_HDF5_CACHE_SIZE * 4, compression_lvl);
+
+  BS::thread_pool tpool(conditional_static_cast<BS::concurrency_t>(num_workers));
+  std::deque<std::future<PixelBuffer>> runs{};
+
+  std::size_t pixels_processed{};
+  auto t0 = std::chrono::steady_clock::now();
+  auto write_next_run = [&]() {
+    assert(!runs.empty());
+    const auto run = runs.front().get();
+    runs.pop_front();
+    if (run.empty()) {
+      return;
+    }
+    dest.append_pixels(run.begin(), run.end());
+    pixels_processed += run.size();
+
+    if (pixels_processed >= update_frequency) {
+      const auto bin1 = dest.bins().at(run.back().bin1_id);
+      const auto t1 = std::chrono::steady_clock::now();
+      const auto delta =
+          static_cast<double>(
+              std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()) /
+          1000.0;
+      SPDLOG_INFO(FMT_STRING("processing {:ucsc} at {:.0f} pixels/s..."), bin1,
+                  double(pixels_processed) / delta);
+      t0 = t1;
+      pixels_processed = 0;
+    }
+  };
+
+  for (std::size_t i = 1; i < boundaries.size(); ++i) {
+    const auto bin1_id_last = boundaries[i];
+    std::vector<PixelBuffer> chunks{};
+    for (auto& clr : coolers) {
+      PixelBuffer chunk{};
+      for (; clr.first_pixel != clr.last_pixel && clr.first_pixel->bin1_id < bin1_id_last;
+           ++clr.first_pixel) {
+        chunk.emplace_back(*clr.first_pixel);
+      }
+      if (!chunk.empty()) {
+        chunks.emplace_back(std::move(chunk));
+      }
+    }
+
+    runs.emplace_back(tpool.submit_task(
+        [chunks = std::move(chunks)]() { return merge_partition<N>(chunks); }));
+
+    while (runs.size() > max_pending_runs ||
+           (!runs.empty() &&
+            runs.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+      write_next_run();
+    }
+  }
+
+  while (!runs.empty()) {
+    write_next_run();
+  }
+}
+
 }  // namespace internal
 
 template <typename N, typename Str>
 inline void merge(Str first_uri, Str last_uri, std::string_view dest_uri, bool overwrite_if_exists,
                   std::size_t chunk_size, std::size_t update_frequency,
-                  std::uint32_t compression_lvl) {
+                  std::uint32_t compression_lvl, std::size_t threads) {
   static_assert(std::is_constructible_v<std::string, decltype(*first_uri)>);
   assert(chunk_size != 0);
   try {
@@ -106,6 +246,15 @@ inline void merge(Str first_uri, Str last_uri, std::string_view dest_uri, bool o
     internal::validate_chromosomes(clrs);
     internal::validate_bin_size(clrs);
 
+    const auto assembly = File(*first_uri).attributes().assembly;
+
+    if (threads > 1) {
+      internal::merge_parallel(clrs, cooler::File(clrs.front().uri).bins(), dest_uri,
+                               assembly.has_value() ? *assembly : "unknown", overwrite_if_exists,
+                               chunk_size, update_frequency, compression_lvl, threads);
+      return;
+    }
+
     std::vector<PixelSelector::iterator<N>> heads;
     std::vector<PixelSelector::iterator<N>> tails;
 
@@ -116,7 +265,6 @@ inline void merge(Str first_uri, Str last_uri, std::string_view dest_uri, bool o
       }
     }
 
-    const auto assembly = File(*first_uri).attributes().assembly;
     merge(heads, tails, cooler::File(clrs.front().uri).bins(), dest_uri,
           assembly.has_value() ? *assembly : "unknown", overwrite_if_exists, chunk_size,
           update_frequency, compression_lvl);
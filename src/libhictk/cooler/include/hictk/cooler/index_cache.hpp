@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// IWYU pragma: private, include "hictk/cooler.hpp"
+
+#include <parallel_hashmap/phmap.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "hictk/cooler/index.hpp"
+
+namespace hictk::cooler::internal {
+
+// Index shared by all File objects opened in read-only mode that refer to the same Cooler.
+// Offsets are still read lazily one chromosome at a time (see File::read_index_chunk()): the
+// mutex is used to synchronize the File objects importing offsets into the shared Index.
+struct SharedIndex {
+  Index index;     // NOLINT
+  std::mutex mtx;  // NOLINT
+
+  explicit SharedIndex(Index index_) : index(std::move(index_)) {}
+};
+
+// Process-wide cache mapping the identity of a Cooler (see make_key()) to its SharedIndex.
+// The cache only holds weak references to the indexes, so indexes are released as soon as the last
+// File (or PixelSelector) using them goes out of scope.
+class IndexCache {
+  std::mutex _mtx{};
+  phmap::flat_hash_map<std::string, std::weak_ptr<SharedIndex>> _indexes{};
+
+ public:
+  [[nodiscard]] static IndexCache &instance();
+
+  // Return the index associated with key. When the index is not found, init_index() is called to
+  // construct a new index, which is then registered in the cache.
+  // init_index() is called while holding the cache lock, so that concurrent calls with the same
+  // key do not read the same index multiple times.
+  template <typename IndexFactory>
+  [[nodiscard]] std::shared_ptr<SharedIndex> get_or_emplace(const std::string &key,
+                                                            IndexFactory &&init_index);
+
+  // Number of indexes currently in use
+  [[nodiscard]] std::size_t size();
+  void clear();
+
+  // Compute a key uniquely identifying the Cooler at the given HDF5 path (i.e. the root group of
+  // the Cooler) inside file_name. The key includes the size and modification time of the file, so
+  // that indexes are not reused after a file is overwritten.
+  // Returns an empty string when the identity of the file cannot be established.
+  [[nodiscard]] static std::string make_key(const std::string &file_name,
+                                            const std::string &hdf5_path) noexcept;
+
+ private:
+  void purge_expired_entries();
+};
+
+}  // namespace hictk::cooler::internal
+
+#include "./impl/index_cache_impl.hpp"  // NOLINT
@@ -4,14 +4,17 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <highfive/H5File.hpp>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "hictk/bin_table.hpp"
 #include "hictk/common.hpp"
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/cooler/group.hpp"
@@ -32,6 +35,61 @@ struct MultiResAttributes {
   [[nodiscard]] bool operator!=(const MultiResAttributes& other) const noexcept;
 };
 
+namespace internal {
+
+// Class used to generate multiple resolutions with a single pass over the interactions of a base
+// resolution.
+// Each resolution is produced by a level of the cascade, which coarsens the pixels emitted by
+// the level with the coarsest resolution that is a divisor of the target resolution (or the
+// pixels of the base resolution, when no such level exists).
+// Each level accumulates the pixels overlapping the current coarse row, then sorts and aggregates
+// them once the row has been completed. Aggregated pixels are written to the level's File and are
+// forwarded to the levels depending on it.
+// Row and write buffers share the max_buffered_pixels budget. Row buffers that fill up before the
+// row is complete are compacted in place, so their size is bounded by the number of non-zero
+// pixels in the coarse row.
+template <typename N>
+class CoarsenCascade {
+  static constexpr auto NO_PARENT = std::numeric_limits<std::size_t>::max();
+  static constexpr auto NO_ROW = std::numeric_limits<std::uint64_t>::max();
+
+  struct Level {
+    File clr{};                                // NOLINT
+    std::size_t parent{NO_PARENT};             // NOLINT
+    std::uint64_t factor{};                    // NOLINT
+    std::vector<std::uint64_t> offsets{};      // NOLINT
+    std::vector<std::size_t> children{};       // NOLINT
+    std::uint32_t chrom1_id{};                 // NOLINT
+    std::uint32_t chrom2_id{};                 // NOLINT
+    std::uint64_t row{NO_ROW};                 // NOLINT
+    std::vector<ThinPixel<N>> row_buffer{};    // NOLINT
+    std::size_t row_buffer_capacity{};         // NOLINT
+    std::vector<ThinPixel<N>> write_buffer{};  // NOLINT
+  };
+
+  std::vector<std::uint64_t> _base_offsets{};
+  std::vector<Level> _levels{};
+  std::vector<std::size_t> _roots{};
+  std::size_t _buffer_capacity{};
+
+ public:
+  CoarsenCascade(const BinTable& base_bins, std::vector<File> levels,
+                 std::size_t max_buffered_pixels);
+
+  void add(const ThinPixel<N>& pixel);
+  // Flush all buffered pixels and return the Files written by the cascade
+  [[nodiscard]] std::vector<File> finalize();
+
+ private:
+  void push(std::size_t level_idx, const ThinPixel<N>& pixel);
+  void flush_row(std::size_t level_idx);
+  static void compact_row(std::vector<ThinPixel<N>>& row);
+  static void flush_write_buffer(Level& level);
+  [[nodiscard]] const std::vector<std::uint64_t>& src_offsets(const Level& level) const noexcept;
+};
+
+}  // namespace internal
+
 class MultiResFile {
   std::unique_ptr<RootGroup> _root_grp{};
   std::vector<std::uint32_t> _resolutions{};
@@ -42,6 +100,8 @@ class MultiResFile {
                MultiResAttributes attrs);
 
  public:
+  static constexpr std::size_t DEFAULT_MAX_BUFFERED_PIXELS{10'000'000};
+
   explicit MultiResFile(const std::filesystem::path& path,
                         unsigned int mode = HighFive::File::ReadOnly);
   [[nodiscard]] static MultiResFile create(const std::filesystem::path& path,
@@ -57,6 +117,14 @@ class MultiResFile {
   File copy_resolution(const cooler::File& clr);
   template <typename N = DefaultPixelT>
   File create_resolution(std::uint32_t resolution, Attributes attributes = Attributes::init<N>(0));
+  // Generate resolutions in the range [first_res, last_res) with a single pass over the
+  // interactions from base.
+  // max_buffered_pixels controls the number of pixels buffered in memory before they are written
+  // to the file.
+  template <typename N = DefaultPixelT, typename ResolutionIt>
+  void create_resolutions(const File& base, ResolutionIt first_res, ResolutionIt last_res,
+                          std::size_t max_buffered_pixels = DEFAULT_MAX_BUFFERED_PIXELS,
+                          std::uint32_t compression_lvl = DEFAULT_COMPRESSION_LEVEL);
   RootGroup init_resolution(std::uint32_t resolution);
 
   [[nodiscard]] explicit operator bool() const noexcept;
@@ -18,10 +18,11 @@
 namespace hictk::cooler::utils {
 
 /// Iterable of strings
+/// When threads > 1, the bin table is split into ranges of rows which are merged in parallel.
 template <typename N, typename Str>
 void merge(Str first_uri, Str last_uri, std::string_view dest_uri, bool overwrite_if_exists = false,
            std::size_t chunk_size = 500'000, std::size_t update_frequency = 10'000'000,
-           std::uint32_t compression_lvl = DEFAULT_COMPRESSION_LEVEL);
+           std::uint32_t compression_lvl = DEFAULT_COMPRESSION_LEVEL, std::size_t threads = 1);
 
 template <typename PixelIt>
 void merge(const std::vector<PixelIt>& heads, const std::vector<PixelIt>& tails,
@@ -8,7 +8,9 @@
 #include <parallel_hashmap/phmap.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <nonstd/span.hpp>
 #include <utility>
 #include <vector>
 
@@ -20,13 +22,18 @@
 namespace hictk {
 
 class ExpectedValuesAggregator {
+ public:
+  // Interactions are aggregated using chromosome IDs as keys
+  using TransKey = std::pair<std::uint32_t, std::uint32_t>;
+  using TransMap = phmap::flat_hash_map<TransKey, double>;
+
+ private:
   std::shared_ptr<const BinTable> _bins{};
   std::size_t _num_bins_gw{};
 
-  using CisKey = Chromosome;
-  using TransKey = std::pair<CisKey, CisKey>;
-  phmap::flat_hash_map<CisKey, double> _cis_sum{};
-  phmap::flat_hash_map<TransKey, double> _trans_sum{};
+  std::vector<double> _cis_sum{};
+  std::vector<std::uint8_t> _cis_found{};
+  TransMap _trans_sum{};
 
   std::vector<double> _possible_distances{};
   std::vector<double> _actual_distances{};
@@ -41,6 +48,23 @@ class ExpectedValuesAggregator {
   void add(const ThinPixel<N>& p);
   template <typename N>
   void add(const Pixel<N>& p);
+  // Add a batch of pixels.
+  // Bin IDs are mapped to chromosomes using the prefix sum of the number of bins per chromosome,
+  // and counts are accumulated locally until the chromosome pair changes.
+  // The type of the bin table is resolved once per batch
+  template <typename N>
+  void add(nonstd::span<const ThinPixel<N>> pixels);
+  // Add the interactions for the chrom1:chrom2 matrix.
+  // Bin IDs are expected to be relative to the first bin of chrom1 and chrom2, respectively
+  template <typename PixelIt>
+  void add(const Chromosome& chrom1, const Chromosome& chrom2, PixelIt first_pixel,
+           PixelIt last_pixel);
+
+  // Add the interactions aggregated by another ExpectedValuesAggregator.
+  // This makes it possible to aggregate interactions using one ExpectedValuesAggregator per
+  // thread. Both aggregators should refer to the same table of bins, and compute_density() should
+  // not have been called on either of them
+  void merge(const ExpectedValuesAggregator& other);
 
   void compute_density();
 
@@ -50,18 +74,24 @@ class ExpectedValuesAggregator {
   [[nodiscard]] double scaling_factor(const Chromosome& chrom) const;
   [[nodiscard]] const phmap::btree_map<Chromosome, double>& scaling_factors() const noexcept;
 
+  // Average interaction frequency of the trans matrices with at least one interaction.
+  // Keys are pairs of chromosome IDs
+  [[nodiscard]] auto trans_weights() const noexcept -> const TransMap&;
+  [[nodiscard]] auto bins_ptr() const noexcept -> std::shared_ptr<const BinTable>;
+
  private:
   [[nodiscard]] const Reference& chromosomes() const noexcept;
 
+  template <typename BinTableT, typename N>
+  void add_pixels(const BinTableT& bins, nonstd::span<const ThinPixel<N>> pixels);
+
   inline void init_possible_distances();
   void compute_density_cis();
   void compute_density_trans();
 
-  [[nodiscard]] double at(const Chromosome& chrom) const;
-  [[nodiscard]] double at(const Chromosome& chrom1, const Chromosome& chrom2) const;
-
-  [[nodiscard]] double& at(const Chromosome& chrom);
-  [[nodiscard]] double& at(const Chromosome& chrom1, const Chromosome& chrom2);
+  void add_cis(std::uint32_t chrom_id, double count);
+  void add_trans(std::uint32_t chrom1_id, std::uint32_t chrom2_id, double count);
+  void add_distance(std::uint64_t bin1_id, std::uint64_t bin2_id, double count);
 };
 
 }  // namespace hictk
@@ -0,0 +1,74 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "hictk/bin_table.hpp"
+#include "hictk/chromosome.hpp"
+#include "hictk/common.hpp"
+#include "hictk/expected_values_aggregator.hpp"
+
+namespace hictk {
+
+// Class storing the result of an expected values computation.
+// For cis matrices, expected values represent the average interaction frequency as a function of
+// the distance from the diagonal (in bins). For trans matrices, expected values represent the
+// average interaction frequency over the entire matrix.
+class ExpectedValuesTable {
+ public:
+  using TransMap = ExpectedValuesAggregator::TransMap;
+
+ private:
+  std::shared_ptr<const BinTable> _bins{};
+  std::vector<std::vector<double>> _cis{};
+  TransMap _trans{};
+
+ public:
+  static constexpr std::size_t DEFAULT_BATCH_SIZE{1'000'000};
+
+  ExpectedValuesTable() = default;
+  ExpectedValuesTable(std::shared_ptr<const BinTable> bins, std::vector<std::vector<double>> cis,
+                      TransMap trans);
+  // Construct an ExpectedValuesTable from an aggregator on which compute_density() has already been
+  // called
+  explicit ExpectedValuesTable(const ExpectedValuesAggregator &aggr);
+
+  // Compute the expected values with a single pass over the pixels in [first_pixel, last_pixel).
+  // Pixels are read by the calling thread in batches of batch_size pixels. When threads > 1,
+  // batches are processed by threads - 1 worker threads, each aggregating interactions into its
+  // own ExpectedValuesAggregator. Partial aggregators are merged once all pixels have been read.
+  // op is applied to each pixel before aggregation (e.g. to balance interactions).
+  // Throws when bins is a table with variable bin size.
+  template <typename PixelIt, typename UnaryOperation = identity>
+  [[nodiscard]] static ExpectedValuesTable compute(std::shared_ptr<const BinTable> bins,
+                                                   PixelIt first_pixel, PixelIt last_pixel,
+                                                   std::size_t threads = 1,
+                                                   UnaryOperation op = identity(),
+                                                   std::size_t batch_size = DEFAULT_BATCH_SIZE);
+
+  [[nodiscard]] const BinTable &bins() const noexcept;
+  [[nodiscard]] auto bins_ptr() const noexcept -> std::shared_ptr<const BinTable>;
+
+  // Expected values for the given cis matrix: the i-th value refers to pixels i bins away from the
+  // diagonal. The vector is empty when the matrix has no interactions
+  [[nodiscard]] const std::vector<double> &cis(const Chromosome &chrom) const;
+  // Distances past the end of the vector of expected values are mapped to the last value
+  [[nodiscard]] double cis(const Chromosome &chrom, std::uint64_t distance) const;
+  [[nodiscard]] double trans(const Chromosome &chrom1, const Chromosome &chrom2) const;
+  [[nodiscard]] auto trans() const noexcept -> const TransMap &;
+
+ private:
+  template <typename PixelT, typename BalancedPixelT, typename UnaryOperation>
+  static void aggregate(ExpectedValuesAggregator &aggr, const std::vector<PixelT> &pixels,
+                        std::vector<BalancedPixelT> &buffer, UnaryOperation &op);
+};
+
+}  // namespace hictk
+
+#include "./impl/expected_values_table_impl.hpp"  // NOLINT
@@ -4,15 +4,21 @@
 
 #pragma once
 
+#include <fmt/format.h>
 #include <parallel_hashmap/btree.h>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
+#include <nonstd/span.hpp>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "hictk/bin_table.hpp"
 #include "hictk/chromosome.hpp"
@@ -22,6 +28,11 @@ namespace hictk {
 
 inline ExpectedValuesAggregator::ExpectedValuesAggregator(std::shared_ptr<const BinTable> bins)
     : _bins(std::move(bins)) {
+  assert(_bins);
+  if (!_bins->has_fixed_resolution()) {
+    throw std::runtime_error(
+        "aggregating expected values for tables with variable bin size is not supported");
+  }
   SPDLOG_INFO(FMT_STRING("[{} bp] initializing expected value vector"), _bins->resolution());
   std::uint32_t max_length = 0;
   for (const auto &chrom : chromosomes()) {
@@ -37,6 +48,8 @@ inline ExpectedValuesAggregator::ExpectedValuesAggregator(std::shared_ptr<const
   const auto bin_size = _bins->resolution();
   // round down to mimick HiCTools' behavior
   const auto max_n_bins = max_length / bin_size;
+  _cis_sum.resize(chromosomes().size(), 0.0);
+  _cis_found.resize(chromosomes().size(), false);
   _possible_distances.resize(max_n_bins, 0.0);
   _actual_distances.resize(max_n_bins, 0.0);
   _weights.resize(max_n_bins, 0.0);
@@ -44,7 +57,7 @@ inline ExpectedValuesAggregator::ExpectedValuesAggregator(std::shared_ptr<const
 
 template <typename N>
 inline void ExpectedValuesAggregator::add(const ThinPixel<N> &p) {
-  add(Pixel<N>{*_bins, p});
+  add(nonstd::span<const ThinPixel<N>>(&p, 1));
 }
 
 template <typename N>
@@ -58,15 +71,120 @@ inline void ExpectedValuesAggregator::add(const Pixel<N> &p) {
   const auto &chrom2 = p.coords.bin2.chrom();
 
   if (p.coords.is_intra()) {
-    at(chrom1) += count;
-    const auto i = p.coords.bin2.id() - p.coords.bin1.id();
-    // skip last bin in chromosome if chromosome size is not a multiple of bin size
-    // this is done to mimick HiCTools' behavior
-    if (i < _actual_distances.size()) {
-      _actual_distances[i] += count;
+    add_cis(chrom1.id(), count);
+    add_distance(p.coords.bin1.id(), p.coords.bin2.id(), count);
+  } else {
+    add_trans(chrom1.id(), chrom2.id(), count);
+  }
+}
+
+template <typename N>
+inline void ExpectedValuesAggregator::add(nonstd::span<const ThinPixel<N>> pixels) {
+  if (pixels.empty()) {
+    return;
+  }
+
+  assert(_bins);
+  _bins->visit([&](const auto &bins) { add_pixels(bins, pixels); });
+}
+
+template <typename BinTableT, typename N>
+inline void ExpectedValuesAggregator::add_pixels(const BinTableT &bins,
+                                                 nonstd::span<const ThinPixel<N>> pixels) {
+  assert(!pixels.empty());
+  const auto &offsets = bins.num_bin_prefix_sum();
+  std::uint32_t chrom1_id = internal::find_chrom_id(offsets, pixels.front().bin1_id, 0);
+  std::uint32_t chrom2_id = internal::find_chrom_id(offsets, pixels.front().bin2_id, chrom1_id);
+  double sum = 0;
+  bool valid_interactions = false;
+
+  auto flush = [&]() {
+    if (valid_interactions) {
+      if (chrom1_id == chrom2_id) {
+        add_cis(chrom1_id, sum);
+      } else {
+        add_trans(chrom1_id, chrom2_id, sum);
+      }
+    }
+    sum = 0;
+    valid_interactions = false;
+  };
+
+  for (const auto &p : pixels) {
+    const auto new_chrom1_id = internal::find_chrom_id(offsets, p.bin1_id, chrom1_id);
+    const auto new_chrom2_id = internal::find_chrom_id(offsets, p.bin2_id, chrom2_id);
+    if (new_chrom1_id != chrom1_id || new_chrom2_id != chrom2_id) {
+      flush();
+      chrom1_id = new_chrom1_id;
+      chrom2_id = new_chrom2_id;
+    }
+
+    const auto count = conditional_static_cast<double>(p.count);
+    if (std::isnan(count)) {
+      continue;
+    }
+    sum += count;
+    valid_interactions = true;
+    if (chrom1_id == chrom2_id) {
+      add_distance(p.bin1_id, p.bin2_id, count);
+    }
+  }
+  flush();
+}
+
+template <typename PixelIt>
+inline void ExpectedValuesAggregator::add(const Chromosome &chrom1, const Chromosome &chrom2,
+                                          PixelIt first_pixel, PixelIt last_pixel) {
+  // Accumulate counts locally and update the per-chromosome sums only once per batch of pixels.
+  // Chromosomes are registered only if at least one valid interaction was found, which is
+  // consistent with add(const Pixel<N>&)
+  double sum = 0;
+  bool valid_interactions = false;
+
+  const auto intra = chrom1 == chrom2;
+  std::for_each(first_pixel, last_pixel, [&](const auto &p) {
+    const auto count = conditional_static_cast<double>(p.count);
+    if (std::isnan(count)) {
+      return;
     }
+    sum += count;
+    valid_interactions = true;
+    if (intra) {
+      add_distance(p.bin1_id, p.bin2_id, count);
+    }
+  });
+
+  if (!valid_interactions) {
+    return;
+  }
+  if (intra) {
+    add_cis(chrom1.id(), sum);
   } else {
-    at(chrom1, chrom2) += count;
+    add_trans(chrom1.id(), chrom2.id(), sum);
+  }
+}
+
+inline void ExpectedValuesAggregator::merge(const ExpectedValuesAggregator &other) {
+  assert(_bins);
+  assert(other._bins);
+  if (_bins->resolution() != other._bins->resolution() || _bins->size() != other._bins->size() ||
+      _cis_sum.size() != other._cis_sum.size()) {
+    throw std::runtime_error(
+        "unable to merge ExpectedValuesAggregators: aggregators refer to different bin tables");
+  }
+
+  assert(_actual_distances.size() == other._actual_distances.size());
+  for (std::size_t i = 0; i < _cis_sum.size(); ++i) {
+    _cis_sum[i] += other._cis_sum[i];
+    _cis_found[i] = _cis_found[i] || other._cis_found[i];
+  }
+
+  for (const auto &[k, v] : other._trans_sum) {
+    add_trans(k.first, k.second, v);
+  }
+
+  for (std::size_t i = 0; i < _actual_distances.size(); ++i) {
+    _actual_distances[i] += other._actual_distances[i];
   }
 }
 
@@ -106,11 +224,20 @@ inline const phmap::btree_map<Chromosome, double> &ExpectedValuesAggregator::sca
   return _scaling_factors;
 }
 
+inline auto ExpectedValuesAggregator::trans_weights() const noexcept -> const TransMap & {
+  return _trans_sum;
+}
+
+inline auto ExpectedValuesAggregator::bins_ptr() const noexcept -> std::shared_ptr<const BinTable> {
+  return _bins;
+}
+
 inline void ExpectedValuesAggregator::init_possible_distances() {
   const auto bin_size = _bins->resolution();
 
-  for (const auto &[chrom, _] : _cis_sum) {
-    if (chrom.is_all()) {
+  for (std::uint32_t chrom_id = 0; chrom_id < _cis_found.size(); ++chrom_id) {
+    const auto &chrom = chromosomes().at(chrom_id);
+    if (!_cis_found[chrom_id] || chrom.is_all()) {
       continue;
     }
     const auto n_bins = chrom.size() / bin_size;
@@ -165,8 +292,9 @@ inline void ExpectedValuesAggregator::compute_density_cis() {
     }
   }
 
-  for (const auto &[chrom, _] : _cis_sum) {
-    if (chrom.is_all()) {
+  for (std::uint32_t chrom_id = 0; chrom_id < _cis_found.size(); ++chrom_id) {
+    const auto &chrom = chromosomes().at(chrom_id);
+    if (!_cis_found[chrom_id] || chrom.is_all()) {
       continue;
     }
     auto num_chrom_bins = chrom.size() / _bins->resolution();
@@ -178,7 +306,7 @@ inline void ExpectedValuesAggregator::compute_density_cis() {
       }
     }
 
-    double observed_count = _cis_sum.at(chrom);
+    double observed_count = _cis_sum[chrom_id];
     double f = expected_count / observed_count;
     _scaling_factors.emplace(chrom, f);
   }
@@ -187,30 +315,33 @@ inline void ExpectedValuesAggregator::compute_density_cis() {
 inline void ExpectedValuesAggregator::compute_density_trans() {
   for (auto &[k, v] : _trans_sum) {
     // We round-down to match HiCTools behavior
-    const auto num_bins1 = k.first.size() / _bins->resolution();
-    const auto num_bins2 = k.second.size() / _bins->resolution();
+    const auto num_bins1 = chromosomes().at(k.first).size() / _bins->resolution();
+    const auto num_bins2 = chromosomes().at(k.second).size() / _bins->resolution();
     const auto num_pixels = num_bins1 * num_bins2;
     v = num_pixels != 0 ? v / static_cast<double>(num_pixels) : 0.0;
   }
 }
 
-inline double ExpectedValuesAggregator::at(const Chromosome &chrom) const {
-  return _cis_sum.at(chrom);
+inline void ExpectedValuesAggregator::add_cis(std::uint32_t chrom_id, double count) {
+  assert(chrom_id < _cis_sum.size());
+  _cis_sum[chrom_id] += count;
+  _cis_found[chrom_id] = true;
 }
 
-inline double ExpectedValuesAggregator::at(const Chromosome &chrom1,
-                                           const Chromosome &chrom2) const {
-  return _trans_sum.at(std::make_pair(chrom1, chrom2));
+inline void ExpectedValuesAggregator::add_trans(std::uint32_t chrom1_id, std::uint32_t chrom2_id,
+                                                double count) {
+  auto [it, _] = _trans_sum.try_emplace(std::make_pair(chrom1_id, chrom2_id), 0.0);
+  it->second += count;
 }
 
-inline double &ExpectedValuesAggregator::at(const Chromosome &chrom) {
-  auto [it, _] = _cis_sum.try_emplace(chrom, 0.0);
-  return it->second;
-}
-
-inline double &ExpectedValuesAggregator::at(const Chromosome &chrom1, const Chromosome &chrom2) {
-  auto [it, _] = _trans_sum.try_emplace(std::make_pair(chrom1, chrom2), 0.0);
-  return it->second;
+inline void ExpectedValuesAggregator::add_distance(std::uint64_t bin1_id, std::uint64_t bin2_id,
+                                                   double count) {
+  const auto i = bin2_id - bin1_id;
+  // skip last bin in chromosome if chromosome size is not a multiple of bin size
+  // this is done to mimick HiCTools' behavior
+  if (i < _actual_distances.size()) {
+    _actual_distances[i] += count;
+  }
 }
 
 inline const Reference &ExpectedValuesAggregator::chromosomes() const noexcept {
@@ -0,0 +1,174 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <BS_thread_pool.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <nonstd/span.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hictk/bin_table.hpp"
+#include "hictk/chromosome.hpp"
+#include "hictk/common.hpp"
+#include "hictk/expected_values_aggregator.hpp"
+#include "hictk/type_traits.hpp"
+
+namespace hictk {
+
+inline ExpectedValuesTable::ExpectedValuesTable(std::shared_ptr<const BinTable> bins,
+                                                std::vector<std::vector<double>> cis,
+                                                TransMap trans)
+    : _bins(std::move(bins)), _cis(std::move(cis)), _trans(std::move(trans)) {
+  assert(_bins);
+  if (_cis.size() != _bins->chromosomes().size()) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("invalid expected values: expected cis expected values for {} "
+                               "chromosomes, found {}"),
+                    _bins->chromosomes().size(), _cis.size()));
+  }
+}
+
+inline ExpectedValuesTable::ExpectedValuesTable(const ExpectedValuesAggregator &aggr)
+    : _bins(aggr.bins_ptr()), _cis(_bins->chromosomes().size()), _trans(aggr.trans_weights()) {
+  for (const auto &[chrom, _] : aggr.scaling_factors()) {
+    _cis[chrom.id()] = aggr.weights(chrom);
+  }
+}
+
+template <typename PixelIt, typename UnaryOperation>
+inline ExpectedValuesTable ExpectedValuesTable::compute(std::shared_ptr<const BinTable> bins,
+                                                        PixelIt first_pixel, PixelIt last_pixel,
+                                                        std::size_t threads, UnaryOperation op,
+                                                        std::size_t batch_size) {
+  using PixelT = remove_cvref_t<decltype(*first_pixel)>;
+  using BalancedPixelT = remove_cvref_t<decltype(op(std::declval<PixelT>()))>;
+
+  assert(bins);
+  if (!bins->has_fixed_resolution()) {
+    throw std::runtime_error(
+        "computing expected values for tables with variable bin size is not supported");
+  }
+
+  batch_size = std::max(std::size_t(1), batch_size);
+  auto read_batch = [&](std::vector<PixelT> &buffer) {
+    buffer.clear();
+    for (; first_pixel != last_pixel && buffer.size() < batch_size; ++first_pixel) {
+      buffer.push_back(*first_pixel);
+    }
+  };
+
+  ExpectedValuesAggregator aggr(bins);
+  if (threads < 2) {
+    std::vector<PixelT> pixels{};
+    std::vector<BalancedPixelT> buffer{};
+    while (first_pixel != last_pixel) {
+      read_batch(pixels);
+      aggregate(aggr, pixels, buffer, op);
+    }
+    aggr.compute_density();
+    return ExpectedValuesTable{aggr};
+  }
+
+  // Each worker owns one slot: a new batch of pixels is assigned to a slot only once the worker
+  // is done processing the previous batch
+  const auto num_workers = threads - 1;
+  std::vector<ExpectedValuesAggregator> aggregators{};
+  std::vector<std::vector<PixelT>> pixels(num_workers);
+  std::vector<std::vector<BalancedPixelT>> buffers(num_workers);
+  aggregators.reserve(num_workers);
+  for (std::size_t i = 0; i < num_workers; ++i) {
+    aggregators.emplace_back(bins);
+  }
+
+  std::vector<std::future<void>> tasks(num_workers);
+  // the thread pool should be declared last, so that it is destroyed (and joined) before the
+  // buffers used by the worker threads
+  BS::thread_pool tpool(conditional_static_cast<BS::concurrency_t>(num_workers));
+  for (std::size_t i = 0; first_pixel != last_pixel; i = (i + 1) % num_workers) {
+    if (tasks[i].valid()) {
+      tasks[i].get();
+    }
+    read_batch(pixels[i]);
+    tasks[i] = tpool.submit_task([&, i, op_ = op]() mutable {
+      aggregate(aggregators[i], pixels[i], buffers[i], op_);
+    });
+  }
+
+  for (auto &task : tasks) {
+    if (task.valid()) {
+      task.get();
+    }
+  }
+
+  for (const auto &partial_aggr : aggregators) {
+    aggr.merge(partial_aggr);
+  }
+  aggr.compute_density();
+  return ExpectedValuesTable{aggr};
+}
+
+inline const BinTable &ExpectedValuesTable::bins() const noexcept {
+  assert(_bins);
+  return *_bins;
+}
+
+inline auto ExpectedValuesTable::bins_ptr() const noexcept -> std::shared_ptr<const BinTable> {
+  return _bins;
+}
+
+inline const std::vector<double> &ExpectedValuesTable::cis(const Chromosome &chrom) const {
+  if (chrom.id() >= _cis.size()) {
+    throw std::out_of_range(fmt::format(
+        FMT_STRING("unable to find expected values for chromosome \"{}\""), chrom.name()));
+  }
+  return _cis[chrom.id()];
+}
+
+inline double ExpectedValuesTable::cis(const Chromosome &chrom, std::uint64_t distance) const {
+  const auto &values = cis(chrom);
+  if (values.empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return values[std::min(distance, static_cast<std::uint64_t>(values.size() - 1))];
+}
+
+inline double ExpectedValuesTable::trans(const Chromosome &chrom1, const Chromosome &chrom2) const {
+  auto key = chrom1.id() <= chrom2.id() ? std::make_pair(chrom1.id(), chrom2.id())
+                                        : std::make_pair(chrom2.id(), chrom1.id());
+  auto match = _trans.find(key);
+  if (match == _trans.end()) {
+    return 0.0;
+  }
+  return match->second;
+}
+
+inline auto ExpectedValuesTable::trans() const noexcept -> const TransMap & { return _trans; }
+
+template <typename PixelT, typename BalancedPixelT, typename UnaryOperation>
+inline void ExpectedValuesTable::aggregate(ExpectedValuesAggregator &aggr,
+                                           const std::vector<PixelT> &pixels,
+                                           std::vector<BalancedPixelT> &buffer,
+                                           UnaryOperation &op) {
+  if constexpr (std::is_same_v<UnaryOperation, identity>) {
+    aggr.add(nonstd::span<const PixelT>(pixels));
+  } else {
+    buffer.resize(pixels.size());
+    std::transform(pixels.begin(), pixels.end(), buffer.begin(), op);
+    aggr.add(nonstd::span<const BalancedPixelT>(buffer));
+  }
+}
+
+}  // namespace hictk
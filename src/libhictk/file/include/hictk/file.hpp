@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <nonstd/span.hpp>
+
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
@@ -17,6 +19,7 @@
 #include "hictk/bin_table.hpp"
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/cooler/pixel_selector.hpp"
+#include "hictk/expected_values_table.hpp"
 #include "hictk/genomic_interval.hpp"
 #include "hictk/hic.hpp"
 #include "hictk/hic/pixel_selector.hpp"
@@ -50,6 +53,19 @@ class PixelSelector {
   template <typename N>
   [[nodiscard]] std::vector<Pixel<N>> read_all() const;
 
+  // Call visitor on each pixel overlapping the query (visitor is called with a const
+  // ThinPixel<N>&).
+  // The underlying pixel selector is resolved once before traversing pixels, so that pixels are
+  // visited by a loop that is specialized for the selector type. This avoids dispatching every call
+  // to operator*, operator++ and operator== through std::visit, as done by iterator<N>.
+  template <typename N, typename PixelVisitor>
+  void for_each_pixel(PixelVisitor &&visitor, bool sorted = true) const;
+  // Same as for_each_pixel(), but pixels are accumulated in batches of up to batch_size pixels,
+  // and visitor is called with a nonstd::span<const ThinPixel<N>> for each batch.
+  // The memory referenced by the span is reused across batches.
+  template <typename N, typename BatchVisitor>
+  void visit_batches(std::size_t batch_size, BatchVisitor &&visitor, bool sorted = true) const;
+
   [[nodiscard]] const PixelCoordinates &coord1() const;
   [[nodiscard]] const PixelCoordinates &coord2() const;
 
@@ -145,10 +161,55 @@ class File {
       std::string_view chrom2_name, std::uint32_t start2, std::uint32_t end2,
       const balancing::Method &normalization = balancing::Method::NONE()) const;
 
+  // Visit all pixels in the file (see PixelSelector::for_each_pixel() and
+  // PixelSelector::visit_batches())
+  template <typename N, typename PixelVisitor>
+  void for_each_pixel(PixelVisitor &&visitor,
+                      const balancing::Method &normalization = balancing::Method::NONE(),
+                      bool sorted = true) const;
+  template <typename N, typename BatchVisitor>
+  void visit_batches(std::size_t batch_size, BatchVisitor &&visitor,
+                     const balancing::Method &normalization = balancing::Method::NONE(),
+                     bool sorted = true) const;
+
   [[nodiscard]] bool has_normalization(std::string_view normalization) const;
   [[nodiscard]] std::vector<balancing::Method> avail_normalizations() const;
   [[nodiscard]] balancing::Weights normalization(std::string_view normalization_) const;
 
+  // Read the interactions overlapping a tile of the genome-wide interaction matrix into buffer.
+  // The tile spans bins [first_bin1, first_bin1 + num_rows) and [first_bin2, first_bin2 +
+  // num_cols), and interactions are stored in row-major order (i.e. the interaction between
+  // first_bin1 + i and first_bin2 + j is stored at buffer[i * num_cols + j]).
+  // buffer should hold at least num_rows * num_cols elements: the tile is zero-filled before
+  // reading interactions, and cells falling outside of the matrix are left set to zero.
+  // Tiles can span multiple chromosomes and overlap the lower-triangle of the matrix: interactions
+  // stored in the upper-triangle are mirrored as needed.
+  // Interactions are scattered directly into buffer, without going through the generic
+  // PixelSelector::iterator or creating Pixel objects. When possible, balancing is applied once
+  // the tile has been filled by multiplying rows and columns by the appropriate weights. As a
+  // consequence, all cells corresponding to bins with a NaN weight are set to NaN.
+  template <typename N>
+  void fetch_tile(nonstd::span<N> buffer, std::uint64_t first_bin1, std::uint64_t first_bin2,
+                  std::size_t num_rows, std::size_t num_cols,
+                  const balancing::Method &normalization = balancing::Method::NONE()) const;
+
+  // Call visitor on each interaction overlapping the given tile (see fetch_tile()).
+  // Interactions from the lower-triangle of the tile are mirrored, so that the bin1_id and bin2_id
+  // of the ThinPixel<N> passed to visitor always refer to a row and column of the tile
+  // respectively. Interactions are visited in no particular order.
+  template <typename N, typename TileVisitor>
+  void visit_tile(std::uint64_t first_bin1, std::uint64_t first_bin2, std::size_t num_rows,
+                  std::size_t num_cols, TileVisitor &&visitor,
+                  const balancing::Method &normalization = balancing::Method::NONE()) const;
+
+  // Compute the expected values for the given normalization.
+  // Expected values for .cool files are cached and are read from the file when available.
+  // For .hic files, threads are used to decode interactions in parallel, while the aggregation
+  // is carried out by the calling thread
+  [[nodiscard]] std::shared_ptr<const ExpectedValuesTable> expected_values(
+      const balancing::Method &normalization = balancing::Method::NONE(),
+      std::size_t threads = 1) const;
+
   template <typename FileT>
   [[nodiscard]] constexpr const FileT &get() const noexcept;
   template <typename FileT>
@@ -5,8 +5,13 @@
 #pragma once
 
 #include <fmt/format.h>
+#include <nonstd/span.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -18,11 +23,14 @@
 #include <vector>
 
 #include "hictk/balancing/methods.hpp"
+#include "hictk/balancing/weights.hpp"
 #include "hictk/bin_table.hpp"
+#include "hictk/common.hpp"
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/cooler/pixel_selector.hpp"
 #include "hictk/cooler/uri.hpp"
 #include "hictk/cooler/validation.hpp"
+#include "hictk/expected_values_table.hpp"
 #include "hictk/hic.hpp"
 #include "hictk/hic/pixel_selector.hpp"
 #include "hictk/hic/validation.hpp"
@@ -68,6 +76,52 @@ inline std::vector<Pixel<N>> PixelSelector::read_all() const {
   return std::visit([&](const auto& sel) { return sel.template read_all<N>(); }, _sel);
 }
 
+template <typename N, typename PixelVisitor>
+inline void PixelSelector::for_each_pixel(PixelVisitor&& visitor,
+                                          [[maybe_unused]] bool sorted) const {
+  std::visit(
+      [&](const auto& sel) {
+        using T = std::decay_t<decltype(sel)>;
+        auto visit_pixels = [&](auto first, auto last) {
+          for (; first != last; ++first) {
+            visitor(*first);
+          }
+        };
+        if constexpr (std::is_same_v<cooler::PixelSelector, T>) {
+          visit_pixels(sel.template begin<N>(), sel.template end<N>());
+        } else {
+          visit_pixels(sel.template begin<N>(sorted), sel.template end<N>());
+        }
+      },
+      _sel);
+}
+
+template <typename N, typename BatchVisitor>
+inline void PixelSelector::visit_batches(std::size_t batch_size, BatchVisitor&& visitor,
+                                         bool sorted) const {
+  if (batch_size == 0) {
+    throw std::runtime_error("batch_size should be greater than zero");
+  }
+
+  std::vector<ThinPixel<N>> buffer{};
+  for_each_pixel<N>(
+      [&](const ThinPixel<N>& p) {
+        if (buffer.empty()) {
+          buffer.reserve(batch_size);
+        }
+        buffer.push_back(p);
+        if (buffer.size() == batch_size) {
+          visitor(nonstd::span<const ThinPixel<N>>(buffer));
+          buffer.clear();
+        }
+      },
+      sorted);
+
+  if (!buffer.empty()) {
+    visitor(nonstd::span<const ThinPixel<N>>(buffer));
+  }
+}
+
 inline const PixelCoordinates& PixelSelector::coord1() const {
   return std::visit(
       [&](const auto& sel) -> const PixelCoordinates& {
@@ -263,6 +317,18 @@ inline PixelSelector File::fetch(const balancing::Method& normalization) const {
   return std::visit([&](const auto& fp) { return PixelSelector{fp.fetch(normalization)}; }, _fp);
 }
 
+template <typename N, typename PixelVisitor>
+inline void File::for_each_pixel(PixelVisitor&& visitor, const balancing::Method& normalization,
+                                 bool sorted) const {
+  fetch(normalization).for_each_pixel<N>(std::forward<PixelVisitor>(visitor), sorted);
+}
+
+template <typename N, typename BatchVisitor>
+inline void File::visit_batches(std::size_t batch_size, BatchVisitor&& visitor,
+                                const balancing::Method& normalization, bool sorted) const {
+  fetch(normalization).visit_batches<N>(batch_size, std::forward<BatchVisitor>(visitor), sorted);
+}
+
 inline PixelSelector File::fetch(std::string_view range, const balancing::Method& normalization,
                                  hictk::File::QUERY_TYPE query_type) const {
   return fetch(range, range, normalization, query_type);
@@ -309,6 +375,209 @@ inline balancing::Weights File::normalization(std::string_view normalization_) c
   return std::get<hic::File>(_fp).normalization(normalization_);
 }
 
+namespace internal {
+
+// Range of bins [first_bin, last_bin) from a tile that belongs to a single chromosome
+struct TileSegment {
+  std::uint32_t chrom_id{};
+  std::uint64_t first_bin{};
+  std::uint64_t last_bin{};
+};
+
+[[nodiscard]] inline std::vector<TileSegment> split_tile_by_chrom(const BinTable &bins,
+                                                                  std::uint64_t first_bin,
+                                                                  std::size_t num_bins) {
+  const auto &prefix_sum = bins.num_bin_prefix_sum();
+  const auto last_bin = (std::min)(first_bin + num_bins, static_cast<std::uint64_t>(bins.size()));
+
+  std::vector<TileSegment> segments{};
+  for (auto bin_id = first_bin; bin_id < last_bin;) {
+    // upper_bound skips chromosomes without bins (e.g. chromosome All)
+    const auto it = std::upper_bound(prefix_sum.begin(), prefix_sum.end(), bin_id);
+    assert(it != prefix_sum.begin());
+    assert(it != prefix_sum.end());
+    const auto chrom_id = static_cast<std::uint32_t>(std::distance(prefix_sum.begin(), it) - 1);
+    const auto chrom_last_bin = (std::min)(*it, last_bin);
+    segments.emplace_back(TileSegment{chrom_id, bin_id, chrom_last_bin});
+    bin_id = chrom_last_bin;
+  }
+  return segments;
+}
+
+// Call visitor on the pixels overlapping the tile.
+// When transpose=true, pixels are mirrored w.r.t. the diagonal and pixels on the diagonal are
+// skipped (as they have already been visited while processing the upper-triangle of the tile)
+template <typename N, typename PixelIt, typename TileVisitor>
+inline void visit_tile_pixels(PixelIt first, PixelIt last, std::uint64_t first_bin1,
+                              std::uint64_t first_bin2, std::size_t num_rows,
+                              std::size_t num_cols, bool transpose, TileVisitor &visitor) {
+  std::for_each(first, last, [&](const ThinPixel<N> &p) {
+    if (transpose && p.bin1_id == p.bin2_id) {
+      return;
+    }
+    const auto bin1 = transpose ? p.bin2_id : p.bin1_id;
+    const auto bin2 = transpose ? p.bin1_id : p.bin2_id;
+    // unsigned arithmetic: also catches bins preceding the first bin of the tile
+    if (bin1 - first_bin1 < num_rows && bin2 - first_bin2 < num_cols) {
+      visitor(ThinPixel<N>{bin1, bin2, p.count});
+    }
+  });
+}
+
+}  // namespace internal
+
+template <typename N, typename TileVisitor>
+inline void File::visit_tile(std::uint64_t first_bin1, std::uint64_t first_bin2,
+                             std::size_t num_rows, std::size_t num_cols, TileVisitor &&visitor,
+                             const balancing::Method &normalization) const {
+  const auto row_segments = internal::split_tile_by_chrom(bins(), first_bin1, num_rows);
+  const auto col_segments = internal::split_tile_by_chrom(bins(), first_bin2, num_cols);
+
+  std::visit(
+      [&](const auto &fp) {
+        using FileT = remove_cvref_t<decltype(fp)>;
+        auto read_segments = [&](const internal::TileSegment &seg1,
+                                 const internal::TileSegment &seg2, bool transpose) {
+          const auto &chrom1 = chromosomes().at(seg1.chrom_id);
+          const auto &chrom2 = chromosomes().at(seg2.chrom_id);
+          const auto sel = fp.fetch(chrom1.name(), bins().at(seg1.first_bin).start(),
+                                    bins().at(seg1.last_bin - 1).end(), chrom2.name(),
+                                    bins().at(seg2.first_bin).start(),
+                                    bins().at(seg2.last_bin - 1).end(), normalization);
+          if constexpr (std::is_same_v<FileT, cooler::File>) {
+            internal::visit_tile_pixels<N>(sel.template begin<N>(), sel.template end<N>(),
+                                           first_bin1, first_bin2, num_rows, num_cols, transpose,
+                                           visitor);
+          } else {
+            // pixels do not need to be sorted, so we can decode one block at a time
+            internal::visit_tile_pixels<N>(sel.template begin<N>(false), sel.template end<N>(),
+                                           first_bin1, first_bin2, num_rows, num_cols, transpose,
+                                           visitor);
+          }
+        };
+
+        for (const auto &rows : row_segments) {
+          for (const auto &cols : col_segments) {
+            if (rows.chrom_id < cols.chrom_id) {
+              read_segments(rows, cols, false);
+            } else if (rows.chrom_id > cols.chrom_id) {
+              read_segments(cols, rows, true);
+            } else {
+              // read the upper- and lower-triangle portions of the tile
+              if (rows.first_bin < cols.last_bin) {
+                read_segments(rows, cols, false);
+              }
+              if (cols.first_bin < rows.last_bin) {
+                read_segments(cols, rows, true);
+              }
+            }
+          }
+        }
+      },
+      _fp);
+}
+
+template <typename N>
+inline void File::fetch_tile(nonstd::span<N> buffer, std::uint64_t first_bin1,
+                             std::uint64_t first_bin2, std::size_t num_rows, std::size_t num_cols,
+                             const balancing::Method &normalization) const {
+  static_assert(std::is_arithmetic_v<N>);
+  const auto tile_size = num_rows * num_cols;
+  if (buffer.size() < tile_size) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("buffer is too small to store a tile of shape {}x{}: expected at "
+                               "least {} elements, found {}"),
+                    num_rows, num_cols, tile_size, buffer.size()));
+  }
+  std::fill(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(tile_size), N{0});
+
+  const auto balance = normalization != balancing::Method::NONE();
+  if constexpr (!std::is_floating_point_v<N>) {
+    if (balance) {
+      throw std::runtime_error("fetching balanced tiles requires a floating-point buffer");
+    }
+  }
+
+  // Interactions from .hic files with matrix type other than observed need to be balanced before
+  // computing O/E values: in this case balancing is carried out by the pixel selector
+  const auto balance_tile =
+      balance && (is_cooler() || get<hic::File>().matrix_type() == hic::MatrixType::observed);
+  const auto &selector_normalization = balance_tile ? balancing::Method::NONE() : normalization;
+
+  visit_tile<N>(
+      first_bin1, first_bin2, num_rows, num_cols,
+      [&](const ThinPixel<N> &p) {
+        buffer[((p.bin1_id - first_bin1) * num_cols) + (p.bin2_id - first_bin2)] = p.count;
+      },
+      selector_normalization);
+
+  if (!balance_tile) {
+    return;
+  }
+
+  if constexpr (std::is_floating_point_v<N>) {
+    const auto row_segments = internal::split_tile_by_chrom(bins(), first_bin1, num_rows);
+    const auto col_segments = internal::split_tile_by_chrom(bins(), first_bin2, num_cols);
+
+    // Collect the (multiplicative) weights for the rows and columns of the tile.
+    // Weights for bins outside of the matrix are set to 1 (the tile is already zero-filled)
+    auto tile_weights = [&](const std::vector<internal::TileSegment> &segments,
+                            std::uint64_t first_bin, std::size_t num_bins) {
+      std::vector<N> weights(num_bins, N{1});
+      auto copy_weights = [&](const balancing::Weights &weights_, const internal::TileSegment &seg,
+                              std::uint64_t offset) {
+        const auto divisive = weights_.type() == balancing::Weights::Type::DIVISIVE;
+        for (auto bin_id = seg.first_bin; bin_id < seg.last_bin; ++bin_id) {
+          const auto w = weights_.at(bin_id - offset);
+          weights[bin_id - first_bin] = conditional_static_cast<N>(divisive ? 1.0 / w : w);
+        }
+      };
+
+      std::visit(
+          [&](const auto &fp) {
+            using FileT = remove_cvref_t<decltype(fp)>;
+            for (const auto &seg : segments) {
+              if constexpr (std::is_same_v<FileT, cooler::File>) {
+                copy_weights(*fp.normalization(normalization), seg, 0);
+              } else {
+                // weights for .hic files are stored per chromosome (and are cached by fp)
+                const auto &chrom = chromosomes().at(seg.chrom_id);
+                copy_weights(*fp.normalization_ptr(normalization, chrom), seg,
+                             bins().num_bin_prefix_sum()[seg.chrom_id]);
+              }
+            }
+          },
+          _fp);
+      return weights;
+    };
+
+    const auto row_weights = tile_weights(row_segments, first_bin1, num_rows);
+    const auto col_weights = tile_weights(col_segments, first_bin2, num_cols);
+
+    // Simple loops over contiguous buffers: these are vectorized by the compiler
+    for (std::size_t i = 0; i < num_rows; ++i) {
+      auto *row = buffer.data() + (i * num_cols);
+      const auto wi = row_weights[i];
+      for (std::size_t j = 0; j < num_cols; ++j) {
+        row[j] *= wi * col_weights[j];
+      }
+    }
+  }
+}
+
+inline std::shared_ptr<const ExpectedValuesTable> File::expected_values(
+    const balancing::Method& normalization, std::size_t threads) const {
+  if (std::holds_alternative<cooler::File>(_fp)) {
+    return std::get<cooler::File>(_fp).expected_values(normalization, threads);
+  }
+
+  const auto& hf = std::get<hic::File>(_fp);
+  const auto sel = hf.fetch(normalization, threads);
+  // pixels do not need to be sorted to compute expected values
+  return std::make_shared<const ExpectedValuesTable>(
+      ExpectedValuesTable::compute(hf.bins_ptr(), sel.begin<double>(false), sel.end<double>()));
+}
+
 template <typename FileT>
 constexpr const FileT& File::get() const noexcept {
   return std::get<FileT>(_fp);
@@ -4,12 +4,38 @@
 
 #pragma once
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <nonstd/span.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hictk/balancing/methods.hpp"
+#include "hictk/bin_table.hpp"
+#include "hictk/common.hpp"
 #include "hictk/cooler/multires_cooler.hpp"
 #include "hictk/cooler/utils.hpp"
 #include "hictk/cooler/validation.hpp"
+#include "hictk/genomic_interval.hpp"
 #include "hictk/hic.hpp"
 #include "hictk/hic/utils.hpp"
 #include "hictk/hic/validation.hpp"
+#include "hictk/pixel.hpp"
+#include "hictk/tile_cache.hpp"
+#include "hictk/transformers/coarsen.hpp"
 
 namespace hictk {
 
@@ -52,6 +78,36 @@ inline MultiResFile::MultiResFile(std::string uri, hic::MatrixType type_, hic::M
   _bin_type = mclr.attributes().bin_type.has_value() ? *mclr.attributes().bin_type : "fixed";
 }
 
+inline MultiResFile::MultiResFile(const MultiResFile& other)
+    : _path(other._path),
+      _type(other._type),
+      _unit(other._unit),
+      _chroms(other._chroms),
+      _resolutions(other._resolutions),
+      _format(other._format),
+      _format_version(other._format_version),
+      _bin_type(other._bin_type),
+      _tile_cache(other._tile_cache.capacity_bytes()) {}
+
+inline MultiResFile& MultiResFile::operator=(const MultiResFile& other) {
+  if (this == &other) {
+    return *this;
+  }
+
+  _path = other._path;
+  _type = other._type;
+  _unit = other._unit;
+  _chroms = other._chroms;
+  _resolutions = other._resolutions;
+  _format = other._format;
+  _format_version = other._format_version;
+  _bin_type = other._bin_type;
+  _files.clear();
+  _tile_cache = internal::TileCache(other._tile_cache.capacity_bytes());
+
+  return *this;
+}
+
 inline std::string MultiResFile::path() const { return _path; }
 
 inline bool MultiResFile::is_hic() const noexcept { return _format == "HIC"; }
@@ -71,4 +127,304 @@ inline const Reference& MultiResFile::chromosomes() const noexcept { return _chr
 
 inline File MultiResFile::open(std::uint32_t resolution) const { return File(_path, resolution); }
 
+inline std::uint32_t MultiResFile::compute_base_resolution(std::uint32_t resolution) const {
+  const auto match = std::find_if(_resolutions.rbegin(), _resolutions.rend(), [&](const auto res) {
+    return res != 0 && res <= resolution && resolution % res == 0;
+  });
+  if (match == _resolutions.rend()) {
+    throw std::runtime_error(fmt::format(
+        FMT_STRING("unable to compute interactions at resolution {}: resolution is not a multiple "
+                   "of any of the resolutions available in file \"{}\""),
+        resolution, _path));
+  }
+  return *match;
+}
+
+namespace internal {
+
+// Map the bins of a fixed bin table to the bins of a coarser bin table (built from the same
+// chromosomes) with a resolution that is a multiple of the resolution of the finer table.
+// Given a range of coarse bins [first_bin, last_bin), return the id of the first fine bin
+// overlapping the range together with a vector mapping each fine bin overlapping the range (in
+// order) to the offset of the corresponding coarse bin w.r.t. first_bin.
+// Coarse bins always overlap a contiguous range of fine bins, so the fine bins overlapping the
+// range of coarse bins are also contiguous.
+[[nodiscard]] inline std::pair<std::uint64_t, std::vector<std::uint32_t>> map_coarse_bins(
+    const BinTable &fine_bins, const BinTable &coarse_bins, std::uint64_t first_bin,
+    std::uint64_t last_bin) {
+  assert(first_bin < last_bin);
+  assert(coarse_bins.resolution() % fine_bins.resolution() == 0);
+  const std::uint64_t factor = coarse_bins.resolution() / fine_bins.resolution();
+  const auto &fine_offsets = fine_bins.num_bin_prefix_sum();
+  const auto &coarse_offsets = coarse_bins.num_bin_prefix_sum();
+
+  // offsets of chromosomes without bins are identical to the offset of the next chromosome:
+  // upper_bound makes sure we always start from a chromosome with at least one bin
+  auto chrom_id = static_cast<std::size_t>(
+      std::distance(coarse_offsets.begin(),
+                    std::upper_bound(coarse_offsets.begin(), coarse_offsets.end(), first_bin)) -
+      1);
+
+  std::uint64_t first_fine_bin{};
+  std::vector<std::uint32_t> mappings{};
+  for (auto bin_id = first_bin; bin_id < last_bin; ++bin_id) {
+    while (bin_id >= coarse_offsets[chrom_id + 1]) {
+      ++chrom_id;
+    }
+    const auto fine_first = fine_offsets[chrom_id] + ((bin_id - coarse_offsets[chrom_id]) * factor);
+    const auto fine_last = (std::min)(fine_first + factor, fine_offsets[chrom_id + 1]);
+    if (bin_id == first_bin) {
+      first_fine_bin = fine_first;
+    }
+    assert(first_fine_bin + mappings.size() == fine_first);
+    mappings.insert(mappings.end(), static_cast<std::size_t>(fine_last - fine_first),
+                    static_cast<std::uint32_t>(bin_id - first_bin));
+  }
+
+  return std::make_pair(first_fine_bin, std::move(mappings));
+}
+
+// Forward iterator adapter skipping pixels with NaN counts (e.g. balanced interactions for bins
+// with NaN weights), so that NaNs are skipped while coarsening interactions
+template <typename PixelIt>
+class SkipNaNPixels {
+  PixelIt _it{};
+  PixelIt _last{};
+
+ public:
+  using difference_type = std::ptrdiff_t;
+  using value_type = typename std::iterator_traits<PixelIt>::value_type;
+  using pointer = const value_type *;
+  using reference = const value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+  SkipNaNPixels() = default;
+  SkipNaNPixels(PixelIt first, PixelIt last) : _it(std::move(first)), _last(std::move(last)) {
+    skip_nans();
+  }
+
+  [[nodiscard]] bool operator==(const SkipNaNPixels &other) const { return _it == other._it; }
+  [[nodiscard]] bool operator!=(const SkipNaNPixels &other) const { return !(*this == other); }
+
+  [[nodiscard]] auto operator*() const -> reference { return *_it; }
+  [[nodiscard]] auto operator->() const -> pointer { return &(*_it); }
+
+  auto operator++() -> SkipNaNPixels & {
+    ++_it;
+    skip_nans();
+    return *this;
+  }
+
+  auto operator++(int) -> SkipNaNPixels {
+    auto it = *this;
+    std::ignore = ++(*this);
+    return it;
+  }
+
+ private:
+  void skip_nans() {
+    while (_it != _last && std::isnan(_it->count)) {
+      ++_it;
+    }
+  }
+};
+
+}  // namespace internal
+
+template <typename N>
+inline void MultiResFile::fetch_tile(std::uint32_t resolution, nonstd::span<N> buffer,
+                                     std::uint64_t first_bin1, std::uint64_t first_bin2,
+                                     std::size_t num_rows, std::size_t num_cols,
+                                     const balancing::Method& normalization) const {
+  static_assert(std::is_arithmetic_v<N>);
+  const auto base_resolution = compute_base_resolution(resolution);
+  const auto& base_file = open_cached(base_resolution);
+  if (base_resolution == resolution) {
+    base_file.fetch_tile(buffer, first_bin1, first_bin2, num_rows, num_cols, normalization);
+    return;
+  }
+
+  validate_coarsening();
+
+  const auto tile_size = num_rows * num_cols;
+  if (buffer.size() < tile_size) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("buffer is too small to store a tile of shape {}x{}: expected at "
+                               "least {} elements, found {}"),
+                    num_rows, num_cols, tile_size, buffer.size()));
+  }
+  if constexpr (!std::is_floating_point_v<N>) {
+    if (normalization != balancing::Method::NONE()) {
+      throw std::runtime_error("fetching balanced tiles requires a floating-point buffer");
+    }
+  }
+  std::fill(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(tile_size), N{0});
+
+  const BinTable bins(_chroms, resolution);
+  const auto num_bins = bins.size();
+  // cells falling outside of the matrix are left set to zero
+  const auto last_bin1 = (std::min)(first_bin1 + num_rows, num_bins);
+  const auto last_bin2 = (std::min)(first_bin2 + num_cols, num_bins);
+  if (first_bin1 >= last_bin1 || first_bin2 >= last_bin2) {
+    return;
+  }
+
+  // copy the portion of each grid tile overlapping the query into buffer.
+  // Only tiles from the upper-triangle of the matrix are cached: tiles from the lower-triangle are
+  // obtained by transposing the corresponding tiles from the upper-triangle
+  for (auto tile_row = first_bin1 / TILE_SIZE; tile_row <= (last_bin1 - 1) / TILE_SIZE;
+       ++tile_row) {
+    for (auto tile_col = first_bin2 / TILE_SIZE; tile_col <= (last_bin2 - 1) / TILE_SIZE;
+         ++tile_col) {
+      const auto transpose = tile_row > tile_col;
+      const auto tile =
+          fetch_coarsened_tile(base_file, bins, (std::min)(tile_row, tile_col),
+                               (std::max)(tile_row, tile_col), normalization);
+      assert(!!tile);
+
+      const auto tile_first_bin1 = tile_row * TILE_SIZE;
+      const auto tile_first_bin2 = tile_col * TILE_SIZE;
+      // number of columns of the tile as it is stored in the cache
+      const auto stride = (std::min)(TILE_SIZE, num_bins - ((transpose ? tile_row : tile_col) *
+                                                            TILE_SIZE));
+
+      const auto i0 = (std::max)(first_bin1, tile_first_bin1);
+      const auto i1 = (std::min)(last_bin1, tile_first_bin1 + TILE_SIZE);
+      const auto j0 = (std::max)(first_bin2, tile_first_bin2);
+      const auto j1 = (std::min)(last_bin2, tile_first_bin2 + TILE_SIZE);
+      for (auto i = i0; i < i1; ++i) {
+        const auto ti = i - tile_first_bin1;
+        for (auto j = j0; j < j1; ++j) {
+          const auto tj = j - tile_first_bin2;
+          const auto count = transpose ? (*tile)[(tj * stride) + ti] : (*tile)[(ti * stride) + tj];
+          buffer[((i - first_bin1) * num_cols) + (j - first_bin2)] =
+              conditional_static_cast<N>(count);
+        }
+      }
+    }
+  }
+}
+
+inline std::vector<ThinPixel<double>> MultiResFile::fetch(std::uint32_t resolution,
+                                                          std::string_view range1,
+                                                          std::string_view range2,
+                                                          const balancing::Method& normalization,
+                                                          QUERY_TYPE query_type) const {
+  std::vector<ThinPixel<double>> pixels{};
+  const auto base_resolution = compute_base_resolution(resolution);
+  const auto& base_file = open_cached(base_resolution);
+  if (base_resolution == resolution) {
+    const auto sel = base_file.fetch(range1, range2, normalization, query_type);
+    std::transform(sel.begin<double>(), sel.end<double>(),
+                   std::back_inserter(pixels), [](const auto& p) {
+                     return ThinPixel<double>{p.bin1_id, p.bin2_id, p.count};
+                   });
+    return pixels;
+  }
+
+  validate_coarsening();
+
+  const BinTable bins(_chroms, resolution);
+  const auto gi1 = GenomicInterval::parse(_chroms, std::string{range1}, query_type);
+  const auto gi2 = GenomicInterval::parse(_chroms, std::string{range2}, query_type);
+  if (gi1.chrom().id() > gi2.chrom().id()) {
+    // only interactions from the upper-triangle of the matrix are returned
+    return pixels;
+  }
+
+  // Expand the queries such that they overlap whole bins at the target resolution
+  const auto [first_bin1, last_bin1] = bins.map_to_bin_ids(gi1);
+  const auto [first_bin2, last_bin2] = bins.map_to_bin_ids(gi2);
+  const auto sel = base_file.fetch(gi1.chrom().name(), bins.at(first_bin1).start(),
+                                   bins.at(last_bin1).end(), gi2.chrom().name(),
+                                   bins.at(first_bin2).start(), bins.at(last_bin2).end(),
+                                   normalization);
+
+  using PixelIt = internal::SkipNaNPixels<PixelSelector::iterator<double>>;
+  const transformers::CoarsenPixels coarsener(PixelIt(sel.begin<double>(), sel.end<double>()),
+                                              PixelIt(sel.end<double>(), sel.end<double>()),
+                                              base_file.bins_ptr(), resolution / base_resolution);
+  std::copy_if(coarsener.begin(), coarsener.end(), std::back_inserter(pixels),
+               [](const ThinPixel<double>& p) { return p.count != 0; });
+  return pixels;
+}
+
+inline void MultiResFile::clear_tile_cache() noexcept { _tile_cache.clear(); }
+
+inline double MultiResFile::tile_cache_hit_rate() const noexcept {
+  return _tile_cache.hit_rate();
+}
+
+inline const File& MultiResFile::open_cached(std::uint32_t resolution) const {
+  auto match = _files.find(resolution);
+  if (match == _files.end()) {
+    match = _files.emplace(resolution, File(_path, resolution, _type, _unit)).first;
+  }
+  return match->second;
+}
+
+inline void MultiResFile::validate_coarsening() const {
+  if (_bin_type != "fixed") {
+    throw std::runtime_error(
+        "computing interactions at arbitrary resolutions requires a file with fixed bins");
+  }
+  // expected and observed/expected values cannot be computed by adding up finer values
+  if (_type != hic::MatrixType::observed) {
+    throw std::runtime_error(fmt::format(
+        FMT_STRING("computing interactions at arbitrary resolutions requires matrix type to be "
+                   "\"observed\", found \"{}\""),
+        _type));
+  }
+}
+
+inline internal::TileCache::Value MultiResFile::fetch_coarsened_tile(
+    const File& base_file, const BinTable& bins, std::size_t tile_row, std::size_t tile_col,
+    const balancing::Method& normalization) const {
+  internal::TileID key{bins.resolution(), std::string{normalization.to_string()}, tile_row,
+                       tile_col};
+  if (auto tile = _tile_cache.find(key); tile) {
+    return tile;
+  }
+  return _tile_cache.emplace(
+      std::move(key), compute_coarsened_tile(base_file, bins, tile_row, tile_col, normalization));
+}
+
+inline internal::TileCache::Value MultiResFile::compute_coarsened_tile(
+    const File& base_file, const BinTable& bins, std::size_t tile_row, std::size_t tile_col,
+    const balancing::Method& normalization) const {
+  assert(tile_row <= tile_col);
+  const auto num_bins = bins.size();
+  const auto first_bin1 = tile_row * TILE_SIZE;
+  const auto first_bin2 = tile_col * TILE_SIZE;
+  const auto num_rows = (std::min)(TILE_SIZE, num_bins - first_bin1);
+  const auto num_cols = (std::min)(TILE_SIZE, num_bins - first_bin2);
+
+  const auto rows = internal::map_coarse_bins(base_file.bins(), bins, first_bin1,
+                                              first_bin1 + num_rows);
+  const auto cols = internal::map_coarse_bins(base_file.bins(), bins, first_bin2,
+                                              first_bin2 + num_cols);
+  const auto base_first_bin1 = rows.first;
+  const auto base_first_bin2 = cols.first;
+  const auto& row_mappings = rows.second;
+  const auto& col_mappings = cols.second;
+
+  auto tile = std::make_shared<std::vector<double>>(num_rows * num_cols, 0.0);
+  base_file.visit_tile<double>(
+      base_first_bin1, base_first_bin2, row_mappings.size(), col_mappings.size(),
+      [&](const ThinPixel<double>& p) {
+        const auto i = row_mappings[p.bin1_id - base_first_bin1];
+        const auto j = col_mappings[p.bin2_id - base_first_bin2];
+        // Interactions mirrored from the lower-triangle are skipped when they fall on the
+        // diagonal of the coarsened matrix, so that, like for the resolutions stored in the file,
+        // diagonal pixels only aggregate interactions from the upper-triangle of the matrix
+        if (std::isnan(p.count) || (p.bin1_id > p.bin2_id && first_bin1 + i == first_bin2 + j)) {
+          return;
+        }
+        (*tile)[(i * num_cols) + j] += p.count;
+      },
+      normalization);
+
+  return tile;
+}
+
 }  // namespace hictk
@@ -0,0 +1,229 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <nonstd/span.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "hictk/balancing/methods.hpp"
+#include "hictk/bin_table.hpp"
+#include "hictk/file.hpp"
+#include "hictk/hic.hpp"
+#include "hictk/pixel.hpp"
+#include "hictk/reference.hpp"
+
+namespace hictk {
+
+namespace internal {
+inline std::recursive_mutex &hdf5_mutex() noexcept {
+  static std::recursive_mutex mtx{};
+  return mtx;
+}
+}  // namespace internal
+
+inline QueryPool::QueryPool(std::string uri, std::uint32_t resolution, hic::MatrixType type,
+                            hic::MatrixUnit unit, std::size_t max_handles)
+    : _uri(std::move(uri)), _resolution(resolution), _type(type), _unit(unit) {
+  // the first handle is used to read the metadata shared by all handles
+  std::unique_ptr<File> file{};
+  {
+    const std::scoped_lock lck(internal::hdf5_mutex());
+    file = std::make_unique<File>(_uri, _resolution, _type, _unit);
+  }
+  _is_hic = file->is_hic();
+  _resolution = file->resolution();
+  _bins = file->bins_ptr();
+  // .cool files are always read using a single handle (see class comment)
+  _max_handles = _is_hic ? (std::max)(max_handles, std::size_t{1}) : 1;
+
+  if (_is_hic) {
+    _hic_prototype = std::make_unique<hic::File>(std::move(file->get<hic::File>()));
+    file = std::make_unique<File>(_hic_prototype->clone());
+  }
+
+  _idle_handles.emplace_back(std::move(file));
+  _num_handles = 1;
+}
+
+inline QueryPool::~QueryPool() noexcept {
+  // closing .cool files requires calling into HDF5
+  const std::scoped_lock lck(internal::hdf5_mutex());
+  _idle_handles.clear();
+}
+
+inline const std::string &QueryPool::uri() const noexcept { return _uri; }
+constexpr bool QueryPool::is_hic() const noexcept { return _is_hic; }
+constexpr bool QueryPool::is_cooler() const noexcept { return !is_hic(); }
+
+inline const Reference &QueryPool::chromosomes() const noexcept { return bins().chromosomes(); }
+inline const BinTable &QueryPool::bins() const noexcept {
+  assert(_bins);
+  return *_bins;
+}
+inline std::shared_ptr<const BinTable> QueryPool::bins_ptr() const noexcept { return _bins; }
+constexpr std::uint32_t QueryPool::resolution() const noexcept { return _resolution; }
+
+constexpr std::size_t QueryPool::max_handles() const noexcept { return _max_handles; }
+inline std::size_t QueryPool::num_handles() const {
+  const std::scoped_lock lck(_mtx);
+  return _num_handles;
+}
+
+inline auto QueryPool::acquire() const -> Handle {
+  const auto thread_id = std::this_thread::get_id();
+  std::unique_ptr<File> file{};
+  {
+    std::unique_lock lck(_mtx);
+    const auto num_borrowed = static_cast<std::size_t>(
+        std::count(_borrowers.begin(), _borrowers.end(), thread_id));
+    if (num_borrowed == _max_handles) {
+      throw std::runtime_error(fmt::format(
+          FMT_STRING("QueryPool::acquire() was called by a thread that is already holding all the "
+                     "handles ({}) to file \"{}\": waiting for a handle would deadlock"),
+          _max_handles, _uri));
+    }
+    _cv.wait(lck, [&]() { return !_idle_handles.empty() || _num_handles < _max_handles; });
+    if (!_idle_handles.empty()) {
+      file = std::move(_idle_handles.back());
+      _idle_handles.pop_back();
+    } else {
+      // reserve a slot for the new handle, so that the file can be opened without holding the lock
+      ++_num_handles;
+    }
+    _borrowers.push_back(thread_id);
+  }
+
+  if (!file) {
+    try {
+      file = open_handle();
+    } catch (...) {
+      {
+        const std::scoped_lock lck(_mtx);
+        --_num_handles;
+        _borrowers.erase(std::find(_borrowers.begin(), _borrowers.end(), thread_id));
+      }
+      _cv.notify_one();
+      throw;
+    }
+  }
+  return {*this, std::move(file)};
+}
+
+template <typename N>
+inline std::vector<ThinPixel<N>> QueryPool::fetch(std::string_view range,
+                                                  const balancing::Method &normalization,
+                                                  QUERY_TYPE query_type) const {
+  const auto handle = acquire();
+  return read_pixels<N>(handle->fetch(range, normalization, query_type));
+}
+
+template <typename N>
+inline std::vector<ThinPixel<N>> QueryPool::fetch(std::string_view range1,
+                                                  std::string_view range2,
+                                                  const balancing::Method &normalization,
+                                                  QUERY_TYPE query_type) const {
+  const auto handle = acquire();
+  return read_pixels<N>(handle->fetch(range1, range2, normalization, query_type));
+}
+
+template <typename N>
+inline void QueryPool::fetch_tile(nonstd::span<N> buffer, std::uint64_t first_bin1,
+                                  std::uint64_t first_bin2, std::size_t num_rows,
+                                  std::size_t num_cols,
+                                  const balancing::Method &normalization) const {
+  const auto handle = acquire();
+  handle->fetch_tile(buffer, first_bin1, first_bin2, num_rows, num_cols, normalization);
+}
+
+inline std::unique_ptr<File> QueryPool::open_handle() const {
+  if (_is_hic) {
+    // copying the prototype is cheap (its members are mostly shared pointers), and allows us to
+    // open the new file stream without holding the lock
+    const auto prototype = [&]() {
+      const std::scoped_lock lck(_mtx);
+      assert(_hic_prototype);
+      return *_hic_prototype;
+    }();
+    return std::make_unique<File>(prototype.clone());
+  }
+  const std::scoped_lock lck(internal::hdf5_mutex());
+  return std::make_unique<File>(_uri, _resolution, _type, _unit);
+}
+
+inline void QueryPool::return_handle(std::unique_ptr<File> file,
+                                     std::thread::id owner) const noexcept {
+  assert(file);
+  {
+    const std::scoped_lock lck(_mtx);
+    // footers only need to be shared as long as new handles can be opened
+    if (_hic_prototype && _num_handles < _max_handles) {
+      try {
+        _hic_prototype->merge_footer_cache(file->get<hic::File>());
+      } catch (...) {  // NOLINT(bugprone-empty-catch)
+        // sharing footers is just an optimization
+      }
+    }
+    _idle_handles.emplace_back(std::move(file));
+    const auto match = std::find(_borrowers.begin(), _borrowers.end(), owner);
+    assert(match != _borrowers.end());
+    _borrowers.erase(match);
+  }
+  _cv.notify_one();
+}
+
+template <typename N, typename Selector>
+inline std::vector<ThinPixel<N>> QueryPool::read_pixels(const Selector &sel) {
+  // We push_back into buff to avoid traversing pixels twice (once to figure out the vector size,
+  // and a second time to copy the actual data)
+  std::vector<ThinPixel<N>> buff{};
+  std::for_each(sel.template begin<N>(), sel.template end<N>(),
+                [&](const ThinPixel<N> &p) { buff.emplace_back(p); });
+  return buff;
+}
+
+inline QueryPool::Handle::Handle(const QueryPool &pool, std::unique_ptr<File> file)
+    : _pool(&pool), _file(std::move(file)) {
+  assert(_file);
+  if (_file->is_cooler()) {
+    _hdf5_lck = std::unique_lock(internal::hdf5_mutex());
+  }
+}
+
+inline QueryPool::Handle::~Handle() noexcept { release(); }
+
+inline const File &QueryPool::Handle::operator*() const noexcept {
+  assert(_file);
+  return *_file;
+}
+
+inline const File *QueryPool::Handle::operator->() const noexcept { return &(**this); }
+
+inline void QueryPool::Handle::release() noexcept {
+  if (!_file) {
+    return;
+  }
+  assert(_pool);
+  // handles are pinned to the thread that acquired them
+  assert(_owner == std::this_thread::get_id());
+  _pool->return_handle(std::move(_file), _owner);
+  if (_hdf5_lck.owns_lock()) {
+    _hdf5_lck.unlock();
+  }
+}
+
+}  // namespace hictk
@@ -0,0 +1,94 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace hictk::internal {
+
+inline bool TileID::operator==(const TileID &other) const noexcept {
+  return resolution == other.resolution && row == other.row && col == other.col &&
+         normalization == other.normalization;
+}
+
+inline TileCache::TileCache(std::size_t capacity_bytes) : _capacity(capacity_bytes) {}
+
+inline auto TileCache::find(const TileID &key) -> Value {
+  auto match = _index.find(key);
+  if (match == _index.end()) {
+    ++_misses;
+    return nullptr;
+  }
+
+  ++_hits;
+  // mark the tile as the most recently used
+  _tiles.splice(_tiles.begin(), _tiles, match->second);
+  return match->second->second;
+}
+
+inline auto TileCache::emplace(TileID key, Value tile) -> Value {
+  assert(!!tile);
+  const auto tile_size = tile->size() * sizeof(double);
+
+  auto match = _index.find(key);
+  if (match != _index.end()) {
+    _size -= match->second->second->size() * sizeof(double);
+    _tiles.erase(match->second);
+    _index.erase(match);
+  }
+
+  while (_size + tile_size > _capacity && !_tiles.empty()) {
+    pop_least_recently_used();
+  }
+
+  _tiles.emplace_front(key, tile);
+  _index.emplace(std::move(key), _tiles.begin());
+  _size += tile_size;
+  return tile;
+}
+
+inline auto TileCache::emplace(TileID key, std::vector<double> &&tile) -> Value {
+  return emplace(std::move(key), std::make_shared<const std::vector<double>>(std::move(tile)));
+}
+
+inline void TileCache::clear() noexcept {
+  reset_stats();
+  _index.clear();
+  _tiles.clear();
+  _size = 0;
+}
+
+constexpr std::size_t TileCache::capacity_bytes() const noexcept { return _capacity; }
+constexpr std::size_t TileCache::size_bytes() const noexcept { return _size; }
+inline std::size_t TileCache::num_tiles() const noexcept { return _tiles.size(); }
+
+constexpr double TileCache::hit_rate() const noexcept {
+  if (_hits + _misses == 0) {
+    return 0.0;
+  }
+  return double(_hits) / double(_hits + _misses);
+}
+
+constexpr std::size_t TileCache::hits() const noexcept { return _hits; }
+constexpr std::size_t TileCache::misses() const noexcept { return _misses; }
+
+constexpr void TileCache::reset_stats() noexcept {
+  _hits = 0;
+  _misses = 0;
+}
+
+inline void TileCache::pop_least_recently_used() {
+  assert(!_tiles.empty());
+  const auto &[key, tile] = _tiles.back();
+  _size -= tile->size() * sizeof(double);
+  _index.erase(key);
+  _tiles.pop_back();
+}
+
+}  // namespace hictk::internal
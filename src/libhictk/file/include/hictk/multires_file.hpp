@@ -6,13 +6,19 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <nonstd/span.hpp>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "hictk/balancing/methods.hpp"
 #include "hictk/cooler/multires_cooler.hpp"
 #include "hictk/file.hpp"
 #include "hictk/hic.hpp"
 #include "hictk/reference.hpp"
+#include "hictk/tile_cache.hpp"
 
 namespace hictk {
 
@@ -26,14 +32,30 @@ class MultiResFile {
   std::uint8_t _format_version{};
   std::string _bin_type{};
 
+  // Files and coarsened tiles are cached per instance: copies of a MultiResFile start with empty
+  // caches, so that each copy can be used from a different thread
+  mutable std::map<std::uint32_t, File> _files{};
+  mutable internal::TileCache _tile_cache{DEFAULT_TILE_CACHE_CAPACITY};
+
  public:
   using QUERY_TYPE = hictk::GenomicInterval::Type;
+  // Coarsened interactions are computed and cached in square tiles spanning TILE_SIZE bins
+  static constexpr std::size_t TILE_SIZE{256};
+  static constexpr std::size_t DEFAULT_TILE_CACHE_CAPACITY{64ULL << 20U};  // 64 MiB
 
   explicit MultiResFile(const cooler::MultiResFile& mclr);
   explicit MultiResFile(const hic::File& hf);
   explicit MultiResFile(std::string uri, hic::MatrixType type_ = hic::MatrixType::observed,
                         hic::MatrixUnit unit_ = hic::MatrixUnit::BP);
 
+  MultiResFile(const MultiResFile& other);
+  MultiResFile(MultiResFile&& other) = default;
+
+  ~MultiResFile() = default;
+
+  MultiResFile& operator=(const MultiResFile& other);
+  MultiResFile& operator=(MultiResFile&& other) = default;
+
   [[nodiscard]] std::string path() const;
 
   [[nodiscard]] bool is_hic() const noexcept;
@@ -48,6 +70,53 @@ class MultiResFile {
   [[nodiscard]] const Reference& chromosomes() const noexcept;
 
   [[nodiscard]] File open(std::uint32_t resolution) const;
+
+  // Return the coarsest resolution available in the file that can be used to compute interactions
+  // at the given resolution (i.e. the largest resolution that is a divisor of resolution)
+  [[nodiscard]] std::uint32_t compute_base_resolution(std::uint32_t resolution) const;
+
+  // Read a tile of the genome-wide interaction matrix at the given resolution into buffer (see
+  // File::fetch_tile() for the meaning of the remaining parameters).
+  // When resolution is not available in the file, interactions are computed on the fly by
+  // coarsening the interactions from the resolution returned by compute_base_resolution().
+  // Coarsened interactions are computed one TILE_SIZE x TILE_SIZE tile at a time and are stored in
+  // an LRU cache, so that overlapping queries (e.g. when panning a viewer) do not need to read and
+  // coarsen the same interactions multiple times.
+  // When a normalization is specified, interactions are balanced before they are coarsened.
+  // Coarsening is only supported for files with fixed bins storing observed interactions.
+  // Calling this method from multiple threads on the same MultiResFile is not safe: use one copy
+  // of the MultiResFile per thread instead.
+  template <typename N>
+  void fetch_tile(std::uint32_t resolution, nonstd::span<N> buffer, std::uint64_t first_bin1,
+                  std::uint64_t first_bin2, std::size_t num_rows, std::size_t num_cols,
+                  const balancing::Method& normalization = balancing::Method::NONE()) const;
+
+  // Fetch the non-zero interactions between range1 and range2 at the given resolution.
+  // When resolution is not available in the file, interactions are coarsened on the fly by
+  // streaming the (sorted) interactions overlapping the query at the base resolution through
+  // transformers::CoarsenPixels. Like for fetch_tile(), interactions are balanced before they are
+  // coarsened, and NaNs are skipped.
+  // Like for File::fetch(), only interactions from the upper-triangle of the matrix are returned.
+  // Pixels are sorted by bin1_id and bin2_id
+  [[nodiscard]] std::vector<ThinPixel<double>> fetch(
+      std::uint32_t resolution, std::string_view range1, std::string_view range2,
+      const balancing::Method& normalization = balancing::Method::NONE(),
+      QUERY_TYPE query_type = QUERY_TYPE::UCSC) const;
+
+  void clear_tile_cache() noexcept;
+  [[nodiscard]] double tile_cache_hit_rate() const noexcept;
+
+ private:
+  [[nodiscard]] const File& open_cached(std::uint32_t resolution) const;
+  // Throw when interactions cannot be computed by coarsening interactions from a finer resolution
+  // (i.e. when the file has variable bins or does not contain observed interactions)
+  void validate_coarsening() const;
+  [[nodiscard]] internal::TileCache::Value fetch_coarsened_tile(
+      const File& base_file, const BinTable& bins, std::size_t tile_row, std::size_t tile_col,
+      const balancing::Method& normalization) const;
+  [[nodiscard]] internal::TileCache::Value compute_coarsened_tile(
+      const File& base_file, const BinTable& bins, std::size_t tile_row, std::size_t tile_col,
+      const balancing::Method& normalization) const;
 };
 
 }  // namespace hictk
@@ -0,0 +1,157 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <nonstd/span.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "hictk/balancing/methods.hpp"
+#include "hictk/bin_table.hpp"
+#include "hictk/file.hpp"
+#include "hictk/genomic_interval.hpp"
+#include "hictk/hic/common.hpp"
+#include "hictk/pixel.hpp"
+#include "hictk/reference.hpp"
+
+namespace hictk {
+
+namespace internal {
+// The HDF5 library shipped with hictk is built without thread-safety support: all HDF5 calls
+// issued through a QueryPool are serialized using this mutex.
+// The mutex is recursive so that a thread can hold handles to multiple .cool files at once
+[[nodiscard]] std::recursive_mutex &hdf5_mutex() noexcept;
+}  // namespace internal
+
+// Facade to query a single .hic or .cool file from multiple threads.
+// hic::File and cooler::File are not thread-safe, as their const methods mutate internal state
+// (file handles, caches etc.). QueryPool manages a set of File handles that are lent to one thread
+// at a time: handles are opened lazily the first time all the existing handles are in use, and
+// are reused by subsequent queries.
+// Interactions from .hic files are read in parallel, with each handle using its own file stream
+// and block cache. New .hic handles are cloned from a prototype hic::File that is never lent: the
+// header, bin table and footers (i.e. the index of the interaction blocks) are shared by all
+// handles instead of being read again from the file, and footers read by a handle are shared with
+// the prototype when the handle is returned to the pool.
+// As HDF5 is not thread-safe, queries targeting .cool files are serialized, and a single handle is
+// used to read interactions from a given .cool file.
+// All public methods are safe to call concurrently.
+class QueryPool {
+ public:
+  using QUERY_TYPE = hictk::GenomicInterval::Type;
+  class Handle;
+
+ private:
+  std::string _uri{};
+  std::uint32_t _resolution{};
+  hic::MatrixType _type{hic::MatrixType::observed};
+  hic::MatrixUnit _unit{hic::MatrixUnit::BP};
+  bool _is_hic{};
+  std::shared_ptr<const BinTable> _bins{};
+  std::size_t _max_handles{};
+
+  mutable std::mutex _mtx{};
+  mutable std::condition_variable _cv{};
+  mutable std::vector<std::unique_ptr<File>> _idle_handles{};
+  mutable std::size_t _num_handles{};
+  // threads currently holding a handle (one entry per handle)
+  mutable std::vector<std::thread::id> _borrowers{};
+  mutable std::unique_ptr<hic::File> _hic_prototype{};
+
+ public:
+  explicit QueryPool(std::string uri, std::uint32_t resolution = 0,
+                     hic::MatrixType type = hic::MatrixType::observed,
+                     hic::MatrixUnit unit = hic::MatrixUnit::BP,
+                     std::size_t max_handles = std::thread::hardware_concurrency());
+  QueryPool(const QueryPool &other) = delete;
+  QueryPool(QueryPool &&other) noexcept = delete;
+  ~QueryPool() noexcept;
+
+  QueryPool &operator=(const QueryPool &other) = delete;
+  QueryPool &operator=(QueryPool &&other) noexcept = delete;
+
+  [[nodiscard]] const std::string &uri() const noexcept;
+  [[nodiscard]] constexpr bool is_hic() const noexcept;
+  [[nodiscard]] constexpr bool is_cooler() const noexcept;
+
+  [[nodiscard]] const Reference &chromosomes() const noexcept;
+  [[nodiscard]] const BinTable &bins() const noexcept;
+  [[nodiscard]] std::shared_ptr<const BinTable> bins_ptr() const noexcept;
+  [[nodiscard]] constexpr std::uint32_t resolution() const noexcept;
+
+  [[nodiscard]] constexpr std::size_t max_handles() const noexcept;
+  [[nodiscard]] std::size_t num_handles() const;
+
+  // Borrow a File handle from the pool, blocking until a handle becomes available.
+  // The File can be used freely (including iterating over PixelSelectors) until the Handle goes
+  // out of scope, at which point the File is returned to the pool.
+  // Handles must not outlive the QueryPool they have been acquired from, and are pinned to the
+  // thread that acquired them.
+  // A thread may hold multiple handles at once (e.g. when querying a .hic file through nested
+  // calls). However, waiting for a handle while holding all the handles of the pool would
+  // deadlock: in this case acquire() throws an exception instead. This is always the case when
+  // calling acquire() (or fetch() etc.) on a pool for a .cool file while holding its only handle.
+  [[nodiscard]] Handle acquire() const;
+
+  // Fetch and read all interactions overlapping the given range(s).
+  // Interactions are read while holding a File handle, so the returned pixels can be used from any
+  // thread.
+  template <typename N>
+  [[nodiscard]] std::vector<ThinPixel<N>> fetch(
+      std::string_view range, const balancing::Method &normalization = balancing::Method::NONE(),
+      QUERY_TYPE query_type = QUERY_TYPE::UCSC) const;
+  template <typename N>
+  [[nodiscard]] std::vector<ThinPixel<N>> fetch(
+      std::string_view range1, std::string_view range2,
+      const balancing::Method &normalization = balancing::Method::NONE(),
+      QUERY_TYPE query_type = QUERY_TYPE::UCSC) const;
+
+  // See File::fetch_tile()
+  template <typename N>
+  void fetch_tile(nonstd::span<N> buffer, std::uint64_t first_bin1, std::uint64_t first_bin2,
+                  std::size_t num_rows, std::size_t num_cols,
+                  const balancing::Method &normalization = balancing::Method::NONE()) const;
+
+  // Handles are neither copyable nor movable: handles to .cool files hold a lock on the HDF5 mutex,
+  // which must be released by the thread that acquired it.
+  class Handle {
+    const QueryPool *_pool{};
+    std::unique_ptr<File> _file{};
+    std::thread::id _owner{std::this_thread::get_id()};
+    std::unique_lock<std::recursive_mutex> _hdf5_lck{};
+
+   public:
+    Handle(const QueryPool &pool, std::unique_ptr<File> file);
+    Handle(const Handle &other) = delete;
+    Handle(Handle &&other) = delete;
+    ~Handle() noexcept;
+
+    Handle &operator=(const Handle &other) = delete;
+    Handle &operator=(Handle &&other) = delete;
+
+    [[nodiscard]] const File &operator*() const noexcept;
+    [[nodiscard]] const File *operator->() const noexcept;
+
+   private:
+    void release() noexcept;
+  };
+
+ private:
+  [[nodiscard]] std::unique_ptr<File> open_handle() const;
+  void return_handle(std::unique_ptr<File> file, std::thread::id owner) const noexcept;
+  template <typename N, typename Selector>
+  [[nodiscard]] static std::vector<ThinPixel<N>> read_pixels(const Selector &sel);
+};
+
+}  // namespace hictk
+
+#include "./impl/query_pool_impl.hpp"  // NOLINT
@@ -0,0 +1,83 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <parallel_hashmap/phmap.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hictk/hash.hpp"
+
+namespace hictk::internal {
+struct TileID {
+  std::uint32_t resolution;    // NOLINT
+  std::string normalization;  // NOLINT
+  std::uint64_t row;           // NOLINT
+  std::uint64_t col;           // NOLINT
+  [[nodiscard]] bool operator==(const TileID &other) const noexcept;
+};
+}  // namespace hictk::internal
+
+template <>
+struct std::hash<hictk::internal::TileID> {
+  inline std::size_t operator()(hictk::internal::TileID const &tid) const noexcept {
+    return hictk::internal::hash_combine(0, tid.resolution, tid.normalization, tid.row, tid.col);
+  }
+};
+
+namespace hictk::internal {
+
+// Cache of dense tiles of interactions with a least-recently-used eviction policy.
+// Tiles are stored as vectors of doubles in row-major order, and the capacity of the cache is
+// expressed in bytes.
+class TileCache {
+ public:
+  using Value = std::shared_ptr<const std::vector<double>>;
+
+ private:
+  using ListT = std::list<std::pair<TileID, Value>>;
+  // tiles are sorted from the most to the least recently used
+  ListT _tiles{};
+  phmap::flat_hash_map<TileID, ListT::iterator> _index{};
+
+  std::size_t _hits{};
+  std::size_t _misses{};
+
+  std::size_t _capacity{};
+  std::size_t _size{};
+
+ public:
+  TileCache() = delete;
+  explicit TileCache(std::size_t capacity_bytes);
+
+  [[nodiscard]] auto find(const TileID &key) -> Value;
+  auto emplace(TileID key, Value tile) -> Value;
+  auto emplace(TileID key, std::vector<double> &&tile) -> Value;
+
+  void clear() noexcept;
+
+  [[nodiscard]] constexpr std::size_t capacity_bytes() const noexcept;
+  [[nodiscard]] constexpr std::size_t size_bytes() const noexcept;
+  [[nodiscard]] std::size_t num_tiles() const noexcept;
+
+  [[nodiscard]] constexpr double hit_rate() const noexcept;
+  [[nodiscard]] constexpr std::size_t hits() const noexcept;
+  [[nodiscard]] constexpr std::size_t misses() const noexcept;
+  constexpr void reset_stats() noexcept;
+
+ private:
+  void pop_least_recently_used();
+};
+
+}  // namespace hictk::internal
+
+#include "./impl/tile_cache_impl.hpp"  // NOLINT
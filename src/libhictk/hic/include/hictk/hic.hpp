@@ -47,6 +47,11 @@ class File {
              MatrixUnit unit_ = MatrixUnit::BP, std::uint64_t block_cache_capacity = 0);
   File &open(std::uint32_t resolution_, MatrixType type_ = MatrixType::observed,
              MatrixUnit unit_ = MatrixUnit::BP, std::uint64_t block_cache_capacity = 0);
+  // Open a new handle to the same matrix. The returned File has its own file stream, block cache
+  // and weight cache, but shares the header, the bin table and the footers read so far (i.e. the
+  // index of the interaction blocks) with *this. The returned File can be used from a thread other
+  // than the one using *this.
+  [[nodiscard]] File clone() const;
   [[nodiscard]] bool has_resolution(std::uint32_t resolution) const;
 
   [[nodiscard]] const std::string &path() const noexcept;
@@ -66,7 +71,8 @@ class File {
   [[nodiscard]] constexpr auto matrix_type() const noexcept -> MatrixType;
   [[nodiscard]] constexpr auto matrix_unit() const noexcept -> MatrixUnit;
 
-  [[nodiscard]] PixelSelectorAll fetch(balancing::Method norm = balancing::Method::NONE()) const;
+  [[nodiscard]] PixelSelectorAll fetch(balancing::Method norm = balancing::Method::NONE(),
+                                       std::size_t num_threads = 1) const;
 
   [[nodiscard]] PixelSelector fetch(std::string_view range,
                                     balancing::Method norm = balancing::Method::NONE(),
@@ -93,6 +99,10 @@ class File {
                                                  const Chromosome &chrom) const;
   [[nodiscard]] balancing::Weights normalization(balancing::Method norm) const;
   [[nodiscard]] balancing::Weights normalization(std::string_view norm) const;
+  // Same as normalization(norm, chrom), but weights are cached (and shared with the pixel
+  // selectors returned by fetch()), so that repeated lookups do not copy the weights
+  [[nodiscard]] std::shared_ptr<const balancing::Weights> normalization_ptr(
+      balancing::Method norm, const Chromosome &chrom) const;
 
   [[nodiscard]] std::vector<double> expected_values(
       const Chromosome &chrom,
@@ -100,6 +110,8 @@ class File {
 
   [[nodiscard]] std::size_t num_cached_footers() const noexcept;
   void purge_footer_cache();
+  // Share the footers cached by other, which should refer to the same file, with *this
+  void merge_footer_cache(const File &other);
 
   [[nodiscard]] double block_cache_hit_rate() const noexcept;
   void reset_cache_stats() const noexcept;
@@ -37,6 +37,13 @@ class HiCBlockReader {
   HiCBlockReader(std::shared_ptr<HiCFileReader> hfs, const Index& master_index,
                  std::shared_ptr<const BinTable> bins_, std::shared_ptr<BlockCache> block_cache_);
 
+  // Open a reader for the same matrix backed by a private file handle and block cache.
+  // The returned object can be used from a thread other than the one owning *this.
+  [[nodiscard]] HiCBlockReader clone(std::size_t cache_capacity_bytes) const;
+  // Open a reader for the same matrix that reads blocks through the file handle and block cache
+  // used by other. Readers sharing a file handle must only be used from one thread at a time.
+  [[nodiscard]] HiCBlockReader clone(const HiCBlockReader& other) const;
+
   [[nodiscard]] explicit operator bool() const noexcept;
 
   [[nodiscard]] const Chromosome& chrom1() const noexcept;
@@ -57,11 +64,16 @@ class HiCBlockReader {
                                                              bool cache_block = true);
   [[nodiscard]] std::size_t read_size(const Chromosome& chrom1, const Chromosome& chrom2,
                                       const BlockIndex& idx);
+  // Decode the interactions stored in a decompressed interaction block (.hic v7+).
+  // Bin IDs are relative to the first bin of the chromosomes overlapping the block
+  static void decode(std::int32_t version, BinaryBuffer& src, std::vector<ThinPixel<float>>& dest);
+
   void evict(const InteractionBlock& blk);
   void evict(const Chromosome& chrom1, const Chromosome& chrom2, const BlockIndex& idx);
   void clear() noexcept;
 
   [[nodiscard]] std::size_t cache_size() const noexcept;
+  [[nodiscard]] std::size_t cache_capacity_bytes() const noexcept;
 
  private:
   [[nodiscard]] static Index read_index(HiCFileReader& hfs, const HiCFooter& footer);
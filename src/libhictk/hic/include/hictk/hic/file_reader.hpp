@@ -36,6 +36,9 @@ class HiCFileReader {
  public:
   HiCFileReader() = default;
   explicit HiCFileReader(std::string url);
+  // Open a new stream to the same file. The header is shared with *this instead of being read
+  // again
+  [[nodiscard]] HiCFileReader clone() const;
   [[nodiscard]] inline const std::string &path() const noexcept;
   [[nodiscard]] const HiCHeader &header() const noexcept;
 
@@ -75,10 +78,15 @@ class HiCFileReader {
                                  const Chromosome &chrom2, MatrixUnit wantedUnit,
                                  std::int64_t wantedResolution);
   void readAndInflate(const BlockIndex &idx, std::string &plainTextBuffer);
+  // Read the compressed payload of the given interaction block without inflating it
+  void read_compressed_block(const BlockIndex &idx, std::string &buffer);
+  void inflate(const std::string &compressed_buffer, std::string &plainTextBuffer);
 
   [[nodiscard]] static bool checkMagicString(std::string url) noexcept;
 
  private:
+  HiCFileReader(std::shared_ptr<filestream::FileStream> fs,
+                std::shared_ptr<const HiCHeader> header) noexcept;
   [[nodiscard]] static filestream::FileStream openStream(std::string url);
   // reads the header, storing the positions of the normalization vectors and returning the
   // masterIndexPosition pointer
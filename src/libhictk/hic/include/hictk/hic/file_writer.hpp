@@ -22,7 +22,9 @@
 #include <mutex>
 #include <queue>
 #include <string>
+#include <vector>
 
+#include "hictk/balancing/methods.hpp"
 #include "hictk/balancing/weights.hpp"
 #include "hictk/bin_table.hpp"
 #include "hictk/binary_buffer.hpp"
@@ -30,9 +32,11 @@
 #include "hictk/expected_values_aggregator.hpp"
 #include "hictk/filestream.hpp"
 #include "hictk/hash.hpp"
+#include "hictk/hic/file_reader.hpp"
 #include "hictk/hic/file_writer_data_structures.hpp"
 #include "hictk/hic/footer.hpp"
 #include "hictk/hic/header.hpp"
+#include "hictk/hic/index.hpp"
 #include "hictk/hic/interaction_block.hpp"
 #include "hictk/hic/interaction_to_block_mapper.hpp"
 #include "hictk/tmpdir.hpp"
@@ -106,18 +110,54 @@ class HiCFileWriter {
   using BlockIndex = phmap::btree_map<BlockIndexKey, phmap::btree_set<MatrixBlockMetadata>>;
   using BlockMappers = phmap::flat_hash_map<std::uint32_t, HiCInteractionToBlockMapper>;
 
+  // Matrices whose compressed interaction blocks are copied verbatim from an existing .hic file
+  struct BlockSource {
+    std::shared_ptr<HiCFileReader> reader{};
+    Index index{};
+  };
+  using BlockSources = phmap::btree_map<BlockIndexKey, BlockSource>;
+  // Matrices whose interaction blocks have already been written by add_sorted_pixels()
+  using StreamedMatrices = phmap::btree_map<BlockIndexKey, Stats>;
+
   HiCHeader _header{};
   BinTables _bin_tables{};
   BlockIndex _block_index{};
   BlockMappers _block_mappers{};
+  BlockSources _block_sources{};
+  StreamedMatrices _streamed_matrices{};
 
   using StatsTank = phmap::flat_hash_map<std::uint32_t, Stats>;
   using FooterTank = phmap::btree_map<std::pair<Chromosome, Chromosome>, FooterMasterIndex>;
 
+  // Expected values are aggregated using one ExpectedValuesAggregator per shard, so that threads
+  // writing interaction blocks concurrently rarely need to wait for each other
+  struct ExpectedValuesShard {
+    ExpectedValuesAggregator aggr{};                                  // NOLINT
+    std::unique_ptr<std::mutex> mtx{std::make_unique<std::mutex>()};  // NOLINT
+  };
+  using ExpectedValuesShards = std::vector<ExpectedValuesShard>;
+  // Weights are the genome-wide (divisive) weights for norm
+  struct NormalizedExpectedValuesShards {
+    balancing::Method norm{};       // NOLINT
+    std::vector<double> weights{};  // NOLINT
+    ExpectedValuesShards shards{};  // NOLINT
+  };
+  using ExpectedValuesAggregators = phmap::flat_hash_map<std::uint32_t, ExpectedValuesShards>;
+  using NormalizedExpectedValuesAggregators =
+      phmap::flat_hash_map<std::uint32_t, std::vector<NormalizedExpectedValuesShards>>;
+
   MatrixBodyMetadataTank _matrix_metadata{};
   FooterTank _footers{};
   StatsTank _stats{};
 
+  // Expected values are aggregated while interaction blocks are being written, so that there
+  // is no need to read back interactions from the file that is being written.
+  // Normalized expected values are aggregated for the normalization vectors that were added before
+  // the first interaction block was written
+  std::size_t _num_expected_values_shards{1};
+  ExpectedValuesAggregators _expected_values_aggregators{};
+  NormalizedExpectedValuesAggregators _normalized_expected_values_aggregators{};
+
   std::uint32_t _compression_lvl{};
   BinaryBuffer _bbuffer{};
   std::unique_ptr<libdeflate_compressor> _compressor{};
@@ -138,10 +178,23 @@ class HiCFileWriter {
   BS::thread_pool _tpool{};
 
   bool _skip_all_vs_all_matrix{};
+  // Max. memory used by add_sorted_pixels() to buffer interaction blocks that are not yet complete
+  std::size_t _max_pending_bytes{};
 
   static constexpr std::uint32_t DEFAULT_CHROM_ALL_SCALE_FACTOR{1000};
+  static constexpr std::size_t EXPECTED_VALUES_BATCH_SIZE{1'000'000};
+  static constexpr std::size_t STREAMED_BLOCKS_BATCH_SIZE{64};
+  // Approximate memory footprint of a pixel stored in a MatrixInteractionBlock (btree overhead
+  // included)
+  static constexpr std::size_t PENDING_PIXEL_SIZE{16};
+  static constexpr std::size_t MAX_EXPECTED_VALUES_SHARDS{8};
 
  public:
+  static constexpr std::size_t DEFAULT_BUFFER_SIZE{32'000'000};
+  // Initial size of the buffers used by worker threads to merge and compress interaction blocks.
+  // Buffers grow as needed: most blocks are much smaller than this.
+  static constexpr std::size_t WORKER_BUFFER_SIZE{1'000'000};
+
   HiCFileWriter() = default;
   explicit HiCFileWriter(std::string_view path_, std::size_t n_threads = 1);
   HiCFileWriter(std::string_view path_, Reference chromosomes_,
@@ -149,7 +202,7 @@ class HiCFileWriter {
                 std::size_t n_threads = 1, std::size_t chunk_size = 10'000'000,
                 const std::filesystem::path& tmpdir = std::filesystem::temp_directory_path(),
                 std::uint32_t compression_lvl = 11, bool skip_all_vs_all_matrix = false,
-                std::size_t buffer_size = 32'000'000);
+                std::size_t buffer_size = DEFAULT_BUFFER_SIZE);
 
   [[nodiscard]] std::string_view path() const noexcept;
   [[nodiscard]] const Reference& chromosomes() const noexcept;
@@ -160,6 +213,30 @@ class HiCFileWriter {
   template <typename PixelIt, typename = std::enable_if_t<is_iterable_v<PixelIt>>>
   void add_pixels(std::uint32_t resolution, PixelIt first_pixel, PixelIt last_pixel);
 
+  // Add pixels sorted by (bin1_id, bin2_id) and located in the upper triangle, such as the pixels
+  // stored in Cooler files.
+  // Only the interaction blocks overlapping the band of rows that is currently being processed are
+  // kept in memory: blocks are compressed and written to the output file as soon as they are
+  // complete.
+  // Blocks can stay incomplete for a long time (e.g. intra-chromosomal blocks far from the
+  // diagonal of .hic v9 files): when the pending blocks use more memory than what is used to map
+  // chunk_size pixels, the blocks that will be completed last are handed over to the block mapper
+  // used by add_pixels(), which spills them to temporary files that are merged by serialize().
+  // An exception is thrown if pixels are not sorted, or if interactions for the same matrix have
+  // already been added.
+  template <typename PixelIt, typename = std::enable_if_t<is_iterable_v<PixelIt>>>
+  void add_sorted_pixels(std::uint32_t resolution, PixelIt first_pixel, PixelIt last_pixel);
+
+  // Add all interactions found in the given .hic file at the given resolution.
+  // When the layout of the interaction blocks of a matrix is compatible with the layout used by
+  // HiCFileWriter, compressed blocks are copied to the output file as they are, skipping the
+  // (expensive) decode, block mapping and re-compression steps. Copied blocks are only inflated
+  // to update statistics and expected values.
+  // Matrices that cannot be copied (e.g. because they come from a .hic v8 file) are added by
+  // decoding their pixels as if they were passed to add_pixels().
+  // An exception is thrown if interactions for any of the matrices have already been added.
+  void add_blocks(std::uint32_t resolution, std::string_view path_to_hic);
+
   // Write normalization vectors
   void add_norm_vector(std::string_view type, const Chromosome& chrom, std::string_view unit,
                        std::uint32_t bin_size, const balancing::Weights& weights,
@@ -186,6 +263,13 @@ class HiCFileWriter {
                                                            const BinTables& bin_tables,
                                                            std::size_t chunk_size,
                                                            int compression_lvl) -> BlockMappers;
+  [[nodiscard]] static auto init_expected_values_shards(std::shared_ptr<const BinTable> bins,
+                                                        std::size_t num_shards)
+      -> ExpectedValuesShards;
+  [[nodiscard]] static auto init_expected_values_aggregators(const BinTables& bin_tables,
+                                                             std::size_t num_shards)
+      -> ExpectedValuesAggregators;
+  void init_normalized_expected_values_aggregators();
   [[nodiscard]] BS::thread_pool init_tpool(std::size_t n_threads);
 
   // Write header
@@ -205,6 +289,36 @@ class HiCFileWriter {
                                const MatrixInteractionBlock<float>& blk) -> HiCSectionOffsets;
   auto write_interaction_blocks(const Chromosome& chrom1, const Chromosome& chrom2,
                                 std::uint32_t resolution) -> Stats;
+  auto copy_interaction_blocks(const Chromosome& chrom1, const Chromosome& chrom2,
+                               std::uint32_t resolution) -> Stats;
+  void write_streamed_blocks(
+      std::uint32_t resolution,
+      std::vector<std::pair<HiCInteractionToBlockMapper::BlockID, MatrixInteractionBlock<float>>>&
+          blocks);
+  void add_block_metadata(std::uint64_t block_id, const Chromosome& chrom1,
+                          const Chromosome& chrom2, std::uint32_t resolution,
+                          std::streamoff offset, std::size_t size);
+  void update_expected_values(const Chromosome& chrom1, const Chromosome& chrom2,
+                              std::uint32_t resolution, const MatrixInteractionBlock<float>& blk);
+  void update_expected_values(const Chromosome& chrom1, const Chromosome& chrom2,
+                              std::uint32_t resolution,
+                              const std::vector<ThinPixel<float>>& pixels);
+  // Add interactions to the first shard that is not in use by other threads.
+  // Pixels should use bin IDs relative to chrom1 and chrom2
+  static void update_expected_values(const Chromosome& chrom1, const Chromosome& chrom2,
+                                     ExpectedValuesShards& shards,
+                                     const std::vector<ThinPixel<float>>& pixels);
+  [[nodiscard]] static ExpectedValuesAggregator merge_expected_values_shards(
+      ExpectedValuesShards& shards);
+
+  // Check whether the interaction blocks for the given matrix are copied from another file or
+  // have already been written by add_sorted_pixels()
+  [[nodiscard]] bool has_interaction_blocks(const BlockIndexKey& key) const;
+  [[nodiscard]] bool has_pixels(const Chromosome& chrom1, const Chromosome& chrom2,
+                                std::uint32_t resolution) const;
+  [[nodiscard]] float pixel_sum(const Chromosome& chrom1, const Chromosome& chrom2,
+                                std::uint32_t resolution) const;
+  [[nodiscard]] bool can_copy_blocks(const Index& index, std::int32_t version);
 
   // Normalization
   void add_norm_vector(const NormalizationVectorIndexBlock& blk, const balancing::Weights& weights,
@@ -235,10 +349,23 @@ class HiCFileWriter {
                                                        std::uint32_t resolution);
   [[nodiscard]] std::size_t compute_num_bins(const Chromosome& chrom1, const Chromosome& chrom2,
                                              std::uint32_t resolution);
+  [[nodiscard]] std::size_t compute_block_bin_count(const Chromosome& chrom1,
+                                                    const Chromosome& chrom2,
+                                                    std::uint32_t resolution);
 
+  // Compute expected values by reading interactions from the file that is being written
   [[nodiscard]] ExpectedValuesBlock compute_expected_values(std::uint32_t resolution);
-  [[nodiscard]] NormalizedExpectedValuesBlock compute_normalized_expected_values(
-      std::uint32_t resolution, const balancing::Method& norm);
+  [[nodiscard]] static ExpectedValuesBlock compute_expected_values(std::uint32_t resolution,
+                                                                   ExpectedValuesAggregator& aggr);
+  [[nodiscard]] static NormalizedExpectedValuesBlock compute_normalized_expected_values(
+      std::uint32_t resolution, const balancing::Method& norm, ExpectedValuesAggregator& aggr);
+  // Compute the normalized expected values for all norms with a single pass over the raw
+  // interactions read back from the file. Weights are taken from the normalization vectors kept
+  // in memory
+  [[nodiscard]] std::vector<NormalizedExpectedValuesBlock> compute_normalized_expected_values(
+      std::uint32_t resolution, const std::vector<balancing::Method>& norms);
+  [[nodiscard]] std::vector<double> genome_wide_weights(std::uint32_t resolution,
+                                                        const balancing::Method& norm) const;
 
   void add_norm_expected_values(const NormalizedExpectedValuesBlock& blk,
                                 bool force_overwrite = false);
@@ -250,8 +377,9 @@ class HiCFileWriter {
 
   // Methods to be called from worker threads
   auto merge_and_compress_blocks_thr(
-      HiCInteractionToBlockMapper& mapper, std::mutex& mapper_mtx,
-      std::queue<std::uint64_t>& block_id_queue, std::mutex& block_id_queue_mtx,
+      const Chromosome& chrom1, const Chromosome& chrom2, std::uint32_t resolution,
+      HiCInteractionToBlockMapper& mapper, std::queue<std::uint64_t>& block_id_queue,
+      std::mutex& block_id_queue_mtx,
       moodycamel::BlockingConcurrentQueue<HiCInteractionToBlockMapper::BlockID>& block_queue,
       phmap::flat_hash_map<std::uint64_t, std::string>& serialized_block_tank,
       std::mutex& serialized_block_tank_mtx, std::atomic<bool>& early_return,
@@ -53,6 +53,9 @@ class FooterCache {
   [[nodiscard]] auto emplace(HiCFooter f) -> decltype(_footers.emplace());
   [[nodiscard]] auto find(const HiCFooterMetadata& m) -> const_iterator;
 
+  // Add the footers from other that are missing from *this. Footers are shared, not copied
+  void merge(const FooterCache& other);
+
   [[nodiscard]] std::size_t size() const noexcept;
   void clear();
 };
@@ -32,6 +32,17 @@ inline HiCBlockReader::HiCBlockReader(std::shared_ptr<HiCFileReader> hfs, const
       _bins(std::move(bins_)),
       _index(master_index) {}
 
+inline HiCBlockReader HiCBlockReader::clone(std::size_t cache_capacity_bytes) const {
+  assert(_hfs);
+  return {std::make_shared<HiCFileReader>(_hfs->clone()), _index, _bins,
+          std::make_shared<BlockCache>(cache_capacity_bytes)};
+}
+
+inline HiCBlockReader HiCBlockReader::clone(const HiCBlockReader &other) const {
+  assert(other._hfs);
+  return {other._hfs, _index, _bins, other._blk_cache};
+}
+
 inline HiCBlockReader::operator bool() const noexcept { return !!_hfs; }
 
 inline const Chromosome &HiCBlockReader::chrom1() const noexcept { return _index.chrom1(); }
@@ -123,18 +134,32 @@ inline std::shared_ptr<const InteractionBlock> HiCBlockReader::read(const Chromo
   }
 
   _hfs->readAndInflate(idx, _bbuffer.reset());
+  decode(_hfs->version(), _bbuffer, _tmp_buffer);
 
-  const auto nRecords = static_cast<std::size_t>(_bbuffer.read<std::int32_t>());
-  _tmp_buffer.resize(nRecords);
+  if (!cache_block) {
+    return std::make_shared<const InteractionBlock>(
+        InteractionBlock{idx.id(), _index.block_bin_count(), std::move(_tmp_buffer)});
+  }
 
-  const auto bin1Offset = _bbuffer.read<std::int32_t>();
-  const auto bin2Offset = _bbuffer.read<std::int32_t>();
+  return _blk_cache->emplace(
+      chrom1.id(), chrom2.id(), idx.id(),
+      InteractionBlock{idx.id(), _index.block_bin_count(), std::move(_tmp_buffer)});
+}
 
-  const auto i16Counts = _bbuffer.read<char>() == 0;
+inline void HiCBlockReader::decode(std::int32_t version, BinaryBuffer &src,
+                                   std::vector<ThinPixel<float>> &dest) {
+  assert(version > 6);
+  const auto nRecords = static_cast<std::size_t>(src.read<std::int32_t>());
+  dest.resize(nRecords);
+
+  const auto bin1Offset = src.read<std::int32_t>();
+  const auto bin2Offset = src.read<std::int32_t>();
+
+  const auto i16Counts = src.read<char>() == 0;
 
   auto readUseShortBinFlag = [&]() {
-    if (_hfs->version() > 8) {
-      return _bbuffer.read<char>() == 0;
+    if (version > 8) {
+      return src.read<char>() == 0;
     }
     return true;
   };
@@ -142,7 +167,7 @@ inline std::shared_ptr<const InteractionBlock> HiCBlockReader::read(const Chromo
   const auto i16Bin1 = readUseShortBinFlag();
   const auto i16Bin2 = readUseShortBinFlag();
 
-  const auto type = static_cast<std::int8_t>(_bbuffer.read<char>());
+  const auto type = static_cast<std::int8_t>(src.read<char>());
   if (type != 1 && type != 2) {
     throw std::runtime_error(
         fmt::format(FMT_STRING("uknown interaction type \"{}\". Supported types: 1, 2"), type));
@@ -150,28 +175,18 @@ inline std::shared_ptr<const InteractionBlock> HiCBlockReader::read(const Chromo
 
   switch (type) {
     case 1:
-      read_dispatcher_type1_block(i16Bin1, i16Bin2, i16Counts, bin1Offset, bin2Offset, _bbuffer,
-                                  _tmp_buffer);
+      read_dispatcher_type1_block(i16Bin1, i16Bin2, i16Counts, bin1Offset, bin2Offset, src, dest);
       break;
     case 2:
       if (i16Counts) {
-        read_type2_block<std::int16_t>(bin1Offset, bin2Offset, _bbuffer, _tmp_buffer);
+        read_type2_block<std::int16_t>(bin1Offset, bin2Offset, src, dest);
         break;
       }
-      read_type2_block<float>(bin1Offset, bin2Offset, _bbuffer, _tmp_buffer);
+      read_type2_block<float>(bin1Offset, bin2Offset, src, dest);
       break;
     default:
       HICTK_UNREACHABLE_CODE;
   }
-
-  if (!cache_block) {
-    return std::make_shared<const InteractionBlock>(
-        InteractionBlock{idx.id(), _index.block_bin_count(), std::move(_tmp_buffer)});
-  }
-
-  return _blk_cache->emplace(
-      chrom1.id(), chrom2.id(), idx.id(),
-      InteractionBlock{idx.id(), _index.block_bin_count(), std::move(_tmp_buffer)});
 }
 
 inline std::size_t HiCBlockReader::read_size(const Chromosome &chrom1, const Chromosome &chrom2,
@@ -205,6 +220,10 @@ inline void HiCBlockReader::clear() noexcept { _blk_cache->clear(); }
 
 inline std::size_t HiCBlockReader::cache_size() const noexcept { return _blk_cache->size(); }
 
+inline std::size_t HiCBlockReader::cache_capacity_bytes() const noexcept {
+  return _blk_cache->capacity_bytes();
+}
+
 inline void HiCBlockReader::read_dispatcher_type1_block(
     bool i16Bin1, bool i16Bin2, bool i16Counts, std::int32_t bin1Offset, std::int32_t bin2Offset,
     BinaryBuffer &src, std::vector<ThinPixel<float>> &dest) noexcept {
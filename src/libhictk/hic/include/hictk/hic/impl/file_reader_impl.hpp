@@ -36,6 +36,16 @@ inline HiCFileReader::HiCFileReader(std::string url)
     : _fs(std::make_shared<filestream::FileStream>(HiCFileReader::openStream(std::move(url)))),
       _header(std::make_shared<const HiCHeader>(HiCFileReader::readHeader(*_fs))) {}
 
+inline HiCFileReader::HiCFileReader(std::shared_ptr<filestream::FileStream> fs,
+                                    std::shared_ptr<const HiCHeader> header) noexcept
+    : _fs(std::move(fs)), _header(std::move(header)) {}
+
+inline HiCFileReader HiCFileReader::clone() const {
+  assert(_fs);
+  return {std::make_shared<filestream::FileStream>(HiCFileReader::openStream(_fs->path())),
+          _header};
+}
+
 inline filestream::FileStream HiCFileReader::openStream(std::string url) {
   try {
     return filestream::FileStream(url);
@@ -250,41 +260,50 @@ inline void HiCFileReader::readAndInflate(const BlockIndex &idx, std::string &pl
   try {
     // _strbuff is used to store compressed data
     // plainTextBuffer is used to store decompressed data
-    assert(_decompressor);
-    assert(idx.compressed_size_bytes() > 0);
-    const auto buffSize = idx.compressed_size_bytes();
-
-    plainTextBuffer.reserve(buffSize * 3);
-    plainTextBuffer.resize(plainTextBuffer.capacity());
-
-    _fs->seekg(static_cast<std::int64_t>(idx.file_offset()));
-    _fs->read(_strbuff, buffSize);
-
-    std::size_t bytes_decompressed{};
-
-    while (true) {
-      using LR = libdeflate_result;
-      const auto status = libdeflate_zlib_decompress(_decompressor.get(), _strbuff.data(),
-                                                     _strbuff.size(), plainTextBuffer.data(),
-                                                     plainTextBuffer.size(), &bytes_decompressed);
-      if (status == LR::LIBDEFLATE_SUCCESS) {
-        plainTextBuffer.resize(bytes_decompressed);
-        break;
-      }
-      if (status == LR::LIBDEFLATE_INSUFFICIENT_SPACE) {
-        plainTextBuffer.resize(plainTextBuffer.size() + buffSize);
-        continue;
-      }
-      if (status == LR::LIBDEFLATE_BAD_DATA) {
-        throw std::runtime_error("invalid or corrupted data");
-      }
-    }
+    read_compressed_block(idx, _strbuff);
+    inflate(_strbuff, plainTextBuffer);
   } catch (const std::exception &e) {
     throw std::runtime_error(fmt::format(FMT_STRING("failed to decompress block at pos {}: {}"),
                                          idx.file_offset(), e.what()));
   }
 }
 
+inline void HiCFileReader::read_compressed_block(const BlockIndex &idx, std::string &buffer) {
+  assert(idx.compressed_size_bytes() > 0);
+  _fs->seekg(static_cast<std::int64_t>(idx.file_offset()));
+  _fs->read(buffer, idx.compressed_size_bytes());
+}
+
+inline void HiCFileReader::inflate(const std::string &compressed_buffer,
+                                   std::string &plainTextBuffer) {
+  assert(_decompressor);
+  assert(!compressed_buffer.empty());
+  const auto buffSize = compressed_buffer.size();
+
+  plainTextBuffer.reserve(buffSize * 3);
+  plainTextBuffer.resize(plainTextBuffer.capacity());
+
+  std::size_t bytes_decompressed{};
+
+  while (true) {
+    using LR = libdeflate_result;
+    const auto status = libdeflate_zlib_decompress(_decompressor.get(), compressed_buffer.data(),
+                                                   compressed_buffer.size(), plainTextBuffer.data(),
+                                                   plainTextBuffer.size(), &bytes_decompressed);
+    if (status == LR::LIBDEFLATE_SUCCESS) {
+      plainTextBuffer.resize(bytes_decompressed);
+      break;
+    }
+    if (status == LR::LIBDEFLATE_INSUFFICIENT_SPACE) {
+      plainTextBuffer.resize(plainTextBuffer.size() + buffSize);
+      continue;
+    }
+    if (status == LR::LIBDEFLATE_BAD_DATA) {
+      throw std::runtime_error("invalid or corrupted data");
+    }
+  }
+}
+
 inline bool HiCFileReader::checkMagicString(std::string url) noexcept {
   try {
     filestream::FileStream fs(HiCFileReader::openStream(std::move(url)));
@@ -26,12 +26,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <exception>
+#include <functional>
+#include <future>
 #include <ios>
+#include <limits>
 #include <memory>
+#include <nonstd/span.hpp>
 #include <numeric>
 #include <queue>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -185,11 +190,16 @@ inline HiCFileWriter::HiCFileWriter(std::string_view path_, Reference chromosome
                           skip_all_vs_all_matrix)),
       _bin_tables(init_bin_tables(chromosomes(), resolutions())),
       _block_mappers(init_interaction_block_mappers(_tmpdir, _bin_tables, chunk_size, 3)),
+      _num_expected_values_shards(
+          std::clamp(n_threads, std::size_t(1), MAX_EXPECTED_VALUES_SHARDS)),
+      _expected_values_aggregators(
+          init_expected_values_aggregators(_bin_tables, _num_expected_values_shards)),
       _compression_lvl(compression_lvl),
       _compressor(libdeflate_alloc_compressor(static_cast<std::int32_t>(compression_lvl))),
       _compression_buffer(buffer_size, '\0'),
       _tpool(init_tpool(n_threads)),
-      _skip_all_vs_all_matrix(skip_all_vs_all_matrix) {
+      _skip_all_vs_all_matrix(skip_all_vs_all_matrix),
+      _max_pending_bytes(chunk_size * sizeof(ThinPixel<float>)) {
   if (!std::filesystem::exists(_tmpdir)) {
     throw std::runtime_error(
         fmt::format(FMT_STRING("temporary directory {} does not exist"), _tmpdir));
@@ -218,12 +228,17 @@ inline auto HiCFileWriter::stats(std::uint32_t resolution) const noexcept -> Sta
 
 inline void HiCFileWriter::serialize() {
   try {
-    write_header();
+    if (_header_section.size() == 0) {
+      // the header has already been written when pixels are added with add_sorted_pixels()
+      write_header();
+    }
     write_pixels(_skip_all_vs_all_matrix);
     finalize(true);
     for (auto &[_, mapper] : _block_mappers) {
       mapper.clear();
     }
+    _block_sources.clear();
+    _streamed_matrices.clear();
   } catch (const std::exception &e) {
     throw std::runtime_error(fmt::format(
         FMT_STRING("an error occurred while writing file \"{}\": {}"), path(), e.what()));
@@ -246,6 +261,9 @@ inline void HiCFileWriter::write_header() {
     _data_block_section = {offset2, 0};
     _body_metadata_section = {offset2, 0};
     _footer_section = {offset2, 0};
+
+    // interaction blocks are written right after the header
+    init_normalized_expected_values_aggregators();
   } catch (const std::exception &e) {
     throw std::runtime_error(fmt::format(
         FMT_STRING("an error occurred while writing the .hic header for file \"{}\" to disk: {}"),
@@ -318,13 +336,343 @@ inline void HiCFileWriter::add_pixels(std::uint32_t resolution, PixelIt first_pi
   }
 }
 
+template <typename PixelIt, typename>
+inline void HiCFileWriter::add_sorted_pixels(std::uint32_t resolution, PixelIt first_pixel,
+                                             PixelIt last_pixel) {
+  using BlockMapper = HiCInteractionToBlockMapper;
+  // Blocks are ready to be written once the rows being processed are past the last row that can
+  // overlap the block. Blocks are thus ranked by (chrom1_id, rel. bin1_id of the first row
+  // following the block, block ID)
+  using PendingBlock = std::tuple<std::uint32_t, std::uint64_t, BlockMapper::BlockID>;
+
+  struct MatrixState {
+    Chromosome chrom1{};
+    Chromosome chrom2{};
+    std::uint64_t block_bin_count{};
+    BlockMapper::BlockMapperIntra mapper_intra{1, 1};
+    BlockMapper::BlockMapperInter mapper_inter{1, 1};
+  };
+
+  try {
+    const auto &bins = *_bin_tables.at(resolution);
+    auto &block_mapper = _block_mappers.at(resolution);
+    if (_header_section.size() == 0) {
+      write_header();
+    }
+
+    using PendingBlockMap =
+        phmap::flat_hash_map<BlockMapper::BlockID,
+                             std::pair<PendingBlock, MatrixInteractionBlock<float>>>;
+    PendingBlockMap blocks{};
+    std::priority_queue<PendingBlock, std::vector<PendingBlock>, std::greater<>> pending_blocks{};
+    std::vector<std::pair<BlockMapper::BlockID, MatrixInteractionBlock<float>>> ready_blocks{};
+    std::size_t pending_pixels = 0;
+
+    // Blocks that would not fit in memory are handed over to the block mapper, which spills them
+    // to temporary files that are read back and merged by serialize()
+    phmap::flat_hash_set<BlockMapper::BlockID> spilled_blocks{};
+    std::vector<ThinPixel<float>> spilled_pixels{};
+    auto flush_spilled_pixels = [&]() {
+      block_mapper.append_pixels(spilled_pixels.begin(), spilled_pixels.end(), _tpool);
+      spilled_pixels.clear();
+    };
+    auto spill_blocks = [&]() {
+      // spill the blocks that will be completed last until half of the memory budget is free
+      std::vector<PendingBlock> candidates{};
+      candidates.reserve(blocks.size());
+      for (const auto &[_, blk] : blocks) {
+        candidates.emplace_back(blk.first);
+      }
+      std::sort(candidates.begin(), candidates.end(), std::greater<>{});
+      for (const auto &[chrom1_id, next_row, bid] : candidates) {
+        if (pending_pixels * PENDING_PIXEL_SIZE <= _max_pending_bytes / 2) {
+          break;
+        }
+        auto match = blocks.find(bid);
+        const auto &chrom1 = chromosomes().at(bid.chrom1_id);
+        const auto &chrom2 = chromosomes().at(bid.chrom2_id);
+        const auto bin1_offset = bins.at(chrom1).id();
+        const auto bin2_offset = bins.at(chrom2).id();
+        const auto &blk = match->second.second;
+        for (const auto &[row, pixels] : blk()) {
+          for (const auto &p : pixels) {
+            spilled_pixels.emplace_back(ThinPixel<float>{
+                bin1_offset + static_cast<std::uint64_t>(p.column),
+                bin2_offset + static_cast<std::uint64_t>(row), p.count});
+          }
+        }
+        pending_pixels -= blk.size();
+        spilled_blocks.emplace(bid);
+        blocks.erase(match);
+      }
+      SPDLOG_DEBUG(FMT_STRING("[{} bp] spilled {} pixels to the interaction block mapper"),
+                   resolution, spilled_pixels.size());
+      flush_spilled_pixels();
+    };
+    auto pop_pending_block = [&]() {
+      // blocks that have been spilled are no longer tracked by blocks
+      auto match = blocks.find(std::get<2>(pending_blocks.top()));
+      if (match != blocks.end()) {
+        pending_pixels -= match->second.second.size();
+        ready_blocks.emplace_back(match->first, std::move(match->second.second));
+        blocks.erase(match);
+      }
+      pending_blocks.pop();
+    };
+
+    phmap::flat_hash_map<std::pair<std::uint32_t, std::uint32_t>, MatrixState> matrices{};
+    const MatrixState *matrix{};
+
+    std::uint64_t prev_bin1_id = 0;
+    std::uint64_t prev_bin2_id = 0;
+    bool first = true;
+
+    for (; first_pixel != last_pixel; std::ignore = ++first_pixel) {
+      const auto p = internal::process_pixel_interaction_block(bins, *first_pixel);
+      const auto bin1_id = p.coords.bin1.id();
+      const auto bin2_id = p.coords.bin2.id();
+      if (bin1_id > bin2_id) {
+        throw std::runtime_error(
+            fmt::format(FMT_STRING("pixel {}:{} does not overlap the upper triangle"), bin1_id,
+                        bin2_id));
+      }
+      const auto sorted =
+          first || std::make_pair(bin1_id, bin2_id) > std::make_pair(prev_bin1_id, prev_bin2_id);
+      if (!sorted) {
+        throw std::runtime_error(fmt::format(
+            FMT_STRING("pixels are not sorted: pixel {}:{} follows pixel {}:{}"), bin1_id, bin2_id,
+            prev_bin1_id, prev_bin2_id));
+      }
+      first = false;
+      prev_bin1_id = bin1_id;
+      prev_bin2_id = bin2_id;
+
+      const auto &chrom1 = p.coords.bin1.chrom();
+      const auto &chrom2 = p.coords.bin2.chrom();
+      const auto rel_bin1_id = p.coords.bin1.rel_id();
+      const auto rel_bin2_id = p.coords.bin2.rel_id();
+
+      while (!pending_blocks.empty()) {
+        const auto &[chrom1_id, next_row, _] = pending_blocks.top();
+        if (chrom1_id == chrom1.id() && next_row > rel_bin1_id) {
+          break;
+        }
+        pop_pending_block();
+      }
+      if (ready_blocks.size() >= STREAMED_BLOCKS_BATCH_SIZE) {
+        write_streamed_blocks(resolution, ready_blocks);
+      }
+
+      if (!matrix || matrix->chrom1 != chrom1 || matrix->chrom2 != chrom2) {
+        auto [it, inserted] = matrices.try_emplace(std::make_pair(chrom1.id(), chrom2.id()));
+        if (inserted) {
+          if (has_interaction_blocks(BlockIndexKey{chrom1, chrom2, resolution}) ||
+              !block_mapper.empty(chrom1, chrom2)) {
+            throw std::runtime_error(
+                fmt::format(FMT_STRING("interactions for {}:{} have already been added"),
+                            chrom1.name(), chrom2.name()));
+          }
+          const auto num_columns = compute_block_column_count(chrom1, chrom2, resolution);
+          const auto num_rows = compute_block_bin_count(chrom1, chrom2, resolution);
+          it->second = MatrixState{chrom1, chrom2, num_rows,
+                                   BlockMapper::BlockMapperIntra{num_rows, num_columns},
+                                   BlockMapper::BlockMapperInter{num_rows, num_columns}};
+          _streamed_matrices.emplace(BlockIndexKey{chrom1, chrom2, resolution}, Stats{});
+        }
+        matrix = &it->second;
+      }
+
+      const auto block_bin_count = matrix->block_bin_count;
+      const auto is_intra = chrom1 == chrom2;
+      const BlockMapper::BlockID bid{chrom1.id(), chrom2.id(),
+                                     is_intra ? matrix->mapper_intra(rel_bin1_id, rel_bin2_id)
+                                              : matrix->mapper_inter(rel_bin1_id, rel_bin2_id)};
+
+      if (!spilled_blocks.empty() && spilled_blocks.contains(bid)) {
+        spilled_pixels.emplace_back(ThinPixel<float>{bin1_id, bin2_id, p.count});
+        if (spilled_pixels.size() >= BlockMapper::DEFAULT_BATCH_SIZE) {
+          flush_spilled_pixels();
+        }
+        continue;
+      }
+
+      auto match = blocks.find(bid);
+      if (match == blocks.end()) {
+        // intra-chromosomal blocks span the pixels whose mid-point along the diagonal falls in the
+        // same block row, and pixels are in the upper triangle: the last row that can overlap a
+        // block is thus the last row of the block row.
+        // For v9 files this means that blocks far from the diagonal stay pending for a long time,
+        // which is why the number of pending pixels is capped (see spill_blocks)
+        const auto block_row = is_intra ? ((rel_bin1_id + rel_bin2_id) / 2) / block_bin_count
+                                        : rel_bin1_id / block_bin_count;
+        const PendingBlock key{chrom1.id(), (block_row + 1) * block_bin_count, bid};
+        pending_blocks.emplace(key);
+        match = blocks.emplace(bid, std::make_pair(key, MatrixInteractionBlock<float>{})).first;
+      }
+      match->second.second.emplace_back(Pixel<float>{p});
+      ++pending_pixels;
+
+      if (pending_pixels * PENDING_PIXEL_SIZE > _max_pending_bytes) {
+        spill_blocks();
+      }
+    }
+
+    while (!pending_blocks.empty()) {
+      pop_pending_block();
+    }
+    write_streamed_blocks(resolution, ready_blocks);
+    flush_spilled_pixels();
+    _fs.flush();
+  } catch (const std::exception &e) {
+    throw std::runtime_error(fmt::format(
+        FMT_STRING(
+            "an error occurred while adding sorted pixels for resolution {} to file \"{}\": {}"),
+        resolution, path(), e.what()));
+  }
+}
+
+inline void HiCFileWriter::write_streamed_blocks(
+    std::uint32_t resolution,
+    std::vector<std::pair<HiCInteractionToBlockMapper::BlockID, MatrixInteractionBlock<float>>>
+        &blocks) {
+  if (blocks.empty()) {
+    return;
+  }
+
+  for (auto &[bid, blk] : blocks) {
+    const auto &chrom1 = chromosomes().at(bid.chrom1_id);
+    const auto &chrom2 = chromosomes().at(bid.chrom2_id);
+    blk.finalize();
+    auto &stats = _streamed_matrices.at(BlockIndexKey{chrom1, chrom2, resolution});
+    stats.sum += blk.sum();
+    stats.nnz += blk.size();
+  }
+
+  std::vector<std::string> serialized_blocks(blocks.size());
+  auto serialize_blocks = [&](std::size_t first, std::size_t last) {
+    BinaryBuffer bbuffer{};
+    std::string compression_buffer{};
+    std::unique_ptr<libdeflate_compressor> compressor(
+        libdeflate_alloc_compressor(static_cast<std::int32_t>(_compression_lvl)));
+    for (std::size_t i = first; i < last; ++i) {
+      const auto &[bid, blk] = blocks[i];
+      update_expected_values(chromosomes().at(bid.chrom1_id), chromosomes().at(bid.chrom2_id),
+                             resolution, blk);
+      std::ignore = blk.serialize(bbuffer, *compressor, compression_buffer);
+      serialized_blocks[i] = compression_buffer;
+    }
+  };
+
+  const auto num_tasks = std::min(blocks.size(), std::size_t{_tpool.get_thread_count()});
+  if (num_tasks < 2) {
+    serialize_blocks(0, blocks.size());
+  } else {
+    std::vector<std::future<void>> tasks{};
+    const auto chunk_size = (blocks.size() + num_tasks - 1) / num_tasks;
+    for (std::size_t i = 0; i < blocks.size(); i += chunk_size) {
+      const auto last = std::min(i + chunk_size, blocks.size());
+      tasks.emplace_back(_tpool.submit_task([&, i, last]() { serialize_blocks(i, last); }));
+    }
+    for (auto &task : tasks) {
+      task.get();
+    }
+  }
+
+  const auto offset = _data_block_section.end();
+  _fs.seekp(offset);
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    const auto &bid = blocks[i].first;
+    const auto block_offset = _fs.tellp();
+    _fs.write(serialized_blocks[i]);
+    add_block_metadata(bid.bid, chromosomes().at(bid.chrom1_id), chromosomes().at(bid.chrom2_id),
+                       resolution, static_cast<std::streamoff>(block_offset),
+                       _fs.tellp() - block_offset);
+  }
+  _data_block_section.size() += _fs.tellp() - static_cast<std::size_t>(offset);
+  blocks.clear();
+}
+
+inline void HiCFileWriter::add_blocks(std::uint32_t resolution, std::string_view path_to_hic) {
+  try {
+    if (_block_mappers.find(resolution) == _block_mappers.end()) {
+      throw std::runtime_error(
+          fmt::format(FMT_STRING("file does not have resolution {}"), resolution));
+    }
+
+    const File f(std::string{path_to_hic}, resolution);
+    if (f.chromosomes() != chromosomes()) {
+      throw std::runtime_error("files have different reference genomes");
+    }
+
+    auto reader = std::make_shared<HiCFileReader>(std::string{path_to_hic});
+    std::size_t num_copied = 0;
+    std::size_t num_decoded = 0;
+    for (std::uint32_t chrom1_id = 0; chrom1_id < chromosomes().size(); ++chrom1_id) {
+      const auto &chrom1 = chromosomes().at(chrom1_id);
+      if (chrom1.is_all()) {
+        continue;
+      }
+      for (std::uint32_t chrom2_id = chrom1_id; chrom2_id < chromosomes().size(); ++chrom2_id) {
+        const auto &chrom2 = chromosomes().at(chrom2_id);
+        if (chrom2.is_all()) {
+          continue;
+        }
+
+        const auto sel = f.fetch(chrom1.name(), chrom2.name());
+        if (sel.empty()) {
+          continue;
+        }
+
+        // matrices that required decoding are tracked by the block mapper
+        const BlockIndexKey key{chrom1, chrom2, resolution};
+        if (has_pixels(chrom1, chrom2, resolution)) {
+          throw std::runtime_error(fmt::format(
+              FMT_STRING("interaction blocks for {}:{} have already been added"), chrom1.name(),
+              chrom2.name()));
+        }
+
+        if (can_copy_blocks(sel.index(), f.version())) {
+          _block_sources.emplace(key, BlockSource{reader, sel.index()});
+          ++num_copied;
+        } else {
+          SPDLOG_DEBUG(FMT_STRING("[{} bp] interaction blocks for {}:{} cannot be copied as they "
+                                  "are: decoding pixels instead"),
+                       resolution, chrom1.name(), chrom2.name());
+          _block_mappers.at(resolution).append_pixels(sel.begin<float>(), sel.end<float>(),
+                                                      _tpool);
+          ++num_decoded;
+        }
+      }
+    }
+    SPDLOG_INFO(FMT_STRING("[{} bp] copying interaction blocks for {} matrices ({} matrices "
+                           "require decoding)"),
+                resolution, num_copied, num_decoded);
+  } catch (const std::exception &e) {
+    throw std::runtime_error(
+        fmt::format(FMT_STRING("an error occurred while adding interaction blocks for resolution "
+                               "{} from file \"{}\" to file \"{}\": {}"),
+                    resolution, path_to_hic, path(), e.what()));
+  }
+}
+
 inline void HiCFileWriter::write_pixels(bool skip_all_vs_all_matrix) {
   SPDLOG_INFO(FMT_STRING("begin writing interaction blocks to file \"{}\"..."), path());
   const auto &chrom_idx = _block_mappers.at(resolutions().front()).chromosome_index();
   std::vector<std::pair<Chromosome, Chromosome>> chroms{chrom_idx.size()};
   std::transform(chrom_idx.begin(), chrom_idx.end(), chroms.begin(),
                  [](const auto &kv) { return kv.first; });
+  for (const auto &[key, _] : _block_sources) {
+    if (key.resolution == resolutions().front()) {
+      chroms.emplace_back(key.chrom1, key.chrom2);
+    }
+  }
+  for (const auto &[key, _] : _streamed_matrices) {
+    if (key.resolution == resolutions().front()) {
+      chroms.emplace_back(key.chrom1, key.chrom2);
+    }
+  }
   std::sort(chroms.begin(), chroms.end());
+  chroms.erase(std::unique(chroms.begin(), chroms.end()), chroms.end());
 
   for (const auto &[chrom1, chrom2] : chroms) {
     if (chrom1.is_all() || chrom2.is_all()) {
@@ -375,7 +723,8 @@ inline void HiCFileWriter::write_all_matrix(std::uint32_t target_num_bins) {
         HiCInteractionToBlockMapper::compute_num_bins(chrom, chrom, target_resolution_scaled);
     const auto num_columns = HiCInteractionToBlockMapper::compute_block_column_count(
         chrom, chrom, target_resolution_scaled, HiCInteractionToBlockMapper::DEFAULT_INTER_CUTOFF);
-    const auto num_rows = num_bins / num_columns + 1;
+    const auto num_rows =
+        HiCInteractionToBlockMapper::compute_block_bin_count(num_bins, num_columns);
 
     HiCInteractionToBlockMapper::BlockMapperIntra mapper{num_rows, num_columns};
 
@@ -446,7 +795,7 @@ inline auto HiCFileWriter::write_pixels(const Chromosome &chrom1, const Chromoso
     const auto res = resolutions()[i];
 
     auto &mapper = _block_mappers.at(res);
-    if (mapper.empty(chrom1, chrom2)) {
+    if (!has_pixels(chrom1, chrom2, res)) {
       try {
         for (std::size_t j = 0; j < i; ++j) {
           if (res % resolutions()[j] == 0) {
@@ -475,7 +824,7 @@ inline auto HiCFileWriter::write_pixels(const Chromosome &chrom1, const Chromoso
       }
     }
 
-    if (mapper.empty(chrom1, chrom2)) {
+    if (!has_pixels(chrom1, chrom2, res)) {
       SPDLOG_WARN(FMT_STRING("[{} bp] no pixels found for {}:{} matrix: SKIPPING!"), res,
                   chrom1.name(), chrom2.name());
       continue;
@@ -537,7 +886,7 @@ inline void HiCFileWriter::add_body_metadata(std::uint32_t resolution, const Chr
   SPDLOG_DEBUG(FMT_STRING("adding MatrixBodyMetadata for {}:{} at {} {}"), chrom1.name(),
                chrom2.name(), resolution, unit);
   const auto sum_counts =
-      chrom1.name() == "__ALL__" ? 1.0F : _block_mappers.at(resolution).pixel_sum(chrom1, chrom2);
+      chrom1.name() == "__ALL__" ? 1.0F : pixel_sum(chrom1, chrom2, resolution);
   if (sum_counts == 0) {
     return;
   }
@@ -549,9 +898,8 @@ inline void HiCFileWriter::add_body_metadata(std::uint32_t resolution, const Chr
     auto &mm = metadata.matrixMetadata;
     MatrixResolutionMetadata mrm{};
 
-    const auto num_bins = compute_num_bins(chrom1, chrom2, resolution);
     const auto num_columns = compute_block_column_count(chrom1, chrom2, resolution);
-    const auto num_rows = num_bins / num_columns + 1;
+    const auto num_rows = compute_block_bin_count(chrom1, chrom2, resolution);
 
     mrm.unit = unit;
     mrm.resIdx = static_cast<std::int32_t>(std::distance(
@@ -640,7 +988,8 @@ inline void HiCFileWriter::add_footer(const Chromosome &chrom1, const Chromosome
 
 inline void HiCFileWriter::write_norm_vectors_and_norm_expected_values() {
   // we are writing the norm vectors twice because the function computing the norm expected values
-  // expects the normalization vectors to be available in the file that is being written
+  // reads interactions from the file that is being written, which thus needs to be in a
+  // consistent state
   write_norm_vectors();
   compute_and_write_normalized_expected_values();
   write_norm_vectors();
@@ -690,22 +1039,18 @@ inline ExpectedValuesBlock HiCFileWriter::compute_expected_values(std::uint32_t
     const auto sel = f.fetch();
 
     ExpectedValuesAggregator aggr(_bin_tables.at(resolution));
-    std::for_each(sel.begin<float>(), sel.end<float>(), [&](const auto &p) { aggr.add(p); });
-    aggr.compute_density();
-
-    std::vector<float> weights(aggr.weights().size());
-    std::transform(aggr.weights().begin(), aggr.weights().end(), weights.begin(),
-                   [](const auto w) { return static_cast<float>(w); });
-
-    std::vector<std::uint32_t> chrom_ids{};
-    std::vector<double> scaling_factors{};
-    std::for_each(aggr.scaling_factors().begin(), aggr.scaling_factors().end(),
-                  [&](const auto &kv) {
-                    chrom_ids.push_back(kv.first.id());
-                    scaling_factors.push_back(kv.second);
-                  });
-
-    return {"BP", resolution, aggr.weights(), chrom_ids, scaling_factors};
+    std::vector<ThinPixel<float>> buffer{};
+    buffer.reserve(EXPECTED_VALUES_BATCH_SIZE);
+    auto first = sel.begin<float>();
+    auto last = sel.end<float>();
+    while (first != last) {
+      buffer.clear();
+      for (; first != last && buffer.size() < EXPECTED_VALUES_BATCH_SIZE; ++first) {
+        buffer.push_back(*first);
+      }
+      aggr.add(nonstd::span<const ThinPixel<float>>(buffer));
+    }
+    return compute_expected_values(resolution, aggr);
   } catch (const std::exception &e) {
     throw std::runtime_error(
         fmt::format(FMT_STRING("an error occurred while computing the expected values for file "
@@ -714,33 +1059,84 @@ inline ExpectedValuesBlock HiCFileWriter::compute_expected_values(std::uint32_t
   }
 }
 
+inline ExpectedValuesBlock HiCFileWriter::compute_expected_values(std::uint32_t resolution,
+                                                                  ExpectedValuesAggregator &aggr) {
+  aggr.compute_density();
+
+  std::vector<std::uint32_t> chrom_ids{};
+  std::vector<double> scaling_factors{};
+  std::for_each(aggr.scaling_factors().begin(), aggr.scaling_factors().end(),
+                [&](const auto &kv) {
+                  chrom_ids.push_back(kv.first.id());
+                  scaling_factors.push_back(kv.second);
+                });
+
+  return {"BP", resolution, aggr.weights(), chrom_ids, scaling_factors};
+}
+
 inline NormalizedExpectedValuesBlock HiCFileWriter::compute_normalized_expected_values(
-    std::uint32_t resolution, const balancing::Method &norm) {
-  assert(norm != balancing::Method::NONE());
-  SPDLOG_INFO(FMT_STRING("computing normalized expected values ({}) at resolution {}..."), norm,
-              resolution);
+    std::uint32_t resolution, const balancing::Method &norm, ExpectedValuesAggregator &aggr) {
+  const auto evb = compute_expected_values(resolution, aggr);
+  NormalizedExpectedValuesBlock blk{};
+  blk.type = norm.to_string();
+  blk.unit = evb.unit;
+  blk.binSize = evb.binSize;
+  blk.value = evb.value;
+  blk.chrIndex = evb.chrIndex;
+  blk.chrScaleFactor = evb.chrScaleFactor;
+  return blk;
+}
+
+inline std::vector<NormalizedExpectedValuesBlock> HiCFileWriter::compute_normalized_expected_values(
+    std::uint32_t resolution, const std::vector<balancing::Method> &norms) {
+  assert(!norms.empty());
+  SPDLOG_INFO(FMT_STRING("computing normalized expected values ({}) at resolution {}..."),
+              fmt::join(norms, ", "), resolution);
 
   try {
+    const auto &bins = _bin_tables.at(resolution);
+
+    std::vector<std::vector<double>> weights(norms.size());
+    std::vector<ExpectedValuesAggregator> aggrs{};
+    aggrs.reserve(norms.size());
+    for (std::size_t i = 0; i < norms.size(); ++i) {
+      assert(norms[i] != balancing::Method::NONE());
+      weights[i] = genome_wide_weights(resolution, norms[i]);
+      aggrs.emplace_back(bins);
+    }
+
+    // Interactions are read only once, and are then normalized using each set of weights
     const File f(std::string{path()}, resolution);
-    const auto sel = f.fetch(norm);
+    const auto sel = f.fetch();
+    std::vector<ThinPixel<float>> raw_pixels{};
+    std::vector<ThinPixel<float>> pixels{};
+    raw_pixels.reserve(EXPECTED_VALUES_BATCH_SIZE);
+    auto first = sel.begin<float>();
+    auto last = sel.end<float>();
+    while (first != last) {
+      raw_pixels.clear();
+      for (; first != last && raw_pixels.size() < EXPECTED_VALUES_BATCH_SIZE; ++first) {
+        raw_pixels.push_back(*first);
+      }
+      for (std::size_t i = 0; i < norms.size(); ++i) {
+        const auto &w = weights[i];
+        pixels = raw_pixels;
+        for (auto &p : pixels) {
+          assert(p.bin1_id < w.size());
+          assert(p.bin2_id < w.size());
+          p.count /= static_cast<float>(w[p.bin1_id] * w[p.bin2_id]);
+        }
+        aggrs[i].add(nonstd::span<const ThinPixel<float>>(pixels));
+      }
+    }
 
-    ExpectedValuesAggregator aggr(_bin_tables.at(resolution));
-    std::for_each(sel.begin<float>(), sel.end<float>(), [&](const auto &p) { aggr.add(p); });
-    aggr.compute_density();
-
-    std::vector<float> weights(aggr.weights().size());
-    std::transform(aggr.weights().begin(), aggr.weights().end(), weights.begin(),
-                   [](const auto w) { return static_cast<float>(w); });
-
-    std::vector<std::uint32_t> chrom_ids{};
-    std::vector<double> scaling_factors{};
-    std::for_each(aggr.scaling_factors().begin(), aggr.scaling_factors().end(),
-                  [&](const auto &kv) {
-                    chrom_ids.push_back(kv.first.id());
-                    scaling_factors.push_back(kv.second);
-                  });
-
-    return {norm.to_string(), "BP", resolution, aggr.weights(), chrom_ids, scaling_factors};
+    std::vector<NormalizedExpectedValuesBlock> blocks{};
+    blocks.reserve(norms.size());
+    for (std::size_t i = 0; i < norms.size(); ++i) {
+      blocks.emplace_back(compute_normalized_expected_values(resolution, norms[i], aggrs[i]));
+    }
+
+    return blocks;
   } catch (const std::exception &e) {
     throw std::runtime_error(fmt::format(
         FMT_STRING("an error occurred while computing the normalized expected values for file "
@@ -749,14 +1145,54 @@ inline NormalizedExpectedValuesBlock HiCFileWriter::compute_normalized_expected_
   }
 }
 
+inline std::vector<double> HiCFileWriter::genome_wide_weights(std::uint32_t resolution,
+                                                              const balancing::Method &norm) const {
+  const auto &bins = *_bin_tables.at(resolution);
+  const auto &offsets = bins.num_bin_prefix_sum();
+
+  // bins for chromosomes without weights are given NaN weights, which is consistent with how
+  // missing normalization vectors are handled by hic::File
+  std::vector<double> weights(bins.size(), std::numeric_limits<double>::quiet_NaN());
+  for (const auto &[blk, chrom_weights] : _normalization_vectors) {
+    if (blk.type != norm.to_string() || static_cast<std::uint32_t>(blk.binSize) != resolution) {
+      continue;
+    }
+    const auto chrom_id = static_cast<std::uint32_t>(blk.chrIdx);
+    const auto &chrom = chromosomes().at(chrom_id);
+    if (chrom.is_all()) {
+      continue;
+    }
+
+    const auto num_bins = std::min(
+        static_cast<std::size_t>(offsets[chrom_id + 1] - offsets[chrom_id]), chrom_weights.size());
+    std::copy_n(chrom_weights.begin(), num_bins,
+                weights.begin() + static_cast<std::ptrdiff_t>(offsets[chrom_id]));
+  }
+
+  return weights;
+}
+
 inline void HiCFileWriter::compute_and_write_expected_values() {
   assert(_tpool.get_thread_count() != 0);
   ExpectedValues ev{};
 
   std::vector<std::future<ExpectedValuesBlock>> results{};
   for (const auto &resolution : resolutions()) {
-    results.emplace_back(
-        _tpool.submit_task([&, res = resolution]() { return compute_expected_values(res); }));
+    auto match = _expected_values_aggregators.find(resolution);
+    if (match == _expected_values_aggregators.end()) {
+      results.emplace_back(
+          _tpool.submit_task([&, res = resolution]() { return compute_expected_values(res); }));
+      continue;
+    }
+
+    // interactions have already been aggregated while writing interaction blocks
+    auto aggr =
+        std::make_shared<ExpectedValuesAggregator>(merge_expected_values_shards(match->second));
+    _expected_values_aggregators.erase(match);
+    results.emplace_back(_tpool.submit_task([aggr, res = resolution]() {
+      SPDLOG_DEBUG(FMT_STRING("computing expected values at resolution {}..."), res);
+      return compute_expected_values(res, *aggr);
+    }));
   }
 
   for (auto &res : results) {
@@ -784,25 +1220,59 @@ inline void HiCFileWriter::compute_and_write_normalized_expected_values() {
   assert(_tpool.get_thread_count() != 0);
   NormalizedExpectedValues ev{};
 
-  phmap::btree_map<NormalizedExpectedValuesBlock, std::future<NormalizedExpectedValuesBlock>>
-      results{};
+  // Normalized expected values for norms that were aggregated while writing interaction blocks
+  std::vector<std::future<NormalizedExpectedValuesBlock>> aggregated_results{};
+  for (auto &[resolution, aggregators] : _normalized_expected_values_aggregators) {
+    for (auto &aggr : aggregators) {
+      const NormalizedExpectedValuesBlock key{aggr.norm.to_string(), "BP", resolution, {}, {}, {}};
+      if (_normalized_expected_values.find(key) != _normalized_expected_values.end()) {
+        continue;
+      }
+      auto evs = std::make_shared<ExpectedValuesAggregator>(
+          merge_expected_values_shards(aggr.shards));
+      aggregated_results.emplace_back(
+          _tpool.submit_task([evs, res = resolution, norm = aggr.norm]() {
+            SPDLOG_INFO(
+                FMT_STRING("computing normalized expected values ({}) at resolution {}..."), norm,
+                res);
+            return compute_normalized_expected_values(res, norm, *evs);
+          }));
+    }
+  }
+  _normalized_expected_values_aggregators.clear();
+
+  for (auto &res : aggregated_results) {
+    _normalized_expected_values.emplace(res.get());
+  }
+
+  // Compute the remaining normalized expected values by reading interactions back from the file.
+  // Norms are grouped by resolution, so that interactions are read only once for each resolution
+  phmap::btree_map<std::uint32_t, std::vector<balancing::Method>> norms{};
+  phmap::btree_set<NormalizedExpectedValuesBlock> submitted{};
   for (const auto &[blk, _] : _normalization_vectors) {
     const NormalizedExpectedValuesBlock key{
         blk.type, blk.unit, static_cast<std::uint32_t>(blk.binSize), {}, {}, {}};
     const auto nev_available =
         _normalized_expected_values.find(key) != _normalized_expected_values.end();
-    const auto nev_already_submitted_for_computation = results.find(key) != results.end();
+    const auto nev_already_submitted_for_computation = submitted.find(key) != submitted.end();
     if (!nev_available && !nev_already_submitted_for_computation) {
-      results.emplace(key, _tpool.submit_task([&, res = static_cast<std::uint32_t>(blk.binSize),
-                                               type = blk.type]() {
-        const balancing::Method norm{type};
-        return compute_normalized_expected_values(res, norm);
-      }));
+      submitted.emplace(key);
+      norms[static_cast<std::uint32_t>(blk.binSize)].emplace_back(blk.type);
     }
   }
 
-  for (auto &[_, res] : results) {
-    _normalized_expected_values.emplace(res.get());
+  std::vector<std::future<std::vector<NormalizedExpectedValuesBlock>>> results{};
+  for (const auto &[resolution, resolution_norms] : norms) {
+    results.emplace_back(
+        _tpool.submit_task([&, res = resolution, res_norms = resolution_norms]() {
+          return compute_normalized_expected_values(res, res_norms);
+        }));
+  }
+
+  for (auto &res : results) {
+    for (auto &nev : res.get()) {
+      _normalized_expected_values.emplace(std::move(nev));
+    }
   }
 
   for (const auto &nev : _normalized_expected_values) {
@@ -853,6 +1323,18 @@ inline void HiCFileWriter::add_norm_vector(const NormalizationVectorIndexBlock &
       }
     }
 
+    // normalized expected values aggregated so far do not reflect the new weights: they will be
+    // computed by reading interactions back from the file
+    if (auto match = _normalized_expected_values_aggregators.find(bin_size);
+        match != _normalized_expected_values_aggregators.end()) {
+      auto &aggregators = match->second;
+      aggregators.erase(std::remove_if(aggregators.begin(), aggregators.end(),
+                                       [&](const NormalizedExpectedValuesShards &aggr) {
+                                         return aggr.norm.to_string() == blk.type;
+                                       }),
+                        aggregators.end());
+    }
+
   } catch (const std::exception &e) {
     throw std::runtime_error(fmt::format(
         FMT_STRING(
@@ -1069,6 +1551,53 @@ inline auto HiCFileWriter::init_interaction_block_mappers(const std::filesystem:
   return mappers;
 }
 
+inline auto HiCFileWriter::init_expected_values_shards(std::shared_ptr<const BinTable> bins,
+                                                       std::size_t num_shards)
+    -> ExpectedValuesShards {
+  assert(num_shards != 0);
+  const ExpectedValuesAggregator aggr{std::move(bins)};
+  ExpectedValuesShards shards(num_shards);
+  for (auto &shard : shards) {
+    shard.aggr = aggr;
+  }
+  return shards;
+}
+
+inline auto HiCFileWriter::init_expected_values_aggregators(const BinTables &bin_tables,
+                                                            std::size_t num_shards)
+    -> ExpectedValuesAggregators {
+  ExpectedValuesAggregators aggregators(bin_tables.size());
+  for (const auto &[resolution, bins] : bin_tables) {
+    aggregators.emplace(resolution, init_expected_values_shards(bins, num_shards));
+  }
+  return aggregators;
+}
+
+inline void HiCFileWriter::init_normalized_expected_values_aggregators() {
+  _normalized_expected_values_aggregators.clear();
+  if (_expected_values_aggregators.empty()) {
+    // expected values are not aggregated when appending data to existing files
+    return;
+  }
+
+  phmap::btree_set<std::pair<std::uint32_t, std::string>> norms{};
+  for (const auto &[blk, _] : _normalization_vectors) {
+    norms.emplace(static_cast<std::uint32_t>(blk.binSize), blk.type);
+  }
+
+  for (const auto &[resolution, norm_name] : norms) {
+    const auto match = _bin_tables.find(resolution);
+    if (match == _bin_tables.end()) {
+      continue;
+    }
+    const balancing::Method norm{norm_name};
+    _normalized_expected_values_aggregators[resolution].emplace_back(
+        NormalizedExpectedValuesShards{
+            norm, genome_wide_weights(resolution, norm),
+            init_expected_values_shards(match->second, _num_expected_values_shards)});
+  }
+}
+
 inline BS::thread_pool HiCFileWriter::init_tpool(std::size_t n_threads) {
   return BS::thread_pool{
       conditional_static_cast<BS::concurrency_t>(n_threads < 2 ? std::size_t(1) : n_threads)};
@@ -1109,20 +1638,40 @@ inline auto HiCFileWriter::write_interaction_blocks(const Chromosome &chrom1,
   auto &mapper = _block_mappers.at(resolution);
   mapper.finalize();
 
+  const BlockIndexKey key{chrom1, chrom2, resolution};
+  // blocks written by add_sorted_pixels(): the remaining blocks (if any) have been spilled to the
+  // block mapper because they did not fit in memory
+  Stats streamed_stats{};
+  if (const auto match = _streamed_matrices.find(key); match != _streamed_matrices.end()) {
+    streamed_stats = match->second;
+    if (mapper.empty(chrom1, chrom2)) {
+      return streamed_stats;
+    }
+  } else if (has_interaction_blocks(key)) {
+    if (!mapper.empty(chrom1, chrom2)) {
+      throw std::runtime_error(fmt::format(
+          FMT_STRING("interactions for {}:{} at resolution {} have been added both as unsorted "
+                     "pixels and as interaction blocks"),
+          chrom1.name(), chrom2.name(), resolution));
+    }
+    return copy_interaction_blocks(chrom1, chrom2, resolution);
+  }
+
   const auto block_ids = mapper.chromosome_index().find(std::make_pair(chrom1, chrom2));
   if (block_ids == mapper.chromosome_index().end()) {
     SPDLOG_DEBUG(FMT_STRING("no pixels to write for {}:{} matrix at {} resolution"), chrom1.name(),
                  chrom2.name(), resolution);
-    return {};
+    return streamed_stats;
   }
 
   if (_tpool.get_thread_count() < 3 || block_ids->second.size() == 1) {
     try {
-      Stats stats{};
+      auto stats = streamed_stats;
       for (const auto &bid : block_ids->second) {
         auto blk = mapper.merge_blocks(bid);
         stats.sum += blk.sum();
         stats.nnz += blk.size();
+        update_expected_values(chrom1, chrom2, resolution, blk);
         write_interaction_block(bid.bid, chrom1, chrom2, resolution, std::move(blk));
       }
 
@@ -1146,13 +1695,11 @@ inline auto HiCFileWriter::write_interaction_blocks(const Chromosome &chrom1,
     const auto stop_token = std::numeric_limits<std::uint64_t>::max();
     std::atomic<bool> early_return = false;
 
-    std::mutex mapper_mtx{};
-
     std::vector<std::future<Stats>> worker_threads{};
     for (BS::concurrency_t i = 2; i < _tpool.get_thread_count(); ++i) {
       worker_threads.emplace_back(_tpool.submit_task([&]() {
-        return merge_and_compress_blocks_thr(mapper, mapper_mtx, block_id_queue, block_id_queue_mtx,
-                                             block_queue, serialized_block_tank,
+        return merge_and_compress_blocks_thr(chrom1, chrom2, resolution, mapper, block_id_queue,
+                                             block_id_queue_mtx, block_queue, serialized_block_tank,
                                              serialized_block_tank_mtx, early_return, stop_token);
       }));
     }
@@ -1190,7 +1737,7 @@ inline auto HiCFileWriter::write_interaction_blocks(const Chromosome &chrom1,
 
     producer.get();
 
-    Stats stats{};
+    auto stats = streamed_stats;
     for (auto &worker : worker_threads) {
       const auto partial_stats = worker.get();
       stats.sum += partial_stats.sum;
@@ -1211,6 +1758,178 @@ inline auto HiCFileWriter::write_interaction_blocks(const Chromosome &chrom1,
   }
 }
 
+inline auto HiCFileWriter::copy_interaction_blocks(const Chromosome &chrom1,
+                                                   const Chromosome &chrom2,
+                                                   std::uint32_t resolution) -> Stats {
+  const auto &src = _block_sources.at(BlockIndexKey{chrom1, chrom2, resolution});
+  assert(src.reader);
+
+  std::vector<hic::internal::BlockIndex> blocks(src.index.begin(), src.index.end());
+  std::sort(blocks.begin(), blocks.end(),
+            [](const auto &b1, const auto &b2) { return b1.id() < b2.id(); });
+
+  try {
+    Stats stats{};
+    std::string compressed_buffer{};
+    BinaryBuffer bbuffer{};
+    std::vector<ThinPixel<float>> pixels{};
+    for (const auto &idx : blocks) {
+      src.reader->read_compressed_block(idx, compressed_buffer);
+
+      const auto offset = _fs.tellp();
+      SPDLOG_DEBUG(FMT_STRING("copying block #{} for {}:{}:{} at {}:{}"), idx.id(), chrom1.name(),
+                   chrom2.name(), resolution, offset, compressed_buffer.size());
+      _fs.write(compressed_buffer);
+      add_block_metadata(idx.id(), chrom1, chrom2, resolution,
+                         static_cast<std::streamoff>(offset), _fs.tellp() - offset);
+
+      src.reader->inflate(compressed_buffer, bbuffer.reset());
+      HiCBlockReader::decode(src.reader->version(), bbuffer, pixels);
+      for (const auto &p : pixels) {
+        stats.sum += static_cast<double>(p.count);
+      }
+      stats.nnz += pixels.size();
+      update_expected_values(chrom1, chrom2, resolution, pixels);
+    }
+
+    return stats;
+  } catch (const std::exception &e) {
+    throw std::runtime_error(fmt::format(
+        FMT_STRING("an error occurred while copying interaction blocks from file \"{}\": {}"),
+        src.reader->path(), e.what()));
+  }
+}
+
+inline void HiCFileWriter::update_expected_values(const Chromosome &chrom1,
+                                                  const Chromosome &chrom2,
+                                                  std::uint32_t resolution,
+                                                  const MatrixInteractionBlock<float> &blk) {
+  if (chrom1.is_all() || chrom2.is_all()) {
+    return;
+  }
+
+  // rows and columns correspond to the relative bin IDs of chrom2 and chrom1, respectively
+  std::vector<ThinPixel<float>> pixels{};
+  pixels.reserve(blk.size());
+  for (const auto &[row, row_pixels] : blk()) {
+    for (const auto &p : row_pixels) {
+      pixels.emplace_back(ThinPixel<float>{static_cast<std::uint64_t>(p.column),
+                                           static_cast<std::uint64_t>(row), p.count});
+    }
+  }
+
+  update_expected_values(chrom1, chrom2, resolution, pixels);
+}
+
+inline void HiCFileWriter::update_expected_values(const Chromosome &chrom1,
+                                                  const Chromosome &chrom2,
+                                                  std::uint32_t resolution,
+                                                  const std::vector<ThinPixel<float>> &pixels) {
+  if (chrom1.is_all() || chrom2.is_all()) {
+    return;
+  }
+
+  if (auto match = _expected_values_aggregators.find(resolution);
+      match != _expected_values_aggregators.end()) {
+    update_expected_values(chrom1, chrom2, match->second, pixels);
+  }
+
+  auto match = _normalized_expected_values_aggregators.find(resolution);
+  if (match == _normalized_expected_values_aggregators.end() || match->second.empty()) {
+    return;
+  }
+
+  const auto &offsets = _bin_tables.at(resolution)->num_bin_prefix_sum();
+  const auto offset1 = offsets[chrom1.id()];
+  const auto offset2 = offsets[chrom2.id()];
+  std::vector<ThinPixel<float>> normalized_pixels(pixels.size());
+  for (auto &aggr : match->second) {
+    const auto &w = aggr.weights;
+    std::transform(pixels.begin(), pixels.end(), normalized_pixels.begin(),
+                   [&](ThinPixel<float> p) {
+                     assert(offset1 + p.bin1_id < w.size());
+                     assert(offset2 + p.bin2_id < w.size());
+                     p.count /= static_cast<float>(w[offset1 + p.bin1_id] * w[offset2 + p.bin2_id]);
+                     return p;
+                   });
+    update_expected_values(chrom1, chrom2, aggr.shards, normalized_pixels);
+  }
+}
+
+inline void HiCFileWriter::update_expected_values(const Chromosome &chrom1,
+                                                  const Chromosome &chrom2,
+                                                  ExpectedValuesShards &shards,
+                                                  const std::vector<ThinPixel<float>> &pixels) {
+  assert(!shards.empty());
+  // Spread threads across shards, then pick the first shard that is not locked by other threads
+  const auto i0 = std::hash<std::thread::id>{}(std::this_thread::get_id()) % shards.size();
+  for (std::size_t i = 0; i < shards.size(); ++i) {
+    auto &shard = shards[(i0 + i) % shards.size()];
+    const std::unique_lock lck(*shard.mtx, std::try_to_lock);
+    if (lck.owns_lock()) {
+      shard.aggr.add(chrom1, chrom2, pixels.begin(), pixels.end());
+      return;
+    }
+  }
+
+  auto &shard = shards[i0];
+  [[maybe_unused]] const std::scoped_lock lck(*shard.mtx);
+  shard.aggr.add(chrom1, chrom2, pixels.begin(), pixels.end());
+}
+
+inline ExpectedValuesAggregator HiCFileWriter::merge_expected_values_shards(
+    ExpectedValuesShards &shards) {
+  assert(!shards.empty());
+  auto aggr = std::move(shards.front().aggr);
+  for (std::size_t i = 1; i < shards.size(); ++i) {
+    aggr.merge(shards[i].aggr);
+  }
+  shards.clear();
+  return aggr;
+}
+
+inline bool HiCFileWriter::has_interaction_blocks(const BlockIndexKey &key) const {
+  return _block_sources.find(key) != _block_sources.end() ||
+         _streamed_matrices.find(key) != _streamed_matrices.end();
+}
+
+inline bool HiCFileWriter::has_pixels(const Chromosome &chrom1, const Chromosome &chrom2,
+                                      std::uint32_t resolution) const {
+  return !_block_mappers.at(resolution).empty(chrom1, chrom2) ||
+         has_interaction_blocks(BlockIndexKey{chrom1, chrom2, resolution});
+}
+
+inline float HiCFileWriter::pixel_sum(const Chromosome &chrom1, const Chromosome &chrom2,
+                                      std::uint32_t resolution) const {
+  const BlockIndexKey key{chrom1, chrom2, resolution};
+  if (const auto match = _block_sources.find(key); match != _block_sources.end()) {
+    return static_cast<float>(match->second.index.matrix_sum());
+  }
+  const auto &mapper = _block_mappers.at(resolution);
+  if (const auto match = _streamed_matrices.find(key); match != _streamed_matrices.end()) {
+    // blocks spilled by add_sorted_pixels() are stored by the block mapper
+    return static_cast<float>(match->second.sum) + mapper.pixel_sum(chrom1, chrom2);
+  }
+  return mapper.pixel_sum(chrom1, chrom2);
+}
+
+inline bool HiCFileWriter::can_copy_blocks(const Index &index, std::int32_t version) {
+  // Block encoding as well as the mapping of intra-chromosomal interactions to blocks changed
+  // with v9: blocks can only be copied from files using the same version as the file being written
+  if (version != _header.version || index.unit() != MatrixUnit::BP || index.empty()) {
+    return false;
+  }
+
+  const auto &chrom1 = index.chrom1();
+  const auto &chrom2 = index.chrom2();
+  const auto resolution = index.resolution();
+
+  const auto num_columns = compute_block_column_count(chrom1, chrom2, resolution);
+  const auto num_rows = compute_block_bin_count(chrom1, chrom2, resolution);
+
+  return index.block_bin_count() == num_rows && index.block_column_count() == num_columns;
+}
+
 inline auto HiCFileWriter::write_interaction_block(std::uint64_t block_id, const Chromosome &chrom1,
                                                    const Chromosome &chrom2,
                                                    std::uint32_t resolution,
@@ -1223,8 +1942,16 @@ inline auto HiCFileWriter::write_interaction_block(std::uint64_t block_id, const
                chrom2.name(), resolution, offset, _compression_buffer.size());
   _fs.write(_compression_buffer);
 
+  add_block_metadata(block_id, chrom1, chrom2, resolution, static_cast<std::streamoff>(offset),
+                     _fs.tellp() - offset);
+  return {offset, _fs.tellp() - offset};
+}
+
+inline void HiCFileWriter::add_block_metadata(std::uint64_t block_id, const Chromosome &chrom1,
+                                              const Chromosome &chrom2, std::uint32_t resolution,
+                                              std::streamoff offset, std::size_t size) {
   MatrixBlockMetadata mm{static_cast<std::int32_t>(block_id), static_cast<std::int64_t>(offset),
-                         static_cast<std::int32_t>(_fs.tellp() - offset)};
+                         static_cast<std::int32_t>(size)};
 
   const BlockIndexKey key{chrom1, chrom2, resolution};
   auto idx = _block_index.find(key);
@@ -1233,7 +1960,6 @@ inline auto HiCFileWriter::write_interaction_block(std::uint64_t block_id, const
   } else {
     _block_index.emplace(key, phmap::btree_set<MatrixBlockMetadata>{std::move(mm)});
   }
-  return {offset, _fs.tellp() - offset};
 }
 
 inline std::size_t HiCFileWriter::compute_num_bins(const Chromosome &chrom1,
@@ -1384,9 +2110,18 @@ inline std::size_t HiCFileWriter::compute_block_column_count(const Chromosome &c
                        : HiCInteractionToBlockMapper::DEFAULT_INTER_CUTOFF);
 }
 
+inline std::size_t HiCFileWriter::compute_block_bin_count(const Chromosome &chrom1,
+                                                          const Chromosome &chrom2,
+                                                          std::uint32_t resolution) {
+  return HiCInteractionToBlockMapper::compute_block_bin_count(
+      compute_num_bins(chrom1, chrom2, resolution),
+      compute_block_column_count(chrom1, chrom2, resolution));
+}
+
 inline auto HiCFileWriter::merge_and_compress_blocks_thr(
-    HiCInteractionToBlockMapper &mapper, std::mutex &mapper_mtx,
-    std::queue<std::uint64_t> &block_id_queue, std::mutex &block_id_queue_mtx,
+    const Chromosome &chrom1, const Chromosome &chrom2, std::uint32_t resolution,
+    HiCInteractionToBlockMapper &mapper, std::queue<std::uint64_t> &block_id_queue,
+    std::mutex &block_id_queue_mtx,
     moodycamel::BlockingConcurrentQueue<HiCInteractionToBlockMapper::BlockID> &block_queue,
     phmap::flat_hash_map<std::uint64_t, std::string> &serialized_block_tank,
     std::mutex &serialized_block_tank_mtx, std::atomic<bool> &early_return,
@@ -1395,10 +2130,12 @@ inline auto HiCFileWriter::merge_and_compress_blocks_thr(
   try {
     HiCInteractionToBlockMapper::BlockID buffer{};
     BinaryBuffer bbuffer{};
-    std::string compression_buffer(16'000'000, '\0');
+    std::string compression_buffer(WORKER_BUFFER_SIZE, '\0');
     std::unique_ptr<libdeflate_compressor> libdeflate_compressor(
         libdeflate_alloc_compressor(static_cast<std::int32_t>(_compression_lvl)));
     std::unique_ptr<ZSTD_DCtx_s> zstd_dctx{ZSTD_createDCtx()};
+    // each thread reads partial blocks through its own file handle
+    auto spill_reader = mapper.open_spill_reader();
 
     Stats stats{};
     while (!early_return) {
@@ -1416,9 +2153,10 @@ inline auto HiCFileWriter::merge_and_compress_blocks_thr(
           FMT_STRING("merge_and_compress_blocks thread: merging partial blocks for block #{}"),
           buffer.bid);
       // read and merge partial blocks
-      auto blk = mapper.merge_blocks(buffer, bbuffer, *zstd_dctx, compression_buffer, mapper_mtx);
+      auto blk = mapper.merge_blocks(buffer, bbuffer, *zstd_dctx, compression_buffer, spill_reader);
       stats.nnz += blk.size();
       stats.sum += blk.sum();
+      update_expected_values(chrom1, chrom2, resolution, blk);
 
       // compress and serialize block
       std::ignore = blk.serialize(bbuffer, *libdeflate_compressor, compression_buffer);
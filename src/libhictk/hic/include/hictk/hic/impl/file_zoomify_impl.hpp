@@ -67,14 +67,10 @@ inline std::uint32_t HiCFileZoomify::compute_base_resolution(std::uint32_t tgt_r
 }
 
 inline void HiCFileZoomify::ingest_interactions(std::uint32_t resolution) {
-  // TODO: check if .hic is version 9
-  // if it is, copy blocks directly
-  // if it isn't copy pixels
-
+  // Interaction blocks from .hic v9 files are copied as they are, while interactions from older
+  // files are decoded and re-encoded
   SPDLOG_INFO(FMT_STRING("[{} bp] ingesting interactions..."), resolution);
-  const File hf(_path_to_input_hic, resolution);
-  const auto sel = hf.fetch();
-  _hfw.add_pixels(resolution, sel.begin<float>(), sel.end<float>());
+  _hfw.add_blocks(resolution, _path_to_input_hic);
 }
 
 inline void HiCFileZoomify::coarsen_interactions(std::uint32_t resolution,
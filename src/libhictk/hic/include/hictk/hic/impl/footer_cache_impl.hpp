@@ -70,6 +70,9 @@ inline auto FooterCache::emplace(HiCFooter f) -> decltype(_footers.emplace()) {
 inline auto FooterCache::find(const HiCFooterMetadata &m) -> const_iterator {
   return _footers.find(m);
 }
+inline void FooterCache::merge(const FooterCache &other) {
+  _footers.insert(other._footers.begin(), other._footers.end());
+}
 inline std::size_t FooterCache::size() const noexcept { return _footers.size(); }
 inline void FooterCache::clear() { return _footers.clear(); }
 
@@ -68,6 +68,14 @@ inline File& File::open(std::uint32_t resolution_, MatrixType type_, MatrixUnit
   return open(path(), resolution_, type_, unit_, block_cache_capacity);
 }
 
+inline File File::clone() const {
+  File f{*this};
+  f._fs = std::make_shared<internal::HiCFileReader>(_fs->clone());
+  f._block_cache = std::make_shared<internal::BlockCache>(_block_cache->capacity_bytes());
+  f._weight_cache = std::make_shared<internal::WeightCache>();
+  return f;
+}
+
 inline bool File::has_resolution(std::uint32_t resolution) const {
   const auto match = std::find(avail_resolutions().begin(), avail_resolutions().end(), resolution);
   return match != avail_resolutions().end();
@@ -137,7 +145,7 @@ constexpr auto File::matrix_type() const noexcept -> MatrixType { return _type;
 
 constexpr auto File::matrix_unit() const noexcept -> MatrixUnit { return _unit; }
 
-inline PixelSelectorAll File::fetch(balancing::Method norm) const {
+inline PixelSelectorAll File::fetch(balancing::Method norm, std::size_t num_threads) const {
   std::vector<PixelSelector> selectors;
 
   for (std::uint32_t chrom1_id = 0; chrom1_id < chromosomes().size(); ++chrom1_id) {
@@ -172,7 +180,7 @@ inline PixelSelectorAll File::fetch(balancing::Method norm) const {
                     norm.to_string(), resolution(), _unit));
   }
 
-  return PixelSelectorAll{std::move(selectors)};
+  return PixelSelectorAll{std::move(selectors), num_threads};
 }
 
 inline PixelSelector File::fetch(std::string_view range, balancing::Method norm,
@@ -282,6 +290,15 @@ inline balancing::Weights File::normalization(std::string_view norm,
   return normalization(balancing::Method{norm}, chrom);
 }
 
+inline std::shared_ptr<const balancing::Weights> File::normalization_ptr(
+    balancing::Method norm, const Chromosome& chrom) const {
+  auto weights = _weight_cache->find_or_emplace(chrom, norm);
+  if (!*weights) {
+    *weights = normalization(norm, chrom);
+  }
+  return weights;
+}
+
 inline balancing::Weights File::normalization(balancing::Method norm) const {
   std::vector<double> weights{};
   weights.reserve(bins().size());
@@ -321,6 +338,11 @@ inline std::size_t File::num_cached_footers() const noexcept { return _footers.s
 
 inline void File::purge_footer_cache() { _footers.clear(); }
 
+inline void File::merge_footer_cache(const File& other) {
+  assert(path() == other.path());
+  _footers.merge(other._footers);
+}
+
 inline double File::block_cache_hit_rate() const noexcept { return _block_cache->hit_rate(); }
 inline void File::reset_cache_stats() const noexcept { _block_cache->reset_stats(); }
 inline void File::clear_cache() noexcept { _block_cache->clear(); }
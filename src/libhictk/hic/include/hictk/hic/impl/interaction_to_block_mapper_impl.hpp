@@ -9,11 +9,13 @@
 #include <zstd.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <numeric>
 #include <stdexcept>
@@ -218,26 +220,43 @@ inline void HiCInteractionToBlockMapper::append_pixels(PixelIt first_pixel, Pixe
                                                        BS::thread_pool &tpool,
                                                        std::uint32_t update_frequency) {
   if (tpool.get_thread_count() < 2) {
-    return append_pixels(first_pixel, last_pixel);
+    return append_pixels(first_pixel, last_pixel, update_frequency);
   }
 
-  SPDLOG_DEBUG(FMT_STRING("mapping pixels to interaction blocks using 2 threads..."));
+  using PixelT = remove_cvref_t<decltype(*first_pixel)>;
+  static_assert(std::is_same_v<PixelT, ThinPixel<float>> || std::is_same_v<PixelT, Pixel<float>>);
 
-  std::atomic<bool> early_return = false;
-  moodycamel::BlockingReaderWriterQueue<Pixel<float>> queue(10'000);
+  SPDLOG_DEBUG(FMT_STRING("mapping pixels to interaction blocks using {} threads..."),
+               tpool.get_thread_count());
+
+  // Pixels are read in batches by the calling thread.
+  // Each batch is split into partitions that are mapped to interaction blocks by the worker threads
+  // using thread-local block buffers. Buffers are then merged into _blocks by the calling thread,
+  // which in the meantime has read the next batch of pixels.
+  // Two batches are enough to overlap reading and mapping, as a batch is only reused once all its
+  // partitions have been merged.
+  const auto num_partitions = static_cast<std::size_t>(tpool.get_thread_count());
+  std::array<std::vector<PixelT>, 2> batches{};
+  std::vector<std::future<BlockMap>> partitions{};
+
+  auto merge_partitions = [&]() {
+    for (auto &partition : partitions) {
+      add_blocks(partition.get());
+    }
+    partitions.clear();
+  };
 
-  auto writer = tpool.submit_task([&]() {
-    try {
-      auto t0 = std::chrono::steady_clock::now();
-      for (std::size_t i = 0; first_pixel != last_pixel && !early_return; ++i) {
-        const auto pixel = internal::process_pixel_interaction_block(*_bin_table, *first_pixel);
+  try {
+    auto t0 = std::chrono::steady_clock::now();
+    std::size_t i = 0;
+    for (std::size_t batch_id = 0; first_pixel != last_pixel; ++batch_id) {
+      auto &batch = batches[batch_id % batches.size()];
+      batch.clear();
+      batch.reserve(DEFAULT_BATCH_SIZE);
+      for (; first_pixel != last_pixel && batch.size() != DEFAULT_BATCH_SIZE; ++i) {
+        batch.emplace_back(*first_pixel);
         std::ignore = ++first_pixel;
 
-        while (!queue.try_enqueue(pixel)) {
-          if (early_return) {
-            return;
-          }
-        }
         if (i == update_frequency) {
           const auto t1 = std::chrono::steady_clock::now();
           const auto delta =
@@ -250,39 +269,28 @@ inline void HiCInteractionToBlockMapper::append_pixels(PixelIt first_pixel, Pixe
           i = 0;
         }
       }
-      queue.enqueue(Pixel<float>{});
 
-    } catch (...) {
-      early_return = true;
-      throw;
-    }
-  });
-
-  auto reader = tpool.submit_task([&]() {
-    try {
-      Pixel<float> p{};
-      while (!early_return) {
-        if (_pending_pixels >= _chunk_size) {
-          write_blocks();
-        }
+      merge_partitions();
 
-        queue.wait_dequeue(p);
-        if (p.count == 0) {
-          return;
-        }
-
-        add_pixel(p);
-        ++_processed_pixels;
-        ++_pending_pixels;
+      const auto partition_size = (batch.size() + num_partitions - 1) / num_partitions;
+      for (std::size_t offset = 0; offset < batch.size(); offset += partition_size) {
+        const auto *first = batch.data() + offset;
+        const auto *last = batch.data() + std::min(offset + partition_size, batch.size());
+        partitions.emplace_back(
+            tpool.submit_task([this, first, last]() { return map_pixels(first, last); }));
       }
-    } catch (...) {
-      early_return = true;
-      throw;
     }
-  });
 
-  writer.get();
-  reader.get();
+    merge_partitions();
+  } catch (...) {
+    // make sure workers are done with the batches before they go out of scope
+    for (auto &partition : partitions) {
+      if (partition.valid()) {
+        partition.wait();
+      }
+    }
+    throw;
+  }
 }
 
 inline auto HiCInteractionToBlockMapper::block_index() const noexcept -> const BlockIndexMap & {
@@ -294,19 +302,33 @@ inline auto HiCInteractionToBlockMapper::chromosome_index() const noexcept
   return _chromosome_index;
 }
 
+inline auto HiCInteractionToBlockMapper::spill_index() const noexcept
+    -> const std::vector<SpillIndex> & {
+  return _spills;
+}
+
+inline auto HiCInteractionToBlockMapper::open_spill_reader() const -> SpillReader {
+  if (_spills.empty()) {
+    return {};
+  }
+  return {_path, _spills};
+}
+
 inline auto HiCInteractionToBlockMapper::merge_blocks(const BlockID &bid)
     -> MatrixInteractionBlock<float> {
-  std::mutex dummy_mtx{};
-  return merge_blocks(bid, _bbuffer, *_zstd_dctx, _compression_buffer, dummy_mtx);
+  if (_spill_reader.num_spills() != _spills.size()) {
+    _spill_reader = open_spill_reader();
+  }
+  return merge_blocks(bid, _bbuffer, *_zstd_dctx, _compression_buffer, _spill_reader);
 }
 
 inline auto HiCInteractionToBlockMapper::merge_blocks(const BlockID &bid, BinaryBuffer &bbuffer,
                                                       ZSTD_DCtx_s &zstd_dctx,
                                                       std::string &compression_buffer,
-                                                      std::mutex &mtx)
+                                                      SpillReader &reader)
     -> MatrixInteractionBlock<float> {
   MatrixInteractionBlock<float> blk{};
-  for (auto &&pixel : fetch_pixels(bid, bbuffer, zstd_dctx, compression_buffer, mtx)) {
+  for (auto &&pixel : fetch_pixels(bid, bbuffer, zstd_dctx, compression_buffer, reader)) {
     blk.emplace_back(std::move(pixel));
   }
   blk.finalize();
@@ -338,12 +360,16 @@ inline void HiCInteractionToBlockMapper::clear() {
   _blocks.clear();
   _block_index.clear();
   _chromosome_index.clear();
+  _spills.clear();
+  _spill_reader = SpillReader{};
   _pixel_sums.clear();
   _processed_pixels = 0;
   _pending_pixels = 0;
   _bbuffer.reset().shrink_to_fit();
   _compression_buffer.clear();
   _compression_buffer.shrink_to_fit();
+  _spill_buffer.clear();
+  _spill_buffer.shrink_to_fit();
   std::error_code ec{};
   std::filesystem::remove(_path, ec);
 }
@@ -358,7 +384,7 @@ inline void HiCInteractionToBlockMapper::init_block_mappers() {
       const auto num_columns = compute_block_column_count(
           chrom1, chrom2, _bin_table->resolution(),
           chrom1 == chrom2 ? DEFAULT_INTRA_CUTOFF : DEFAULT_INTER_CUTOFF);
-      const auto num_rows = num_bins / num_columns + 1;
+      const auto num_rows = compute_block_bin_count(num_bins, num_columns);
 
       if (chrom1 == chrom2) {
         _mappers_intra.emplace(chrom1, BlockMapperIntra{num_rows, num_columns});
@@ -370,14 +396,6 @@ inline void HiCInteractionToBlockMapper::init_block_mappers() {
   }
 }
 
-inline std::pair<std::uint64_t, std::uint32_t> HiCInteractionToBlockMapper::write_block(
-    const MatrixInteractionBlockFlat<float> &blk) {
-  const auto offset = _fs.tellp();
-  _fs.write(blk.serialize(_bbuffer, *_zstd_cctx, _compression_buffer, _compression_lvl));
-  const auto size = _fs.tellp() - offset;
-  return std::make_pair(offset, static_cast<std::uint32_t>(size));
-}
-
 template <typename N>
 inline auto HiCInteractionToBlockMapper::map(const ThinPixel<N> &p) const -> BlockID {
   return map(Pixel<N>(*_bin_table, p));
@@ -414,12 +432,11 @@ inline void HiCInteractionToBlockMapper::add_pixel(const Pixel<N> &p) {
   const auto &chrom2 = p.coords.bin2.chrom();
   const auto chrom_pair = std::make_pair(chrom1, chrom2);
 
+  _pixel_sums[chrom_pair] += p.count;
   auto match1 = _blocks.find(bid);
   if (match1 != _blocks.end()) {
-    _pixel_sums.at(chrom_pair) += p.count;
     match1->second.emplace_back(p.to_thin());
   } else {
-    _pixel_sums.emplace(chrom_pair, p.count);
     auto [it, _] = _blocks.emplace(std::move(bid), MatrixInteractionBlockFlat<float>{});
     it->second.emplace_back(p.to_thin());
   }
@@ -434,14 +451,52 @@ inline void HiCInteractionToBlockMapper::add_pixel(const Pixel<N> &p) {
   ++_pending_pixels;
 }
 
+template <typename PixelT>
+inline auto HiCInteractionToBlockMapper::map_pixels(const PixelT *first_pixel,
+                                                    const PixelT *last_pixel) const -> BlockMap {
+  BlockMap blocks{};
+  for (; first_pixel != last_pixel; ++first_pixel) {
+    const auto p = internal::process_pixel_interaction_block(*_bin_table, *first_pixel);
+    blocks[map(p)].emplace_back(p.to_thin());
+  }
+  return blocks;
+}
+
+inline void HiCInteractionToBlockMapper::add_blocks(BlockMap &&blocks) {
+  for (auto &[bid, blk] : blocks) {
+    const auto chrom_pair =
+        std::make_pair(chromosomes().at(bid.chrom1_id), chromosomes().at(bid.chrom2_id));
+    _pixel_sums[chrom_pair] += std::accumulate(blk.counts.begin(), blk.counts.end(), 0.0F);
+    _chromosome_index[chrom_pair].emplace(bid);
+    _processed_pixels += blk.size();
+    _pending_pixels += blk.size();
+
+    auto [it, inserted] = _blocks.try_emplace(bid);
+    if (inserted) {
+      it->second = std::move(blk);
+      continue;
+    }
+    auto &dest = it->second;
+    dest.bin1_ids.insert(dest.bin1_ids.end(), blk.bin1_ids.begin(), blk.bin1_ids.end());
+    dest.bin2_ids.insert(dest.bin2_ids.end(), blk.bin2_ids.begin(), blk.bin2_ids.end());
+    dest.counts.insert(dest.counts.end(), blk.counts.begin(), blk.counts.end());
+  }
+
+  if (_pending_pixels >= _chunk_size) {
+    write_blocks();
+  }
+}
+
 inline std::vector<Pixel<float>> HiCInteractionToBlockMapper::fetch_pixels(const BlockID &bid) {
-  std::mutex dummy_mtx{};
-  return fetch_pixels(bid, _bbuffer, *_zstd_dctx, _compression_buffer, dummy_mtx);
+  if (_spill_reader.num_spills() != _spills.size()) {
+    _spill_reader = open_spill_reader();
+  }
+  return fetch_pixels(bid, _bbuffer, *_zstd_dctx, _compression_buffer, _spill_reader);
 }
 
 inline std::vector<Pixel<float>> HiCInteractionToBlockMapper::fetch_pixels(
     const BlockID &bid, BinaryBuffer &bbuffer, ZSTD_DCtx_s &zstd_dctx,
-    std::string &compression_buffer, std::mutex &mtx) {
+    std::string &compression_buffer, SpillReader &reader) {
   std::vector<Pixel<float>> pixels{};
   auto match = _blocks.find(bid);
   if (match != _blocks.end()) {
@@ -455,12 +510,9 @@ inline std::vector<Pixel<float>> HiCInteractionToBlockMapper::fetch_pixels(
     return pixels;
   }
 
-  for (const auto &[pos, size] : _block_index.at(bid)) {
-    {
-      std::scoped_lock lck(mtx);
-      _fs.seekg(static_cast<std::streamoff>(pos));
-      _fs.read(bbuffer.reset(), size);
-    }
+  // partial blocks are stored in the same order as spills, so reads only move forward in each spill
+  for (const auto &idx : _block_index.at(bid)) {
+    reader.read(idx, bbuffer.reset());
     const auto flat_pixels =
         MatrixInteractionBlockFlat<float>::deserialize(bbuffer, zstd_dctx, compression_buffer);
     pixels.reserve(pixels.size() + flat_pixels.size());
@@ -476,20 +528,65 @@ inline void HiCInteractionToBlockMapper::write_blocks() {
     _fs = filestream::FileStream::create(_path.string());
   }
   SPDLOG_DEBUG(FMT_STRING("writing {} pixels to file {}..."), _pending_pixels, _path);
+
+  // Partial blocks are serialized in BlockID order (i.e. the order of _blocks) into a single
+  // buffer, which is then written to disk as one contiguous run.
+  // This way, the fragments of a given block can be read back with one pass over the file.
+  const auto spill_offset = static_cast<std::uint64_t>(_fs.tellp());
+  const auto spill_id = static_cast<std::uint32_t>(_spills.size());
+  _spill_buffer.clear();
   for (auto &[bid, blk] : _blocks) {
-    const auto [offset, size] = write_block(blk);
+    const auto offset = spill_offset + _spill_buffer.size();
+    _spill_buffer.append(
+        blk.serialize(_bbuffer, *_zstd_cctx, _compression_buffer, _compression_lvl));
+    const auto size = static_cast<std::uint32_t>(spill_offset + _spill_buffer.size() - offset);
     auto match = _block_index.find(bid);
     if (match != _block_index.end()) {
-      match->second.emplace_back(BlockIndex{offset, size});
+      match->second.emplace_back(BlockIndex{offset, size, spill_id});
     } else {
-      _block_index.emplace(bid, std::vector<BlockIndex>{{offset, size}});
+      _block_index.emplace(bid, std::vector<BlockIndex>{{offset, size, spill_id}});
     }
   }
+  _fs.write(_spill_buffer);
   _fs.flush();
+  _spills.emplace_back(SpillIndex{spill_offset, _spill_buffer.size()});
   _blocks.clear();
   _pending_pixels = 0;
 }
 
+inline HiCInteractionToBlockMapper::SpillReader::SpillReader(const std::filesystem::path &path,
+                                                             std::vector<SpillIndex> spills,
+                                                             std::size_t readahead_budget)
+    : _fs(path.string()),
+      _spills(std::move(spills)),
+      _windows(_spills.size()),
+      _readahead(std::clamp(readahead_budget / std::max(_spills.size(), std::size_t{1}),
+                            MIN_READAHEAD, MAX_READAHEAD)) {}
+
+inline std::size_t HiCInteractionToBlockMapper::SpillReader::num_spills() const noexcept {
+  return _spills.size();
+}
+
+inline void HiCInteractionToBlockMapper::SpillReader::read(const BlockIndex &idx,
+                                                           std::string &buffer) {
+  assert(idx.spill_id < _spills.size());
+  auto &window = _windows[idx.spill_id];
+  const auto window_end = window.offset + window.buffer.size();
+
+  if (idx.offset < window.offset || idx.offset + idx.size > window_end) {
+    const auto &spill = _spills[idx.spill_id];
+    const auto spill_end = spill.offset + spill.size;
+    assert(idx.offset + idx.size <= spill_end);
+    const auto count = std::max(std::uint64_t{idx.size},
+                                std::min(std::uint64_t{_readahead}, spill_end - idx.offset));
+    _fs.seekg(static_cast<std::streamoff>(idx.offset));
+    _fs.read(window.buffer, static_cast<std::size_t>(count));
+    window.offset = idx.offset;
+  }
+
+  buffer.assign(window.buffer, static_cast<std::size_t>(idx.offset - window.offset), idx.size);
+}
+
 inline std::size_t HiCInteractionToBlockMapper::compute_block_column_count(
     const Chromosome &chrom1, const Chromosome &chrom2, std::uint32_t bin_size,
     std::uint32_t cutoff, std::size_t block_capacity) {
@@ -512,6 +609,11 @@ inline std::size_t HiCInteractionToBlockMapper::compute_num_bins(const Chromosom
   return (max_size + bin_size - 1) / bin_size;
 }
 
+inline std::size_t HiCInteractionToBlockMapper::compute_block_bin_count(
+    std::size_t num_bins, std::size_t num_columns) noexcept {
+  return num_bins / num_columns + 1;
+}
+
 inline HiCInteractionToBlockMapper::BlockMapperInter::BlockMapperInter(
     std::uint64_t block_bin_count, std::uint64_t block_column_count)
     : _block_bin_count(block_bin_count), _block_column_count(block_column_count) {
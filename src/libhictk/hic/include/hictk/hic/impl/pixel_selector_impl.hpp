@@ -49,6 +49,15 @@ inline PixelSelector::PixelSelector(std::shared_ptr<internal::HiCFileReader> hfs
       _coord1(std::make_shared<const PixelCoordinates>(std::move(coord1_))),
       _coord2(std::make_shared<const PixelCoordinates>(std::move(coord2_))) {}
 
+inline PixelSelector::PixelSelector(std::shared_ptr<internal::HiCBlockReader> reader_,
+                                    std::shared_ptr<const internal::HiCFooter> footer_,
+                                    std::shared_ptr<const PixelCoordinates> coord1_,
+                                    std::shared_ptr<const PixelCoordinates> coord2_) noexcept
+    : _reader(std::move(reader_)),
+      _footer(std::move(footer_)),
+      _coord1(std::move(coord1_)),
+      _coord2(std::move(coord2_)) {}
+
 inline PixelSelector::~PixelSelector() noexcept {
   try {
     if (_reader) {
@@ -87,6 +96,15 @@ inline auto PixelSelector::end() const -> iterator<N> {
   return cend<N>();
 }
 
+namespace internal {
+// Weights are accessed through this function to avoid materializing the vector of divisive weights
+// (i.e. weights(balancing::Weights::Type::DIVISIVE)) for every pixel
+[[nodiscard]] inline double divisive_weight(const balancing::Weights &weights,
+                                            std::size_t i) noexcept {
+  return weights.type() == balancing::Weights::Type::DIVISIVE ? weights[i] : 1.0 / weights[i];
+}
+}  // namespace internal
+
 template <typename N>
 inline ThinPixel<N> PixelSelector::transform_pixel(ThinPixel<float> pixel) const {
   auto return_pixel = [&]() -> ThinPixel<N> {
@@ -97,8 +115,8 @@ inline ThinPixel<N> PixelSelector::transform_pixel(ThinPixel<float> pixel) const
     }
   };
 
-  const auto &weights1 = _footer->weights1()(balancing::Weights::Type::DIVISIVE);
-  const auto &weights2 = _footer->weights2()(balancing::Weights::Type::DIVISIVE);
+  const auto &weights1 = _footer->weights1();
+  const auto &weights2 = _footer->weights2();
   const auto &expected = _footer->expectedValues();
 
   const auto bin1 = pixel.bin1_id;
@@ -112,7 +130,8 @@ inline ThinPixel<N> PixelSelector::transform_pixel(ThinPixel<float> pixel) const
   if (!skipNormalization) {
     assert(bin1 < weights1.size());
     assert(bin2 < weights2.size());
-    pixel.count /= static_cast<float>(weights1[bin1] * weights2[bin2]);
+    pixel.count /= static_cast<float>(internal::divisive_weight(weights1, bin1) *
+                                      internal::divisive_weight(weights2, bin2));
   }
 
   if (matrix_type() == MatrixType::observed) {
@@ -181,6 +200,11 @@ inline const internal::HiCFooterMetadata &PixelSelector::metadata() const noexce
   return _footer->metadata();
 }
 
+inline const internal::Index &PixelSelector::index() const noexcept {
+  assert(!!_footer);
+  return _footer->index();
+}
+
 inline bool PixelSelector::is_inter() const noexcept { return !is_intra(); }
 
 inline bool PixelSelector::is_intra() const noexcept { return chrom1() == chrom2(); }
@@ -239,6 +263,26 @@ inline void PixelSelector::clear_cache() const {
   }
 }
 
+inline std::size_t PixelSelector::cache_capacity_bytes() const noexcept {
+  assert(_reader);
+  return _reader->cache_capacity_bytes();
+}
+
+inline PixelSelector PixelSelector::clone() const { return clone(cache_capacity_bytes()); }
+
+inline PixelSelector PixelSelector::clone(std::size_t cache_capacity_bytes_) const {
+  assert(_reader);
+  return {std::make_shared<internal::HiCBlockReader>(_reader->clone(cache_capacity_bytes_)),
+          _footer, _coord1, _coord2};
+}
+
+inline PixelSelector PixelSelector::clone(const PixelSelector &other) const {
+  assert(_reader);
+  assert(other._reader);
+  return {std::make_shared<internal::HiCBlockReader>(_reader->clone(*other._reader)), _footer,
+          _coord1, _coord2};
+}
+
 template <typename N>
 inline PixelSelector::iterator<N>::iterator(const PixelSelector &sel, bool sorted)
     : _reader(sel._reader),
@@ -249,7 +293,8 @@ inline PixelSelector::iterator<N>::iterator(const PixelSelector &sel, bool sorte
           _reader->index().find_overlaps(coord1(), coord2()))),
       _block_blacklist(std::make_shared<BlockBlacklist>()),
       _block_it(_block_idx->begin()),
-      _buffer(std::make_shared<BufferT>()),
+      _buffer_pool(hictk::internal::BufferPool<BufferT>::create()),
+      _buffer(_buffer_pool->acquire()),
       _bin1_id(coord1().bin1.rel_id()),
       _sorted(sorted) {
   if (_reader->index().empty()) {
@@ -429,6 +474,20 @@ inline std::uint32_t PixelSelector::iterator<N>::compute_chunk_size() const noex
   return static_cast<std::uint32_t>((pos2 - pos1 + bin_size - 1) / bin_size);
 }
 
+template <typename N>
+inline void PixelSelector::iterator<N>::reset_buffer() {
+  assert(!!_buffer);
+  if (_buffer.use_count() != 1) {
+    // the current buffer is still referenced by a copy of this iterator
+    assert(!!_buffer_pool);
+    const auto capacity = _buffer->capacity();
+    _buffer = _buffer_pool->acquire();
+    _buffer->reserve(capacity);
+  }
+  _buffer->clear();
+  _buffer_i = 0;
+}
+
 template <typename N>
 inline void PixelSelector::iterator<N>::read_next_chunk() {
   assert(!!_reader);
@@ -453,11 +512,7 @@ inline void PixelSelector::iterator<N>::read_next_chunk_unsorted() {
     return;
   }
 
-  if (_buffer.use_count() != 1) {
-    _buffer = std::make_shared<BufferT>(_buffer->capacity());
-  }
-  _buffer->clear();
-  _buffer_i = 0;
+  reset_buffer();
 
   const auto bin1_lb = coord1().bin1.rel_id();
   const auto bin1_ub = coord1().bin2.rel_id();
@@ -491,11 +546,7 @@ inline void PixelSelector::iterator<N>::read_next_chunk_sorted() {
     return;
   }
 
-  if (_buffer.use_count() != 1) {
-    _buffer = std::make_shared<BufferT>(_buffer->capacity());
-  }
-  _buffer->clear();
-  _buffer_i = 0;
+  reset_buffer();
 
   const auto bin1_lb = _bin1_id;
   const auto bin1_ub = coord1().bin2.rel_id();
@@ -538,15 +589,7 @@ inline void PixelSelector::iterator<N>::read_next_chunk_v9_intra_sorted() {
     return;
   }
 
-  if (_buffer.use_count() != 1) {
-    _buffer = std::make_shared<BufferT>(_buffer->capacity());
-  }
-
-  if (_block_blacklist.use_count() != 1) {
-    _block_blacklist = std::make_shared<BlockBlacklist>(*_block_blacklist);
-  }
-  _buffer->clear();
-  _buffer_i = 0;
+  reset_buffer();
 
   const auto chunk_size = compute_chunk_size();
   const auto bin1_id_last = _bin1_id + chunk_size;
@@ -557,7 +600,9 @@ inline void PixelSelector::iterator<N>::read_next_chunk_v9_intra_sorted() {
       continue;
     }
 
-    const auto bin1_lb = _bin1_id;
+    // Blocks are blacklisted based on the bounds of the query (and not on the position of the
+    // iterator), as the blacklist is shared by all copies of the iterator
+    const auto bin1_lb = coord1().bin1.rel_id();
     const auto bin1_ub = coord1().bin2.rel_id();
     const auto bin2_lb = coord2().bin1.rel_id();
     const auto bin2_ub = coord2().bin2.rel_id();
@@ -573,7 +618,8 @@ inline void PixelSelector::iterator<N>::read_next_chunk_v9_intra_sorted() {
                                              int(static_cast<std::size_t>(p.bin2_id) <= bin2_ub));
 
       const auto pixel_overlaps_chunk =
-          pixel_overlaps_query && static_cast<std::size_t>(p.bin1_id) <= bin1_id_last;
+          bool(int(pixel_overlaps_query) & int(static_cast<std::size_t>(p.bin1_id) >= _bin1_id) &
+               int(static_cast<std::size_t>(p.bin1_id) <= bin1_id_last));
 
       block_overlaps_query |= pixel_overlaps_query;
       if (!pixel_overlaps_chunk) {
@@ -609,8 +655,8 @@ inline ThinPixel<N> PixelSelector::iterator<N>::transform_pixel(ThinPixel<float>
     }
   };
 
-  const auto &weights1 = _footer->weights1()(balancing::Weights::Type::DIVISIVE);
-  const auto &weights2 = _footer->weights2()(balancing::Weights::Type::DIVISIVE);
+  const auto &weights1 = _footer->weights1();
+  const auto &weights2 = _footer->weights2();
   const auto &expected = _footer->expectedValues();
 
   const auto bin1 = pixel.bin1_id;
@@ -627,7 +673,8 @@ inline ThinPixel<N> PixelSelector::iterator<N>::transform_pixel(ThinPixel<float>
   if (!skip_normalization) {
     assert(bin1 < weights1.size());
     assert(bin2 < weights2.size());
-    pixel.count /= static_cast<float>(weights1[bin1] * weights2[bin2]);
+    pixel.count /= static_cast<float>(internal::divisive_weight(weights1, bin1) *
+                                      internal::divisive_weight(weights2, bin2));
   }
 
   if (matrix_type == MatrixType::observed) {
@@ -655,10 +702,17 @@ inline ThinPixel<N> PixelSelector::iterator<N>::transform_pixel(ThinPixel<float>
   return return_pixel();
 }
 
-inline PixelSelectorAll::PixelSelectorAll(std::vector<PixelSelector> selectors_) noexcept
-    : _selectors(std::move(selectors_)) {}
+inline PixelSelectorAll::PixelSelectorAll(std::vector<PixelSelector> selectors_,
+                                          std::size_t num_threads) noexcept
+    : _selectors(std::move(selectors_)), _num_threads(std::max(std::size_t(1), num_threads)) {}
+
+inline bool PixelSelectorAll::empty() const noexcept {
+  return std::all_of(_selectors.begin(), _selectors.end(), [](const PixelSelector &sel) {
+    return sel.begin<float>() == sel.end<float>();
+  });
+}
 
-inline bool PixelSelectorAll::empty() const noexcept { return begin<float>() == end<float>(); }
+inline std::size_t PixelSelectorAll::num_threads() const noexcept { return _num_threads; }
 
 template <typename N>
 inline auto PixelSelectorAll::begin(bool sorted) const -> iterator<N> {
@@ -738,6 +792,14 @@ inline PixelSelectorAll::iterator<N>::iterator(const PixelSelectorAll &selector,
     *this = iterator<N>{};
     return;
   }
+
+  if (selector._num_threads > 1) {
+    _prefetcher = std::make_shared<internal::PixelStreamPrefetcher<N>>(
+        selector._selectors, sorted, selector._num_threads - 1);
+    read_next_chunk_parallel();
+    return;
+  }
+
   std::for_each(selector._selectors.begin(), selector._selectors.end(),
                 [&](const PixelSelector &sel) { _selectors->push(&sel); });
 
@@ -753,6 +815,7 @@ inline PixelSelectorAll::iterator<N>::iterator(const iterator<N> &other)
                             ? std::make_shared<SelectorQueue>(*other._active_selectors)
                             : nullptr),
       _its(other._its ? std::make_shared<ItPQueue>(*other._its) : nullptr),
+      _prefetcher(other._prefetcher),
       _sorted(other._sorted),
       _chrom1_id(other._chrom1_id),
       _buff(other._buff ? std::make_shared<std::vector<ThinPixel<N>>>(*other._buff) : nullptr),
@@ -768,6 +831,7 @@ inline auto PixelSelectorAll::iterator<N>::operator=(const iterator<N> &other) -
   _active_selectors =
       other._active_selectors ? std::make_shared<SelectorQueue>(*other._active_selectors) : nullptr;
   _its = other._its ? std::make_shared<ItPQueue>(*other._its) : nullptr;
+  _prefetcher = other._prefetcher;
   _sorted = other._sorted;
   _chrom1_id = other._chrom1_id;
   _buff = other._buff ? std::make_shared<std::vector<ThinPixel<N>>>(*other._buff) : nullptr;
@@ -808,7 +872,11 @@ template <typename N>
 inline auto PixelSelectorAll::iterator<N>::operator++() -> iterator & {
   assert(_buff);
   if (++_i == _buff->size()) {
-    read_next_chunk();
+    if (_prefetcher) {
+      read_next_chunk_parallel();
+    } else {
+      read_next_chunk();
+    }
   }
   return *this;
 }
@@ -899,4 +967,18 @@ inline void PixelSelectorAll::iterator<N>::read_next_chunk() {
   _its->emplace(Pair{first, last});
 }
 
+template <typename N>
+inline void PixelSelectorAll::iterator<N>::read_next_chunk_parallel() {
+  assert(_prefetcher);
+  if (_buff.use_count() != 1) {
+    _buff = std::make_shared<std::vector<ThinPixel<N>>>();
+  }
+  _i = 0;
+
+  if (!_prefetcher->read_next_chunk(*_buff)) {
+    _buff = nullptr;  // signal end
+    _prefetcher = nullptr;
+  }
+}
+
 }  // namespace hictk::hic
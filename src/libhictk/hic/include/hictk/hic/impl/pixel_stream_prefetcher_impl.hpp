@@ -0,0 +1,286 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <BS_thread_pool.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "hictk/common.hpp"
+#include "hictk/hic/pixel_selector.hpp"
+#include "hictk/pixel.hpp"
+
+namespace hictk::hic::internal {
+
+template <typename N>
+inline const ThinPixel<N> &PixelStreamPrefetcher<N>::Head::operator*() const noexcept {
+  assert(!!chunk);
+  assert(i < chunk->size());
+  return (*chunk)[i];
+}
+
+template <typename N>
+inline bool PixelStreamPrefetcher<N>::Head::operator>(const Head &other) const noexcept {
+  const auto &p1 = **this;
+  const auto &p2 = *other;
+  if (p1.bin1_id != p2.bin1_id) {
+    return p1.bin1_id > p2.bin1_id;
+  }
+  if (p1.bin2_id != p2.bin2_id) {
+    return p1.bin2_id > p2.bin2_id;
+  }
+  return stream > other.stream;
+}
+
+template <typename N>
+inline PixelStreamPrefetcher<N>::PixelStreamPrefetcher(const std::vector<PixelSelector> &selectors,
+                                                       bool sorted, std::size_t num_workers,
+                                                       std::size_t chunk_size,
+                                                       std::size_t max_chunks_per_stream)
+    : _streams(selectors.size()),
+      _sorted(sorted),
+      _chunk_size(std::max(std::size_t(1), chunk_size)),
+      _max_chunks_per_stream(std::max(std::size_t(1), max_chunks_per_stream)),
+      _tpool(conditional_static_cast<BS::concurrency_t>(std::max(std::size_t(1), num_workers))) {
+  for (std::size_t i = 0; i < selectors.size(); ++i) {
+    _streams[i].sel = &selectors[i];
+    _streams[i].chrom1_id = selectors[i].chrom1().id();
+    assert(i == 0 || _streams[i - 1].chrom1_id <= _streams[i].chrom1_id);
+  }
+
+  if (!selectors.empty()) {
+    _cache_capacity_bytes =
+        selectors.front().cache_capacity_bytes() / std::size_t{_tpool.get_thread_count()};
+  }
+
+  for (BS::concurrency_t i = 0; i < _tpool.get_thread_count(); ++i) {
+    _tpool.detach_task([this, i]() { worker_loop(i); });
+  }
+}
+
+template <typename N>
+inline PixelStreamPrefetcher<N>::~PixelStreamPrefetcher() noexcept {
+  try {
+    stop();
+    _tpool.wait();
+  } catch (...) {
+  }
+}
+
+template <typename N>
+inline bool PixelStreamPrefetcher<N>::read_next_chunk(BufferT &buff) {
+  buff.clear();
+  while (_heads.empty()) {
+    if (!init_heads()) {
+      return false;
+    }
+  }
+
+  auto head = _heads.top();
+  _heads.pop();
+
+  if (!_sorted) {
+    buff.insert(buff.end(), head.chunk->begin() + static_cast<std::ptrdiff_t>(head.i),
+                head.chunk->end());
+    head.chunk = wait_for_next_chunk(head.stream);
+    head.i = 0;
+    if (head.chunk) {
+      _heads.emplace(std::move(head));
+    }
+    return true;
+  }
+
+  const auto bin1_id = (*head).bin1_id;
+  while (head.chunk) {
+    const auto &chunk = *head.chunk;
+    while (head.i < chunk.size() && chunk[head.i].bin1_id == bin1_id) {
+      buff.push_back(chunk[head.i++]);
+    }
+
+    if (head.i < chunk.size()) {
+      _heads.emplace(std::move(head));
+      break;
+    }
+
+    head.chunk = wait_for_next_chunk(head.stream);
+    head.i = 0;
+  }
+
+  return true;
+}
+
+template <typename N>
+inline void PixelStreamPrefetcher<N>::stop() noexcept {
+  {
+    [[maybe_unused]] const std::scoped_lock lck(_mtx);
+    _stop = true;
+  }
+  _work_available.notify_all();
+  _stream_ready.notify_all();
+}
+
+template <typename N>
+inline void PixelStreamPrefetcher<N>::worker_loop(std::size_t worker_id) {
+  // File handle and block cache shared by all the streams processed by this worker
+  std::unique_ptr<PixelSelector> io{};
+  while (true) {
+    std::size_t i = _streams.size();
+    {
+      std::unique_lock lck(_mtx);
+      _work_available.wait(lck, [&]() {
+        i = find_next_stream(worker_id);
+        return _stop || i != _streams.size() || _first_active_stream == _streams.size();
+      });
+      if (_stop || i == _streams.size()) {
+        return;
+      }
+      _streams[i].busy = true;
+      _streams[i].worker = worker_id;
+    }
+
+    auto &s = _streams[i];
+    try {
+      auto [chunk, exhausted] = decode_next_chunk(s, io);
+      {
+        [[maybe_unused]] const std::scoped_lock lck(_mtx);
+        s.busy = false;
+        s.exhausted = exhausted;
+        if (!chunk->empty()) {
+          s.chunks.emplace_back(std::move(chunk));
+        }
+      }
+      _stream_ready.notify_all();
+      // Streams are pinned to workers: wake up all workers, as the stream that can be processed
+      // next may be pinned to any of them
+      _work_available.notify_all();
+    } catch (...) {
+      {
+        [[maybe_unused]] const std::scoped_lock lck(_mtx);
+        _exception = std::current_exception();
+        _stop = true;
+      }
+      _stream_ready.notify_all();
+      _work_available.notify_all();
+      return;
+    }
+  }
+}
+
+template <typename N>
+inline std::size_t PixelStreamPrefetcher<N>::find_next_stream(
+    std::size_t worker_id) const noexcept {
+  // Streams are processed in order. Workers are allowed to run ahead of the consumer by one
+  // chromosome: this is enough to keep workers busy without buffering too many pixels.
+  if (_first_active_stream == _streams.size()) {
+    return _streams.size();
+  }
+
+  auto chrom1_id = _streams[_first_active_stream].chrom1_id;
+  std::size_t lookahead = 0;
+  for (std::size_t i = _first_active_stream; i < _streams.size(); ++i) {
+    const auto &s = _streams[i];
+    if (s.chrom1_id != chrom1_id) {
+      if (++lookahead > 1) {
+        break;
+      }
+      chrom1_id = s.chrom1_id;
+    }
+    const auto available = s.worker == NO_WORKER || s.worker == worker_id;
+    if (available && !s.busy && !s.exhausted && s.chunks.size() < _max_chunks_per_stream) {
+      return i;
+    }
+  }
+
+  return _streams.size();
+}
+
+template <typename N>
+inline auto PixelStreamPrefetcher<N>::decode_next_chunk(
+    Stream &s, std::unique_ptr<PixelSelector> &io) const -> std::pair<ChunkPtr, bool> {
+  if (!s.private_sel) {
+    assert(s.sel);
+    if (!io) {
+      io = std::make_unique<PixelSelector>(s.sel->clone(_cache_capacity_bytes));
+    }
+    s.private_sel = std::make_unique<PixelSelector>(s.sel->clone(*io));
+    s.first = s.private_sel->template begin<N>(_sorted);
+    s.last = s.private_sel->template end<N>();
+  }
+
+  auto buff = std::make_shared<BufferT>();
+  buff->reserve(_chunk_size);
+  for (; s.first != s.last && buff->size() < _chunk_size; ++s.first) {
+    buff->push_back(*s.first);
+  }
+
+  const auto exhausted = s.first == s.last;
+  if (exhausted) {
+    // release the iterators as soon as possible (the file handle and block cache are owned by the
+    // worker)
+    s.first = PixelSelector::iterator<N>{};
+    s.last = PixelSelector::iterator<N>{};
+    s.private_sel.reset();
+  }
+
+  return std::make_pair(std::move(buff), exhausted);
+}
+
+template <typename N>
+inline auto PixelStreamPrefetcher<N>::wait_for_next_chunk(std::size_t stream) -> ChunkPtr {
+  assert(stream < _streams.size());
+  std::unique_lock lck(_mtx);
+  auto &s = _streams[stream];
+  _stream_ready.wait(lck, [&]() { return !!_exception || !s.chunks.empty() || s.exhausted; });
+
+  if (_exception) {
+    std::rethrow_exception(_exception);
+  }
+
+  if (s.chunks.empty()) {
+    assert(s.exhausted);
+    while (_first_active_stream < _streams.size() &&
+           _streams[_first_active_stream].exhausted &&
+           _streams[_first_active_stream].chunks.empty()) {
+      ++_first_active_stream;
+    }
+    lck.unlock();
+    _work_available.notify_all();
+    return nullptr;
+  }
+
+  auto chunk = std::move(s.chunks.front());
+  s.chunks.pop_front();
+  lck.unlock();
+  _work_available.notify_all();
+  return chunk;
+}
+
+template <typename N>
+inline bool PixelStreamPrefetcher<N>::init_heads() {
+  assert(_heads.empty());
+  if (_next_stream == _streams.size()) {
+    return false;
+  }
+
+  const auto chrom1_id = _streams[_next_stream].chrom1_id;
+  for (; _next_stream < _streams.size() && _streams[_next_stream].chrom1_id == chrom1_id;
+       ++_next_stream) {
+    auto chunk = wait_for_next_chunk(_next_stream);
+    if (chunk) {
+      _heads.emplace(Head{std::move(chunk), 0, _next_stream});
+    }
+  }
+
+  return true;
+}
+
+}  // namespace hictk::hic::internal
@@ -4,13 +4,27 @@
 
 #pragma once
 
+#include <BS_thread_pool.hpp>
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "hictk/chromosome.hpp"
+#include "hictk/common.hpp"
+#include "hictk/hic.hpp"
 #include "hictk/hic/file_reader.hpp"
 #include "hictk/hic/file_writer.hpp"
+#include "hictk/pixel.hpp"
+#include "hictk/transformers/pixel_merger.hpp"
 
 namespace hictk::hic::utils {
 
@@ -28,6 +42,145 @@ inline void validate_chromosomes(const std::vector<hic::File>& files) {
     }
   }
 }
+
+// Compute the number of bins spanned by each partition of chrom rows.
+// Partitions are aligned to the block grid of the intra-chromosomal matrices, so that, when
+// reading interactions for a given partition, most blocks are decoded exactly once.
+[[nodiscard]] inline std::uint32_t compute_partition_size(const std::vector<hic::File>& files,
+                                                          const Chromosome& chrom) {
+  const auto resolution = files.front().resolution();
+  const auto num_bins = (chrom.size() + resolution - 1) / resolution;
+  std::size_t partition_size = num_bins;
+  for (const auto& f : files) {
+    const auto sel = f.fetch(chrom.name(), chrom.name());
+    if (!sel.empty()) {
+      partition_size = std::min(partition_size, sel.index().block_bin_count());
+    }
+  }
+  return static_cast<std::uint32_t>(std::max(std::size_t(1), partition_size));
+}
+
+// Read and merge the interactions overlapping rows [start, end) of chrom1 from all files
+[[nodiscard]] inline std::vector<ThinPixel<float>> read_and_merge_partition(
+    const std::vector<hic::File>& files, const Chromosome& chrom1, std::uint32_t start,
+    std::uint32_t end) {
+  using PixelBuffer = std::vector<ThinPixel<float>>;
+  std::vector<PixelBuffer> chunks{};
+  for (const auto& f : files) {
+    for (std::uint32_t chrom2_id = chrom1.id(); chrom2_id < f.chromosomes().size(); ++chrom2_id) {
+      const auto& chrom2 = f.chromosomes().at(chrom2_id);
+      if (chrom2.is_all()) {
+        continue;
+      }
+      // only the upper-triangle is stored, so for cis matrices we can skip columns before start
+      const auto sel = f.fetch(chrom1.name(), start, end, chrom2.name(),
+                               chrom1 == chrom2 ? start : 0, chrom2.size());
+      PixelBuffer chunk(sel.begin<float>(), sel.end<float>());
+      if (!chunk.empty()) {
+        chunks.emplace_back(std::move(chunk));
+      }
+    }
+  }
+
+  using PixelIt = PixelBuffer::const_iterator;
+  std::vector<PixelIt> heads{};
+  std::vector<PixelIt> tails{};
+  for (const auto& chunk : chunks) {
+    heads.emplace_back(chunk.begin());
+    tails.emplace_back(chunk.end());
+  }
+  return hictk::transformers::PixelMerger<PixelIt>{heads, tails}.read_all();
+}
+
+// Merge .hic files by splitting each chromosome into ranges of rows (partitions).
+// Partitions are read from the input files and merged into sorted runs of pixels by a pool of
+// worker threads, each using its own set of file handles.
+// Runs are then passed to the HiCFileWriter in order by the calling thread.
+inline void merge_parallel(const std::vector<hic::File>& files, std::string_view dest_file,
+                           const std::filesystem::path& tmp_dir, bool overwrite_if_exists,
+                           std::size_t chunk_size, std::size_t n_threads,
+                           std::uint32_t compression_lvl, bool skip_all_vs_all) {
+  assert(n_threads > 1);
+  using PixelBuffer = std::vector<ThinPixel<float>>;
+  using FileSet = std::vector<hic::File>;
+
+  const auto& bins = files.front().bins();
+  const auto resolution = bins.resolution();
+
+  if (overwrite_if_exists) {
+    std::filesystem::remove(dest_file);
+  }
+
+  hic::internal::HiCFileWriter w(dest_file, bins.chromosomes(), {resolution},
+                                 files.front().assembly(), n_threads, chunk_size, tmp_dir,
+                                 compression_lvl, skip_all_vs_all);
+
+  // File handles are not thread-safe: each task borrows a set of file handles that are not in use
+  // by any other task
+  std::mutex mtx{};
+  std::vector<std::unique_ptr<FileSet>> file_sets{};
+  auto borrow_file_set = [&]() {
+    {
+      [[maybe_unused]] const std::scoped_lock lck(mtx);
+      if (!file_sets.empty()) {
+        auto fs = std::move(file_sets.back());
+        file_sets.pop_back();
+        return fs;
+      }
+    }
+    auto fs = std::make_unique<FileSet>();
+    for (const auto& f : files) {
+      fs->emplace_back(f.path(), resolution);
+    }
+    return fs;
+  };
+  auto return_file_set = [&](std::unique_ptr<FileSet> fs) {
+    [[maybe_unused]] const std::scoped_lock lck(mtx);
+    file_sets.emplace_back(std::move(fs));
+  };
+
+  const auto num_workers = n_threads - 1;
+  const auto max_pending_runs = num_workers + 1;
+  BS::thread_pool tpool(conditional_static_cast<BS::concurrency_t>(num_workers));
+  std::deque<std::future<PixelBuffer>> runs{};
+
+  auto write_next_run = [&]() {
+    assert(!runs.empty());
+    const auto run = runs.front().get();
+    runs.pop_front();
+    w.add_pixels(resolution, run.begin(), run.end());
+  };
+
+  for (const auto& chrom1 : bins.chromosomes()) {
+    if (chrom1.is_all()) {
+      continue;
+    }
+    SPDLOG_INFO(FMT_STRING("merging interactions for {}..."), chrom1.name());
+    const auto partition_size = compute_partition_size(files, chrom1) * resolution;
+    for (std::uint32_t start = 0; start < chrom1.size(); start += partition_size) {
+      const auto end = std::min(chrom1.size(), start + partition_size);
+      runs.emplace_back(tpool.submit_task([&, chrom1_ = chrom1, start, end]() {
+        auto fs = borrow_file_set();
+        auto run = read_and_merge_partition(*fs, chrom1_, start, end);
+        return_file_set(std::move(fs));
+        return run;
+      }));
+
+      while (runs.size() > max_pending_runs ||
+             (!runs.empty() &&
+              runs.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+        write_next_run();
+      }
+    }
+  }
+
+  while (!runs.empty()) {
+    write_next_run();
+  }
+
+  w.serialize();
+}
+
 }  // namespace internal
 
 template <typename Str>
@@ -47,6 +200,12 @@ inline void merge(Str first_file, Str last_file, std::string_view dest_file,
 
     internal::validate_chromosomes(files);
 
+    if (n_threads > 1) {
+      internal::merge_parallel(files, dest_file, tmp_dir, overwrite_if_exists, chunk_size,
+                               n_threads, compression_lvl, skip_all_vs_all);
+      return;
+    }
+
     std::vector<PixelSelectorAll> selectors;
     std::vector<PixelSelectorAll::iterator<float>> heads;
     std::vector<PixelSelectorAll::iterator<float>> tails;
@@ -8,11 +8,6 @@
 
 #include <parallel_hashmap/btree.h>
 #include <parallel_hashmap/phmap.h>
-#if __has_include(<readerwriterqueue.h>)
-#include <readerwriterqueue.h>
-#else
-#include <readerwriterqueue/readerwriterqueue.h>
-#endif
 #include <zstd.h>
 
 #include <BS_thread_pool.hpp>
@@ -20,7 +15,6 @@
 #include <cstdint>
 #include <filesystem>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -62,6 +56,8 @@ class HiCInteractionToBlockMapper {
   static constexpr std::uint32_t DEFAULT_INTRA_CUTOFF = 500;
   static constexpr std::uint32_t DEFAULT_INTER_CUTOFF = 5'000;
   static constexpr std::size_t DEFAULT_BLOCK_CAPACITY = 1'000;
+  // Number of pixels read by append_pixels() before handing them over to the worker threads
+  static constexpr std::size_t DEFAULT_BATCH_SIZE = 500'000;
 
   struct BlockID {
     std::uint32_t chrom1_id;
@@ -72,9 +68,48 @@ class HiCInteractionToBlockMapper {
     [[nodiscard]] bool operator==(const BlockID& other) const noexcept;
   };
 
+  // Location of a partial block within the file where pixels are spilled
   struct BlockIndex {
     std::uint64_t offset;
     std::uint32_t size;
+    std::uint32_t spill_id;
+  };
+
+  // Location of the contiguous run of partial blocks written by a single call to write_blocks()
+  struct SpillIndex {
+    std::uint64_t offset;
+    std::uint64_t size;
+  };
+
+  // Class used to read partial blocks back from the file where pixels are spilled.
+  // Partial blocks belonging to the same spill are sorted by BlockID, so fetching blocks in
+  // ascending order reads each spill sequentially: the reader exploits this by reading large chunks
+  // of each spill at once (readahead), and serving subsequent blocks from memory.
+  // Each reader owns its file handle, so different threads can fetch blocks concurrently without
+  // any synchronization.
+  class SpillReader {
+    struct Window {
+      std::uint64_t offset{};
+      std::string buffer{};
+    };
+
+    filestream::FileStream _fs{};
+    std::vector<SpillIndex> _spills{};
+    std::vector<Window> _windows{};
+    std::size_t _readahead{};
+
+   public:
+    static constexpr std::size_t DEFAULT_READAHEAD_BUDGET = 16ULL << 20U;  // 16 MiB
+    static constexpr std::size_t MIN_READAHEAD = 64ULL << 10U;             // 64 KiB
+    static constexpr std::size_t MAX_READAHEAD = 4ULL << 20U;              // 4 MiB
+
+    SpillReader() = default;
+    // The readahead budget is split across spills
+    SpillReader(const std::filesystem::path& path, std::vector<SpillIndex> spills,
+                std::size_t readahead_budget = DEFAULT_READAHEAD_BUDGET);
+
+    [[nodiscard]] std::size_t num_spills() const noexcept;
+    void read(const BlockIndex& idx, std::string& buffer);
   };
 
  private:
@@ -87,8 +122,11 @@ class HiCInteractionToBlockMapper {
       phmap::flat_hash_map<std::pair<Chromosome, Chromosome>, phmap::btree_set<BlockID>>;
   BlockIndexMap _block_index{};
   ChromosomeIndexMap _chromosome_index{};
+  std::vector<SpillIndex> _spills{};
+  SpillReader _spill_reader{};
 
-  phmap::btree_map<BlockID, MatrixInteractionBlockFlat<float>> _blocks{};
+  using BlockMap = phmap::btree_map<BlockID, MatrixInteractionBlockFlat<float>>;
+  BlockMap _blocks{};
   phmap::flat_hash_map<std::pair<Chromosome, Chromosome>, float> _pixel_sums{};
   std::size_t _processed_pixels{};
   std::size_t _pending_pixels{};
@@ -102,6 +140,7 @@ class HiCInteractionToBlockMapper {
   std::unique_ptr<ZSTD_CCtx_s> _zstd_cctx{};
   std::unique_ptr<ZSTD_DCtx_s> _zstd_dctx{};
   std::string _compression_buffer{};
+  std::string _spill_buffer{};
 
  public:
   HiCInteractionToBlockMapper() = default;
@@ -140,9 +179,12 @@ class HiCInteractionToBlockMapper {
 
   [[nodiscard]] auto block_index() const noexcept -> const BlockIndexMap&;
   [[nodiscard]] auto chromosome_index() const noexcept -> const ChromosomeIndexMap&;
+  [[nodiscard]] auto spill_index() const noexcept -> const std::vector<SpillIndex>&;
+  // Readers should be opened after all pixels have been added (i.e. after calling finalize())
+  [[nodiscard]] SpillReader open_spill_reader() const;
   [[nodiscard]] auto merge_blocks(const BlockID& bid) -> MatrixInteractionBlock<float>;
   [[nodiscard]] auto merge_blocks(const BlockID& bid, BinaryBuffer& bbuffer, ZSTD_DCtx_s& zstd_dctx,
-                                  std::string& compression_buffer, std::mutex& mtx)
+                                  std::string& compression_buffer, SpillReader& reader)
       -> MatrixInteractionBlock<float>;
   [[nodiscard]] float pixel_sum(const Chromosome& chrom1, const Chromosome& chrom2) const;
   [[nodiscard]] float pixel_sum() const;
@@ -155,6 +197,9 @@ class HiCInteractionToBlockMapper {
       std::uint32_t cutoff, std::size_t block_capacity = DEFAULT_BLOCK_CAPACITY);
   [[nodiscard]] static std::size_t compute_num_bins(const Chromosome& chrom1,
                                                     const Chromosome& chrom2, std::size_t bin_size);
+  // Number of bins spanned by each row of interaction blocks (i.e. blockBinCount)
+  [[nodiscard]] static std::size_t compute_block_bin_count(std::size_t num_bins,
+                                                           std::size_t num_columns) noexcept;
 
  private:
   void init_block_mappers();
@@ -169,14 +214,19 @@ class HiCInteractionToBlockMapper {
   template <typename N>
   void add_pixel(const Pixel<N>& p);
 
+  // Map pixels to interaction blocks without touching the state of the mapper (i.e. this can be
+  // called concurrently from multiple threads)
+  template <typename PixelT>
+  [[nodiscard]] BlockMap map_pixels(const PixelT* first_pixel, const PixelT* last_pixel) const;
+  void add_blocks(BlockMap&& blocks);
+
   [[nodiscard]] std::vector<Pixel<float>> fetch_pixels(const BlockID& bid);
   [[nodiscard]] std::vector<Pixel<float>> fetch_pixels(const BlockID& bid, BinaryBuffer& bbuffer,
                                                        ZSTD_DCtx_s& zstd_dctx,
                                                        std::string& compression_buffer,
-                                                       std::mutex& mtx);
+                                                       SpillReader& reader);
 
   void write_blocks();
-  std::pair<std::uint64_t, std::uint32_t> write_block(const MatrixInteractionBlockFlat<float>& blk);
 
  public:
   class BlockMapperInter {
@@ -19,6 +19,7 @@
 #include "hictk/balancing/methods.hpp"
 #include "hictk/balancing/weights.hpp"
 #include "hictk/bin_table.hpp"
+#include "hictk/buffer_pool.hpp"
 #include "hictk/hic/block_reader.hpp"
 #include "hictk/hic/cache.hpp"
 #include "hictk/hic/common.hpp"
@@ -29,6 +30,11 @@
 
 namespace hictk::hic {
 
+namespace internal {
+template <typename N>
+class PixelStreamPrefetcher;
+}  // namespace internal
+
 class PixelSelector {
   std::shared_ptr<internal::HiCBlockReader> _reader{};
 
@@ -91,15 +97,33 @@ class PixelSelector {
 
   [[nodiscard]] const BinTable &bins() const noexcept;
   [[nodiscard]] const internal::HiCFooterMetadata &metadata() const noexcept;
+  [[nodiscard]] const internal::Index &index() const noexcept;
 
   [[nodiscard]] bool is_inter() const noexcept;
   [[nodiscard]] bool is_intra() const noexcept;
   [[nodiscard]] bool empty() const noexcept;
 
   [[nodiscard]] std::size_t estimate_optimal_cache_size(std::size_t num_samples = 500) const;
+  [[nodiscard]] std::size_t cache_capacity_bytes() const noexcept;
   void clear_cache() const;
 
+  // Return a selector for the same query backed by a private file handle and block cache.
+  // The returned selector can be safely iterated over from a different thread.
+  // When cache_capacity_bytes is not specified, the new block cache has the same capacity as the
+  // block cache used by *this.
+  [[nodiscard]] PixelSelector clone() const;
+  [[nodiscard]] PixelSelector clone(std::size_t cache_capacity_bytes) const;
+  // Return a selector for the same query that reads interactions through the file handle and block
+  // cache used by other.
+  // Selectors sharing a file handle must not be iterated over concurrently.
+  [[nodiscard]] PixelSelector clone(const PixelSelector &other) const;
+
  private:
+  PixelSelector(std::shared_ptr<internal::HiCBlockReader> reader_,
+                std::shared_ptr<const internal::HiCFooter> footer_,
+                std::shared_ptr<const PixelCoordinates> coord1_,
+                std::shared_ptr<const PixelCoordinates> coord2_) noexcept;
+
   template <typename N>
   [[nodiscard]] ThinPixel<N> transform_pixel(ThinPixel<float> pixel) const;
 
@@ -116,8 +140,12 @@ class PixelSelector {
     std::shared_ptr<const PixelCoordinates> _coord2{};
     std::shared_ptr<const internal::HiCFooter> _footer{};
     std::shared_ptr<const internal::Index::Overlap> _block_idx{};
+    // Blocks that do not overlap the query. Blocks are blacklisted based on the query bounds only,
+    // so that the blacklist can be shared by copies of the same iterator at different positions
     std::shared_ptr<BlockBlacklist> _block_blacklist{};
     internal::Index::Overlap::const_iterator _block_it{};
+    // Buffers are recycled through a pool shared by all copies of the same iterator
+    std::shared_ptr<hictk::internal::BufferPool<BufferT>> _buffer_pool{};
     mutable std::shared_ptr<BufferT> _buffer{};
     mutable std::size_t _buffer_i{};
     std::uint32_t _bin1_id{};
@@ -163,6 +191,7 @@ class PixelSelector {
     [[nodiscard]] std::vector<internal::BlockIndex> find_blocks_overlapping_next_chunk(
         std::size_t num_bins);
 
+    void reset_buffer();
     void read_next_chunk();
     void read_next_chunk_unsorted();
     void read_next_chunk_sorted();
@@ -178,12 +207,15 @@ class PixelSelectorAll {
 
  private:
   std::vector<PixelSelector> _selectors{};
+  std::size_t _num_threads{1};
 
  public:
   PixelSelectorAll() = default;
-  explicit PixelSelectorAll(std::vector<PixelSelector> selectors_) noexcept;
+  explicit PixelSelectorAll(std::vector<PixelSelector> selectors_,
+                            std::size_t num_threads = 1) noexcept;
 
   [[nodiscard]] bool empty() const noexcept;
+  [[nodiscard]] std::size_t num_threads() const noexcept;
 
   template <typename N>
   [[nodiscard]] auto begin(bool sorted = true) const -> iterator<N>;
@@ -205,6 +237,10 @@ class PixelSelectorAll {
   [[nodiscard]] const BinTable &bins() const noexcept;
   [[nodiscard]] std::vector<double> weights() const;
 
+  // When num_threads > 1, interactions are decoded ahead of time by num_threads - 1 worker threads
+  // while the thread driving the iterator merges the decoded streams.
+  // In this case the iterator is single-pass: copies of an iterator share the same underlying
+  // stream of pixels.
   template <typename N>
   class iterator {
     struct Pair {
@@ -219,6 +255,7 @@ class PixelSelectorAll {
     std::shared_ptr<SelectorQueue> _selectors{};
     std::shared_ptr<SelectorQueue> _active_selectors{};
     std::shared_ptr<ItPQueue> _its{};
+    std::shared_ptr<internal::PixelStreamPrefetcher<N>> _prefetcher{};
     bool _sorted{};
 
     std::uint32_t _chrom1_id{};
@@ -257,9 +294,11 @@ class PixelSelectorAll {
    private:
     void init_iterators();
     void read_next_chunk();
+    void read_next_chunk_parallel();
   };
 };
 
 }  // namespace hictk::hic
 
 #include "./impl/pixel_selector_impl.hpp"  // NOLINT
+#include "./pixel_stream_prefetcher.hpp"     // NOLINT
@@ -0,0 +1,129 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+// IWYU pragma: private, include "hictk/hic.hpp"
+
+#include <BS_thread_pool.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "hictk/hic/pixel_selector.hpp"
+#include "hictk/pixel.hpp"
+
+namespace hictk::hic::internal {
+
+// Class used by PixelSelectorAll::iterator to decode the interactions of multiple chromosome
+// pairs using a pool of worker threads.
+// Each worker thread owns a file handle and a block cache, which are shared by all the streams
+// (i.e. PixelSelectors) processed by that worker. The block cache capacity of the original
+// selectors is split evenly across workers.
+// Once a worker starts decoding a stream, the stream is pinned to that worker until it is
+// exhausted, so that file handles and block caches are never accessed concurrently.
+// Worker threads decode streams ahead of the consumer into bounded per-stream queues of pixel
+// chunks, while the consumer thread only takes care of merging the streams overlapping the
+// current chromosome.
+template <typename N>
+class PixelStreamPrefetcher {
+ public:
+  using BufferT = std::vector<ThinPixel<N>>;
+
+ private:
+  using ChunkPtr = std::shared_ptr<const BufferT>;
+
+  static constexpr auto NO_WORKER = std::numeric_limits<std::size_t>::max();
+
+  struct Stream {
+    const PixelSelector *sel{};  // NOLINT
+    std::uint32_t chrom1_id{};   // NOLINT
+
+    // The following members are only accessed by the worker thread that is processing the stream
+    std::unique_ptr<PixelSelector> private_sel{};  // NOLINT
+    PixelSelector::iterator<N> first{};            // NOLINT
+    PixelSelector::iterator<N> last{};             // NOLINT
+
+    // The following members are guarded by PixelStreamPrefetcher::_mtx
+    std::deque<ChunkPtr> chunks{};  // NOLINT
+    std::size_t worker{NO_WORKER};  // NOLINT
+    bool busy{false};               // NOLINT
+    bool exhausted{false};          // NOLINT
+  };
+
+  struct Head {
+    ChunkPtr chunk{};      // NOLINT
+    std::size_t i{};       // NOLINT
+    std::size_t stream{};  // NOLINT
+
+    [[nodiscard]] const ThinPixel<N> &operator*() const noexcept;
+    [[nodiscard]] bool operator>(const Head &other) const noexcept;
+  };
+
+  std::vector<Stream> _streams{};
+  bool _sorted{true};
+  std::size_t _chunk_size{};
+  std::size_t _max_chunks_per_stream{};
+  std::size_t _cache_capacity_bytes{};
+
+  // Consumer state
+  using HeadPQueue = std::priority_queue<Head, std::vector<Head>, std::greater<>>;
+  HeadPQueue _heads{};
+  std::size_t _next_stream{};
+
+  // Shared state
+  std::mutex _mtx{};
+  std::condition_variable _stream_ready{};
+  std::condition_variable _work_available{};
+  std::size_t _first_active_stream{};
+  std::exception_ptr _exception{};
+  bool _stop{false};
+
+  BS::thread_pool _tpool;
+
+ public:
+  static constexpr std::size_t DEFAULT_CHUNK_SIZE{64'000};
+  static constexpr std::size_t DEFAULT_MAX_CHUNKS_PER_STREAM{4};
+
+  PixelStreamPrefetcher(const std::vector<PixelSelector> &selectors, bool sorted,
+                        std::size_t num_workers, std::size_t chunk_size = DEFAULT_CHUNK_SIZE,
+                        std::size_t max_chunks_per_stream = DEFAULT_MAX_CHUNKS_PER_STREAM);
+
+  PixelStreamPrefetcher(const PixelStreamPrefetcher &other) = delete;
+  PixelStreamPrefetcher(PixelStreamPrefetcher &&other) = delete;
+
+  ~PixelStreamPrefetcher() noexcept;
+
+  PixelStreamPrefetcher &operator=(const PixelStreamPrefetcher &other) = delete;
+  PixelStreamPrefetcher &operator=(PixelStreamPrefetcher &&other) = delete;
+
+  // Fill buff with the next batch of pixels.
+  // When iterating in sorted order, the batch consists of the pixels from a single stream sharing
+  // the same bin1_id.
+  // Returns false once all streams have been exhausted.
+  [[nodiscard]] bool read_next_chunk(BufferT &buff);
+
+ private:
+  void stop() noexcept;
+  void worker_loop(std::size_t worker_id);
+  [[nodiscard]] std::size_t find_next_stream(std::size_t worker_id) const noexcept;
+  [[nodiscard]] std::pair<ChunkPtr, bool> decode_next_chunk(
+      Stream &s, std::unique_ptr<PixelSelector> &io) const;
+
+  [[nodiscard]] ChunkPtr wait_for_next_chunk(std::size_t stream);
+  [[nodiscard]] bool init_heads();
+};
+
+}  // namespace hictk::hic::internal
+
+#include "./impl/pixel_stream_prefetcher_impl.hpp"  // NOLINT
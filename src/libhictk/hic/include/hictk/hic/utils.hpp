@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <string_view>
 #include <vector>
 
+#include "hictk/bin_table.hpp"
+
 namespace hictk::hic::utils {
 
 /// Iterable of hictk::hic::File or strings
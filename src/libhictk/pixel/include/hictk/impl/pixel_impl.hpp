@@ -129,9 +129,13 @@ inline bool ThinPixel<N>::operator>=(const ThinPixel &other) const noexcept {
 }
 
 template <typename N>
-inline auto ThinPixel<N>::from_coo(const BinTable &bins, std::string_view line, std::int64_t offset)
-    -> ThinPixel<N> {
+template <typename BinTableT>
+inline auto ThinPixel<N>::from_coo(const BinTableT &bins, std::string_view line,
+                                   std::int64_t offset) -> ThinPixel<N> {
   try {
+    if (!line.empty() && line.back() == '\r') {
+      line = line.substr(0, line.size() - 1);
+    }
     const auto toks = internal::tokenize_n<3>(line);
 
     const auto bin1_id =
@@ -140,14 +144,16 @@ inline auto ThinPixel<N>::from_coo(const BinTable &bins, std::string_view line,
         static_cast<std::size_t>(internal::parse_numeric_or_throw<std::int64_t>(toks[1]) + offset);
     const auto count = internal::parse_numeric_or_throw<N>(toks[2]);
 
-    if (bin1_id > bins.size()) {
+    // bin ids only need to be validated: there is no need to map them to the corresponding Bin
+    const auto num_bins = bins.size();
+    if (bin1_id >= num_bins) {
       throw std::out_of_range("invalid bin1_id: out of range");
     }
-    if (bin2_id > bins.size()) {
+    if (bin2_id >= num_bins) {
       throw std::out_of_range("invalid bin2_id: out of range");
     }
 
-    return {bins.at(bin1_id).id(), bins.at(bin2_id).id(), count};
+    return {bin1_id, bin2_id, count};
   } catch (const std::exception &e) {
     throw std::runtime_error(
         fmt::format(FMT_STRING("line \"{}\" is not in coo format: {}"), line, e.what()));
@@ -307,8 +313,9 @@ inline ThinPixel<N> Pixel<N>::to_thin() const noexcept {
 }
 
 template <typename N>
-inline auto Pixel<N>::from_coo(const hictk::BinTable &bins, std::string_view line,
-                               std::int64_t offset) -> Pixel<N> {
+template <typename BinTableT>
+inline auto Pixel<N>::from_coo(const BinTableT &bins, std::string_view line, std::int64_t offset)
+    -> Pixel<N> {
   try {
     const auto toks = internal::tokenize_n<3>(line);
 
@@ -326,8 +333,9 @@ inline auto Pixel<N>::from_coo(const hictk::BinTable &bins, std::string_view lin
 }
 
 template <typename N>
-inline auto Pixel<N>::from_bg2(const hictk::BinTable &bins, std::string_view line,
-                               std::int64_t offset) -> Pixel<N> {
+template <typename BinTableT>
+inline auto Pixel<N>::from_bg2(const BinTableT &bins, std::string_view line, std::int64_t offset)
+    -> Pixel<N> {
   try {
     if (line.empty()) {
       throw std::runtime_error("found an empty line");
@@ -354,7 +362,8 @@ inline auto Pixel<N>::from_bg2(const hictk::BinTable &bins, std::string_view lin
 }
 
 template <typename N>
-inline auto Pixel<N>::from_validpair(const hictk::BinTable &bins, std::string_view line,
+template <typename BinTableT>
+inline auto Pixel<N>::from_validpair(const BinTableT &bins, std::string_view line,
                                      std::int64_t offset) -> Pixel<N> {
   try {
     if (line.empty()) {
@@ -381,7 +390,8 @@ inline auto Pixel<N>::from_validpair(const hictk::BinTable &bins, std::string_vi
 }
 
 template <typename N>
-inline auto Pixel<N>::from_4dn_pairs(const hictk::BinTable &bins, std::string_view line,
+template <typename BinTableT>
+inline auto Pixel<N>::from_4dn_pairs(const BinTableT &bins, std::string_view line,
                                      std::int64_t offset) -> Pixel<N> {
   try {
     if (line.empty()) {
@@ -34,7 +34,9 @@ struct ThinPixel {
   [[nodiscard]] bool operator>=(const ThinPixel &other) const noexcept;
 
   static auto from_coo(std::string_view line, std::int64_t offset = 0) -> ThinPixel;
-  static auto from_coo(const BinTable &bins, std::string_view line, std::int64_t offset = 0)
+  // bins can be any bin table type (see Pixel::from_coo())
+  template <typename BinTableT>
+  static auto from_coo(const BinTableT &bins, std::string_view line, std::int64_t offset = 0)
       -> ThinPixel;
 };
 
@@ -86,13 +88,20 @@ struct Pixel {
   [[nodiscard]] bool operator>=(const Pixel<N> &other) const noexcept;
 
   [[nodiscard]] ThinPixel<N> to_thin() const noexcept;
-  static auto from_coo(const BinTable &bins, std::string_view line, std::int64_t offset = 0)
+  // Parsers accept any bin table type (i.e. BinTable, BinTableFixed or BinTableVariable<>).
+  // Passing the concrete bin table (see BinTable::visit()) avoids dispatching bin lookups through
+  // std::variant when parsing large numbers of pixels
+  template <typename BinTableT>
+  static auto from_coo(const BinTableT &bins, std::string_view line, std::int64_t offset = 0)
       -> Pixel;
-  static auto from_bg2(const BinTable &bins, std::string_view line, std::int64_t offset = 0)
+  template <typename BinTableT>
+  static auto from_bg2(const BinTableT &bins, std::string_view line, std::int64_t offset = 0)
       -> Pixel;
-  static auto from_validpair(const BinTable &bins, std::string_view line, std::int64_t offset = 0)
+  template <typename BinTableT>
+  static auto from_validpair(const BinTableT &bins, std::string_view line, std::int64_t offset = 0)
       -> Pixel;
-  static auto from_4dn_pairs(const BinTable &bins, std::string_view line, std::int64_t offset = 0)
+  template <typename BinTableT>
+  static auto from_4dn_pairs(const BinTableT &bins, std::string_view line, std::int64_t offset = 0)
       -> Pixel;
 };
 
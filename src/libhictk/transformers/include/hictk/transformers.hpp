@@ -10,3 +10,4 @@
 #include "hictk/transformers/stats.hpp"
 #include "hictk/transformers/to_dense_matrix.hpp"
 #include "hictk/transformers/to_sparse_matrix.hpp"
+#include "hictk/transformers/transform_matrix.hpp"
@@ -9,11 +9,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <type_traits>
+#include <variant>
 #include <vector>
 
 #include "hictk/bin_table.hpp"
 #include "hictk/pixel.hpp"
+#include "hictk/transformers/impl/common.hpp"
 
 namespace hictk::transformers {
 
@@ -52,15 +56,35 @@ class CoarsenPixels {
     using RowIt = typename BufferT::const_iterator;
     using ColumnMerger = phmap::flat_hash_map<std::uint64_t, BufferT>;
 
+    // Dense accumulator used to aggregate the pixels overlapping a row of the coarse matrix.
+    // counts and occupied only span the coarse columns overlapping the rows processed so far for
+    // the current chromosome, starting from first_column.
+    // Only used when coarsening tables with fixed bin size
+    struct RowAccumulator {
+      std::uint32_t chrom1_id{std::numeric_limits<std::uint32_t>::max()};  // NOLINT
+      std::uint64_t first_column{};                                        // NOLINT
+      std::vector<N> counts{};                                             // NOLINT
+      std::vector<std::uint8_t> occupied{};                                // NOLINT
+      std::vector<std::uint64_t> columns{};                                // NOLINT
+    };
+
     PixelIt _pixel_it{};
     PixelIt _pixel_last{};
     std::shared_ptr<const BinTable> _src_bins{};
     std::shared_ptr<const BinTable> _dest_bins{};
+    // Concrete bin tables, resolved once on construction so that mapping pixels does not go
+    // through std::visit. Only one of _src_bins_fixed and _src_bins_variable is not null, while
+    // the coarse bin table always has a fixed bin size
+    const BinTableFixed *_src_bins_fixed{};
+    const BinTableVariable<> *_src_bins_variable{};
+    const BinTableFixed *_dest_bins_fixed{};
     std::shared_ptr<BufferT> _buffer{};
+    std::shared_ptr<RowAccumulator> _accumulator{};
     RowIt _it{};
 
     std::uint64_t _bin1_id_chunk_start{};
     std::uint64_t _bin1_id_chunk_end{};
+    std::uint32_t _chrom1_id{};
 
    public:
     using difference_type = std::ptrdiff_t;
@@ -88,8 +112,11 @@ class CoarsenPixels {
     auto operator++(int) -> iterator;
 
    private:
-    auto coarsen_chunk_pass1() -> ColumnMerger;
+    void resolve_bin_tables() noexcept;
+    template <typename BinTableT>
+    auto coarsen_chunk_pass1(const BinTableT &src_bins) -> ColumnMerger;
     void coarsen_chunk_pass2(const ColumnMerger &col_merger);
+    void coarsen_row(const BinTableFixed &src_bins);
     void process_next_row();
   };
 };
@@ -7,14 +7,18 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "hictk/bin_table.hpp"
 #include "hictk/pixel.hpp"
+#include "hictk/transformers/impl/common.hpp"
 #include "hictk/transformers/pixel_merger.hpp"
 
 namespace hictk::transformers {
@@ -90,6 +94,9 @@ inline CoarsenPixels<PixelIt>::iterator::iterator(PixelIt first, PixelIt last,
       _dest_bins(std::move(dest_bins)),
       _buffer(std::make_shared<BufferT>()) {
   assert(_dest_bins->resolution() > _src_bins->resolution());
+  resolve_bin_tables();
+  assert(_src_bins_fixed || _src_bins_variable);
+  assert(_dest_bins_fixed);
 
   if (_pixel_it == _pixel_last) {
     *this = at_end(_pixel_last, _src_bins, _dest_bins);
@@ -108,31 +115,146 @@ inline auto CoarsenPixels<PixelIt>::iterator::at_end(PixelIt last,
   it._pixel_last = last;
   it._src_bins = std::move(src_bins);
   it._dest_bins = std::move(dest_bins);
+  it.resolve_bin_tables();
   return it;
 }
 
+template <typename PixelIt>
+inline void CoarsenPixels<PixelIt>::iterator::resolve_bin_tables() noexcept {
+  _src_bins_fixed = nullptr;
+  _src_bins_variable = nullptr;
+  _dest_bins_fixed = nullptr;
+  if (_src_bins) {
+    _src_bins_fixed = std::get_if<BinTableFixed>(&_src_bins->get());
+    _src_bins_variable = std::get_if<BinTableVariable<>>(&_src_bins->get());
+  }
+  if (_dest_bins) {
+    _dest_bins_fixed = std::get_if<BinTableFixed>(&_dest_bins->get());
+  }
+}
+
 template <typename PixelIt>
 inline void CoarsenPixels<PixelIt>::iterator::process_next_row() {
   if (_pixel_it == _pixel_last) {
     *this = at_end(_pixel_last, _src_bins, _dest_bins);
     return;
   }
-  auto buffer = coarsen_chunk_pass1();
-  coarsen_chunk_pass2(buffer);
+  if (_src_bins_fixed) {
+    coarsen_row(*_src_bins_fixed);
+  } else {
+    assert(_src_bins_variable);
+    auto buffer = coarsen_chunk_pass1(*_src_bins_variable);
+    coarsen_chunk_pass2(buffer);
+  }
   if (!!_buffer) {
     _it = _buffer->begin();
   }
 }
 
+// Aggregate all pixels mapping to the next row of the coarse matrix.
+// Bins are mapped using the chromosome offsets and integer division, while pixels are aggregated
+// using a dense accumulator indexed by the coarse bin2_id. The accumulator only spans the columns
+// overlapping the rows of the current chromosome, and is reset every time a new chromosome is
+// processed.
+template <typename PixelIt>
+inline void CoarsenPixels<PixelIt>::iterator::coarsen_row(const BinTableFixed &src_bins) {
+  assert(_pixel_it != _pixel_last);
+  const auto &src_offsets = src_bins.num_bin_prefix_sum();
+  assert(_dest_bins_fixed);
+  const auto &dest_offsets = _dest_bins_fixed->num_bin_prefix_sum();
+  const auto factor = _dest_bins_fixed->resolution() / src_bins.resolution();
+
+  // We need to map bin ids to the corresponding chromosome instead of just dividing bin ids by the
+  // coarsening factor to avoid mapping the last bin in chromosome i and the first bin in chromosome
+  // i+1 to the same coarse bin
+  _chrom1_id = hictk::internal::find_chrom_id(src_offsets, _pixel_it->bin1_id, _chrom1_id);
+
+  if (!_accumulator) {
+    _accumulator = std::make_shared<RowAccumulator>();
+  }
+  auto &acc = *_accumulator;
+  if (acc.chrom1_id != _chrom1_id) {
+    // release the memory used to process the rows of the previous chromosome
+    acc = RowAccumulator{};
+    acc.chrom1_id = _chrom1_id;
+  }
+
+  // Extend the accumulator so that it spans the given coarse column and return the index of the
+  // column in the accumulator. Extensions are amortized by (at least) doubling the size of the
+  // accumulator
+  auto column_idx = [&](std::uint64_t bin2_id) {
+    if (acc.counts.empty()) {
+      acc.first_column = bin2_id;
+    }
+    if (bin2_id < acc.first_column) {
+      const auto size = static_cast<std::uint64_t>(acc.counts.size());
+      const auto n = static_cast<std::size_t>(std::min(std::max(acc.first_column - bin2_id, size),
+                                                       acc.first_column - dest_offsets.front()));
+      acc.counts.insert(acc.counts.begin(), n, N{});
+      acc.occupied.insert(acc.occupied.begin(), n, 0);
+      acc.first_column -= n;
+    }
+    const auto i = static_cast<std::size_t>(bin2_id - acc.first_column);
+    if (i >= acc.counts.size()) {
+      const auto size = static_cast<std::uint64_t>(acc.counts.size());
+      const auto n = static_cast<std::size_t>(
+          std::min(std::max(bin2_id - acc.first_column + 1, 2 * size),
+                   dest_offsets.back() - acc.first_column));
+      acc.counts.resize(n);
+      acc.occupied.resize(n, 0);
+    }
+    return i;
+  };
+
+  const auto src_offset1 = src_offsets[_chrom1_id];
+  const auto dest_offset1 = dest_offsets[_chrom1_id];
+  const auto bin1_id = dest_offset1 + (_pixel_it->bin1_id - src_offset1) / factor;
+  const auto last_src_bin1_id =
+      std::min(src_offset1 + ((bin1_id - dest_offset1 + 1) * factor), src_offsets[_chrom1_id + 1]);
+
+  auto chrom2_id = _chrom1_id;
+  for (; _pixel_it != _pixel_last && _pixel_it->bin1_id < last_src_bin1_id; ++_pixel_it) {
+    const ThinPixel<N> p = *_pixel_it;
+    chrom2_id = hictk::internal::find_chrom_id(src_offsets, p.bin2_id, chrom2_id);
+    const auto bin2_id = dest_offsets[chrom2_id] + (p.bin2_id - src_offsets[chrom2_id]) / factor;
+    const auto i = column_idx(bin2_id);
+    if (acc.occupied[i]) {
+      acc.counts[i] += p.count;
+    } else {
+      acc.occupied[i] = 1;
+      acc.counts[i] = p.count;
+      acc.columns.push_back(bin2_id);
+    }
+  }
+
+  std::sort(acc.columns.begin(), acc.columns.end());
+
+  if (_buffer.use_count() != 1) {
+    _buffer = std::make_shared<BufferT>();
+  }
+  _buffer->clear();
+  _buffer->reserve(acc.columns.size());
+  for (const auto &bin2_id : acc.columns) {
+    const auto i = static_cast<std::size_t>(bin2_id - acc.first_column);
+    _buffer->emplace_back(ThinPixel<N>{bin1_id, bin2_id, acc.counts[i]});
+    acc.occupied[i] = 0;
+  }
+  acc.columns.clear();
+}
+
 // Loop over the current chunk and coarse pixels based on bin1_ids
 template <typename PixelIt>
-inline auto CoarsenPixels<PixelIt>::iterator::coarsen_chunk_pass1() -> ColumnMerger {
+template <typename BinTableT>
+inline auto CoarsenPixels<PixelIt>::iterator::coarsen_chunk_pass1(const BinTableT &src_bins)
+    -> ColumnMerger {
   assert(_pixel_it != _pixel_last);
+  assert(_dest_bins_fixed);
+  const auto &dest_bins = *_dest_bins_fixed;
   ColumnMerger merger{};
 
   // Compute the first and last bins mapping to chunk we are processing
-  const auto factor = _dest_bins->resolution() / _src_bins->resolution();
-  _bin1_id_chunk_start = (_src_bins->at(_pixel_it->bin1_id).rel_id() / factor) * factor;
+  const auto factor = dest_bins.resolution() / _src_bins->resolution();
+  _bin1_id_chunk_start = (src_bins.at(_pixel_it->bin1_id).rel_id() / factor) * factor;
   _bin1_id_chunk_end = _bin1_id_chunk_start + factor;
 
   // Init one empty buffer for each row in the current chunk
@@ -148,16 +270,16 @@ inline auto CoarsenPixels<PixelIt>::iterator::coarsen_chunk_pass1() -> ColumnMer
     // We need to map pixel coordinates instead of just dividing bin ids by the coarsening factor to
     // avoid mapping the last pixel in a chromosome i and the first pixel in chromosome i+1 as to
     // the same coarse bin
-    const PixelCoordinates src_coords{_src_bins->at(_pixel_it->bin1_id),
-                                      _src_bins->at(_pixel_it->bin2_id)};
+    const PixelCoordinates src_coords{src_bins.at(_pixel_it->bin1_id),
+                                      src_bins.at(_pixel_it->bin2_id)};
     const PixelCoordinates dest_coords{
-        _dest_bins->at(src_coords.bin1.chrom(), src_coords.bin1.start()),
-        _dest_bins->at(src_coords.bin2.chrom(), src_coords.bin2.start())};
+        dest_bins.at(src_coords.bin1.chrom(), src_coords.bin1.start()),
+        dest_bins.at(src_coords.bin2.chrom(), src_coords.bin2.start())};
 
     if (const auto id = src_coords.bin1.rel_id();
         id < _bin1_id_chunk_start || id >= _bin1_id_chunk_end) {
       if (i == 0) {
-        return coarsen_chunk_pass1();  // found an empty row
+        return coarsen_chunk_pass1(src_bins);  // found an empty row
       }
       break;  // done processing current chunk
     }
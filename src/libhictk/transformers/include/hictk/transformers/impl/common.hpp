@@ -4,7 +4,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <type_traits>
+#include <vector>
+
+#include "hictk/bin.hpp"
+#include "hictk/bin_table.hpp"
 
 namespace hictk::transformers::internal {
 template <typename T, typename = std::void_t<>>
@@ -13,4 +18,19 @@ inline constexpr bool has_coord1_member_fx = false;
 template <typename T>
 inline constexpr bool has_coord1_member_fx<T, std::void_t<decltype(std::declval<T>().coord1())>> =
     true;
+
+// Map bin_id to the corresponding Bin using the given bin table (e.g. BinTableFixed).
+// chrom_id is used as hint to find the chromosome overlapping bin_id (see
+// hictk::internal::find_chrom_id()), and is updated with the id of the chromosome overlapping
+// bin_id
+template <typename BinTableT>
+[[nodiscard]] inline Bin map_bin_id(const BinTableT &bins, std::uint64_t bin_id,
+                                    std::uint32_t &chrom_id) {
+  const auto &offsets = bins.num_bin_prefix_sum();
+  if (offsets.size() < 2 || bin_id < offsets.front() || bin_id >= offsets.back()) {
+    return bins.at(bin_id);  // throws
+  }
+  chrom_id = hictk::internal::find_chrom_id(offsets, bin_id, chrom_id);
+  return bins.at_hint(bin_id, bins.chromosomes()[chrom_id]);
 }
+}  // namespace hictk::transformers::internal
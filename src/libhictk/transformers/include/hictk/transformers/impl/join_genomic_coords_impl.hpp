@@ -6,14 +6,17 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <tuple>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "hictk/bin_table.hpp"
 #include "hictk/pixel.hpp"
+#include "hictk/transformers/impl/common.hpp"
 
 namespace hictk::transformers {
 
@@ -46,8 +49,13 @@ inline auto JoinGenomicCoords<PixelIt>::read_all() const -> std::vector<Pixel<N>
   // We push_back into buff to avoid traversing pixels twice (once to figure out the vector size,
   // and a second time to copy the actual data)
   std::vector<Pixel<N>> buff{};
-  std::transform(_first, _last, std::back_inserter(buff), [&](const ThinPixel<N>& p) {
-    return Pixel<N>{{_bins->at(p.bin1_id), _bins->at(p.bin2_id)}, p.count};
+  _bins->visit([&](const auto& bins) {
+    std::uint32_t chrom1_id{};
+    std::uint32_t chrom2_id{};
+    std::transform(_first, _last, std::back_inserter(buff), [&](const ThinPixel<N>& p) {
+      return Pixel<N>{internal::map_bin_id(bins, p.bin1_id, chrom1_id),
+                      internal::map_bin_id(bins, p.bin2_id, chrom2_id), p.count};
+    });
   });
   return buff;
 }
@@ -55,7 +63,9 @@ inline auto JoinGenomicCoords<PixelIt>::read_all() const -> std::vector<Pixel<N>
 template <typename PixelIt>
 inline JoinGenomicCoords<PixelIt>::iterator::iterator(PixelIt it,
                                                       std::shared_ptr<const BinTable> bins)
-    : _it(std::move(it)), _bins(std::move(bins)) {}
+    : _it(std::move(it)), _bins(std::move(bins)) {
+  resolve_bin_table();
+}
 
 template <typename PixelIt>
 inline auto JoinGenomicCoords<PixelIt>::iterator::at_end(PixelIt it,
@@ -64,6 +74,7 @@ inline auto JoinGenomicCoords<PixelIt>::iterator::at_end(PixelIt it,
   iterator it_{};
   it_._it = std::move(it);
   it_._bins = std::move(bins);
+  it_.resolve_bin_table();
   return it_;
 }
 
@@ -78,8 +89,12 @@ inline bool JoinGenomicCoords<PixelIt>::iterator::operator!=(const iterator& oth
 
 template <typename PixelIt>
 inline auto JoinGenomicCoords<PixelIt>::iterator::operator*() const -> const_reference {
-  assert(_bins);
-  _value = Pixel<N>{_bins->at(_it->bin1_id), _bins->at(_it->bin2_id), _it->count};
+  assert(_bins_fixed || _bins_variable);
+  if (_bins_fixed) {
+    map_pixel(*_bins_fixed);
+  } else {
+    map_pixel(*_bins_variable);
+  }
   return _value;
 }
 template <typename PixelIt>
@@ -100,4 +115,21 @@ inline auto JoinGenomicCoords<PixelIt>::iterator::operator++(int) -> iterator {
   return it;
 }
 
+template <typename PixelIt>
+inline void JoinGenomicCoords<PixelIt>::iterator::resolve_bin_table() noexcept {
+  _bins_fixed = nullptr;
+  _bins_variable = nullptr;
+  if (_bins) {
+    _bins_fixed = std::get_if<BinTableFixed>(&_bins->get());
+    _bins_variable = std::get_if<BinTableVariable<>>(&_bins->get());
+  }
+}
+
+template <typename PixelIt>
+template <typename BinTableT>
+inline void JoinGenomicCoords<PixelIt>::iterator::map_pixel(const BinTableT& bins) const {
+  _value = Pixel<N>{internal::map_bin_id(bins, _it->bin1_id, _chrom1_id),
+                    internal::map_bin_id(bins, _it->bin2_id, _chrom2_id), _it->count};
+}
+
 }  // namespace hictk::transformers
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -13,33 +17,163 @@
 namespace hictk::transformers {
 
 template <typename PixelIt>
-inline bool PixelMerger<PixelIt>::Node::operator<(const Node &other) const noexcept {
-  assert(!!pixel);
-  assert(!!other.pixel);
-  if (pixel.bin1_id != other.pixel.bin1_id) {
-    return pixel.bin1_id < other.pixel.bin1_id;
+inline PixelMerger<PixelIt>::LoserTree::LoserTree(const std::vector<PixelIt> &heads,
+                                                  const std::vector<PixelIt> &tails,
+                                                  std::size_t block_size)
+    : _block_size(std::max(std::size_t(1), block_size)) {
+  assert(heads.size() == tails.size());
+  _sources.reserve(heads.size());
+  for (std::size_t i = 0; i < heads.size(); ++i) {
+    _sources.emplace_back(Source{heads[i], tails[i], {}, 0});
+  }
+
+  std::size_t num_leaves = 1;
+  while (num_leaves < _sources.size()) {
+    num_leaves <<= 1U;
   }
-  return pixel.bin2_id < other.pixel.bin2_id;
+  _keys.resize(num_leaves, &SENTINEL);
+  for (std::size_t i = 0; i < _sources.size(); ++i) {
+    refill(i);
+  }
+  init_tree();
 }
 
 template <typename PixelIt>
-inline bool PixelMerger<PixelIt>::Node::operator>(const Node &other) const noexcept {
-  assert(!!pixel);
-  assert(!!other.pixel);
-  if (pixel.bin1_id != other.pixel.bin1_id) {
-    return pixel.bin1_id > other.pixel.bin1_id;
+inline PixelMerger<PixelIt>::LoserTree::LoserTree(const LoserTree &other)
+    : _sources(other._sources),
+      _keys(other._keys.size(), &SENTINEL),
+      _tree(other._tree),
+      _block_size(other._block_size) {
+  reset_keys();
+}
+
+template <typename PixelIt>
+inline auto PixelMerger<PixelIt>::LoserTree::operator=(const LoserTree &other) -> LoserTree & {
+  if (this == &other) {
+    return *this;
   }
-  return pixel.bin2_id > other.pixel.bin2_id;
+
+  _sources = other._sources;
+  _keys.assign(other._keys.size(), &SENTINEL);
+  _tree = other._tree;
+  _block_size = other._block_size;
+  reset_keys();
+
+  return *this;
 }
 
 template <typename PixelIt>
-inline bool PixelMerger<PixelIt>::Node::operator==(const Node &other) const noexcept {
-  return pixel.bin1_id == other.pixel.bin1_id && pixel.bin2_id == other.pixel.bin2_id;
+inline bool PixelMerger<PixelIt>::LoserTree::empty() const noexcept {
+  return _tree.empty() || _keys[_tree.front()] == &SENTINEL;
 }
 
 template <typename PixelIt>
-inline bool PixelMerger<PixelIt>::Node::operator!=(const Node &other) const noexcept {
-  return !(*this == other);
+inline std::size_t PixelMerger<PixelIt>::LoserTree::read(std::vector<ThinPixel<N>> &buff,
+                                                         std::size_t count) {
+  std::size_t i = 0;
+  for (; i < count && !empty(); ++i) {
+    auto pixel = top();
+    pop_and_replay();
+
+    // aggregate interactions with identical coordinates
+    while (!empty()) {
+      const auto &next_pixel = top();
+      if (next_pixel.bin1_id != pixel.bin1_id || next_pixel.bin2_id != pixel.bin2_id) {
+        break;
+      }
+      pixel.count += next_pixel.count;
+      pop_and_replay();
+    }
+    buff.push_back(pixel);
+  }
+  return i;
+}
+
+template <typename PixelIt>
+inline bool PixelMerger<PixelIt>::LoserTree::less(std::size_t i1, std::size_t i2) const noexcept {
+  const auto &p1 = *_keys[i1];
+  const auto &p2 = *_keys[i2];
+  if (p1.bin1_id != p2.bin1_id) {
+    return p1.bin1_id < p2.bin1_id;
+  }
+  return p1.bin2_id < p2.bin2_id;
+}
+
+template <typename PixelIt>
+inline std::size_t PixelMerger<PixelIt>::LoserTree::num_leaves() const noexcept {
+  return _keys.size();
+}
+
+template <typename PixelIt>
+inline auto PixelMerger<PixelIt>::LoserTree::top() const noexcept -> const ThinPixel<N> & {
+  assert(!empty());
+  return *_keys[_tree.front()];
+}
+
+template <typename PixelIt>
+inline void PixelMerger<PixelIt>::LoserTree::pop_and_replay() {
+  assert(!empty());
+  auto winner = _tree.front();
+
+  auto &src = _sources[winner];
+  if (++src.i == src.buff.size()) {
+    refill(winner);
+  } else {
+    _keys[winner] = &src.buff[src.i];
+  }
+
+  // replay the matches from the leaf up to the root
+  for (auto node = (winner + num_leaves()) >> 1U; node != 0; node >>= 1U) {
+    if (less(_tree[node], winner)) {
+      std::swap(_tree[node], winner);
+    }
+  }
+  _tree.front() = winner;
+}
+
+template <typename PixelIt>
+inline void PixelMerger<PixelIt>::LoserTree::refill(std::size_t i) {
+  auto &src = _sources[i];
+  src.buff.clear();
+  src.i = 0;
+  for (; src.first != src.last && src.buff.size() < _block_size; ++src.first) {
+    src.buff.emplace_back(*src.first);
+  }
+  _keys[i] = src.buff.empty() ? &SENTINEL : &src.buff.front();
+}
+
+template <typename PixelIt>
+inline void PixelMerger<PixelIt>::LoserTree::reset_keys() noexcept {
+  for (std::size_t i = 0; i < _sources.size(); ++i) {
+    const auto &src = _sources[i];
+    _keys[i] = src.i < src.buff.size() ? &src.buff[src.i] : &SENTINEL;
+  }
+}
+
+template <typename PixelIt>
+inline void PixelMerger<PixelIt>::LoserTree::init_tree() {
+  if (_sources.empty()) {
+    _tree.clear();
+    return;
+  }
+
+  // winners[n] holds the winner of the match played at node n, with leaves stored at
+  // winners[num_leaves()..2 * num_leaves())
+  const auto n = num_leaves();
+  std::vector<std::size_t> winners(2 * n);
+  _tree.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    winners[n + i] = i;
+  }
+
+  for (auto node = n - 1; node != 0; --node) {
+    const auto i1 = winners[2 * node];
+    const auto i2 = winners[(2 * node) + 1];
+    const auto i1_wins = !less(i2, i1);
+    winners[node] = i1_wins ? i1 : i2;
+    _tree[node] = i1_wins ? i2 : i1;
+  }
+  _tree.front() = winners[1];
 }
 
 template <typename PixelIt>
@@ -82,30 +216,20 @@ inline auto PixelMerger<PixelIt>::read_all() const -> std::vector<PixelT> {
 template <typename PixelIt>
 inline PixelMerger<PixelIt>::iterator::iterator(const std::vector<PixelIt> &heads,
                                                 const std::vector<PixelIt> &tails)
-    : _pqueue(std::make_shared<PQueueT>()),
-      _heads(std::make_shared<std::vector<PixelIt>>(heads)),
-      _tails(std::make_shared<std::vector<PixelIt>>(tails)) {
+    : _buff(std::make_shared<BufferT>()) {
   assert(heads.size() == tails.size());
-  for (auto &it : *_heads) {
-    _pqueue->emplace(Node{*it++, _pqueue->size()});
-  }
-  _value = next();
+  const auto block_size =
+      std::clamp(DEFAULT_INPUT_BUFFER_SIZE / std::max(std::size_t(1), heads.size()),
+                 MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+  _tree = std::make_shared<LoserTree>(heads, tails, block_size);
+  read_next_chunk();
 }
 
 template <typename PixelIt>
 inline PixelMerger<PixelIt>::iterator::iterator(const iterator &other)
-    : _value(other._value),
-      _pqueue(other._pqueue ? std::make_shared<PQueueT>(*other._pqueue) : nullptr),
-      _heads(other._heads ? std::make_shared<std::vector<PixelIt>>(*other._heads) : nullptr),
-      _tails(other._tails ? std::make_shared<std::vector<PixelIt>>(*other._tails) : nullptr),
-      _i(other._i) {}
-
-template <typename PixelIt>
-inline PixelMerger<PixelIt>::iterator::iterator(iterator &&other) noexcept
-    : _value(other._value),
-      _pqueue(std::move(other._pqueue)),
-      _heads(std::move(other._heads)),
-      _tails(std::move(other._tails)),
+    : _tree(other._tree ? std::make_shared<LoserTree>(*other._tree) : nullptr),
+      _buff(other._buff),
+      _j(other._j),
       _i(other._i) {}
 
 template <typename PixelIt>
@@ -114,25 +238,9 @@ inline auto PixelMerger<PixelIt>::iterator::operator=(const iterator &other) ->
     return *this;
   }
 
-  _value = other._value;
-  _pqueue = other._pqueue ? std::make_shared<PQueueT>(*other._pqueue) : nullptr;
-  _heads = other._heads ? std::make_shared<std::vector<PixelIt>>(*other._heads) : nullptr;
-  _tails = other._tails ? std::make_shared<std::vector<PixelIt>>(*other._tails) : nullptr;
-  _i = other._i;
-
-  return *this;
-}
-
-template <typename PixelIt>
-inline auto PixelMerger<PixelIt>::iterator::operator=(iterator &&other) noexcept -> iterator & {
-  if (this == &other) {
-    return *this;
-  }
-
-  _value = std::move(other._value);
-  _pqueue = std::move(other._pqueue);
-  _heads = std::move(other._heads);
-  _tails = std::move(other._tails);
+  _tree = other._tree ? std::make_shared<LoserTree>(*other._tree) : nullptr;
+  _buff = other._buff;
+  _j = other._j;
   _i = other._i;
 
   return *this;
@@ -140,11 +248,11 @@ inline auto PixelMerger<PixelIt>::iterator::operator=(iterator &&other) noexcept
 
 template <typename PixelIt>
 inline bool PixelMerger<PixelIt>::iterator::operator==(const iterator &other) const noexcept {
-  if (!_heads || !other._heads) {
+  if (!_tree || !other._tree) {
     // check if we are at end
-    return _heads == other._heads;
+    return _tree == other._tree;
   }
-  return _heads == other._heads && _i == other._i;
+  return _tree == other._tree && _i == other._i;
 }
 
 template <typename PixelIt>
@@ -154,7 +262,9 @@ inline bool PixelMerger<PixelIt>::iterator::operator!=(const iterator &other) co
 
 template <typename PixelIt>
 inline auto PixelMerger<PixelIt>::iterator::operator*() const noexcept -> const ThinPixel<N> & {
-  return _value;
+  assert(_buff);
+  assert(_j < _buff->size());
+  return (*_buff)[_j];
 }
 
 template <typename PixelIt>
@@ -164,47 +274,29 @@ inline auto PixelMerger<PixelIt>::iterator::operator->() const noexcept -> const
 
 template <typename PixelIt>
 inline auto PixelMerger<PixelIt>::iterator::operator++() -> iterator & {
-  assert(_heads);
-  _value = next();
-  if (!_value) {
-    _heads = nullptr;
-    _tails = nullptr;
+  assert(_tree);
+  ++_i;
+  if (++_j == _buff->size()) {
+    read_next_chunk();
   }
 
   return *this;
 }
 
 template <typename PixelIt>
-inline void PixelMerger<PixelIt>::iterator::replace_top_node() {
-  assert(_heads);
-  assert(_tails);
-  const auto i = _pqueue->top().i;
-  _pqueue->pop();
-  if (auto &it = (*_heads)[i]; it != (*_tails)[i]) {
-    _pqueue->emplace(Node{*it, i});
-    ++it;
-  }
-}
-
-template <typename PixelIt>
-inline auto PixelMerger<PixelIt>::iterator::next() -> PixelT {
-  if (_pqueue->empty()) {
-    return {};
+inline void PixelMerger<PixelIt>::iterator::read_next_chunk() {
+  assert(_tree);
+  if (_buff.use_count() != 1) {
+    // other iterators are still referencing the current buffer
+    _buff = std::make_shared<BufferT>();
   }
+  _buff->clear();
+  _j = 0;
 
-  auto current_node = _pqueue->top();
-  replace_top_node();
-
-  while (!_pqueue->empty()) {
-    const auto next_node = _pqueue->top();
-    if (next_node != current_node) {
-      break;
-    }
-    current_node.pixel.count += next_node.pixel.count;
-    replace_top_node();
+  if (_tree->read(*_buff, OUTPUT_BLOCK_SIZE) == 0) {
+    _tree = nullptr;
+    _buff = nullptr;
   }
-  ++_i;
-  return current_node.pixel;
 }
 
 }  // namespace hictk::transformers
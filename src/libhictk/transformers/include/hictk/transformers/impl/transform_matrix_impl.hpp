@@ -0,0 +1,233 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "hictk/common.hpp"
+#include "hictk/expected_values_table.hpp"
+#include "hictk/pixel.hpp"
+#include "hictk/transformers/impl/common.hpp"
+
+namespace hictk::transformers {
+
+template <typename PixelIt>
+inline TransformMatrix<PixelIt>::TransformMatrix(
+    PixelIt first_pixel, PixelIt last_pixel, std::shared_ptr<const ExpectedValuesTable> expected,
+    MatrixTransform transform, std::uint64_t min_distance, std::uint64_t max_distance)
+    : _first(std::move(first_pixel)),
+      _last(std::move(last_pixel)),
+      _expected(std::move(expected)),
+      _transform(transform),
+      _min_distance(min_distance),
+      _max_distance(max_distance) {
+  if (!_expected) {
+    throw std::invalid_argument("expected values cannot be null");
+  }
+  if (_min_distance >= _max_distance) {
+    throw std::invalid_argument("min_distance should be smaller than max_distance");
+  }
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::begin() const -> iterator {
+  return iterator{_first, _last, _expected, _transform, _min_distance, _max_distance};
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::end() const -> iterator {
+  return iterator::at_end(_last);
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::cbegin() const -> iterator {
+  return begin();
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::cend() const -> iterator {
+  return end();
+}
+
+template <typename PixelIt>
+inline const ExpectedValuesTable &TransformMatrix<PixelIt>::expected_values() const noexcept {
+  assert(_expected);
+  return *_expected;
+}
+
+template <typename PixelIt>
+constexpr MatrixTransform TransformMatrix<PixelIt>::transform() const noexcept {
+  return _transform;
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::read_all() const -> std::vector<ThinPixel<double>> {
+  // We push_back into buff to avoid traversing pixels twice (once to figure out the vector size,
+  // and a second time to copy the actual data)
+  std::vector<ThinPixel<double>> buff{};
+  std::copy(begin(), end(), std::back_inserter(buff));
+  return buff;
+}
+
+template <typename PixelIt>
+inline TransformMatrix<PixelIt>::iterator::iterator(
+    PixelIt first, PixelIt last, std::shared_ptr<const ExpectedValuesTable> expected,
+    MatrixTransform transform, std::uint64_t min_distance, std::uint64_t max_distance)
+    : _it(std::move(first)),
+      _last(std::move(last)),
+      _expected(std::move(expected)),
+      _transform(transform),
+      _min_distance(min_distance),
+      _max_distance(max_distance),
+      _offsets(&_expected->bins().num_bin_prefix_sum()) {
+  seek_next_pixel();
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::iterator::at_end(PixelIt last) -> iterator {
+  iterator it{};
+  it._it = last;
+  it._last = std::move(last);
+  return it;
+}
+
+template <typename PixelIt>
+inline bool TransformMatrix<PixelIt>::iterator::operator==(const iterator &other) const noexcept {
+  return _it == other._it;
+}
+
+template <typename PixelIt>
+inline bool TransformMatrix<PixelIt>::iterator::operator!=(const iterator &other) const noexcept {
+  return !(*this == other);
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::iterator::operator*() const noexcept -> const_reference {
+  assert(_it != _last);
+  return _value;
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::iterator::operator->() const noexcept -> const_pointer {
+  return &(**this);
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::iterator::operator++() -> iterator & {
+  assert(_it != _last);
+  std::ignore = ++_it;
+  seek_next_pixel();
+  return *this;
+}
+
+template <typename PixelIt>
+inline auto TransformMatrix<PixelIt>::iterator::operator++(int) -> iterator {
+  auto it = *this;
+  std::ignore = ++(*this);
+  return it;
+}
+
+template <typename PixelIt>
+inline bool TransformMatrix<PixelIt>::iterator::has_distance_band() const noexcept {
+  return _min_distance != 0 || _max_distance != UNBOUNDED_DISTANCE;
+}
+
+template <typename PixelIt>
+inline void TransformMatrix<PixelIt>::iterator::update_expected_values(std::uint32_t chrom1_id,
+                                                                       std::uint32_t chrom2_id) {
+  assert(_expected);
+  const auto &chroms = _expected->bins().chromosomes();
+  const auto &chrom1 = chroms.at(chrom1_id);
+  const auto &chrom2 = chroms.at(chrom2_id);
+
+  _chrom1_id = chrom1_id;
+  _chrom2_id = chrom2_id;
+  _init = true;
+
+  if (chrom1_id == chrom2_id) {
+    _cis_expected = &_expected->cis(chrom1);
+    _trans_expected = std::numeric_limits<double>::quiet_NaN();
+  } else {
+    _cis_expected = nullptr;
+    _trans_expected = _expected->trans(chrom1, chrom2);
+  }
+}
+
+template <typename PixelIt>
+inline double TransformMatrix<PixelIt>::iterator::cis_expected_value(
+    std::uint64_t distance) const noexcept {
+  assert(_cis_expected);
+  if (_cis_expected->empty()) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  // Distances past the end of the vector of expected values are mapped to the last value
+  const auto i = std::min(distance, static_cast<std::uint64_t>(_cis_expected->size() - 1));
+  return (*_cis_expected)[i];
+}
+
+template <typename PixelIt>
+inline double TransformMatrix<PixelIt>::iterator::transform(double observed,
+                                                            double expected) const noexcept {
+  if (_transform == MatrixTransform::observed) {
+    return observed;
+  }
+  if (!(expected > 0)) {  // also catches NaNs
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  switch (_transform) {
+    case MatrixTransform::oe:
+      return observed / expected;
+    case MatrixTransform::log2_oe:
+      return std::log2(observed / expected);
+    case MatrixTransform::pearson:
+      return (observed - expected) / std::sqrt(expected);
+    default:
+      unreachable_code();
+  }
+}
+
+template <typename PixelIt>
+inline void TransformMatrix<PixelIt>::iterator::seek_next_pixel() {
+  assert(_offsets);
+  for (; _it != _last; std::ignore = ++_it) {
+    const auto bin1_id = _it->bin1_id;
+    const auto bin2_id = _it->bin2_id;
+    const auto observed = conditional_static_cast<double>(_it->count);
+
+    const auto chrom1_id = hictk::internal::find_chrom_id(*_offsets, bin1_id, _chrom1_id);
+    const auto chrom2_id = hictk::internal::find_chrom_id(*_offsets, bin2_id, _chrom2_id);
+    if (!_init || chrom1_id != _chrom1_id || chrom2_id != _chrom2_id) {
+      update_expected_values(chrom1_id, chrom2_id);
+    }
+
+    if (chrom1_id != chrom2_id) {
+      if (has_distance_band()) {
+        continue;
+      }
+      _value = ThinPixel<double>{bin1_id, bin2_id, transform(observed, _trans_expected)};
+      return;
+    }
+
+    const auto distance = bin1_id <= bin2_id ? bin2_id - bin1_id : bin1_id - bin2_id;
+    if (distance < _min_distance || distance >= _max_distance) {
+      continue;
+    }
+    _value = ThinPixel<double>{bin1_id, bin2_id, transform(observed, cis_expected_value(distance))};
+    return;
+  }
+}
+
+}  // namespace hictk::transformers
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <type_traits>
@@ -39,7 +40,14 @@ class JoinGenomicCoords {
   class iterator {
     PixelIt _it{};
     std::shared_ptr<const BinTable> _bins{};
+    // Concrete bin table, resolved once on construction so that mapping pixels does not go
+    // through std::visit. Only one of the two pointers is not null
+    const BinTableFixed *_bins_fixed{};
+    const BinTableVariable<> *_bins_variable{};
     mutable Pixel<N> _value{};
+    // ids of the chromosomes overlapping the last pixel, used to speed up bin lookups
+    mutable std::uint32_t _chrom1_id{};
+    mutable std::uint32_t _chrom2_id{};
 
    public:
     using difference_type = std::ptrdiff_t;
@@ -62,6 +70,11 @@ class JoinGenomicCoords {
 
     auto operator++() -> iterator &;
     auto operator++(int) -> iterator;
+
+   private:
+    void resolve_bin_table() noexcept;
+    template <typename BinTableT>
+    void map_pixel(const BinTableT &bins) const;
   };
 };
 
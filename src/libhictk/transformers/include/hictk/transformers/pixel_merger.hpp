@@ -5,10 +5,10 @@
 #pragma once
 
 #include <cstddef>
-#include <functional>
+#include <cstdint>
 #include <iterator>
+#include <limits>
 #include <memory>
-#include <queue>
 #include <type_traits>
 #include <vector>
 
@@ -17,31 +17,75 @@
 
 namespace hictk::transformers {
 
-/// This class is basically a wrapper around a priority queue of objects of type Node
-/// Node consist of a pixel and an index. The index represent from which iterator the
-/// pixel was read. This allows us to know from which iterator we should read the next pixel (i.e.
-/// the same iterator from which the top pixel originated)
+/// This class implements a k-way merge of sorted sequences of pixels.
+/// Sequences are merged using a tournament tree of losers (loser tree): each internal node of the
+/// tree stores the index of the sequence that lost the match played at that node, while the
+/// overall winner is stored at the root.
+/// Replacing the winner only requires replaying the matches along the path from the winner's leaf
+/// to the root, i.e. log2(k) comparisons, each involving a single node.
+/// Pixels are read from the input iterators in blocks, and pixels with identical coordinates
+/// are aggregated as they are popped from the tree. Merged pixels are also produced in blocks, so
+/// that iterating over PixelMerger only costs an index increment for most pixels.
 template <typename PixelIt>
 class PixelMerger {
   using N = decltype(std::declval<PixelIt>()->count);
-  struct Node {
-    ThinPixel<N> pixel{};  // NOLINT
-    std::size_t i{};       // NOLINT
-
-    bool operator<(const Node &other) const noexcept;
-    bool operator>(const Node &other) const noexcept;
-    bool operator==(const Node &other) const noexcept;
-    bool operator!=(const Node &other) const noexcept;
+
+  class LoserTree {
+    struct Source {
+      PixelIt first{};                   // NOLINT
+      PixelIt last{};                    // NOLINT
+      std::vector<ThinPixel<N>> buff{};  // NOLINT
+      std::size_t i{};                   // NOLINT
+    };
+
+    std::vector<Source> _sources{};
+    // Pointers to the current pixel of each source (padded to a power of 2)
+    std::vector<const ThinPixel<N> *> _keys{};
+    // _tree[0] holds the winner, while _tree[1..] hold the losers of each match
+    std::vector<std::size_t> _tree{};
+    std::size_t _block_size{};
+
+    static inline const ThinPixel<N> SENTINEL{std::numeric_limits<std::uint64_t>::max(),
+                                              std::numeric_limits<std::uint64_t>::max(), 0};
+
+   public:
+    LoserTree() = default;
+    LoserTree(const std::vector<PixelIt> &heads, const std::vector<PixelIt> &tails,
+              std::size_t block_size);
+    LoserTree(const LoserTree &other);
+    LoserTree(LoserTree &&other) noexcept = default;
+    ~LoserTree() noexcept = default;
+
+    LoserTree &operator=(const LoserTree &other);
+    LoserTree &operator=(LoserTree &&other) noexcept = default;
+
+    [[nodiscard]] bool empty() const noexcept;
+    // Append up to count merged pixels to buff.
+    // Returns the number of pixels that were appended
+    std::size_t read(std::vector<ThinPixel<N>> &buff, std::size_t count);
+
+   private:
+    [[nodiscard]] bool less(std::size_t i1, std::size_t i2) const noexcept;
+    [[nodiscard]] std::size_t num_leaves() const noexcept;
+    [[nodiscard]] const ThinPixel<N> &top() const noexcept;
+    void pop_and_replay();
+    void refill(std::size_t i);
+    void reset_keys() noexcept;
+    void init_tree();
   };
 
   std::vector<PixelIt> _heads{};
   std::vector<PixelIt> _tails{};
-  std::size_t _i{};
 
  public:
   using PixelT = remove_cvref_t<decltype(*std::declval<PixelIt>())>;
   class iterator;
 
+  // Maximum number of pixels buffered across all input sequences
+  static constexpr std::size_t DEFAULT_INPUT_BUFFER_SIZE{256ULL << 10U};
+  static constexpr std::size_t MIN_BLOCK_SIZE{8};
+  static constexpr std::size_t MAX_BLOCK_SIZE{1024};
+
   PixelMerger() = delete;
   PixelMerger(std::vector<PixelIt> head, std::vector<PixelIt> tail);
 
@@ -54,14 +98,14 @@ class PixelMerger {
   [[nodiscard]] auto read_all() const -> std::vector<PixelT>;
 
   class iterator {
-    PixelT _value{};
+    using BufferT = std::vector<ThinPixel<N>>;
 
-    using PQueueT = std::priority_queue<Node, std::vector<Node>, std::greater<>>;
-    std::shared_ptr<PQueueT> _pqueue{};
+    std::shared_ptr<LoserTree> _tree{};
+    std::shared_ptr<BufferT> _buff{};
+    std::size_t _j{};  // position within the current block of pixels
+    std::size_t _i{};  // number of pixels produced so far
 
-    std::shared_ptr<std::vector<PixelIt>> _heads{};
-    std::shared_ptr<std::vector<PixelIt>> _tails{};
-    std::size_t _i{};
+    static constexpr std::size_t OUTPUT_BLOCK_SIZE{4096};
 
    public:
     using difference_type = std::ptrdiff_t;
@@ -75,11 +119,11 @@ class PixelMerger {
     iterator() = default;
     explicit iterator(const std::vector<PixelIt> &heads, const std::vector<PixelIt> &tails);
     iterator(const iterator &other);
-    iterator(iterator &&other) noexcept;
+    iterator(iterator &&other) noexcept = default;
     ~iterator() noexcept = default;
 
     auto operator=(const iterator &other) -> iterator &;
-    auto operator=(iterator &&other) noexcept -> iterator &;
+    auto operator=(iterator &&other) noexcept -> iterator & = default;
 
     [[nodiscard]] bool operator==(const iterator &other) const noexcept;
     [[nodiscard]] bool operator!=(const iterator &other) const noexcept;
@@ -90,8 +134,7 @@ class PixelMerger {
     [[nodiscard]] auto operator++() -> iterator &;
 
    private:
-    [[nodiscard]] auto next() -> PixelT;
-    void replace_top_node();
+    void read_next_chunk();
   };
 };
 }  // namespace hictk::transformers
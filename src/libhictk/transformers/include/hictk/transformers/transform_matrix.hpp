@@ -0,0 +1,126 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "hictk/expected_values_table.hpp"
+#include "hictk/pixel.hpp"
+
+namespace hictk::transformers {
+
+enum class MatrixTransform : std::uint_fast8_t {
+  // interactions are returned as they are (useful to filter pixels by distance)
+  observed,
+  // observed / expected
+  oe,
+  // log2(observed / expected)
+  log2_oe,
+  // (observed - expected) / sqrt(expected), i.e. the Pearson residuals of a Poisson model where
+  // the expected value is used as the mean
+  pearson
+};
+
+// This class transforms a stream of pixels on the fly using the expected values from an
+// ExpectedValuesTable.
+// Pixels can optionally be filtered based on their distance from the diagonal (in bins). The
+// band of distances is defined by [min_distance, max_distance): when a band is specified, trans
+// pixels are always dropped.
+// Transformed values are NaN when the corresponding expected value is NaN or not positive.
+// Expected values are only looked up when the pixels move to a new chromosome pair, so the
+// overhead of the transformation is a handful of arithmetic operations per pixel.
+// Note that expected values should be computed using the same normalization used to fetch the
+// pixels being transformed.
+template <typename PixelIt>
+class TransformMatrix {
+  PixelIt _first{};
+  PixelIt _last{};
+  std::shared_ptr<const ExpectedValuesTable> _expected{};
+  MatrixTransform _transform{MatrixTransform::oe};
+  std::uint64_t _min_distance{};
+  std::uint64_t _max_distance{};
+
+ public:
+  class iterator;
+
+  static constexpr auto UNBOUNDED_DISTANCE = std::numeric_limits<std::uint64_t>::max();
+
+  TransformMatrix(PixelIt first_pixel, PixelIt last_pixel,
+                  std::shared_ptr<const ExpectedValuesTable> expected,
+                  MatrixTransform transform = MatrixTransform::oe, std::uint64_t min_distance = 0,
+                  std::uint64_t max_distance = UNBOUNDED_DISTANCE);
+
+  auto begin() const -> iterator;
+  auto end() const -> iterator;
+
+  auto cbegin() const -> iterator;
+  auto cend() const -> iterator;
+
+  [[nodiscard]] const ExpectedValuesTable &expected_values() const noexcept;
+  [[nodiscard]] constexpr MatrixTransform transform() const noexcept;
+
+  [[nodiscard]] auto read_all() const -> std::vector<ThinPixel<double>>;
+
+  class iterator {
+    PixelIt _it{};
+    PixelIt _last{};
+    std::shared_ptr<const ExpectedValuesTable> _expected{};
+    MatrixTransform _transform{MatrixTransform::oe};
+    std::uint64_t _min_distance{};
+    std::uint64_t _max_distance{};
+
+    // Bin offsets and expected values for the current chromosome pair
+    const std::vector<std::uint64_t> *_offsets{};
+    const std::vector<double> *_cis_expected{};
+    double _trans_expected{};
+    std::uint32_t _chrom1_id{};
+    std::uint32_t _chrom2_id{};
+    bool _init{false};
+
+    ThinPixel<double> _value{};
+
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = ThinPixel<double>;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using iterator_category = std::forward_iterator_tag;
+
+    iterator() = default;
+    iterator(PixelIt first, PixelIt last, std::shared_ptr<const ExpectedValuesTable> expected,
+             MatrixTransform transform, std::uint64_t min_distance, std::uint64_t max_distance);
+    static auto at_end(PixelIt last) -> iterator;
+
+    [[nodiscard]] bool operator==(const iterator &other) const noexcept;
+    [[nodiscard]] bool operator!=(const iterator &other) const noexcept;
+
+    [[nodiscard]] auto operator*() const noexcept -> const_reference;
+    [[nodiscard]] auto operator->() const noexcept -> const_pointer;
+
+    auto operator++() -> iterator &;
+    auto operator++(int) -> iterator;
+
+   private:
+    [[nodiscard]] bool has_distance_band() const noexcept;
+    void update_expected_values(std::uint32_t chrom1_id, std::uint32_t chrom2_id);
+    [[nodiscard]] double cis_expected_value(std::uint64_t distance) const noexcept;
+    [[nodiscard]] double transform(double observed, double expected) const noexcept;
+    // Move to the first pixel (starting from the current one) that passes the distance filter and
+    // compute its transformed value
+    void seek_next_pixel();
+  };
+};
+
+}  // namespace hictk::transformers
+
+#include "./impl/transform_matrix_impl.hpp"  // NOLINT
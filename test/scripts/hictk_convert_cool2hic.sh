@@ -60,6 +60,36 @@ for resolution in "${resolutions[@]}"; do
   fi
 done
 
+# the memory budget is only large enough to buffer a fraction of the interactions
+"$hictk_bin" convert \
+             "$ref_cool" \
+             "$outdir/out.max_memory.hic" \
+             --resolutions ${resolutions[*]} \
+             --threads 2 \
+             --max-memory 128MiB \
+             --compression-lvl 1
+
+for resolution in "${resolutions[@]}"; do
+  if ! compare_matrix_files.sh "$hictk_bin_opt" "$outdir/out.max_memory.hic" "$ref_cool" "$resolution"; then
+    status=1
+  fi
+done
+
+# budgets that cannot accommodate the buffers used by the .hic writer should be rejected
+if "$hictk_bin" convert \
+                "$ref_cool" \
+                "$outdir/out.too_small.hic" \
+                --resolutions ${resolutions[*]} \
+                --threads 2 \
+                --max-memory 64MiB \
+                --compression-lvl 1 2> "$outdir/too_small.log"; then
+  2>&1 echo "hictk convert did not fail when --max-memory is too small"
+  status=1
+elif ! grep -q 'max-memory is too small' "$outdir/too_small.log"; then
+  2>&1 cat "$outdir/too_small.log"
+  status=1
+fi
+
 "$hictk_bin" dump -t normalizations "$ref_cool" | sed 's/weight/ICE/' | sort > "$outdir/normalizations.mcool"
 "$hictk_bin" dump -t normalizations "$outdir/out.hic" | sort > "$outdir/normalizations.hic"
 
@@ -0,0 +1,100 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+#
+# SPDX-License-Identifier: MIT
+
+set -e
+set -o pipefail
+set -u
+
+echo "#############################"
+echo "#### hictk dump (binary) ####"
+
+# readlink -f is not available on macos...
+function readlink_py {
+  set -eu
+  python3 -c 'import os, sys; print(os.path.realpath(sys.argv[1]))' "$1"
+}
+
+function compare_binary_and_tsv {
+  set -eu
+  python3 - "$@" <<'PYEOF'
+import ast
+import struct
+import sys
+
+path_to_binary, path_to_tsv, fmt = sys.argv[1:]
+
+with open(path_to_binary, "rb") as f:
+    data = f.read()
+
+if fmt == "npy":
+    assert data[:8] == b"\x93NUMPY\x01\x00", "invalid magic string"
+    header_len = struct.unpack("<H", data[8:10])[0]
+    header = ast.literal_eval(data[10 : 10 + header_len].decode("latin1"))
+    data = data[10 + header_len :]
+    assert header["shape"] == (len(data) // 24,), "header shape does not match the number of records"
+
+found = [struct.unpack_from("<QQd", data, i) for i in range(0, len(data), 24)]
+with open(path_to_tsv) as f:
+    expected = [tuple(t(x) for t, x in zip((int, int, float), l.split("\t"))) for l in f]
+
+if found != expected:
+    print(f"FAIL! {path_to_binary} and {path_to_tsv} differ", file=sys.stderr)
+    sys.exit(1)
+print(f"{path_to_binary} and {path_to_tsv} are identical")
+PYEOF
+}
+
+status=0
+
+if [ $# -ne 1 ]; then
+  2>&1 echo "Usage: $0 path_to_hictk"
+  status=1
+fi
+
+hictk_bin="$1"
+
+data_dir="$(readlink_py "$(dirname "$0")/../data/")"
+script_dir="$(readlink_py "$(dirname "$0")")"
+
+ref_cooler="$data_dir/integration_tests/4DNFIZ1ZVXC8.mcool"
+ref_hic="$data_dir/hic/4DNFIZ1ZVXC8.hic9"
+
+export PATH="$PATH:$script_dir"
+
+if [ $status -ne 0 ]; then
+  exit $status
+fi
+
+if ! check_test_files_exist.sh "$ref_cooler" "$ref_hic"; then
+  exit 1
+fi
+
+outdir="$(mktemp -d -t hictk-tmp-XXXXXXXXXX)"
+trap 'rm -rf -- "$outdir"' EXIT
+
+for uri in "$ref_cooler" "$ref_hic"; do
+  for range in all chr2L chr2R:5,000,000-10,000,000; do
+    "$hictk_bin" dump --resolution 100000 "$uri" -r "$range" > "$outdir/expected.tsv"
+
+    "$hictk_bin" dump --resolution 100000 "$uri" -r "$range" --output-format binary > "$outdir/out.bin"
+    "$hictk_bin" dump --resolution 100000 "$uri" -r "$range" --output-format npy -o "$outdir/out.npy" --force
+
+    if ! compare_binary_and_tsv "$outdir/out.bin" "$outdir/expected.tsv" binary; then
+      status=1
+    fi
+    if ! compare_binary_and_tsv "$outdir/out.npy" "$outdir/expected.tsv" npy; then
+      status=1
+    fi
+  done
+done
+
+if [ "$status" -eq 0 ]; then
+  printf '\n### PASS ###\n'
+else
+  printf '\n### FAIL ###\n'
+fi
+
+exit "$status"
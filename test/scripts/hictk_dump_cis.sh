@@ -94,6 +94,13 @@ if ! compare_plain_files.sh "$outdir/expected.pixels" "$outdir/out.hic9.pixels";
   status=1
 fi
 
+# Test --cis-only matrix (--threads should be ignored)
+"$hictk_bin" dump --join --resolution 100000 "$ref_hic9" --cis-only --threads 2 | tee "$outdir/out.hic9.pixels" > /dev/null
+
+if ! compare_plain_files.sh "$outdir/expected.pixels" "$outdir/out.hic9.pixels"; then
+  status=1
+fi
+
 if [ "$status" -eq 0 ]; then
   printf '\n### PASS ###\n'
 else
@@ -0,0 +1,93 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Roberto Rossini <roberros@uio.no>
+#
+# SPDX-License-Identifier: MIT
+
+set -e
+set -o pipefail
+set -u
+
+echo "##############################"
+echo "#### hictk dump (threads) ####"
+
+# readlink -f is not available on macos...
+function readlink_py {
+  set -eu
+  python3 -c 'import os, sys; print(os.path.realpath(sys.argv[1]))' "$1"
+}
+
+export function readlink_py
+
+status=0
+
+if [ $# -ne 1 ]; then
+  2>&1 echo "Usage: $0 path_to_hictk"
+  status=1
+fi
+
+hictk_bin="$1"
+
+data_dir="$(readlink_py "$(dirname "$0")/../data/")"
+script_dir="$(readlink_py "$(dirname "$0")")"
+
+ref_cooler="$data_dir/integration_tests/4DNFIZ1ZVXC8.mcool::/resolutions/100000"
+ref_hic8="$data_dir/hic/4DNFIZ1ZVXC8.hic8"
+ref_hic9="$data_dir/hic/4DNFIZ1ZVXC8.hic9"
+
+export PATH="$PATH:$script_dir"
+
+if [ $status -ne 0 ]; then
+  exit $status
+fi
+
+if ! check_test_files_exist.sh "${ref_cooler%%::*}" "$ref_hic8" "$ref_hic9"; then
+  exit 1
+fi
+
+outdir="$(mktemp -d -t hictk-tmp-XXXXXXXXXX)"
+trap 'rm -rf -- "$outdir"' EXIT
+
+# Output produced with --threads > 1 must be byte-identical to single-threaded output
+function compare_dump {
+  set -o pipefail
+  set -eu
+
+  local name="$1"
+  shift
+
+  "$hictk_bin" dump --threads 1 "$@" > "$outdir/$name.st.pixels"
+  for threads in 2 4 8; do
+    "$hictk_bin" dump --threads "$threads" "$@" > "$outdir/$name.mt.pixels"
+    if ! cmp "$outdir/$name.st.pixels" "$outdir/$name.mt.pixels"; then
+      2>&1 echo "FAIL: $name (--threads $threads)"
+      return 1
+    fi
+  done
+  2>&1 echo "OK: $name"
+}
+
+for f in "$ref_cooler" "$ref_hic8" "$ref_hic9"; do
+  args=("$f")
+  if [[ "$f" != *.mcool* ]]; then
+    args+=(--resolution 100000)
+  fi
+  name="$(basename "${f%%::*}")"
+
+  compare_dump "$name.gw" "${args[@]}" || status=1
+  compare_dump "$name.gw.join" --join "${args[@]}" || status=1
+  compare_dump "$name.gw.unsorted" --unsorted "${args[@]}" || status=1
+  compare_dump "$name.cis" --cis-only --join "${args[@]}" || status=1
+  compare_dump "$name.trans" --trans-only --join "${args[@]}" || status=1
+  compare_dump "$name.range" --join --range chr2L --range2 chrX "${args[@]}" || status=1
+done
+
+compare_dump "cooler.balanced" --join --balance weight "$ref_cooler" || status=1
+
+if [ "$status" -eq 0 ]; then
+  printf '\n### PASS ###\n'
+else
+  printf '\n### FAIL ###\n'
+fi
+
+exit "$status"
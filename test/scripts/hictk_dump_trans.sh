@@ -93,6 +93,21 @@ if ! compare_plain_files.sh "$outdir/expected.pixels" "$outdir/out.hic9.pixels";
   status=1
 fi
 
+# Test --trans-only matrix (sorted, without --join)
+paste <(cooler dump "$ref_cooler::/resolutions/100000") <(cooler dump --join "$ref_cooler::/resolutions/100000") |
+  awk -F '\t' -v OFS='\t' '$4!=$7 {print $1,$2,$3}' |
+  tee "$outdir/expected.bin_ids.pixels" > /dev/null
+"$hictk_bin" dump "$ref_cooler::/resolutions/100000" --trans-only | tee "$outdir/out.cooler.pixels" > /dev/null
+"$hictk_bin" dump --resolution 100000 "$ref_hic9" --trans-only | tee "$outdir/out.hic9.pixels" > /dev/null
+
+if ! compare_plain_files.sh "$outdir/expected.bin_ids.pixels" "$outdir/out.cooler.pixels"; then
+  status=1
+fi
+
+if ! compare_plain_files.sh "$outdir/expected.bin_ids.pixels" "$outdir/out.hic9.pixels"; then
+  status=1
+fi
+
 # Test --trans-only matrix (unsorted)
 "$hictk_bin" dump --join "$ref_cooler::/resolutions/100000" --trans-only --unsorted | sort -V | tee "$outdir/out.cooler.pixels" > /dev/null
 "$hictk_bin" dump --join --resolution 100000 "$ref_hic8" --trans-only --unsorted | sort -V | tee "$outdir/out.hic8.pixels" > /dev/null
@@ -110,6 +125,13 @@ if ! compare_plain_files.sh "$outdir/expected.pixels" "$outdir/out.hic9.pixels";
   status=1
 fi
 
+# Test --trans-only matrix (unsorted, --threads should be ignored)
+"$hictk_bin" dump --join --resolution 100000 "$ref_hic9" --trans-only --unsorted --threads 2 | sort -V | tee "$outdir/out.hic9.pixels" > /dev/null
+
+if ! compare_plain_files.sh "$outdir/expected.pixels" "$outdir/out.hic9.pixels"; then
+  status=1
+fi
+
 if [ "$status" -eq 0 ]; then
   printf '\n### PASS ###\n'
 else
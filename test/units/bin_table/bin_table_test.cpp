@@ -14,11 +14,14 @@
 #include <iterator>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "hictk/chromosome.hpp"
 #include "hictk/common.hpp"
 #include "hictk/genomic_interval.hpp"
+#include "hictk/type_traits.hpp"
 
 namespace hictk::test::bin_table {
 
@@ -68,6 +71,11 @@ TEST_CASE("BinTable (fixed bins)", "[bin-table][short]") {
     CHECK_THROWS_AS(table.map_to_bin_id("chr1", 99999), std::out_of_range);
     CHECK_THROWS_AS(table.map_to_bin_id(chr2, 99999), std::out_of_range);
     CHECK_THROWS_AS(table.map_to_bin_id(1, 99999), std::out_of_range);
+
+    const std::array<std::uint32_t, 4> pos{0, 7500, 9999, 10000};
+    std::array<std::uint64_t, 4> bin_ids{};
+    table.map_to_bin_ids(chr2, pos.begin(), pos.end(), bin_ids.begin());
+    CHECK(bin_ids == std::array<std::uint64_t, 4>{11, 12, 12, 13});
   }
 
   SECTION("subset") {
@@ -109,6 +117,18 @@ TEST_CASE("BinTable (fixed bins)", "[bin-table][short]") {
     CHECK_THROWS(table.get<BinTableVariable<>>());
   }
 
+  SECTION("visit") {
+    const auto fixed = table.visit([](const auto& t) {
+      return std::is_same_v<remove_cvref_t<decltype(t)>, BinTableFixed>;
+    });
+    CHECK(fixed);
+    table.visit([&](const auto& t) {
+      CHECK(t.size() == table.size());
+      CHECK(t.at(11) == table.at(11));
+      CHECK(t.map_to_bin_id("chr1", 50000) == table.map_to_bin_id("chr1", 50000));
+    });
+  }
+
   SECTION("operator==") {
     CHECK(BinTable(table.chromosomes(), 10) == BinTable(table.chromosomes(), 10));
     CHECK(BinTable(table.chromosomes(), 10) != BinTable(table.chromosomes(), 20));
@@ -257,6 +277,29 @@ TEST_CASE("BinTable (variable bins)", "[bin-table][short]") {
     CHECK_THROWS_AS(table.map_to_bin_id("chr1", 33), std::out_of_range);
     CHECK_THROWS_AS(table.map_to_bin_id(chr2, 50), std::out_of_range);
     CHECK_THROWS_AS(table.map_to_bin_id(1, 50), std::out_of_range);
+
+    SECTION("all positions") {
+      for (const auto& chrom : table.chromosomes()) {
+        for (std::uint32_t pos = 0; pos < chrom.size(); ++pos) {
+          const auto bin = table.at(table.map_to_bin_id(chrom, pos));
+          CHECK(bin.chrom() == chrom);
+          CHECK(bin.start() <= pos);
+          CHECK(bin.end() > pos);
+        }
+      }
+    }
+
+    SECTION("sorted positions") {
+      const std::vector<std::uint32_t> pos{0, 0, 4, 5, 9, 10, 25, 26, 31};
+      std::vector<std::uint64_t> bin_ids{};
+      table.map_to_bin_ids(chr2, pos.begin(), pos.end(), std::back_inserter(bin_ids));
+      CHECK(bin_ids == std::vector<std::uint64_t>{4, 4, 4, 5, 5, 6, 6, 7, 7});
+
+      const std::vector<std::uint32_t> invalid_pos{0, 32};
+      CHECK_THROWS_AS(table.map_to_bin_ids(chr2, invalid_pos.begin(), invalid_pos.end(),
+                                           bin_ids.begin()),
+                      std::out_of_range);
+    }
   }
 
   SECTION("subset") {
@@ -299,6 +342,17 @@ TEST_CASE("BinTable (variable bins)", "[bin-table][short]") {
     CHECK_THROWS(table.get<BinTableFixed>());
   }
 
+  SECTION("visit") {
+    const auto fixed = table.visit([](const auto& t) {
+      return std::is_same_v<remove_cvref_t<decltype(t)>, BinTableFixed>;
+    });
+    CHECK_FALSE(fixed);
+    table.visit([&](const auto& t) {
+      CHECK(t.size() == table.size());
+      CHECK(t.at(5) == table.at(5));
+    });
+  }
+
   SECTION("invalid bins") {
     SECTION("bins out of order") {
       const std::vector<std::uint32_t> start_pos1{0, 8, 7};
@@ -440,4 +494,22 @@ TEST_CASE("BinTable (variable bins)", "[bin-table][short]") {
   }
 }
 
+TEST_CASE("BinTable: find_chrom_id", "[bin-table][short]") {
+  // the second chromosome has no bins
+  const std::vector<std::uint64_t> offsets{0, 10, 10, 25};
+
+  CHECK(internal::find_chrom_id(offsets, 0, 0) == 0);
+  CHECK(internal::find_chrom_id(offsets, 9, 0) == 0);
+  CHECK(internal::find_chrom_id(offsets, 10, 0) == 2);
+  CHECK(internal::find_chrom_id(offsets, 24, 2) == 2);
+
+  // wrong hints
+  CHECK(internal::find_chrom_id(offsets, 5, 2) == 0);
+  CHECK(internal::find_chrom_id(offsets, 15, 1) == 2);
+  CHECK(internal::find_chrom_id(offsets, 15, 100) == 2);
+
+  CHECK_THROWS_AS(internal::find_chrom_id(offsets, 25, 0), std::out_of_range);
+  CHECK_THROWS_AS(internal::find_chrom_id(offsets, 25, 2), std::out_of_range);
+}
+
 }  // namespace hictk::test::bin_table
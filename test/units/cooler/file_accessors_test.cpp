@@ -5,6 +5,7 @@
 #include <fmt/format.h>
 #include <fmt/ranges.h>  // IWYU pragma: keep
 
+#include <algorithm>
 #include <array>
 #include <catch2/catch_test_macros.hpp>
 #include <cstdint>
@@ -13,6 +14,7 @@
 
 #include "hictk/common.hpp"
 #include "hictk/cooler/cooler.hpp"
+#include "hictk/cooler/index_cache.hpp"
 #include "hictk/version.hpp"
 #include "tmpdir.hpp"
 
@@ -64,4 +66,44 @@ TEST_CASE("Cooler: accessors", "[cooler][short]") {
   }
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Cooler: shared index", "[cooler][short]") {
+  const auto path = datadir / "cooler_test_file.cool";
+
+  SECTION("same file") {
+    const File f1(path.string());
+    const File f2(path.string());
+    CHECK(&f1.index() == &f2.index());
+    CHECK(f1.bins_ptr() == f2.bins_ptr());
+    CHECK(internal::IndexCache::instance().size() != 0);
+
+    // offsets imported by one file are visible from the other file
+    const auto& chrom = f1.chromosomes().at(0);
+    const auto sel1 = f1.fetch(chrom.name());
+    CHECK(f2.index().size(chrom.id()) == f1.index().size(chrom.id()));
+    const auto sel2 = f2.fetch(chrom.name());
+    CHECK(std::equal(sel1.begin<std::int32_t>(), sel1.end<std::int32_t>(),
+                     sel2.begin<std::int32_t>(), sel2.end<std::int32_t>()));
+  }
+
+  SECTION("different files") {
+    const auto path2 = testdir() / "cooler_shared_index_test.cool";
+    std::filesystem::copy_file(path, path2, std::filesystem::copy_options::overwrite_existing);
+    const File f1(path.string());
+    const File f2(path2.string());
+    CHECK(&f1.index() != &f2.index());
+  }
+
+  SECTION("indexes are released") {
+    const auto path2 = testdir() / "cooler_shared_index_test2.cool";
+    std::filesystem::copy_file(path, path2, std::filesystem::copy_options::overwrite_existing);
+    const auto num_indexes = internal::IndexCache::instance().size();
+    {
+      const File f(path2.string());
+      CHECK(internal::IndexCache::instance().size() == num_indexes + 1);
+    }
+    CHECK(internal::IndexCache::instance().size() == num_indexes);
+  }
+}
+
 }  // namespace hictk::cooler::test::cooler_file
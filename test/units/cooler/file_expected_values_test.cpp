@@ -0,0 +1,84 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cstddef>
+#include <filesystem>
+
+#include "hictk/balancing/methods.hpp"
+#include "hictk/cooler/cooler.hpp"
+#include "hictk/expected_values_table.hpp"
+#include "tmpdir.hpp"
+
+namespace hictk::cooler::test::cooler_file {
+
+static void compare_expected_values(const ExpectedValuesTable& expected,
+                                    const ExpectedValuesTable& found) {
+  for (const auto& chrom : expected.bins().chromosomes()) {
+    const auto& v1 = expected.cis(chrom);
+    const auto& v2 = found.cis(chrom);
+    REQUIRE(v1.size() == v2.size());
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+      CHECK_THAT(v2[i], Catch::Matchers::WithinRel(v1[i]));
+    }
+  }
+
+  REQUIRE(expected.trans().size() == found.trans().size());
+  for (const auto& [key, value] : expected.trans()) {
+    CHECK_THAT(found.trans().at(key), Catch::Matchers::WithinRel(value));
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Cooler: expected values", "[cooler][short]") {
+  const auto path1 = datadir / "ENCFF993FGR.2500000.cool";
+  const auto path2 = testdir() / "cooler_test_expected_values.cool";
+
+  std::filesystem::remove(path2);
+  std::filesystem::copy(path1, path2);
+
+  const File clr(path1.string());
+  REQUIRE_FALSE(clr.has_expected_values(balancing::Method::NONE()));
+
+  SECTION("multi-threaded") {
+    for (const auto& norm : {balancing::Method::NONE(), balancing::Method::SCALE()}) {
+      const File clr1(path1.string());
+      const File clr2(path1.string());
+      compare_expected_values(*clr1.expected_values(norm), *clr2.expected_values(norm, 4));
+    }
+  }
+
+  SECTION("cached") {
+    CHECK(clr.expected_values() == clr.expected_values());
+    CHECK(clr.expected_values() != clr.expected_values(balancing::Method::SCALE()));
+  }
+
+  SECTION("write") {
+    for (const auto& norm : {balancing::Method::NONE(), balancing::Method::SCALE()}) {
+      File::write_expected_values(path2.string(), norm, 2);
+      const File clr2(path2.string());
+      CHECK(clr2.has_expected_values(norm));
+      compare_expected_values(*clr.expected_values(norm), *clr2.expected_values(norm));
+    }
+  }
+
+  SECTION("overwriting") {
+    File::write_expected_values(path2.string(), balancing::Method::NONE());
+    CHECK_THROWS(File::write_expected_values(path2.string(), balancing::Method::NONE()));
+    CHECK_NOTHROW(
+        File::write_expected_values(path2.string(), balancing::Method::NONE(), 1, true));
+  }
+
+  SECTION("attempt write on read-only file") {
+    CHECK_THROWS(File(path2.string())
+                     .write_expected_values(balancing::Method::NONE(), *clr.expected_values()));
+  }
+
+  SECTION("missing normalization") {
+    CHECK_THROWS(clr.expected_values(balancing::Method{"FOOBAR"}));
+  }
+}
+
+}  // namespace hictk::cooler::test::cooler_file
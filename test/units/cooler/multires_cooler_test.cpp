@@ -8,6 +8,7 @@
 
 #include <array>
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <tuple>
 #include <vector>
@@ -114,4 +115,57 @@ TEST_CASE("MultiResCooler: create resolutions", "[cooler][short]") {
   }
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("MultiResCooler: create resolutions (single pass)", "[cooler][short]") {
+  const auto base_path = datadir / "cooler_test_file.cool";
+  const File base_clr(base_path.string());
+  const auto base_resolution = base_clr.resolution();
+
+  const auto path1 = testdir() / "test_create_resolutions_single_pass1.mcool";
+  const auto path2 = testdir() / "test_create_resolutions_single_pass2.mcool";
+  const std::array<std::uint32_t, 4> resolutions{
+      // clang-format off
+      base_resolution * 2,
+      base_resolution * 4,
+      base_resolution * 6,
+      base_resolution * 8
+      // clang-format on
+  };
+
+  SECTION("valid resolutions") {
+    {
+      auto mclr1 = MultiResFile::create(path1.string(), base_clr.chromosomes(), true);
+      mclr1.copy_resolution(base_clr);
+      for (const auto res : resolutions) {
+        std::ignore = mclr1.create_resolution(res);
+      }
+
+      auto mclr2 = MultiResFile::create(path2.string(), base_clr.chromosomes(), true);
+      mclr2.copy_resolution(base_clr);
+      // use a tiny buffer to make sure pixels are flushed and rows are compacted multiple times
+      mclr2.create_resolutions(base_clr, resolutions.begin(), resolutions.end(), 1'000);
+      CHECK(mclr2.resolutions().size() == resolutions.size() + 1);
+    }
+
+    const MultiResFile mclr1(path1.string());
+    const MultiResFile mclr2(path2.string());
+    for (const auto res : resolutions) {
+      const auto pixels1 = mclr1.open(res).fetch().read_all<std::int32_t>();
+      const auto pixels2 = mclr2.open(res).fetch().read_all<std::int32_t>();
+      REQUIRE(pixels1.size() == pixels2.size());
+      for (std::size_t i = 0; i < pixels1.size(); ++i) {
+        CHECK(pixels1[i] == pixels2[i]);
+      }
+    }
+  }
+
+  SECTION("invalid resolutions") {
+    auto mclr = MultiResFile::create(path1.string(), base_clr.chromosomes(), true);
+    std::vector<std::uint32_t> resolutions_{base_resolution / 2};
+    CHECK_THROWS(mclr.create_resolutions(base_clr, resolutions_.begin(), resolutions_.end()));
+    resolutions_ = {base_resolution + 1};
+    CHECK_THROWS(mclr.create_resolutions(base_clr, resolutions_.begin(), resolutions_.end()));
+  }
+}
+
 }  // namespace hictk::cooler::test::multires_cooler_file
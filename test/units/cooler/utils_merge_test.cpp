@@ -55,6 +55,28 @@ TEST_CASE("Cooler: utils merge", "[merge][utils][long]") {
     }
   }
 
+  SECTION("merge int (multi-threaded)") {
+    const auto src = datadir / "cooler_test_file.cool";
+    const auto dest1 = testdir() / "cooler_merge_test_int_st.cool";
+    const auto dest2 = testdir() / "cooler_merge_test_int_mt.cool";
+
+    const std::array<std::string, 3> sources{src.string(), src.string(), src.string()};
+    cooler::utils::merge<std::int32_t>(sources.begin(), sources.end(), dest1.string(), true, 1'000);
+    cooler::utils::merge<std::int32_t>(sources.begin(), sources.end(), dest2.string(), true, 1'000,
+                                       10'000'000, DEFAULT_COMPRESSION_LEVEL, 4);
+
+    const auto clr1 = File::open_read_once(dest1.string());
+    const auto clr2 = File::open_read_once(dest2.string());
+
+    const auto pixels1 = clr1.fetch().read_all<std::int32_t>();
+    const auto pixels2 = clr2.fetch().read_all<std::int32_t>();
+
+    REQUIRE(pixels1.size() == pixels2.size());
+    for (std::size_t i = 0; i < pixels1.size(); ++i) {
+      CHECK(pixels1[i] == pixels2[i]);
+    }
+  }
+
   SECTION("merge float") {
     const auto src = datadir / "cooler_test_file_float.cool";
     const auto dest = testdir() / "cooler_merge_test_float.cool";
@@ -9,11 +9,18 @@
 #include <algorithm>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <limits>
+#include <memory>
+#include <nonstd/span.hpp>
 #include <string>
+#include <vector>
 
+#include "hictk/expected_values_table.hpp"
 #include "hictk/hic.hpp"
 
 using namespace hictk;
@@ -58,4 +65,182 @@ TEST_CASE("ExpectedValuesAggregator", "[file][short]") {
   }
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ExpectedValuesAggregator: batch add", "[file][short]") {
+  const Reference chroms{Chromosome{0, "chr1", 1'000}, Chromosome{1, "chr2", 505},
+                         Chromosome{2, "chr3", 250}};
+  const auto bins = std::make_shared<const BinTable>(chroms, 10);
+
+  std::vector<ThinPixel<double>> pixels{};
+  for (std::uint64_t bin1_id = 0; bin1_id < bins->size(); bin1_id += 3) {
+    for (std::uint64_t bin2_id = bin1_id; bin2_id < bins->size(); bin2_id += 7) {
+      const auto count = (bin1_id + bin2_id) % 5 == 0 ? std::numeric_limits<double>::quiet_NaN()
+                                                      : static_cast<double>(bin2_id - bin1_id + 1);
+      pixels.emplace_back(ThinPixel<double>{bin1_id, bin2_id, count});
+    }
+  }
+
+  ExpectedValuesAggregator expected(bins);
+  for (const auto& p : pixels) {
+    expected.add(Pixel<double>{*bins, p});
+  }
+  expected.compute_density();
+
+  auto compare = [&](const ExpectedValuesAggregator& found) {
+    REQUIRE(expected.weights().size() == found.weights().size());
+    for (std::size_t i = 0; i < expected.weights().size(); ++i) {
+      CHECK_THAT(found.weights()[i], Catch::Matchers::WithinRel(expected.weights()[i]));
+    }
+    REQUIRE(expected.scaling_factors().size() == found.scaling_factors().size());
+    for (const auto& [chrom, sf] : expected.scaling_factors()) {
+      CHECK_THAT(found.scaling_factor(chrom), Catch::Matchers::WithinRel(sf));
+    }
+  };
+
+  SECTION("thin pixels") {
+    ExpectedValuesAggregator aggr(bins);
+    for (const auto& p : pixels) {
+      aggr.add(p);
+    }
+    aggr.compute_density();
+    compare(aggr);
+  }
+
+  SECTION("span") {
+    ExpectedValuesAggregator aggr(bins);
+    aggr.add(nonstd::span<const ThinPixel<double>>(pixels));
+    aggr.compute_density();
+    compare(aggr);
+  }
+
+  SECTION("merge") {
+    const auto num_partitions = std::size_t{4};
+    const auto partition_size = (pixels.size() + num_partitions - 1) / num_partitions;
+    ExpectedValuesAggregator aggr(bins);
+    for (std::size_t i = 0; i < pixels.size(); i += partition_size) {
+      const auto size = std::min(partition_size, pixels.size() - i);
+      ExpectedValuesAggregator partial_aggr(bins);
+      partial_aggr.add(nonstd::span<const ThinPixel<double>>(pixels).subspan(i, size));
+      aggr.merge(partial_aggr);
+    }
+    aggr.compute_density();
+    compare(aggr);
+  }
+
+  SECTION("merge (incompatible)") {
+    ExpectedValuesAggregator aggr(bins);
+    const ExpectedValuesAggregator other(
+        std::make_shared<const BinTable>(bins->chromosomes(), bins->resolution() * 2));
+    CHECK_THROWS(aggr.merge(other));
+  }
+
+  SECTION("invalid bin") {
+    ExpectedValuesAggregator aggr(bins);
+    CHECK_THROWS(aggr.add(ThinPixel<double>{0, bins->size(), 1}));
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("ExpectedValuesTable", "[file][short]") {
+  const Reference chroms{Chromosome{0, "chr1", 1'000}, Chromosome{1, "chr2", 505},
+                         Chromosome{2, "chr3", 250}};
+  const auto bins = std::make_shared<const BinTable>(chroms, 10);
+
+  std::vector<ThinPixel<double>> pixels{};
+  for (std::uint64_t bin1_id = 0; bin1_id < bins->size(); bin1_id += 3) {
+    for (std::uint64_t bin2_id = bin1_id; bin2_id < bins->size(); bin2_id += 7) {
+      if (bin1_id >= 100 && bin1_id < 151) {
+        continue;  // chr2 has no interactions
+      }
+      pixels.emplace_back(ThinPixel<double>{bin1_id, bin2_id, double(bin1_id % 11 + 1)});
+    }
+  }
+
+  ExpectedValuesAggregator aggr(bins);
+  aggr.add(nonstd::span<const ThinPixel<double>>(pixels));
+  aggr.compute_density();
+
+  auto compare = [&](const ExpectedValuesTable& found) {
+    CHECK(found.cis(chroms.at("chr2")).empty());
+    for (const auto& [chrom, _] : aggr.scaling_factors()) {
+      const auto expected = aggr.weights(chrom);
+      const auto& weights = found.cis(chrom);
+      REQUIRE(expected.size() == weights.size());
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        CHECK_THAT(weights[i], Catch::Matchers::WithinRel(expected[i]));
+      }
+    }
+
+    REQUIRE(aggr.trans_weights().size() == found.trans().size());
+    for (const auto& [key, value] : aggr.trans_weights()) {
+      const auto& chrom1 = chroms.at(key.first);
+      const auto& chrom2 = chroms.at(key.second);
+      CHECK_THAT(found.trans(chrom1, chrom2), Catch::Matchers::WithinRel(value));
+      CHECK_THAT(found.trans(chrom2, chrom1), Catch::Matchers::WithinRel(value));
+    }
+  };
+
+  SECTION("aggregator") { compare(ExpectedValuesTable(aggr)); }
+
+  SECTION("single-threaded") {
+    compare(ExpectedValuesTable::compute(bins, pixels.begin(), pixels.end()));
+  }
+
+  SECTION("multi-threaded") {
+    for (const std::size_t batch_size : {1, 13, 1'000'000}) {
+      compare(ExpectedValuesTable::compute(bins, pixels.begin(), pixels.end(), 4, identity(),
+                                           batch_size));
+    }
+  }
+
+  SECTION("transform") {
+    const auto table =
+        ExpectedValuesTable::compute(bins, pixels.begin(), pixels.end(), 4, [](auto p) {
+          p.count *= 2;
+          return p;
+        });
+    REQUIRE(table.trans().size() == aggr.trans_weights().size());
+    for (const auto& [key, value] : aggr.trans_weights()) {
+      CHECK_THAT(table.trans().at(key), Catch::Matchers::WithinRel(2 * value));
+    }
+  }
+
+  SECTION("accessors") {
+    const auto table = ExpectedValuesTable::compute(bins, pixels.begin(), pixels.end());
+    const auto& chr1 = chroms.at("chr1");
+    const auto& chr2 = chroms.at("chr2");
+    const auto& chr3 = chroms.at("chr3");
+
+    const auto& weights = table.cis(chr1);
+    REQUIRE(!weights.empty());
+    CHECK(table.cis(chr1, 0) == weights.front());
+    CHECK(table.cis(chr1, 1'000'000) == weights.back());
+
+    CHECK(table.cis(chr2).empty());
+    CHECK(std::isnan(table.cis(chr2, 0)));
+    CHECK(table.trans(chr1, chr2) != 0);
+    CHECK(table.trans(chr3, chr2) == 0);
+
+    CHECK_THROWS(table.cis(Chromosome{99, "A", 10}));
+  }
+
+  SECTION("variable bin size") {
+    const std::vector<std::uint32_t> start_pos{0, 100, 0, 0};
+    const std::vector<std::uint32_t> end_pos{100, 1'000, 505, 250};
+    const auto variable_bins = std::make_shared<const BinTable>(chroms, start_pos, end_pos);
+    const std::vector<ThinPixel<double>> variable_pixels{{0, 1, 1.0}, {1, 1, 2.0}, {0, 2, 3.0}};
+
+    CHECK_THROWS_WITH(
+        ExpectedValuesTable::compute(variable_bins, variable_pixels.begin(),
+                                     variable_pixels.end()),
+        Catch::Matchers::ContainsSubstring("variable bin size is not supported"));
+    CHECK_THROWS_WITH(
+        ExpectedValuesTable::compute(variable_bins, variable_pixels.begin(),
+                                     variable_pixels.end(), 4),
+        Catch::Matchers::ContainsSubstring("variable bin size is not supported"));
+    CHECK_THROWS_WITH(ExpectedValuesAggregator{variable_bins},
+                      Catch::Matchers::ContainsSubstring("variable bin size is not supported"));
+  }
+}
+
 }  // namespace hictk::test::expected_values_aggregator
@@ -6,11 +6,17 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <iterator>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "hictk/cooler/cooler.hpp"
 #include "hictk/hic.hpp"
@@ -152,6 +158,139 @@ TEST_CASE("PixelSelector", "[file][short]") {
       CHECK(sel1.read_all<std::int32_t>().size() == 624);
     }
   }
+
+  SECTION("for_each_pixel") {
+    for (const auto& path : {path_hic, path_cooler}) {
+      const auto f = File(path, resolution);
+      const auto sel = f.fetch("chr2L", "chr2R");
+      const auto expected = sel.read_all<std::int32_t>();
+
+      std::vector<ThinPixel<std::int32_t>> pixels{};
+      sel.for_each_pixel<std::int32_t>(
+          [&](const ThinPixel<std::int32_t>& p) { pixels.push_back(p); });
+      REQUIRE(pixels.size() == expected.size());
+      for (std::size_t i = 0; i < pixels.size(); ++i) {
+        CHECK(pixels[i] == expected[i].to_thin());
+      }
+
+      std::size_t num_pixels{};
+      f.for_each_pixel<std::int32_t>([&](const auto&) { ++num_pixels; });
+      CHECK(num_pixels == f.fetch().read_all<std::int32_t>().size());
+    }
+  }
+
+  SECTION("visit_batches") {
+    for (const auto& path : {path_hic, path_cooler}) {
+      const auto f = File(path, resolution);
+      const auto sel = f.fetch("chr2L", "chr2R");
+      const auto expected = sel.read_all<std::int32_t>();
+
+      constexpr std::size_t batch_size = 100;
+      std::vector<ThinPixel<std::int32_t>> pixels{};
+      std::size_t num_batches{};
+      sel.visit_batches<std::int32_t>(
+          batch_size, [&](nonstd::span<const ThinPixel<std::int32_t>> batch) {
+            CHECK(!batch.empty());
+            CHECK(batch.size() <= batch_size);
+            pixels.insert(pixels.end(), batch.begin(), batch.end());
+            ++num_batches;
+          });
+      CHECK(num_batches == (expected.size() + batch_size - 1) / batch_size);
+      REQUIRE(pixels.size() == expected.size());
+      for (std::size_t i = 0; i < pixels.size(); ++i) {
+        CHECK(pixels[i] == expected[i].to_thin());
+      }
+
+      std::size_t num_pixels{};
+      f.visit_batches<std::int32_t>(
+          batch_size, [&](const auto& batch) { num_pixels += batch.size(); });
+      CHECK(num_pixels == f.fetch().read_all<std::int32_t>().size());
+
+      CHECK_THROWS(sel.visit_batches<std::int32_t>(0, [](const auto&) {}));
+    }
+  }
+}
+
+static std::vector<double> fetch_dense_matrix(const File& f, const balancing::Method& norm) {
+  const auto num_bins = f.nbins();
+  std::vector<double> matrix(num_bins * num_bins, 0);
+  const auto sel = f.fetch(norm);
+  std::for_each(sel.begin<double>(), sel.end<double>(), [&](const ThinPixel<double>& p) {
+    matrix[(p.bin1_id * num_bins) + p.bin2_id] = p.count;
+    matrix[(p.bin2_id * num_bins) + p.bin1_id] = p.count;
+  });
+  return matrix;
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+static void check_tiles(const File& f, const balancing::Method& norm) {
+  const auto num_bins = f.nbins();
+  const auto expected = fetch_dense_matrix(f, norm);
+
+  // clang-format off
+  const std::vector<std::tuple<std::uint64_t, std::uint64_t, std::size_t, std::size_t>> tiles{
+      {0, 0, 16, 16},                        // cis
+      {10, 50, 32, 8},                       // spans multiple chromosomes
+      {50, 10, 8, 32},                       // lower-triangle
+      {20, 15, 32, 32},                      // overlaps the diagonal
+      {num_bins - 5, num_bins - 10, 16, 16}  // extends past the end of the matrix
+  };
+  // clang-format on
+
+  for (const auto& [first_bin1, first_bin2, num_rows, num_cols] : tiles) {
+    std::vector<double> tile(num_rows * num_cols, -1);
+    f.fetch_tile(nonstd::span<double>(tile), first_bin1, first_bin2, num_rows, num_cols, norm);
+
+    for (std::size_t i = 0; i < num_rows; ++i) {
+      for (std::size_t j = 0; j < num_cols; ++j) {
+        const auto bin1 = first_bin1 + i;
+        const auto bin2 = first_bin2 + j;
+        const auto found = tile[(i * num_cols) + j];
+        if (bin1 >= num_bins || bin2 >= num_bins) {
+          CHECK(found == 0);
+          continue;
+        }
+
+        const auto expected_count = expected[(bin1 * num_bins) + bin2];
+        if (norm == balancing::Method::NONE()) {
+          CHECK(found == expected_count);
+        } else if (!std::isnan(expected_count) && expected_count != 0) {
+          // missing pixels overlapping bins with NaN weights are set to NaN
+          CHECK_THAT(found, Catch::Matchers::WithinRel(expected_count, 1.0e-6));
+        }
+      }
+    }
+  }
+
+  std::vector<double> small_buffer(10);
+  CHECK_THROWS(f.fetch_tile(nonstd::span<double>(small_buffer), 0, 0, 4, 4, norm));
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("File: fetch_tile", "[file][short]") {
+  const std::uint32_t resolution = 1'000'000;
+  const auto path_hic = (datadir / "hic" / "4DNFIZ1ZVXC8.hic8").string();
+  const auto path_cooler = (datadir / "integration_tests" / "4DNFIZ1ZVXC8.mcool").string();
+
+  SECTION("hic") {
+    const auto hf = File(path_hic, resolution);
+    check_tiles(hf, balancing::Method::NONE());
+    check_tiles(hf, balancing::Method::KR());
+  }
+
+  SECTION("cooler") {
+    const auto clr = File(path_cooler, resolution);
+    check_tiles(clr, balancing::Method::NONE());
+    check_tiles(clr, balancing::Method{"weight"});
+  }
+
+  SECTION("integer buffer") {
+    const auto clr = File(path_cooler, resolution);
+    std::vector<std::int32_t> tile(16 * 16);
+    const nonstd::span<std::int32_t> buffer(tile);
+    CHECK_NOTHROW(clr.fetch_tile(buffer, 0, 0, 16, 16));
+    CHECK_THROWS(clr.fetch_tile(buffer, 0, 0, 16, 16, balancing::Method{"weight"}));
+  }
 }
 
 }  // namespace hictk::test::file
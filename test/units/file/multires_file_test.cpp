@@ -4,10 +4,21 @@
 
 #include "hictk/multires_file.hpp"
 
+#include <algorithm>
+#include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <nonstd/span.hpp>
+#include <vector>
 
+#include "hictk/balancing/methods.hpp"
+#include "hictk/bin_table.hpp"
 #include "hictk/cooler/multires_cooler.hpp"
+#include "hictk/genomic_interval.hpp"
 #include "hictk/hic.hpp"
 
 using namespace hictk;
@@ -74,4 +85,217 @@ TEST_CASE("MultiResFile", "[file][short]") {
     }
   }
 }
+
+// Coarsen a dense genome-wide matrix by brute force
+[[nodiscard]] static std::vector<double> coarsen_matrix(const std::vector<double>& matrix,
+                                                        const BinTable& fine_bins,
+                                                        const BinTable& coarse_bins) {
+  const auto num_fine_bins = fine_bins.size();
+  const auto num_coarse_bins = coarse_bins.size();
+  std::vector<double> coarse_matrix(num_coarse_bins * num_coarse_bins, 0.0);
+
+  std::vector<std::uint64_t> mappings(num_fine_bins);
+  for (std::size_t i = 0; i < num_fine_bins; ++i) {
+    const auto bin = fine_bins.at(i);
+    mappings[i] = coarse_bins.at(bin.chrom(), bin.start()).id();
+  }
+
+  for (std::size_t i = 0; i < num_fine_bins; ++i) {
+    for (std::size_t j = i; j < num_fine_bins; ++j) {
+      const auto count = matrix[(i * num_fine_bins) + j];
+      const auto i1 = mappings[i];
+      const auto j1 = mappings[j];
+      coarse_matrix[(i1 * num_coarse_bins) + j1] += count;
+      if (i1 != j1) {
+        coarse_matrix[(j1 * num_coarse_bins) + i1] += count;
+      }
+    }
+  }
+  return coarse_matrix;
+}
+
+TEST_CASE("MultiResFile: fetch_tile", "[file][medium]") {
+  const auto path_hic = (datadir / "hic" / "4DNFIZ1ZVXC8.hic8").string();
+  const auto path_mcool = (datadir / "integration_tests" / "4DNFIZ1ZVXC8.mcool").string();
+  const std::uint32_t base_resolution = 1'000'000;
+
+  for (const auto& path : {path_hic, path_mcool}) {
+    const MultiResFile mrf(path);
+
+    SECTION("compute_base_resolution") {
+      CHECK(mrf.compute_base_resolution(base_resolution) == base_resolution);
+      CHECK(mrf.compute_base_resolution(3'000'000) == base_resolution);
+      CHECK(mrf.compute_base_resolution(5'000'000) == 2'500'000);
+      CHECK_THROWS(mrf.compute_base_resolution(1'234));
+    }
+
+    SECTION("stored resolution") {
+      const auto f = mrf.open(base_resolution);
+      const auto num_bins = f.bins().size();
+      std::vector<std::int32_t> expected(num_bins * num_bins);
+      std::vector<std::int32_t> found(num_bins * num_bins);
+      f.fetch_tile(nonstd::span<std::int32_t>(expected), 0, 0, num_bins, num_bins);
+      mrf.fetch_tile(base_resolution, nonstd::span<std::int32_t>(found), 0, 0, num_bins, num_bins);
+      CHECK(found == expected);
+    }
+
+    SECTION("coarsened resolution") {
+      const auto f = mrf.open(base_resolution);
+      const auto num_bins = f.bins().size();
+      std::vector<double> matrix(num_bins * num_bins);
+      f.fetch_tile(nonstd::span<double>(matrix), 0, 0, num_bins, num_bins);
+
+      for (const std::uint32_t resolution : {2'000'000U, 3'000'000U}) {
+        const BinTable bins(mrf.chromosomes(), resolution);
+        const auto expected = coarsen_matrix(matrix, f.bins(), bins);
+        const auto num_coarse_bins = bins.size();
+
+        // genome-wide tile
+        std::vector<double> found(num_coarse_bins * num_coarse_bins);
+        mrf.fetch_tile(resolution, nonstd::span<double>(found), 0, 0, num_coarse_bins,
+                       num_coarse_bins);
+        REQUIRE(found.size() == expected.size());
+        for (std::size_t i = 0; i < found.size(); ++i) {
+          CHECK(found[i] == Catch::Approx(expected[i]));
+        }
+
+        // tile overlapping the lower-triangle and the end of the matrix
+        const std::size_t first_bin1 = num_coarse_bins / 2;
+        const std::size_t first_bin2 = 3;
+        const std::size_t num_rows = num_coarse_bins;
+        const std::size_t num_cols = 10;
+        std::vector<double> tile(num_rows * num_cols);
+        mrf.fetch_tile(resolution, nonstd::span<double>(tile), first_bin1, first_bin2, num_rows,
+                       num_cols);
+        for (std::size_t i = 0; i < num_rows; ++i) {
+          for (std::size_t j = 0; j < num_cols; ++j) {
+            const auto bin1 = first_bin1 + i;
+            const auto bin2 = first_bin2 + j;
+            const auto count = bin1 < num_coarse_bins && bin2 < num_coarse_bins
+                                   ? expected[(bin1 * num_coarse_bins) + bin2]
+                                   : 0.0;
+            CHECK(tile[(i * num_cols) + j] == Catch::Approx(count));
+          }
+        }
+      }
+      CHECK(mrf.tile_cache_hit_rate() > 0);
+    }
+
+    SECTION("fetch") {
+      const std::uint32_t resolution = 2'000'000;
+      const auto pixels = mrf.fetch(resolution, "chr2L", "chr2L");
+      REQUIRE(!pixels.empty());
+
+      const BinTable bins(mrf.chromosomes(), resolution);
+      const auto [first_bin, last_bin] =
+          bins.map_to_bin_ids(GenomicInterval{bins.chromosomes().at("chr2L")});
+      const auto num_bins = static_cast<std::size_t>(last_bin - first_bin + 1);
+      std::vector<double> tile(num_bins * num_bins);
+      mrf.fetch_tile(resolution, nonstd::span<double>(tile), first_bin, first_bin, num_bins,
+                     num_bins);
+
+      double sum{};
+      for (const auto& p : pixels) {
+        CHECK(p.bin1_id <= p.bin2_id);
+        CHECK(p.count == tile[((p.bin1_id - first_bin) * num_bins) + (p.bin2_id - first_bin)]);
+        sum += p.count;
+      }
+      double expected_sum{};
+      for (std::size_t i = 0; i < num_bins; ++i) {
+        for (std::size_t j = i; j < num_bins; ++j) {
+          expected_sum += tile[(i * num_bins) + j];
+        }
+      }
+      CHECK(sum == Catch::Approx(expected_sum));
+    }
+
+    SECTION("fetch balanced") {
+      const std::uint32_t resolution = 2'000'000;
+      const auto norm = mrf.is_hic() ? balancing::Method::KR() : balancing::Method{"weight"};
+      const auto pixels = mrf.fetch(resolution, "chr2L", "chr2R", norm);
+      REQUIRE(!pixels.empty());
+
+      const BinTable bins(mrf.chromosomes(), resolution);
+      const auto [first_bin1, last_bin1] =
+          bins.map_to_bin_ids(GenomicInterval{bins.chromosomes().at("chr2L")});
+      const auto [first_bin2, last_bin2] =
+          bins.map_to_bin_ids(GenomicInterval{bins.chromosomes().at("chr2R")});
+      const auto num_rows = static_cast<std::size_t>(last_bin1 - first_bin1 + 1);
+      const auto num_cols = static_cast<std::size_t>(last_bin2 - first_bin2 + 1);
+      std::vector<double> tile(num_rows * num_cols);
+      mrf.fetch_tile(resolution, nonstd::span<double>(tile), first_bin1, first_bin2, num_rows,
+                     num_cols, norm);
+
+      for (const auto& p : pixels) {
+        const auto i = p.bin1_id - first_bin1;
+        const auto j = p.bin2_id - first_bin2;
+        CHECK(p.count == Catch::Approx(tile[(i * num_cols) + j]));
+      }
+      const auto num_nnz = std::count_if(tile.begin(), tile.end(),
+                                         [](const auto n) { return n != 0 && !std::isnan(n); });
+      CHECK(pixels.size() == static_cast<std::size_t>(num_nnz));
+    }
+
+    SECTION("copies") {
+      const std::uint32_t resolution = 2'000'000;
+      const BinTable bins(mrf.chromosomes(), resolution);
+      const auto num_bins = bins.size();
+      std::vector<double> expected(num_bins * num_bins);
+      mrf.fetch_tile(resolution, nonstd::span<double>(expected), 0, 0, num_bins, num_bins);
+
+      // copies do not share their caches with the MultiResFile they were copied from
+      const auto mrf_copy = mrf;  // NOLINT(performance-unnecessary-copy-initialization)
+      CHECK(mrf_copy.tile_cache_hit_rate() == 0);
+      std::vector<double> found(num_bins * num_bins);
+      mrf_copy.fetch_tile(resolution, nonstd::span<double>(found), 0, 0, num_bins, num_bins);
+      CHECK(found == expected);
+    }
+
+    SECTION("balanced tiles") {
+      const std::uint32_t resolution = 2'000'000;
+      const auto norm = mrf.is_hic() ? balancing::Method::KR() : balancing::Method{"weight"};
+      const BinTable bins(mrf.chromosomes(), resolution);
+      const auto num_bins = bins.size();
+      std::vector<double> tile(num_bins * num_bins);
+      mrf.fetch_tile(resolution, nonstd::span<double>(tile), 0, 0, num_bins, num_bins, norm);
+
+      const auto f = mrf.open(base_resolution);
+      const auto num_fine_bins = f.bins().size();
+      std::vector<double> matrix(num_fine_bins * num_fine_bins);
+      f.fetch_tile(nonstd::span<double>(matrix), 0, 0, num_fine_bins, num_fine_bins, norm);
+      // NaNs are skipped while coarsening
+      std::replace_if(
+          matrix.begin(), matrix.end(), [](const auto n) { return std::isnan(n); }, 0.0);
+      const auto expected = coarsen_matrix(matrix, f.bins(), bins);
+      for (std::size_t i = 0; i < tile.size(); ++i) {
+        CHECK(tile[i] == Catch::Approx(expected[i]));
+      }
+
+      std::vector<std::int32_t> int_tile(num_bins * num_bins);
+      CHECK_THROWS(mrf.fetch_tile(resolution, nonstd::span<std::int32_t>(int_tile), 0, 0,
+                                  num_bins, num_bins, norm));
+    }
+  }
+
+  SECTION("non-observed matrix types") {
+    const std::uint32_t resolution = 2'000'000;
+    const BinTable bins(MultiResFile{path_hic}.chromosomes(), resolution);
+    const auto num_bins = bins.size();
+    std::vector<double> tile(num_bins * num_bins);
+
+    for (const auto matrix_type : {hic::MatrixType::oe, hic::MatrixType::expected}) {
+      const MultiResFile mrf(path_hic, matrix_type);
+      // resolutions stored in the file can still be fetched
+      std::vector<double> base_tile(1);
+      CHECK_NOTHROW(mrf.fetch_tile(base_resolution, nonstd::span<double>(base_tile), 0, 0, 1, 1));
+
+      CHECK_THROWS_WITH(
+          mrf.fetch_tile(resolution, nonstd::span<double>(tile), 0, 0, num_bins, num_bins),
+          Catch::Matchers::ContainsSubstring("requires matrix type to be \"observed\""));
+      CHECK_THROWS_WITH(
+          mrf.fetch(resolution, "chr2L", "chr2L"),
+          Catch::Matchers::ContainsSubstring("requires matrix type to be \"observed\""));
+    }
+  }
+}
 }  // namespace hictk::test::file
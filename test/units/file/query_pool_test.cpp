@@ -0,0 +1,135 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#include "hictk/query_pool.hpp"
+
+#include <fmt/format.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "hictk/file.hpp"
+#include "hictk/pixel.hpp"
+
+using namespace hictk;
+
+namespace hictk::test::file {
+inline const std::filesystem::path datadir{"test/data"};  // NOLINT(cert-err58-cpp)
+
+[[nodiscard]] static std::vector<ThinPixel<std::int32_t>> read_pixels(const File& f,
+                                                                     const std::string& range1,
+                                                                     const std::string& range2) {
+  const auto sel = f.fetch(range1, range2);
+  return {sel.begin<std::int32_t>(), sel.end<std::int32_t>()};
+}
+
+using QueryList = std::vector<std::pair<std::string, std::string>>;
+
+static void check_concurrent_queries(const QueryPool& pool, const QueryList& queries) {
+  const File ref(pool.uri(), pool.resolution());
+  std::vector<std::vector<ThinPixel<std::int32_t>>> expected{};
+  for (const auto& [range1, range2] : queries) {
+    expected.emplace_back(read_pixels(ref, range1, range2));
+  }
+
+  constexpr std::size_t num_workers = 8;
+  std::vector<std::future<bool>> workers{};
+  for (std::size_t i = 0; i < num_workers; ++i) {
+    workers.emplace_back(std::async(std::launch::async, [&, i]() {
+      bool ok = true;
+      for (std::size_t j = 0; j < 3 * queries.size(); ++j) {
+        const auto k = (i + j) % queries.size();
+        const auto& [range1, range2] = queries[k];
+        ok &= pool.fetch<std::int32_t>(range1, range2) == expected[k];
+      }
+      return ok;
+    }));
+  }
+
+  for (auto& worker : workers) {
+    CHECK(worker.get());
+  }
+  CHECK(pool.num_handles() <= pool.max_handles());
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("QueryPool", "[file][medium]") {
+  const std::uint32_t resolution = 100'000;
+  const auto path_hic = (datadir / "hic" / "4DNFIZ1ZVXC8.hic8").string();
+  const auto path_cooler = (datadir / "integration_tests" / "4DNFIZ1ZVXC8.mcool").string();
+  const auto uri_cooler = fmt::format(FMT_STRING("{}::/resolutions/{}"), path_cooler, resolution);
+
+  const QueryList queries{{"chr2L", "chr2L"},
+                          {"chr2L", "chr2R"},
+                          {"chr2R:5,000,000-15,000,000", "chr3L"},
+                          {"chr3R", "chr3R"},
+                          {"chr3L", "chrX"},
+                          {"chrX:1,000,000-2,000,000", "chrX"}};
+
+  SECTION("accessors") {
+    const QueryPool pool_hic(path_hic, resolution, hic::MatrixType::observed,
+                             hic::MatrixUnit::BP, 4);
+    const File hf(path_hic, resolution);
+    CHECK(pool_hic.uri() == path_hic);
+    CHECK(pool_hic.is_hic());
+    CHECK(pool_hic.resolution() == resolution);
+    CHECK(pool_hic.bins() == hf.bins());
+    CHECK(pool_hic.chromosomes() == hf.chromosomes());
+    CHECK(pool_hic.max_handles() == 4);
+    CHECK(pool_hic.num_handles() == 1);
+
+    const QueryPool pool_cooler(path_cooler, resolution, hic::MatrixType::observed,
+                                hic::MatrixUnit::BP, 4);
+    CHECK(pool_cooler.is_cooler());
+    CHECK(pool_cooler.resolution() == resolution);
+    CHECK(pool_cooler.max_handles() == 1);
+  }
+
+  SECTION("handles") {
+    const QueryPool pool(path_hic, resolution, hic::MatrixType::observed, hic::MatrixUnit::BP, 2);
+    {
+      const auto h1 = pool.acquire();
+      const auto h2 = pool.acquire();
+      CHECK(h1->resolution() == resolution);
+      CHECK(pool.num_handles() == 2);
+      // metadata is shared by all handles
+      CHECK(&h1->bins() == &h2->bins());
+      CHECK(&h1->bins() == &pool.bins());
+      CHECK(read_pixels(*h1, "chr2L", "chr2L") == read_pixels(*h2, "chr2L", "chr2L"));
+      // waiting for a third handle would deadlock
+      CHECK_THROWS(std::ignore = pool.acquire());
+    }
+    // handles are returned to the pool and reused
+    const auto h = pool.acquire();
+    CHECK(pool.num_handles() == 2);
+  }
+
+  SECTION("reentrant acquire") {
+    const QueryPool pool(uri_cooler, resolution);
+    const auto h = pool.acquire();
+    CHECK_THROWS(std::ignore = pool.acquire());
+    CHECK_THROWS(std::ignore = pool.fetch<std::int32_t>("chr2L", "chr2L"));
+  }
+
+  SECTION("concurrent queries") {
+    SECTION("hic") {
+      const QueryPool pool(path_hic, resolution, hic::MatrixType::observed, hic::MatrixUnit::BP,
+                           4);
+      check_concurrent_queries(pool, queries);
+    }
+    SECTION("cooler") {
+      const QueryPool pool(uri_cooler, resolution);
+      check_concurrent_queries(pool, queries);
+    }
+  }
+}
+
+}  // namespace hictk::test::file
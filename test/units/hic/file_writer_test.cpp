@@ -8,12 +8,26 @@
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <zstd.h>
+
+#include <BS_thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <nonstd/span.hpp>
 #include <string>
+#include <vector>
 
+#include "hictk/balancing/methods.hpp"
+#include "hictk/balancing/weights.hpp"
+#include "hictk/binary_buffer.hpp"
 #include "hictk/chromosome.hpp"
+#include "hictk/expected_values_aggregator.hpp"
 #include "hictk/hic.hpp"
+#include "hictk/pixel.hpp"
 #include "hictk/reference.hpp"
 #include "hictk/transformers/join_genomic_coords.hpp"
 #include "tmpdir.hpp"
@@ -80,13 +94,65 @@ TEST_CASE("HiC: HiCInteractionToBlockMapper", "[hic][v9][short]") {
   partitioner.append_pixels(pixels2.begin(), pixels2.end());
   partitioner.finalize();
 
-  std::size_t num_interactions = 0;
-  for (const auto& [bid, _] : partitioner.block_index()) {
-    const auto blk = partitioner.merge_blocks(bid);
-    num_interactions += static_cast<std::size_t>(blk.nRecords);
+  SECTION("spill index") {
+    const auto& spills = partitioner.spill_index();
+    REQUIRE(spills.size() > 1);
+    CHECK(spills.front().offset == 0);
+    for (std::size_t i = 1; i < spills.size(); ++i) {
+      CHECK(spills[i].offset == spills[i - 1].offset + spills[i - 1].size);
+    }
+  }
+
+  SECTION("merge blocks") {
+    std::size_t num_interactions = 0;
+    for (const auto& [bid, _] : partitioner.block_index()) {
+      const auto blk = partitioner.merge_blocks(bid);
+      num_interactions += static_cast<std::size_t>(blk.nRecords);
+    }
+
+    CHECK(num_interactions == pixels1.size() + pixels2.size());
+  }
+
+  SECTION("merge blocks with spill reader") {
+    auto reader = partitioner.open_spill_reader();
+    CHECK(reader.num_spills() == partitioner.spill_index().size());
+
+    BinaryBuffer bbuffer{};
+    std::string compression_buffer{};
+    std::unique_ptr<ZSTD_DCtx_s> zstd_dctx{ZSTD_createDCtx()};
+
+    std::size_t num_interactions = 0;
+    for (const auto& [bid, _] : partitioner.block_index()) {
+      const auto blk =
+          partitioner.merge_blocks(bid, bbuffer, *zstd_dctx, compression_buffer, reader);
+      num_interactions += static_cast<std::size_t>(blk.nRecords);
+    }
+
+    CHECK(num_interactions == pixels1.size() + pixels2.size());
   }
 
-  CHECK(num_interactions == pixels1.size() + pixels2.size());
+  SECTION("append pixels using multiple threads") {
+    const auto path3 = (testdir() / "hic_block_partitioner_mt.bin").string();
+    HiCInteractionToBlockMapper partitioner_mt(path3, f1.bins_ptr(), 50'000, 3);
+    BS::thread_pool tpool(3);
+
+    partitioner_mt.append_pixels(pixels1.begin(), pixels1.end(), tpool);
+    partitioner_mt.append_pixels(pixels2.begin(), pixels2.end(), tpool);
+    partitioner_mt.finalize();
+
+    CHECK(partitioner_mt.size() == partitioner.size());
+    CHECK_THAT(partitioner_mt.pixel_sum(), Catch::Matchers::WithinRel(partitioner.pixel_sum()));
+    REQUIRE(partitioner_mt.chromosome_index().size() == partitioner.chromosome_index().size());
+    for (const auto& [chroms, block_ids] : partitioner.chromosome_index()) {
+      const auto& [chrom1, chrom2] = chroms;
+      CHECK_THAT(partitioner_mt.pixel_sum(chrom1, chrom2),
+                 Catch::Matchers::WithinRel(partitioner.pixel_sum(chrom1, chrom2)));
+      CHECK(partitioner_mt.chromosome_index().at(chroms) == block_ids);
+      for (const auto& bid : block_ids) {
+        CHECK(partitioner_mt.merge_blocks(bid).nRecords == partitioner.merge_blocks(bid).nRecords);
+      }
+    }
+  }
 }
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
@@ -171,6 +237,108 @@ TEST_CASE("HiC: HiCFileWriter", "[hic][v9][long]") {
     hic_file_writer_create_file_test(path1, path2, resolutions, 3, true);
   }
 
+  SECTION("add sorted pixels") {
+    const std::uint32_t resolution = 100'000;
+    const hic::File hf1(path1, resolution);
+
+    auto pixels1 = hf1.fetch("chr3R").read_all<float>();
+    const auto pixels2 = hf1.fetch("chr3R", "chr4").read_all<float>();
+    pixels1.insert(pixels1.end(), pixels2.begin(), pixels2.end());
+    std::sort(pixels1.begin(), pixels1.end());
+
+    {
+      HiCFileWriter w(path3, hf1.chromosomes(), {resolution}, "dm6", 3);
+      CHECK_THROWS_WITH(w.add_sorted_pixels(resolution, pixels1.rbegin(), pixels1.rend()),
+                        Catch::Matchers::ContainsSubstring("pixels are not sorted"));
+    }
+
+    {
+      HiCFileWriter w(path3, hf1.chromosomes(), {resolution}, "dm6", 3);
+      w.add_sorted_pixels(resolution, pixels1.begin(), pixels1.end());
+      CHECK_THROWS_WITH(w.add_sorted_pixels(resolution, pixels1.begin(), pixels1.end()),
+                        Catch::Matchers::ContainsSubstring("have already been added"));
+      w.serialize();
+    }
+
+    const hic::File hf2(path3, resolution);
+    hic_file_writer_compare_pixels(hf1.fetch("chr3R").read_all<float>(),
+                                   hf2.fetch("chr3R").read_all<float>());
+    hic_file_writer_compare_pixels(hf1.fetch("chr3R", "chr4").read_all<float>(),
+                                   hf2.fetch("chr3R", "chr4").read_all<float>());
+  }
+
+  SECTION("add sorted pixels (spill)") {
+    const std::uint32_t resolution = 100'000;
+    const hic::File hf1(path1, resolution);
+
+    auto pixels = hf1.fetch("chr3R").read_all<float>();
+    const auto pixels2 = hf1.fetch("chr3R", "chr4").read_all<float>();
+    pixels.insert(pixels.end(), pixels2.begin(), pixels2.end());
+    std::sort(pixels.begin(), pixels.end());
+
+    {
+      // chunk_size is small enough that most of the pending blocks are spilled to the block mapper
+      const std::size_t chunk_size = 1'000;
+      HiCFileWriter w(path3, hf1.chromosomes(), {resolution}, "dm6", 3, chunk_size);
+      w.add_sorted_pixels(resolution, pixels.begin(), pixels.end());
+      w.serialize();
+      CHECK(w.stats(resolution).nnz == pixels.size());
+    }
+
+    const hic::File hf2(path3, resolution);
+    hic_file_writer_compare_pixels(hf1.fetch("chr3R").read_all<float>(),
+                                   hf2.fetch("chr3R").read_all<float>());
+    hic_file_writer_compare_pixels(hf1.fetch("chr3R", "chr4").read_all<float>(),
+                                   hf2.fetch("chr3R", "chr4").read_all<float>());
+  }
+
+  SECTION("copy interaction blocks") {
+    const std::uint32_t resolution = 500'000;
+    const hic::File hf1(path1, resolution);
+
+    {
+      HiCFileWriter w(path3, hf1.chromosomes(), {resolution}, "dm6");
+      w.add_blocks(resolution, path1);
+      CHECK_THROWS_WITH(w.add_blocks(resolution, path1),
+                        Catch::Matchers::ContainsSubstring("have already been added"));
+      w.serialize();
+      CHECK(w.stats(resolution).nnz == hf1.fetch().read_all<float>().size());
+    }
+
+    const hic::File hf2(path3, resolution);
+    const auto correct_pixels = hf1.fetch().read_all<float>();
+    const auto pixels = hf2.fetch().read_all<float>();
+    hic_file_writer_compare_pixels(correct_pixels, pixels);
+
+    const hic::File f3(path1, resolution, MatrixType::expected);
+    const hic::File f4(path3, resolution, MatrixType::expected);
+
+    const auto correct_expected_pixels = f3.fetch("chr2L").read_all<float>();
+    const auto expected_pixels = f4.fetch("chr2L").read_all<float>();
+    // NOLINTNEXTLINE(*-suspicious-call-argument)
+    hic_file_writer_compare_pixels(correct_expected_pixels, expected_pixels);
+  }
+
+  SECTION("copy interaction blocks (decoded)") {
+    // blocks from .hic v8 files cannot be copied and are decoded instead
+    const auto path_v8 = (datadir / "4DNFIZ1ZVXC8.hic8").string();
+    const std::uint32_t resolution = 500'000;
+    const hic::File hf1(path_v8, resolution);
+    const auto correct_pixels = hf1.fetch().read_all<float>();
+
+    {
+      HiCFileWriter w(path3, hf1.chromosomes(), {resolution}, "dm6");
+      w.add_blocks(resolution, path_v8);
+      CHECK_THROWS_WITH(w.add_blocks(resolution, path_v8),
+                        Catch::Matchers::ContainsSubstring("have already been added"));
+      w.serialize();
+      CHECK(w.stats(resolution).nnz == correct_pixels.size());
+    }
+
+    const hic::File hf2(path3, resolution);
+    hic_file_writer_compare_pixels(correct_pixels, hf2.fetch().read_all<float>());
+  }
+
   SECTION("add weights") {
     const std::uint32_t resolution = 500'000;
     const hic::File hf1(path1, resolution);
@@ -228,6 +396,63 @@ TEST_CASE("HiC: HiCFileWriter", "[hic][v9][long]") {
     // NOLINTNEXTLINE(*-suspicious-call-argument)
     hic_file_writer_compare_pixels(correct_expected_pixels, expected_pixels);
   }
+
+  SECTION("add weights before pixels") {
+    const std::uint32_t resolution = 500'000;
+    const hic::File hf1(path1, resolution);
+
+    {
+      // normalized expected values are aggregated while interaction blocks are being written
+      HiCFileWriter w(path3, hf1.chromosomes(), {hf1.resolution()}, "dm6", 3);
+      for (const auto& chrom : w.chromosomes()) {
+        if (chrom.is_all()) {
+          continue;
+        }
+        w.add_norm_vector("SCALE", chrom, "BP", hf1.resolution(),
+                          hf1.normalization("SCALE", chrom));
+      }
+      const auto sel = hf1.fetch();
+      w.add_pixels(resolution, sel.begin<float>(), sel.end<float>());
+      w.serialize();
+    }
+
+    const hic::File hf2(path3, resolution);
+    const auto avail_norms = hf2.avail_normalizations();
+    REQUIRE(avail_norms.size() == 1);
+    CHECK(avail_norms.front() == balancing::Method::SCALE());
+
+    // compute normalized expected values from the interactions read back from the file
+    const auto weights = hf2.normalization(balancing::Method::SCALE())(
+        balancing::Weights::Type::DIVISIVE);
+    REQUIRE(weights.size() == hf2.bins().size());
+    const auto pixels = hf2.fetch().read_all<float>();
+    std::vector<ThinPixel<float>> normalized_pixels(pixels.size());
+    std::transform(pixels.begin(), pixels.end(), normalized_pixels.begin(), [&](const auto& p) {
+      const auto w1 = weights[p.coords.bin1.id()];
+      const auto w2 = weights[p.coords.bin2.id()];
+      return ThinPixel<float>{p.coords.bin1.id(), p.coords.bin2.id(),
+                              p.count / static_cast<float>(w1 * w2)};
+    });
+    ExpectedValuesAggregator aggr(hf2.bins_ptr());
+    aggr.add(nonstd::span<const ThinPixel<float>>(normalized_pixels));
+    aggr.compute_density();
+
+    for (const auto& chrom : hf2.chromosomes()) {
+      if (chrom.is_all()) {
+        continue;
+      }
+      const auto expected = aggr.weights(chrom);
+      const auto found = hf2.expected_values(chrom, balancing::Method::SCALE());
+      REQUIRE(found.size() >= expected.size());
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (std::isnan(expected[i])) {
+          CHECK(std::isnan(found[i]));
+        } else {
+          CHECK_THAT(found[i], Catch::Matchers::WithinRel(expected[i], 1.0e-6));
+        }
+      }
+    }
+  }
 }
 
 }  // namespace hictk::hic::test::file_writer
@@ -3,6 +3,8 @@
 // SPDX-License-Identifier: MIT
 
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <limits>
@@ -10,6 +12,7 @@
 #include <tuple>
 
 #include "hictk/balancing/methods.hpp"
+#include "hictk/balancing/weights.hpp"
 #include "hictk/hic.hpp"
 #include "hictk/hic/validation.hpp"
 
@@ -90,6 +93,28 @@ TEST_CASE("HiC: footer cache", "[hic][short]") {
   CHECK(&sel1.metadata() != &sel3.metadata());
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("HiC: weight cache", "[hic][short]") {
+  const File f(pathV8, 2'500'000, MatrixType::observed, MatrixUnit::BP);
+  const auto norm = hictk::balancing::Method::KR();
+  const auto& chrom = f.chromosomes().at("chr2L");
+
+  const auto weights1 = f.normalization_ptr(norm, chrom);
+  const auto weights2 = f.normalization_ptr(norm, chrom);
+  CHECK(weights1 == weights2);
+
+  const auto expected = f.normalization(norm, chrom)(hictk::balancing::Weights::Type::DIVISIVE);
+  const auto found = (*weights1)(hictk::balancing::Weights::Type::DIVISIVE);
+  REQUIRE(expected.size() == found.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    if (std::isnan(expected[i])) {
+      CHECK(std::isnan(found[i]));
+    } else {
+      CHECK(expected[i] == found[i]);
+    }
+  }
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 TEST_CASE("HiC: fetch", "[hic][short]") {
   const auto norm = hictk::balancing::Method::NONE();
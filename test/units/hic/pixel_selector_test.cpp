@@ -13,6 +13,7 @@
 #include <filesystem>
 #include <numeric>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -152,6 +153,52 @@ TEST_CASE("HiC: pixel selector fetch (observed NONE BP 10000)", "[hic][long]") {
                         return accumulator + tp.count;
                       }) == expected_sum);
           }
+
+          SECTION("iterator copies") {
+            // copies share the same chunk of pixels until one of them moves to the next chunk
+            auto first1 = sel.begin<std::int32_t>();
+            auto first2 = first1;
+            const auto last = sel.end<std::int32_t>();
+
+            std::size_t num_pixels = 0;
+            for (; first1 != last; ++first1, ++first2, ++num_pixels) {
+              REQUIRE(first2 != last);
+              CHECK(*first1 == *first2);
+              if (num_pixels % 100'000 == 0) {
+                // copy the iterator while the current chunk is still being read
+                auto first3 = first1;
+                CHECK(*first3 == *first1);
+                std::ignore = ++first3;
+              }
+            }
+            CHECK(first2 == last);
+            CHECK(num_pixels == expected_size);
+          }
+
+          SECTION("iterator copies at different positions") {
+            // copies share the block blacklist: advancing one of them to the end should not
+            // affect the pixels returned by the others
+            const auto sel1 = File(path, 10'000, MatrixType::observed, MatrixUnit::BP)
+                                  .fetch("chr2L:5,000,000-15,000,000");
+            const auto expected = sel1.read_all<std::int32_t>();
+            REQUIRE(!expected.empty());
+
+            auto first1 = sel1.begin<std::int32_t>();
+            const auto first2 = first1;
+            const auto last = sel1.end<std::int32_t>();
+
+            std::size_t num_pixels = 0;
+            for (; first1 != last; ++first1) {
+              ++num_pixels;
+            }
+            CHECK(num_pixels == expected.size());
+
+            const std::vector<hictk::ThinPixel<std::int32_t>> pixels(first2, last);
+            REQUIRE(pixels.size() == expected.size());
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+              CHECK(pixels[i] == expected[i].to_thin());
+            }
+          }
         }
 
         SECTION("overloads return identical results") {
@@ -391,6 +438,41 @@ TEST_CASE("HiC: pixel selector fetch all (observed NONE BP 100000)", "[hic][long
   }
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("HiC: pixel selector fetch all (multi-threaded)", "[hic][long]") {
+  for (const std::string version : {"v8", "v9"}) {
+    const auto path = version == "v8" ? pathV8 : pathV9;
+    SECTION(version) {
+      const File f(path, 100'000, MatrixType::observed, MatrixUnit::BP);
+      const auto expected = f.fetch().read_all<double>();
+      REQUIRE(expected.size() == 890384);
+
+      const auto sel = f.fetch(hictk::balancing::Method::NONE(), 4);
+      CHECK(sel.num_threads() == 4);
+
+      SECTION("sorted") {
+        const auto buffer = sel.read_all<double>();
+        REQUIRE(buffer.size() == expected.size());
+        CHECK(std::is_sorted(buffer.begin(), buffer.end()));
+        for (std::size_t i = 0; i < buffer.size(); ++i) {
+          CHECK(buffer[i] == expected[i]);
+        }
+      }
+      SECTION("unsorted") {
+        REQUIRE(std::distance(sel.begin<double>(false), sel.end<double>()) == 890384);
+        CHECK_THAT(sumCounts(sel.read_all<double>()),
+                   Catch::Matchers::WithinRel(119208613, 1.0e-6));
+      }
+      SECTION("early termination") {
+        auto it = sel.begin<double>();
+        for (std::size_t i = 0; i < 10; ++i, ++it) {
+          CHECK(*it == expected[i].to_thin());
+        }
+      }
+    }
+  }
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 TEST_CASE("HiC: pixel selector fetch all repeatedly", "[hic][short]") {
   const auto sel = File(pathV8, 100'000, MatrixType::observed, MatrixUnit::BP).fetch();
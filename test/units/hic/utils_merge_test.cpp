@@ -7,6 +7,7 @@
 #include <array>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 #include <cstddef>
 #include <cstdint>
@@ -45,6 +46,28 @@ TEST_CASE("HiC: utils merge", "[merge][utils][long]") {
     }
   }  // namespace hictk::hic::test::utils
 
+  SECTION("merge gw (multi-threaded)") {
+    const auto src = datadir / "4DNFIZ1ZVXC8.hic9";
+    const auto dest = testdir() / "hic_merge_test_004.hic";
+
+    const std::uint32_t resolution = 500'000;
+    const std::array<std::string, 3> sources{src.string(), src.string(), src.string()};
+    hic::utils::merge(sources.begin(), sources.end(), dest.string(), resolution, testdir(), true,
+                      1'000, 4);
+
+    const File f1(src.string(), resolution);
+    const File f2(dest.string(), resolution);
+
+    const auto pixels1 = f1.fetch().read_all<float>();
+    const auto pixels2 = f2.fetch().read_all<float>();
+
+    REQUIRE(pixels1.size() == pixels2.size());
+    for (std::size_t i = 0; i < pixels1.size(); ++i) {
+      CHECK(pixels1[i].coords == pixels2[i].coords);
+      CHECK_THAT(pixels1[i].count * 3, Catch::Matchers::WithinRel(pixels2[i].count, 1.0e-6F));
+    }
+  }
+
   SECTION("merge chromosomes") {
     const auto src = datadir / "4DNFIZ1ZVXC8.hic9";
     const auto dest = testdir() / "hic_merge_test_002.hic";
@@ -0,0 +1,87 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#include "hictk/tools/memory_budget.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <cstddef>
+
+#include "hictk/hic/file_writer.hpp"
+#include "hictk/hic/interaction_to_block_mapper.hpp"
+#include "hictk/pixel.hpp"
+
+namespace hictk::tools::test {
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Tools: MemoryBudget", "[tools][short]") {
+  constexpr std::size_t min_chunk_size = MemoryBudget::MIN_CHUNK_SIZE;
+
+  SECTION("reserve") {
+    MemoryBudget budget{1'000};
+    CHECK(budget.capacity() == 1'000);
+    CHECK(budget.available() == 1'000);
+
+    budget.reserve(400);
+    CHECK(budget.reserved() == 400);
+    CHECK(budget.available() == 600);
+
+    budget.reserve(600);
+    CHECK(budget.available() == 0);
+    budget.reserve(0);
+    CHECK(budget.available() == 0);
+  }
+
+  SECTION("reserve items") {
+    constexpr std::size_t footprint = 16;
+    constexpr std::size_t fixed = 1'000;
+    MemoryBudget budget{fixed + (3 * min_chunk_size * footprint) + footprint - 1};
+    budget.reserve(fixed);
+    CHECK(budget.reserve_items(footprint) == 3 * min_chunk_size);
+    CHECK(budget.available() == 0);
+  }
+
+  SECTION("zero footprint") {
+    MemoryBudget budget{min_chunk_size};
+    CHECK(budget.reserve_items(0) == min_chunk_size);
+  }
+
+  SECTION("budget too small") {
+    constexpr std::size_t footprint = 16;
+    constexpr std::size_t fixed = 1'000;
+
+    MemoryBudget budget1{fixed - 1};
+    CHECK_THROWS_WITH(budget1.reserve(fixed),
+                      Catch::Matchers::ContainsSubstring("at least 1000 bytes are required"));
+    CHECK(budget1.available() == fixed - 1);
+
+    MemoryBudget budget2{fixed + (min_chunk_size * footprint) - 1};
+    budget2.reserve(fixed);
+    CHECK_THROWS_WITH(budget2.reserve_items(footprint),
+                      Catch::Matchers::ContainsSubstring("at least 1601000 bytes are required"));
+
+    MemoryBudget budget3{fixed + (min_chunk_size * footprint)};
+    budget3.reserve(fixed);
+    CHECK(budget3.reserve_items(footprint) == min_chunk_size);
+  }
+
+  SECTION("HiCFileWriter footprint") {
+    const auto fixed1 = hic_file_writer_fixed_footprint(1);
+    const auto fixed2 = hic_file_writer_fixed_footprint(2);
+    CHECK(fixed1 > hic::internal::HiCFileWriter::DEFAULT_BUFFER_SIZE);
+    // pixel batches used to map pixels to interaction blocks can store full pixels
+    CHECK(fixed1 > 2 * hic::internal::HiCInteractionToBlockMapper::DEFAULT_BATCH_SIZE *
+                       sizeof(Pixel<float>));
+    CHECK(fixed2 - fixed1 ==
+          hic::internal::HiCFileWriter::WORKER_BUFFER_SIZE +
+              hic::internal::HiCInteractionToBlockMapper::SpillReader::DEFAULT_READAHEAD_BUDGET);
+
+    // each resolution has its own block mapper
+    CHECK(hic_file_writer_pixel_footprint(0) == HIC_BLOCK_MAPPER_FOOTPRINT);
+    CHECK(hic_file_writer_pixel_footprint(1) == HIC_BLOCK_MAPPER_FOOTPRINT);
+    CHECK(hic_file_writer_pixel_footprint(4) == 4 * HIC_BLOCK_MAPPER_FOOTPRINT);
+  }
+}
+
+}  // namespace hictk::tools::test
@@ -0,0 +1,317 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "hictk/bin_table.hpp"
+#include "hictk/pixel.hpp"
+#include "hictk/reference.hpp"
+#include "hictk/type_traits.hpp"
+#include "load/common.hpp"
+
+namespace hictk::tools::test {
+
+// Outcome of parsing a line: either a pixel or the message of the exception that was thrown
+template <typename N>
+struct ParseResult {
+  ThinPixel<N> pixel{};
+  std::string error{};
+};
+
+template <typename N, typename BinTableT>
+[[nodiscard]] static ParseResult<N> parse_slow(const BinTableT& bins, std::string_view line,
+                                               Format format, std::int64_t offset) {
+  try {
+    return {parse_pixel<N>(bins, line, format, offset), {}};
+  } catch (const std::exception& e) {
+    return {{}, e.what()};
+  }
+}
+
+template <typename N, typename BinTableT>
+[[nodiscard]] static ParseResult<N> parse_fast(PixelParser<N, BinTableT>& parser,
+                                               std::string_view line) {
+  try {
+    return {parser(line), {}};
+  } catch (const std::exception& e) {
+    return {{}, e.what()};
+  }
+}
+
+// Parse each line with both the fast and the slow parsers and compare the outcome
+template <typename N, typename BinTableT>
+static void compare_parsers(const BinTableT& bins, const std::vector<std::string>& lines,
+                            Format format, std::int64_t offset) {
+  PixelParser<N, BinTableT> parser(bins, format, offset);
+  for (const auto& line : lines) {
+    const auto expected = parse_slow<N>(bins, line, format, offset);
+    const auto found = parse_fast(parser, line);
+    INFO("line: \"" << line << "\", offset: " << offset);
+    CHECK(found.error == expected.error);
+    CHECK(found.pixel.bin1_id == expected.pixel.bin1_id);
+    CHECK(found.pixel.bin2_id == expected.pixel.bin2_id);
+    if constexpr (std::is_floating_point_v<N>) {
+      if (std::isnan(expected.pixel.count)) {
+        CHECK(std::isnan(found.pixel.count));
+        continue;
+      }
+    }
+    CHECK(found.pixel.count == expected.pixel.count);
+  }
+
+  // lines that can be parsed are also parsed in batches (NaNs never compare equal, so skip them)
+  std::vector<ThinPixel<N>> expected{};
+  std::vector<ThinPixel<N>> found{};
+  for (const auto& line : lines) {
+    const auto result = parse_slow<N>(bins, line, format, offset);
+    bool is_nan = false;
+    if constexpr (std::is_floating_point_v<N>) {
+      is_nan = std::isnan(result.pixel.count);
+    }
+    if (result.error.empty() && !is_nan) {
+      expected.push_back(result.pixel);
+      parser.push_back(line, found);
+    }
+  }
+  parser.flush(found);
+  CHECK(found == expected);
+}
+
+template <typename N>
+static void compare_parsers(const BinTable& bins, const std::vector<std::string>& lines,
+                            Format format) {
+  for (const std::int64_t offset : {0, 1, -1}) {
+    compare_parsers<N>(bins, lines, format, offset);
+    bins.visit([&](const auto& bins_) { compare_parsers<N>(bins_, lines, format, offset); });
+  }
+}
+
+[[nodiscard]] static std::vector<std::string> generate_coo_lines() {
+  return {"0\t1\t5",   "3\t2\t5",     "0\t1\t5\r",   "0\t1\t5\t7", "0\t1\t1.5",  "0\t1\t-3",
+          "\t1\t5",    "0\t\t5",      "0\t1\t",      "0\t1",       "-1\t0\t1",   "0\t-1\t1",
+          "14\t14\t1", "14\t15\t1",   "15\t15\t1",   "0 1 5",      "a\t1\t5",    "0\t1\tb",
+          "",          "0\t1\t5\t\r", "+1\t+2\t+3", "01\t02\t03", "0\t1\tnan", "0\t1\t1e3"};
+}
+
+[[nodiscard]] static std::vector<std::string> generate_bg2_lines() {
+  return {"chr1\t0\t100\tchr2\t0\t100\t5",
+          "chr2\t0\t100\tchr1\t100\t200\t5",
+          "chr1\t0\t100\tchr2\t0\t100\t5\r",
+          "chr1\t0\t100\tchr2\t0\t100\t5\textra",
+          "chr1\t0\t100\tchr2\t0\t100\t5\t\r",
+          "chr1\t0\t100\tchr2\t0\t100\t1.5",
+          "chr1\t0\t100\tchr2\t0\t100",
+          "chr1\t\t100\tchr2\t0\t100\t5",
+          "\t0\t100\tchr2\t0\t100\t5",
+          "chr1\t0\t100\tchr2\t0\t100\t",
+          "chr1\t0\t\tchr2\t0\t100\t5",
+          "chr1\t-1\t100\tchr2\t0\t100\t5",
+          "chr1\t999\t1000\tchr2\t499\t500\t5",
+          "chr1\t1000\t1100\tchr2\t0\t100\t5",
+          "chr2\t500\t600\tchr2\t0\t100\t5",
+          "chrX\t0\t100\tchr2\t0\t100\t5",
+          "chr1\t0\t100\tchrX\t0\t100\t5",
+          "chr1\ta\t100\tchr2\t0\t100\t5",
+          "chr1 0 100 chr2 0 100 5",
+          ""};
+}
+
+[[nodiscard]] static std::vector<std::string> generate_validpairs_lines() {
+  return {"read1\tchr1\t10\t+\tchr2\t20\t-",
+          "read1\tchr2\t10\t+\tchr1\t20\t-",
+          "read1\tchr1\t10\t+\tchr2\t20\t-\r",
+          "read1\tchr1\t10\t+\tchr2\t20\t-\textra\textra",
+          "read1\tchr1\t10\t+\tchr2\t20",
+          "read1\tchr1\t10\t+\tchr2\t20\t",
+          "read1\tchr1\t10\t+\tchr2",
+          "\tchr1\t10\t+\tchr2\t20\t-",
+          "read1\t\t10\t+\tchr2\t20\t-",
+          "read1\tchr1\t\t+\tchr2\t20\t-",
+          "read1\tchr1\t10\t\tchr2\t20\t-",
+          "read1\tchr1\t-1\t+\tchr2\t20\t-",
+          "read1\tchr1\t0\t+\tchr2\t0\t-",
+          "read1\tchr1\t999\t+\tchr2\t499\t-",
+          "read1\tchr1\t1000\t+\tchr2\t20\t-",
+          "read1\tchrX\t10\t+\tchr2\t20\t-",
+          "read1\tchr1\t10\t+\tchrX\t20\t-",
+          "read1\tchr1\t1.5\t+\tchr2\t20\t-",
+          "read1 chr1 10 + chr2 20 -",
+          ""};
+}
+
+[[nodiscard]] static std::vector<std::string> generate_4dn_lines() {
+  return {"read1\tchr1\t10\tchr2\t20\t+\t-",
+          "read1\tchr2\t10\tchr1\t20\t+\t-",
+          "read1\tchr1\t10\tchr2\t20\t+\t-\r",
+          "read1\tchr1\t10\tchr2\t20\t+\t-\textra\textra",
+          "read1\tchr1\t10\tchr2\t20\t+",
+          "read1\tchr1\t10\tchr2\t20",
+          "read1\tchr1\t10\tchr2\t20\t\r",
+          "\tchr1\t10\tchr2\t20\t+\t-",
+          "read1\t\t10\tchr2\t20\t+\t-",
+          "read1\tchr1\t\tchr2\t20\t+\t-",
+          "read1\tchr1\t10\tchr2\t20\t\t-",
+          "read1\tchr1\t-1\tchr2\t20\t+\t-",
+          "read1\tchr1\t0\tchr2\t0\t+\t-",
+          "read1\tchr1\t999\tchr2\t499\t+\t-",
+          "read1\tchr1\t10\tchr2\t500\t+\t-",
+          "read1\tchrX\t10\tchr2\t20\t+\t-",
+          "read1\tchr1\t10\tchrX\t20\t+\t-",
+          "read1\tchr1\t10\tchr2\tb\t+\t-",
+          "read1 chr1 10 chr2 20 + -",
+          ""};
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Tools: PixelParser", "[tools][short]") {
+  const Reference chroms{Chromosome{0, "chr1", 1000}, Chromosome{1, "chr2", 500}};
+  const BinTable fixed_bins(chroms, 100);
+
+  const std::vector<std::uint32_t> start_pos{0, 10, 250, 600, 0, 300};
+  const std::vector<std::uint32_t> end_pos{10, 250, 600, 1000, 300, 500};
+  const BinTable variable_bins(chroms, start_pos, end_pos);
+
+  for (const auto* bins : {&fixed_bins, &variable_bins}) {
+    const auto table_type = bins->has_fixed_resolution() ? "fixed" : "variable";
+    SECTION(std::string{"coo - "} + table_type) {
+      compare_parsers<std::int32_t>(*bins, generate_coo_lines(), Format::COO);
+      compare_parsers<double>(*bins, generate_coo_lines(), Format::COO);
+    }
+    SECTION(std::string{"bg2 - "} + table_type) {
+      compare_parsers<std::int32_t>(*bins, generate_bg2_lines(), Format::BG2);
+      compare_parsers<double>(*bins, generate_bg2_lines(), Format::BG2);
+    }
+    SECTION(std::string{"validpairs - "} + table_type) {
+      compare_parsers<std::int32_t>(*bins, generate_validpairs_lines(), Format::VP);
+      compare_parsers<double>(*bins, generate_validpairs_lines(), Format::VP);
+    }
+    SECTION(std::string{"4dn - "} + table_type) {
+      compare_parsers<std::int32_t>(*bins, generate_4dn_lines(), Format::_4DN);
+      compare_parsers<double>(*bins, generate_4dn_lines(), Format::_4DN);
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Tools: PixelParser (batched)", "[tools][short]") {
+  const Reference chroms{Chromosome{0, "chr1", 1'000'000}, Chromosome{1, "chr2", 500'000}};
+  const BinTable fixed_bins(chroms, 1'000);
+
+  // bins of variable size between 1 and 2'000 bp
+  std::vector<std::uint32_t> start_pos{};
+  std::vector<std::uint32_t> end_pos{};
+  for (const auto& chrom : chroms) {
+    for (std::uint32_t pos = 0, i = 0; pos < chrom.size(); ++i) {
+      const auto size = 1 + ((i * 7919) % 2'000);
+      start_pos.push_back(pos);
+      pos = std::min(pos + size, chrom.size());
+      end_pos.push_back(pos);
+    }
+  }
+  const BinTable variable_bins(chroms, start_pos, end_pos);
+
+  // more lines than PixelParser::MAX_PENDING_PIXELS, sorted by the coordinates of the first bin
+  std::vector<std::string> lines{};
+  const std::size_t num_lines = 150'000;
+  for (std::size_t i = 0; i < num_lines; ++i) {
+    const auto& chrom1 = chroms.at(i < 2 * num_lines / 3 ? 0 : 1);
+    const auto& chrom2 = chroms.at(i % 3 == 0 ? 1 : 0);
+    const auto pos1 = static_cast<std::uint32_t>((i * 6) % chrom1.size());
+    const auto pos2 = static_cast<std::uint32_t>((i * 104'729) % chrom2.size());
+    lines.emplace_back(fmt::format(FMT_STRING("read{}\t{}\t{}\t+\t{}\t{}\t-"), i,
+                                   chrom1.name(), pos1, chrom2.name(), pos2));
+  }
+  lines.emplace_back("read1\tchr1\t10\t+\tchr2\t20\t-\r");
+
+  for (const auto* bins : {&fixed_bins, &variable_bins}) {
+    bins->visit([&](const auto& bins_) {
+      using BinTableT = remove_cvref_t<decltype(bins_)>;
+      PixelParser<std::int32_t, BinTableT> parser(bins_, Format::VP, 0);
+      std::vector<ThinPixel<std::int32_t>> expected{};
+      std::vector<ThinPixel<std::int32_t>> found{};
+      for (const auto& line : lines) {
+        expected.push_back(parse_pixel<std::int32_t>(bins_, line, Format::VP, 0));
+        parser.push_back(line, found);
+      }
+      parser.flush(found);
+      REQUIRE(found.size() == expected.size());
+      CHECK(found == expected);
+    });
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Tools: LineReader", "[tools][short]") {
+  auto read_lines = [](const std::string& text, std::size_t buffer_size) {
+    std::istringstream ss(text);
+    LineReader reader(ss, buffer_size);
+    std::vector<std::string> lines{};
+    std::string_view line{};
+    while (reader.getline(line)) {
+      lines.emplace_back(line);
+    }
+    CHECK(line.empty());
+    CHECK(reader.eof());
+    return lines;
+  };
+
+  auto read_lines_getline = [](const std::string& text) {
+    std::istringstream ss(text);
+    std::vector<std::string> lines{};
+    std::string line{};
+    while (std::getline(ss, line)) {
+      lines.emplace_back(line);
+    }
+    return lines;
+  };
+
+  const std::string long_line(100, 'x');
+  const std::vector<std::string> texts{"",
+                                       "\n",
+                                       "\n\n",
+                                       "a",
+                                       "a\n",
+                                       "a\nb",
+                                       "a\nb\n",
+                                       "a\r\nb\r\n",
+                                       "a\n\nb\n\n",
+                                       long_line,
+                                       long_line + "\n" + long_line,
+                                       "a\n" + long_line + "\nb\n" + long_line + "\n"};
+
+  for (const std::size_t buffer_size : {1, 2, 3, 7, 64, 1024}) {
+    for (const auto& text : texts) {
+      INFO("buffer_size: " << buffer_size << ", text: \"" << text << "\"");
+      CHECK(read_lines(text, buffer_size) == read_lines_getline(text));
+    }
+  }
+
+  SECTION("eof") {
+    std::istringstream ss("a\nb\n");
+    LineReader reader(ss, 1);
+    std::string_view line{};
+    CHECK_FALSE(reader.eof());
+    CHECK(reader.getline(line));
+    CHECK(line == "a");
+    CHECK(reader.getline(line));
+    CHECK(line == "b");
+    CHECK_FALSE(reader.getline(line));
+    CHECK(reader.eof());
+    CHECK_FALSE(reader.getline(line));
+  }
+}
+
+}  // namespace hictk::tools::test
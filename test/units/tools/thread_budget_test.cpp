@@ -0,0 +1,45 @@
+// Copyright (C) 2024 Roberto Rossini <roberros@uio.no>
+//
+// SPDX-License-Identifier: MIT
+
+#include "hictk/tools/thread_budget.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace hictk::tools::test {
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Tools: thread budget (dump)", "[tools][short]") {
+  SECTION("parallel formatting") {
+    for (std::size_t threads = 1; threads <= 64; ++threads) {
+      const auto stage_threads = split_dump_threads(threads, true);
+      INFO("threads: " << threads);
+      CHECK(stage_threads.fetch >= 1);
+      CHECK(stage_threads.format >= 1);
+      CHECK(stage_threads.total() <= threads);
+      CHECK(stage_threads.fetch == std::max(std::size_t{1}, threads / 2));
+      if (threads > 1) {
+        CHECK(stage_threads.format > 1);
+      }
+    }
+  }
+
+  SECTION("serial formatting") {
+    for (std::size_t threads = 1; threads <= 64; ++threads) {
+      const auto stage_threads = split_dump_threads(threads, false);
+      INFO("threads: " << threads);
+      CHECK(stage_threads.fetch == threads);
+      CHECK(stage_threads.format == 1);
+      CHECK(stage_threads.total() <= threads);
+    }
+  }
+
+  SECTION("zero threads") {
+    CHECK(split_dump_threads(0, true).total() == 1);
+    CHECK(split_dump_threads(0, false).total() == 1);
+  }
+}
+
+}  // namespace hictk::tools::test
@@ -4,17 +4,26 @@
 
 #include <parallel_hashmap/btree.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "hictk/bin_table.hpp"
 #include "hictk/cooler/cooler.hpp"
+#include "hictk/expected_values_table.hpp"
 #include "hictk/hic.hpp"
 #include "hictk/pixel.hpp"
 #include "hictk/transformers/coarsen.hpp"
@@ -23,6 +32,7 @@
 #include "hictk/transformers/stats.hpp"
 #include "hictk/transformers/to_dense_matrix.hpp"
 #include "hictk/transformers/to_sparse_matrix.hpp"
+#include "hictk/transformers/transform_matrix.hpp"
 
 namespace hictk::test {
 inline const std::filesystem::path datadir{"test/data"};  // NOLINT(cert-err58-cpp)
@@ -247,6 +257,213 @@ TEST_CASE("Transformers (cooler)", "[transformers][short]") {
   }
 }
 
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Transformers: PixelMerger", "[transformers][short]") {
+  using PixelBuffer = std::vector<ThinPixel<std::int32_t>>;
+  using It = PixelBuffer::const_iterator;
+
+  // Generate num_chunks sorted chunks of pixels with plenty of duplicate coordinates, both within
+  // and across chunks
+  auto generate_chunks = [](std::size_t num_chunks) {
+    std::vector<PixelBuffer> chunks(num_chunks);
+    std::uint64_t seed = 42;
+    for (std::size_t i = 0; i < num_chunks; ++i) {
+      auto& chunk = chunks[i];
+      for (std::size_t j = 0; j < 50 + (i % 7) * 100; ++j) {
+        seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+        const auto bin1_id = (seed >> 33U) % 50;
+        const auto bin2_id = bin1_id + ((seed >> 13U) % 50);
+        chunk.emplace_back(ThinPixel<std::int32_t>{bin1_id, bin2_id, 1});
+      }
+      std::sort(chunk.begin(), chunk.end());
+    }
+    return chunks;
+  };
+
+  for (const std::size_t num_chunks : {0, 1, 2, 3, 17, 1000}) {
+    SECTION(std::to_string(num_chunks) + " chunks") {
+      const auto chunks = generate_chunks(num_chunks);
+      std::vector<It> heads{};
+      std::vector<It> tails{};
+      for (const auto& chunk : chunks) {
+        heads.emplace_back(chunk.cbegin());
+        tails.emplace_back(chunk.cend());
+      }
+
+      const PixelMerger<It> merger(heads, tails);
+      const auto pixels = merger.read_all();
+      const auto expected_pixels = merge_pixels_hashmap(heads, tails);
+
+      REQUIRE(pixels.size() == expected_pixels.size());
+      auto expected_it = expected_pixels.begin();
+      for (const auto& p : pixels) {
+        CHECK(p.bin1_id == expected_it->first.bin1);
+        CHECK(p.bin2_id == expected_it->first.bin2);
+        CHECK(p.count == expected_it->second);
+        ++expected_it;
+      }
+
+      if (!pixels.empty()) {
+        // copies of an iterator should be independent from each other
+        auto it1 = merger.begin();
+        for (std::size_t i = 0; i < pixels.size() / 2; ++i) {
+          std::ignore = ++it1;
+        }
+        auto it2 = it1;
+        CHECK(std::distance(it1, merger.end()) == std::distance(it2, merger.end()));
+        CHECK(*it1 == *it2);
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Transformers: CoarsenPixels", "[transformers][short]") {
+  // chr2 is shorter than the coarsest resolution, so that its bins end up in the same chunk of
+  // rel_ids as the last bins of chr1
+  const Reference chroms{Chromosome{0, "chr1", 1'000'003}, Chromosome{1, "chr2", 50'000},
+                         Chromosome{2, "chr3", 300'000}};
+  const std::uint32_t resolution = 1'000;
+  const auto bins = std::make_shared<const BinTable>(chroms, resolution);
+
+  std::vector<ThinPixel<std::int32_t>> pixels{};
+  std::uint64_t seed = 42;
+  for (std::size_t i = 0; i < 100'000; ++i) {
+    seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+    auto bin1_id = (seed >> 13U) % bins->size();
+    auto bin2_id = (seed >> 33U) % bins->size();
+    if (bin1_id > bin2_id) {
+      std::swap(bin1_id, bin2_id);
+    }
+    pixels.emplace_back(ThinPixel<std::int32_t>{bin1_id, bin2_id, 1});
+  }
+  std::sort(pixels.begin(), pixels.end());
+  pixels.erase(std::unique(pixels.begin(), pixels.end(),
+                           [](const auto& p1, const auto& p2) {
+                             return p1.bin1_id == p2.bin1_id && p1.bin2_id == p2.bin2_id;
+                           }),
+               pixels.end());
+
+  for (const std::size_t factor : {2, 10, 100, 500}) {
+    SECTION(std::to_string(factor) + "x") {
+      const BinTable dest_bins(chroms, resolution * static_cast<std::uint32_t>(factor));
+      std::map<std::pair<std::uint64_t, std::uint64_t>, std::int32_t> expected_pixels{};
+      for (const auto& p : pixels) {
+        const auto bin1 = bins->at(p.bin1_id);
+        const auto bin2 = bins->at(p.bin2_id);
+        const auto coarse_bin1_id = dest_bins.at(bin1.chrom(), bin1.start()).id();
+        const auto coarse_bin2_id = dest_bins.at(bin2.chrom(), bin2.start()).id();
+        expected_pixels[std::make_pair(coarse_bin1_id, coarse_bin2_id)] += p.count;
+      }
+
+      const auto coarsened_pixels =
+          CoarsenPixels(pixels.begin(), pixels.end(), bins, factor).read_all();
+
+      REQUIRE(coarsened_pixels.size() == expected_pixels.size());
+      auto expected_it = expected_pixels.begin();
+      for (const auto& p : coarsened_pixels) {
+        CHECK(p.bin1_id == expected_it->first.first);
+        CHECK(p.bin2_id == expected_it->first.second);
+        CHECK(p.count == expected_it->second);
+        ++expected_it;
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+TEST_CASE("Transformers: TransformMatrix", "[transformers][short]") {
+  const Reference chroms{Chromosome{0, "chr1", 1'000}, Chromosome{1, "chr2", 505},
+                         Chromosome{2, "chr3", 250}};
+  const auto bins = std::make_shared<const BinTable>(chroms, 10);
+
+  std::vector<ThinPixel<std::int32_t>> pixels{};
+  for (std::uint64_t bin1_id = 0; bin1_id < bins->size(); bin1_id += 3) {
+    for (std::uint64_t bin2_id = bin1_id; bin2_id < bins->size(); bin2_id += 7) {
+      pixels.emplace_back(
+          ThinPixel<std::int32_t>{bin1_id, bin2_id, static_cast<std::int32_t>(bin1_id % 11 + 1)});
+    }
+  }
+
+  const auto expected = std::make_shared<const ExpectedValuesTable>(
+      ExpectedValuesTable::compute(bins, pixels.begin(), pixels.end()));
+
+  auto expected_value = [&](const ThinPixel<std::int32_t>& p) {
+    const auto chrom1 = bins->at(p.bin1_id).chrom();
+    const auto chrom2 = bins->at(p.bin2_id).chrom();
+    if (chrom1 == chrom2) {
+      return expected->cis(chrom1, p.bin2_id - p.bin1_id);
+    }
+    return expected->trans(chrom1, chrom2);
+  };
+
+  SECTION("oe") {
+    const auto transformed =
+        TransformMatrix(pixels.begin(), pixels.end(), expected, MatrixTransform::oe).read_all();
+    REQUIRE(transformed.size() == pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      const auto oe = static_cast<double>(pixels[i].count) / expected_value(pixels[i]);
+      CHECK(transformed[i].bin1_id == pixels[i].bin1_id);
+      CHECK(transformed[i].bin2_id == pixels[i].bin2_id);
+      CHECK_THAT(transformed[i].count, Catch::Matchers::WithinRel(oe));
+    }
+  }
+
+  SECTION("log2(oe)") {
+    const auto transformed =
+        TransformMatrix(pixels.begin(), pixels.end(), expected, MatrixTransform::log2_oe)
+            .read_all();
+    REQUIRE(transformed.size() == pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      const auto oe = static_cast<double>(pixels[i].count) / expected_value(pixels[i]);
+      const auto log2_oe = std::log2(oe);
+      CHECK_THAT(transformed[i].count, Catch::Matchers::WithinAbs(log2_oe, 1.0e-9));
+    }
+  }
+
+  SECTION("pearson") {
+    const auto transformed =
+        TransformMatrix(pixels.begin(), pixels.end(), expected, MatrixTransform::pearson)
+            .read_all();
+    REQUIRE(transformed.size() == pixels.size());
+    for (std::size_t i = 0; i < pixels.size(); ++i) {
+      const auto e = expected_value(pixels[i]);
+      const auto residual = (static_cast<double>(pixels[i].count) - e) / std::sqrt(e);
+      CHECK_THAT(transformed[i].count, Catch::Matchers::WithinAbs(residual, 1.0e-9));
+    }
+  }
+
+  SECTION("distance band") {
+    const std::uint64_t min_distance = 1;
+    const std::uint64_t max_distance = 10;
+    const auto transformed = TransformMatrix(pixels.begin(), pixels.end(), expected,
+                                             MatrixTransform::observed, min_distance, max_distance)
+                                 .read_all();
+
+    std::vector<ThinPixel<double>> expected_pixels{};
+    for (const auto& p : pixels) {
+      const auto distance = p.bin2_id - p.bin1_id;
+      if (bins->at(p.bin1_id).chrom() == bins->at(p.bin2_id).chrom() &&
+          distance >= min_distance && distance < max_distance) {
+        expected_pixels.emplace_back(
+            ThinPixel<double>{p.bin1_id, p.bin2_id, static_cast<double>(p.count)});
+      }
+    }
+
+    REQUIRE(!expected_pixels.empty());
+    REQUIRE(transformed.size() == expected_pixels.size());
+    for (std::size_t i = 0; i < expected_pixels.size(); ++i) {
+      CHECK(transformed[i] == expected_pixels[i]);
+    }
+  }
+
+  SECTION("invalid params") {
+    CHECK_THROWS(TransformMatrix(pixels.begin(), pixels.end(), nullptr));
+    CHECK_THROWS(
+        TransformMatrix(pixels.begin(), pixels.end(), expected, MatrixTransform::oe, 10, 10));
+  }
+}
+
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 TEST_CASE("Transformers (hic)", "[transformers][short]") {
   auto path = datadir / "hic/4DNFIZ1ZVXC8.hic8";